@@ -584,6 +584,22 @@ void I_ShutdownSound(void) {
 	return;
 }
 
+/*
+======================
+I_GetXAudio2
+
+The software mixer has no XAudio2 engine and never calls I_InitSoundHardware,
+so Doom classic stays silent in that configuration.
+======================
+*/
+static IXAudio2 * I_GetXAudio2() {
+#if defined( ID_SOUND_SOFTWARE )
+	return NULL;
+#else
+	return soundSystemLocal.hardware.GetIXAudio2();
+#endif
+}
+
 /*
 ======================
 I_InitSoundHardware
@@ -705,7 +721,10 @@ void I_InitSoundChannel( int channel, int numOutputChannels_ ) {
     voiceFormat.wBitsPerSample = 8;
     voiceFormat.cbSize = 0;
 
-	soundSystemLocal.hardware.GetIXAudio2()->CreateSourceVoice( &soundchannel->m_pSourceVoice, (WAVEFORMATEX *)&voiceFormat );
+	IXAudio2 * pXAudio2 = I_GetXAudio2();
+	if ( pXAudio2 != NULL ) {
+		pXAudio2->CreateSourceVoice( &soundchannel->m_pSourceVoice, (WAVEFORMATEX *)&voiceFormat );
+	}
 }
 
 /*
@@ -813,7 +832,10 @@ void I_InitMusic(void)
 		voiceFormat.wBitsPerSample = MIDI_FORMAT_BYTES * 8;
 		voiceFormat.cbSize = 0;
 
-		soundSystemLocal.hardware.GetIXAudio2()->CreateSourceVoice( &pMusicSourceVoice, (WAVEFORMATEX *)&voiceFormat, XAUDIO2_VOICE_MUSIC );
+		IXAudio2 * pXAudio2 = I_GetXAudio2();
+		if ( pXAudio2 != NULL ) {
+			pXAudio2->CreateSourceVoice( &pMusicSourceVoice, (WAVEFORMATEX *)&voiceFormat, XAUDIO2_VOICE_MUSIC );
+		}
 
 		Music_initialized = true;
 	}
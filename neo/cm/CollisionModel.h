@@ -80,6 +80,22 @@ typedef struct trace_s {
 
 typedef int cmHandle_t;
 
+// batched trace query
+typedef struct cmTraceQuery_s {
+	trace_t					results;		// trace result, set by TranslationBatch
+	int						contents;		// contents, set by ContentsBatch
+	idVec3					start;			// start of trace
+	idVec3					end;			// end of trace, ignored by ContentsBatch
+	const idTraceModel *	trm;			// trace model or NULL for a point trace
+	idMat3					trmAxis;		// orientation of the trace model
+	int						contentMask;	// contents to collide with
+	cmHandle_t				model;			// model to trace against
+	const idTraceModel *	targetTrm;		// if set trace against this trace model instead of model
+	const idMaterial *		targetMaterial;	// material for the target trace model
+	idVec3					modelOrigin;	// origin of the model
+	idMat3					modelAxis;		// orientation of the model
+} cmTraceQuery_t;
+
 #define CM_CLIP_EPSILON		0.25f			// always stay this distance away from any model
 #define CM_BOX_EPSILON		1.0f			// should always be larger than clip epsilon
 #define CM_MAX_TRACE_DIST	4096.0f			// maximum distance a trace model may be traced, point traces are unlimited
@@ -131,6 +147,12 @@ public:
 	virtual int				Contacts( contactInfo_t *contacts, const int maxContacts, const idVec3 &start, const idVec6 &dir, const float depth,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) = 0;
+	// Translates a batch of trace models on the job threads, results are identical to calling Translation for each query.
+	// Only the thread running the game may start a batch.
+	virtual void			TranslationBatch( cmTraceQuery_t *queries, int numQueries ) = 0;
+	// Gets the contents for a batch of trace models on the job threads, results are identical to calling Contents for each query.
+	// Only the thread running the game may start a batch.
+	virtual void			ContentsBatch( cmTraceQuery_t *queries, int numQueries ) = 0;
 
 	// Tests collision detection.
 	virtual void			DebugOutput( const idVec3 &origin ) = 0;
@@ -61,10 +61,10 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_b
 	float d, bestd;
 	idVec3 *p;
 
-	if ( b->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( CM_BrushCheckcount( tw, b ) == tw->checkCount ) {
 		return false;
 	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
+	CM_BrushCheckcount( tw, b ) = tw->checkCount;
 
 	if ( !(b->contents & tw->contents) ) {
 		return false;
@@ -133,10 +133,10 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {						\
+#define CM_SetTrmPolygonSidedness( v, p, plane, bitNum ) {					\
 	const int mask = 1 << bitNum;											\
 	if ( ( (v)->sideSet & mask ) == 0 ) {									\
-		const float fl = plane.Distance( (v)->p );							\
+		const float fl = plane.Distance( p );								\
 		(v)->side = ( (v)->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );		\
 		(v)->sideSet |= mask;												\
 	}																		\
@@ -155,13 +155,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	float d, bestd;
 	cm_trmEdge_t *trmEdge;
 	cm_edge_t *edge;
-	cm_vertex_t *v, *v1, *v2;
+	cm_vertex_t *v;
+	cm_primitiveState_t *edgeState, *vertexState, *v1, *v2;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( CM_PolygonCheckcount( tw, p ) == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	CM_PolygonCheckcount( tw, p ) = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -193,14 +194,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
 			// if this edge is already tested
-			if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( CM_EdgeState( tw, edge )->checkcount == tw->checkCount ) {
 				continue;
 			}
 
 			for ( j = 0; j < 2; j++ ) {
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( CM_VertexState( tw, v )->checkcount == tw->checkCount ) {
 					continue;
 				}
 
@@ -235,19 +236,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		edgeState = CM_EdgeState( tw, edge );
 		// reset sidedness cache if this is the first time we encounter this edge
-		if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			edge->sideSet = 0;
+		if ( edgeState->checkcount != tw->checkCount ) {
+			edgeState->sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 													tw->model->vertices[edge->vertexNum[1]].p );
-		v = &tw->model->vertices[edge->vertexNum[INT32_SIGNBITSET( edgeNum )]];
+		vertexState = tw->state->vertices + edge->vertexNum[INT32_SIGNBITSET( edgeNum )];
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			v->sideSet = 0;
+		if ( vertexState->checkcount != tw->checkCount ) {
+			vertexState->sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		vertexState->checkcount = tw->checkCount;
 	}
 
 	// get side of polygon for each trm vertex
@@ -269,8 +271,9 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[j];
 			edge = tw->model->edges + abs(edgeNum);
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> i ) & 1 ) ^ flip ) {
+			edgeState = CM_EdgeState( tw, edge );
+			CM_SetTrmEdgeSidedness( edgeState, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
+			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( edgeState->side >> i ) & 1 ) ^ flip ) {
 				break;
 			}
 #else
@@ -308,17 +311,18 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		edgeState = CM_EdgeState( tw, edge );
+		if ( edgeState->checkcount == tw->checkCount ) {
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		edgeState->checkcount = tw->checkCount;
 
 		for ( j = 0; j < tw->numPolys; j++ ) {
 #if 1
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			v1 = tw->state->vertices + edge->vertexNum[0];
+			CM_SetTrmPolygonSidedness( v1, tw->model->vertices[edge->vertexNum[0]].p, tw->polys[j].plane, j );
+			v2 = tw->state->vertices + edge->vertexNum[1];
+			CM_SetTrmPolygonSidedness( v2, tw->model->vertices[edge->vertexNum[1]].p, tw->polys[j].plane, j );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( !(((v1->side ^ v2->side) >> j) & 1) ) {
 				continue;
@@ -327,10 +331,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 #else
 			float d1, d2;
 
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			d1 = tw->polys[j].plane.Distance( v1->p );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			d2 = tw->polys[j].plane.Distance( v2->p );
+			d1 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[0]].p );
+			d2 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[1]].p );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( (d1 >= 0.0f && d2 >= 0.0f) || (d1 <= 0.0f && d2 <= 0.0f) ) {
 				continue;
@@ -346,8 +348,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 				trmEdge = tw->edges + abs(trmEdgeNum);
 #if 1
 				bitNum = abs(trmEdgeNum);
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if ( INT32_SIGNBITSET( trmEdgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) ^ flip ) {
+				CM_SetTrmEdgeSidedness( edgeState, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
+				if ( INT32_SIGNBITSET( trmEdgeNum ) ^ ( ( edgeState->side >> bitNum ) & 1 ) ^ flip ) {
 					break;
 				}
 #else
@@ -411,7 +413,7 @@ cm_node_t *idCollisionModelManagerLocal::PointNode( const idVec3 &p, cm_model_t
 idCollisionModelManagerLocal::PointContents
 ================
 */
-int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t model ) {
+int idCollisionModelManagerLocal::PointContents( cm_traceContext_t *context, const idVec3 p, cmHandle_t model ) {
 	int i;
 	float d;
 	cm_node_t *node;
@@ -419,7 +421,7 @@ int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t mode
 	cm_brush_t *b;
 	idPlane *plane;
 
-	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::models[model] );
+	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::GetTraceModel( context, model ) );
 	for ( bref = node->brushes; bref; bref = bref->next ) {
 		b = bref->b;
 		// test if the point is within the brush bounds
@@ -454,7 +456,7 @@ int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t mode
 idCollisionModelManagerLocal::TransformedPointContents
 ==================
 */
-int	idCollisionModelManagerLocal::TransformedPointContents( const idVec3 &p, cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis ) {
+int	idCollisionModelManagerLocal::TransformedPointContents( cm_traceContext_t *context, const idVec3 &p, cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis ) {
 	idVec3 p_l;
 
 	// subtract origin offset
@@ -462,7 +464,7 @@ int	idCollisionModelManagerLocal::TransformedPointContents( const idVec3 &p, cmH
 	if ( modelAxis.IsRotated() ) {
 		p_l *= modelAxis;
 	}
-	return idCollisionModelManagerLocal::PointContents( p_l, model );
+	return idCollisionModelManagerLocal::PointContents( context, p_l, model );
 }
 
 
@@ -471,7 +473,7 @@ int	idCollisionModelManagerLocal::TransformedPointContents( const idVec3 &p, cmH
 idCollisionModelManagerLocal::ContentsTrm
 ==================
 */
-int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &start,
+int idCollisionModelManagerLocal::ContentsTrm( cm_traceContext_t *context, trace_t *results, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
 	int i;
@@ -485,7 +487,7 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 					trm->bounds[1][1] - trm->bounds[0][1] <= 0.0f &&
 					trm->bounds[1][2] - trm->bounds[0][2] <= 0.0f ) ) {
 
-		results->c.contents = idCollisionModelManagerLocal::TransformedPointContents( start, model, modelOrigin, modelAxis );
+		results->c.contents = idCollisionModelManagerLocal::TransformedPointContents( context, start, model, modelOrigin, modelAxis );
 		results->fraction = ( results->c.contents == 0 );
 		results->endpos = start;
 		results->endAxis = trmAxis;
@@ -493,8 +495,6 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		return results->c.contents;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
-
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
 	tw.trace.c.type = CONTACT_NONE;
@@ -505,7 +505,8 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::GetTraceModel( context, model );
+	idCollisionModelManagerLocal::SetupTraceState( context, &tw, model );
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 
@@ -619,7 +620,7 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 idCollisionModelManagerLocal::Contents
 ==================
 */
-int idCollisionModelManagerLocal::Contents( const idVec3 &start,
+int idCollisionModelManagerLocal::Contents( cm_traceContext_t *context, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
 	trace_t results;
@@ -628,10 +629,21 @@ int idCollisionModelManagerLocal::Contents( const idVec3 &start,
 		idLib::Printf("idCollisionModelManagerLocal::Contents: invalid model handle\n");
 		return 0;
 	}
-	if ( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::models[model] ) {
+	if ( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::GetTraceModel( context, model ) ) {
 		idLib::Printf("idCollisionModelManagerLocal::Contents: invalid model\n");
 		return 0;
 	}
 
-	return ContentsTrm( &results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+	return ContentsTrm( context, &results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+}
+
+/*
+==================
+idCollisionModelManagerLocal::Contents
+==================
+*/
+int idCollisionModelManagerLocal::Contents( const idVec3 &start,
+									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+	return idCollisionModelManagerLocal::Contents( traceContexts[0], start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 }
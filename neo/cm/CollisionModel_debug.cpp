@@ -352,6 +352,8 @@ static idCVar cm_testWalk(			"cm_testWalk",			"1",					CVAR_GAME | CVAR_BOOL,		"
 static idCVar cm_testLength(		"cm_testLength",		"1024",					CVAR_GAME | CVAR_FLOAT,		"" );
 static idCVar cm_testRadius(		"cm_testRadius",		"64",					CVAR_GAME | CVAR_FLOAT,		"" );
 static idCVar cm_testAngle(			"cm_testAngle",			"60",					CVAR_GAME | CVAR_FLOAT,		"" );
+idCVar cm_simdPlueckers(			"cm_simdPlueckers",		"1",					CVAR_GAME | CVAR_BOOL,		"test four polygon edge Plueckers at once during translations and rotations" );
+idCVar cm_recordTraces(				"cm_recordTraces",		"0",					CVAR_GAME | CVAR_BOOL,		"record the translations and rotations of the main thread for cm_testRecorded" );
 
 static int total_translation;
 static int min_translation = 999999;
@@ -488,3 +490,139 @@ void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 	Mem_Free( testend );
 	testend = NULL;
 }
+
+/*
+===============================================================================
+
+Recorded trace replay
+
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::RecordTrace
+================
+*/
+void idCollisionModelManagerLocal::RecordTrace( cm_recordedTrace_t &trace, const idTraceModel *trm ) {
+	int i;
+
+	if ( recordedTraces.Num() >= MAX_RECORDED_TRACES ) {
+		return;
+	}
+
+	trace.trmNum = -1;
+	if ( trm != NULL ) {
+		// most traces are done with the same few trace models
+		for ( i = recordedTrms.Num() - 1; i >= 0; i-- ) {
+			if ( recordedTrms[i]->Compare( *trm ) ) {
+				break;
+			}
+		}
+		if ( i < 0 ) {
+			i = recordedTrms.Append( new (TAG_COLLISION) idTraceModel( *trm ) );
+		}
+		trace.trmNum = i;
+	}
+	recordedTraces.Append( trace );
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeRecordedTraces
+================
+*/
+void idCollisionModelManagerLocal::FreeRecordedTraces() {
+	recordedTraces.Clear();
+	recordedTrms.DeleteContents( true );
+}
+
+/*
+================
+CM_TracesEqual
+================
+*/
+static bool CM_TracesEqual( const trace_t &a, const trace_t &b ) {
+	if ( a.fraction != b.fraction || a.endpos != b.endpos || a.endAxis != b.endAxis ) {
+		return false;
+	}
+	if ( a.c.type != b.c.type || a.c.normal != b.c.normal || a.c.dist != b.c.dist || a.c.point != b.c.point ) {
+		return false;
+	}
+	if ( a.c.contents != b.c.contents || a.c.material != b.c.material || a.c.modelFeature != b.c.modelFeature || a.c.trmFeature != b.c.trmFeature ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::TestRecordedTraces
+
+  Replays the traces recorded with cm_recordTraces with the scalar and the SIMD Pluecker tests
+  and verifies both give exactly the same results.
+================
+*/
+void idCollisionModelManagerLocal::TestRecordedTraces() {
+	int i, pass, slot, numTranslations, numMismatches;
+	double ms[2];
+	trace_t *results[2];
+	idTimer timer;
+
+	if ( recordedTraces.Num() == 0 ) {
+		idLib::Printf( "no traces recorded, set cm_recordTraces 1 and play for a while\n" );
+		return;
+	}
+
+	cm_recordTraces.SetBool( false );
+	const bool simdPlueckers = cm_simdPlueckers.GetBool();
+
+	results[0] = (trace_t *) Mem_Alloc( recordedTraces.Num() * sizeof( trace_t ), TAG_COLLISION );
+	results[1] = (trace_t *) Mem_Alloc( recordedTraces.Num() * sizeof( trace_t ), TAG_COLLISION );
+
+	// the first pass only warms up the caches
+	for ( pass = -1; pass < 2; pass++ ) {
+		slot = Max( pass, 0 );
+		cm_simdPlueckers.SetBool( slot != 0 );
+
+		timer.Clear();
+		timer.Start();
+		for ( i = 0; i < recordedTraces.Num(); i++ ) {
+			const cm_recordedTrace_t &rec = recordedTraces[i];
+			const idTraceModel *trm = ( rec.trmNum >= 0 ) ? recordedTrms[rec.trmNum] : NULL;
+			if ( rec.isRotation ) {
+				Rotation( &results[slot][i], rec.start, rec.rotation, trm, rec.trmAxis, rec.contentMask, rec.model, rec.modelOrigin, rec.modelAxis );
+			} else {
+				Translation( &results[slot][i], rec.start, rec.end, trm, rec.trmAxis, rec.contentMask, rec.model, rec.modelOrigin, rec.modelAxis );
+			}
+		}
+		timer.Stop();
+		ms[slot] = timer.Milliseconds();
+	}
+
+	cm_simdPlueckers.SetBool( simdPlueckers );
+
+	numTranslations = numMismatches = 0;
+	for ( i = 0; i < recordedTraces.Num(); i++ ) {
+		if ( !recordedTraces[i].isRotation ) {
+			numTranslations++;
+		}
+		if ( !CM_TracesEqual( results[0][i], results[1][i] ) ) {
+			numMismatches++;
+		}
+	}
+
+	Mem_Free( results[0] );
+	Mem_Free( results[1] );
+
+	idLib::Printf( "%d translations, %d rotations, %d trace models\n", numTranslations, recordedTraces.Num() - numTranslations, recordedTrms.Num() );
+	idLib::Printf( "scalar Plueckers: %1.2f milliseconds\n", ms[0] );
+	idLib::Printf( "SIMD Plueckers:   %1.2f milliseconds (%1.2fx)\n", ms[1], ( ms[1] > 0.0 ) ? ms[0] / ms[1] : 0.0 );
+	if ( numMismatches ) {
+		idLib::Warning( "%d traces differ between the scalar and SIMD Pluecker tests", numMismatches );
+	}
+}
+
+CONSOLE_COMMAND( cm_testRecorded, "replays the traces recorded with cm_recordTraces with the scalar and the SIMD Pluecker tests", NULL ) {
+	collisionModelManagerLocal.TestRecordedTraces();
+}
@@ -539,6 +539,8 @@ cm_model_t * idCollisionModelManagerLocal::ParseCollisionModel( idLexer *src ) {
 	CM_GetNodeBounds( &model->bounds, model->node );
 	// get model contents
 	model->contents = CM_GetNodeContents( model->node );
+	// number polygons and brushes for the trace contexts
+	IndexModelPrimitives( model );
 	// total memory used by this model
 	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
 						model->numEdges * sizeof(cm_edge_t) +
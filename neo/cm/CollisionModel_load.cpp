@@ -188,15 +188,13 @@ void idCollisionModelManagerLocal::Clear() {
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
 	trmMaterial = NULL;
 	numProcNodes = 0;
 	procNodes = NULL;
-	getContacts = false;
-	contacts = NULL;
-	maxContacts = 0;
-	numContacts = 0;
+	memset( traceContexts, 0, sizeof( traceContexts ) );
+	memset( traceContextUsed, 0, sizeof( traceContextUsed ) );
+	traceBatchJobs = NULL;
+	traceBatches.Clear();
 }
 
 /*
@@ -412,6 +410,9 @@ idCollisionModelManagerLocal::FreeMap
 void idCollisionModelManagerLocal::FreeMap() {
 	int i;
 
+	// the recorded model handles are only valid for this map
+	FreeRecordedTraces();
+
 	if ( !loaded ) {
 		Clear();
 		return;
@@ -424,7 +425,7 @@ void idCollisionModelManagerLocal::FreeMap() {
 		FreeModel( models[i] );
 	}
 
-	FreeTrmModelStructure();
+	FreeTraceContexts();
 
 	Mem_Free( models );
 
@@ -438,22 +439,22 @@ void idCollisionModelManagerLocal::FreeMap() {
 idCollisionModelManagerLocal::FreeTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::FreeTrmModelStructure() {
+void idCollisionModelManagerLocal::FreeTrmModelStructure( cm_traceContext_t *context ) {
 	int i;
 
-	assert( models );
-	if ( !models[MAX_SUBMODELS] ) {
+	if ( !context->trmModel ) {
 		return;
 	}
 
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
+		FreePolygon( context->trmModel, context->trmPolygons[i]->p );
 	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
+	FreeBrush( context->trmModel, context->trmBrushes[0]->b );
 
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+	context->trmModel->node->polygons = NULL;
+	context->trmModel->node->brushes = NULL;
+	FreeModel( context->trmModel );
+	context->trmModel = NULL;
 }
 
 
@@ -558,6 +559,8 @@ cm_model_t *idCollisionModelManagerLocal::AllocModel() {
 	model->brushRefBlocks = NULL;
 	model->polygonBlock = NULL;
 	model->brushBlock = NULL;
+	model->numIndexedPolygons = 0;
+	model->numIndexedBrushes = 0;
 	model->numPolygons = model->polygonMemory =
 	model->numBrushes = model->brushMemory =
 	model->numNodes = model->numBrushRefs =
@@ -735,7 +738,7 @@ void idCollisionModelManagerLocal::AddBrushToNode( cm_model_t *model, cm_node_t
 idCollisionModelManagerLocal::SetupTrmModelStructure
 ================
 */
-void idCollisionModelManagerLocal::SetupTrmModelStructure() {
+void idCollisionModelManagerLocal::SetupTrmModelStructure( cm_traceContext_t *context ) {
 	int i;
 	cm_node_t *node;
 	cm_model_t *model;
@@ -743,8 +746,7 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure() {
 	// setup model
 	model = AllocModel();
 
-	assert( models );
-	models[MAX_SUBMODELS] = model;
+	context->trmModel = model;
 	// create node to hold the collision data
 	node = (cm_node_t *) AllocNode( model, 1 );
 	node->planeType = -1;
@@ -756,32 +758,36 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure() {
 	model->numEdges = 0;
 	model->maxEdges = MAX_TRACEMODEL_EDGES+1;
 	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t), TAG_COLLISION );
-	// create a material for the trace model polygons
-	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
-	if ( !trmMaterial ) {
-		common->FatalError( "_tracemodel material not found" );
-	}
+	// the material for the trace model polygons is found on the main thread when loading the map
+	assert( trmMaterial != NULL );
 
 	// allocate polygons
+	cm_polygonRef_t **trmPolygons = context->trmPolygons;
 	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
 		trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
 		trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
 		trmPolygons[i]->p->bounds.Clear();
 		trmPolygons[i]->p->plane.Zero();
 		trmPolygons[i]->p->checkcount = 0;
+		trmPolygons[i]->p->index = i;
 		trmPolygons[i]->p->contents = -1;		// all contents
 		trmPolygons[i]->p->material = trmMaterial;
 		trmPolygons[i]->p->numEdges = 0;
 	}
 	// allocate brush for position test
+	cm_brushRef_t **trmBrushes = context->trmBrushes;
 	trmBrushes[0] = AllocBrushReference( model, 1 );
 	trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
 	trmBrushes[0]->b->primitiveNum = 0;
 	trmBrushes[0]->b->bounds.Clear();
 	trmBrushes[0]->b->checkcount = 0;
+	trmBrushes[0]->b->index = 0;
 	trmBrushes[0]->b->contents = -1;		// all contents
 	trmBrushes[ 0 ]->b->material = trmMaterial;
 	trmBrushes[0]->b->numPlanes = 0;
+
+	model->numIndexedPolygons = MAX_TRACEMODEL_POLYS;
+	model->numIndexedBrushes = 1;
 }
 
 /*
@@ -789,10 +795,11 @@ void idCollisionModelManagerLocal::SetupTrmModelStructure() {
 idCollisionModelManagerLocal::SetupTrmModel
 
 Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+as a reusable temporary buffer. Every trace context has its own buffer so the returned handle always
+refers to the trace model set up for that context.
 ================
 */
-cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
+cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( cm_traceContext_t *context, const idTraceModel &trm, const idMaterial *material ) {
 	int i, j;
 	cm_vertex_t *vertex;
 	cm_edge_t *edge;
@@ -808,7 +815,10 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		material = trmMaterial;
 	}
 
-	model = models[MAX_SUBMODELS];
+	cm_polygonRef_t **trmPolygons = context->trmPolygons;
+	cm_brushRef_t **trmBrushes = context->trmBrushes;
+
+	model = context->trmModel;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
@@ -872,6 +882,199 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	return TRACE_MODEL_HANDLE;
 }
 
+/*
+================
+idCollisionModelManagerLocal::SetupTrmModel
+================
+*/
+cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
+	return SetupTrmModel( traceContexts[0], trm, material );
+}
+
+
+/*
+===============================================================================
+
+Trace contexts
+
+===============================================================================
+*/
+
+/*
+================
+CM_GrowModelState
+================
+*/
+static void CM_GrowModelState( cm_modelState_t *state, const cm_model_t *model ) {
+	if ( state->maxVertices < model->maxVertices ) {
+		Mem_Free( state->vertices );
+		state->maxVertices = model->maxVertices;
+		state->vertices = (cm_primitiveState_t *) Mem_ClearedAlloc( state->maxVertices * sizeof( cm_primitiveState_t ), TAG_COLLISION );
+	}
+	if ( state->maxEdges < model->maxEdges ) {
+		Mem_Free( state->edges );
+		state->maxEdges = model->maxEdges;
+		state->edges = (cm_primitiveState_t *) Mem_ClearedAlloc( state->maxEdges * sizeof( cm_primitiveState_t ), TAG_COLLISION );
+	}
+	if ( state->maxPolygons < model->numIndexedPolygons ) {
+		Mem_Free( state->polygons );
+		state->maxPolygons = model->numIndexedPolygons;
+		state->polygons = (int *) Mem_ClearedAlloc( state->maxPolygons * sizeof( int ), TAG_COLLISION );
+	}
+	if ( state->maxBrushes < model->numIndexedBrushes ) {
+		Mem_Free( state->brushes );
+		state->maxBrushes = model->numIndexedBrushes;
+		state->brushes = (int *) Mem_ClearedAlloc( state->maxBrushes * sizeof( int ), TAG_COLLISION );
+	}
+}
+
+/*
+================
+CM_FreeModelState
+================
+*/
+static void CM_FreeModelState( cm_modelState_t *state ) {
+	Mem_Free( state->vertices );
+	Mem_Free( state->edges );
+	Mem_Free( state->polygons );
+	Mem_Free( state->brushes );
+	memset( state, 0, sizeof( *state ) );
+}
+
+/*
+================
+idCollisionModelManagerLocal::AllocTraceContext
+================
+*/
+cm_traceContext_t *idCollisionModelManagerLocal::AllocTraceContext() {
+	cm_traceContext_t *context;
+
+	context = new (TAG_COLLISION) cm_traceContext_t;
+	context->checkCount = 0;
+	memset( &context->trmModelState, 0, sizeof( context->trmModelState ) );
+	context->getContacts = false;
+	context->contacts = NULL;
+	context->maxContacts = 0;
+	context->numContacts = 0;
+	SetupTrmModelStructure( context );
+
+	return context;
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeTraceContext
+================
+*/
+void idCollisionModelManagerLocal::FreeTraceContext( cm_traceContext_t *context ) {
+	for ( int i = 0; i < context->modelStates.Num(); i++ ) {
+		CM_FreeModelState( &context->modelStates[i] );
+	}
+	CM_FreeModelState( &context->trmModelState );
+	FreeTrmModelStructure( context );
+	delete context;
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeTraceContexts
+================
+*/
+void idCollisionModelManagerLocal::FreeTraceContexts() {
+	if ( traceBatchJobs != NULL ) {
+		parallelJobManager->FreeJobList( traceBatchJobs );
+		traceBatchJobs = NULL;
+	}
+	for ( int i = 0; i < MAX_TRACE_CONTEXTS; i++ ) {
+		if ( traceContexts[i] != NULL ) {
+			FreeTraceContext( traceContexts[i] );
+			traceContexts[i] = NULL;
+		}
+		traceContextUsed[i] = 0;
+	}
+	models[MAX_SUBMODELS] = NULL;
+}
+
+/*
+================
+idCollisionModelManagerLocal::AcquireTraceContext
+
+  claims a free trace context for a batch job, context 0 is never handed out
+  because the regular trace functions use it on the thread running the game
+================
+*/
+cm_traceContext_t *idCollisionModelManagerLocal::AcquireTraceContext() {
+	while ( 1 ) {
+		for ( int i = 1; i < MAX_TRACE_CONTEXTS; i++ ) {
+			if ( Sys_InterlockedCompareExchange( traceContextUsed[i], 0, 1 ) != 0 ) {
+				continue;
+			}
+			// only the thread that claimed the slot touches the context
+			if ( traceContexts[i] == NULL ) {
+				traceContexts[i] = AllocTraceContext();
+			}
+			return traceContexts[i];
+		}
+		Sys_Yield();
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReleaseTraceContext
+================
+*/
+void idCollisionModelManagerLocal::ReleaseTraceContext( cm_traceContext_t *context ) {
+	for ( int i = 1; i < MAX_TRACE_CONTEXTS; i++ ) {
+		if ( traceContexts[i] == context ) {
+			Sys_InterlockedExchange( traceContextUsed[i], 0 );
+			return;
+		}
+	}
+	assert( false );
+}
+
+/*
+================
+idCollisionModelManagerLocal::GetTraceModel
+
+  the trace model handle refers to the trm model of the trace context
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::GetTraceModel( cm_traceContext_t *context, cmHandle_t model ) {
+	if ( model == TRACE_MODEL_HANDLE ) {
+		return context->trmModel;
+	}
+	return models[model];
+}
+
+/*
+================
+idCollisionModelManagerLocal::SetupTraceState
+
+  starts a new trace on tw->model using the primitive state of the trace context
+================
+*/
+void idCollisionModelManagerLocal::SetupTraceState( cm_traceContext_t *context, cm_traceWork_t *tw, cmHandle_t model ) {
+	cm_modelState_t *state;
+
+	if ( model == TRACE_MODEL_HANDLE ) {
+		state = &context->trmModelState;
+	} else {
+		if ( model >= context->modelStates.Num() ) {
+			cm_modelState_t empty;
+			memset( &empty, 0, sizeof( empty ) );
+			context->modelStates.AssureSize( model + 1, empty );
+		}
+		state = &context->modelStates[model];
+	}
+	CM_GrowModelState( state, tw->model );
+
+	context->checkCount++;
+	tw->checkCount = context->checkCount;
+	tw->state = state;
+}
+
 /*
 ===============================================================================
 
@@ -2933,6 +3136,57 @@ void idCollisionModelManagerLocal::OptimizeArrays( cm_model_t *model ) {
 	}
 }
 
+/*
+================
+CM_R_IndexNodePrimitives
+================
+*/
+static void CM_R_IndexNodePrimitives( cm_model_t *model, cm_node_t *node, bool clear ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+
+	while( 1 ) {
+		for ( pref = node->polygons; pref; pref = pref->next ) {
+			if ( clear ) {
+				pref->p->index = -1;
+			} else if ( pref->p->index < 0 ) {
+				pref->p->index = model->numIndexedPolygons++;
+			}
+		}
+		for ( bref = node->brushes; bref; bref = bref->next ) {
+			if ( clear ) {
+				bref->b->index = -1;
+			} else if ( bref->b->index < 0 ) {
+				bref->b->index = model->numIndexedBrushes++;
+			}
+		}
+		// if leaf node
+		if ( node->planeType == -1 ) {
+			break;
+		}
+		CM_R_IndexNodePrimitives( model, node->children[1], clear );
+		node = node->children[0];
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::IndexModelPrimitives
+
+  numbers the polygons and brushes of the model so the trace contexts can keep
+  their check counts outside the shared model data
+================
+*/
+void idCollisionModelManagerLocal::IndexModelPrimitives( cm_model_t *model ) {
+	model->numIndexedPolygons = 0;
+	model->numIndexedBrushes = 0;
+	if ( model->node == NULL ) {
+		return;
+	}
+	CM_R_IndexNodePrimitives( model, model->node, true );
+	CM_R_IndexNodePrimitives( model, model->node, false );
+}
+
 /*
 ================
 idCollisionModelManagerLocal::FinishModel
@@ -2958,6 +3212,8 @@ void idCollisionModelManagerLocal::FinishModel( cm_model_t *model ) {
 	CM_GetNodeBounds( &model->bounds, model->node );
 	// get model contents
 	model->contents = CM_GetNodeContents( model->node );
+	// number polygons and brushes for the trace contexts
+	IndexModelPrimitives( model );
 	// total memory used by this model
 	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
 						model->numEdges * sizeof(cm_edge_t) +
@@ -3120,6 +3376,8 @@ cm_model_t * idCollisionModelManagerLocal::LoadBinaryModelFromFile( idFile *file
 	assert( model->polygonBlock->bytesRemaining == 0 );
 	assert( model->brushBlock->bytesRemaining == 0 );
 
+	IndexModelPrimitives( model );
+
 	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
 		model->numEdges * sizeof(cm_edge_t) +
 		model->polygonMemory +
@@ -3726,8 +3984,16 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 
 	common->UpdateLevelLoadPacifier();
 
-	// setup trace model structure
-	SetupTrmModelStructure();
+	// create a material for the trace model polygons
+	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
+	if ( !trmMaterial ) {
+		common->FatalError( "_tracemodel material not found" );
+	}
+
+	// setup the trace context of the public trace functions, the batch job contexts are created when first used
+	traceContexts[0] = AllocTraceContext();
+	models[MAX_SUBMODELS] = traceContexts[0]->trmModel;
+	traceBatchJobs = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_TRACE_BATCH_JOBS, 0, NULL );
 
 	common->UpdateLevelLoadPacifier();
 
@@ -39,11 +39,17 @@ If you have questions concerning this license or the applicable additional terms
 #define MIN_NODE_SIZE						64.0f
 #define MAX_NODE_POLYGONS					128
 #define CM_MAX_POLYGON_EDGES				64
+#define CM_PLUECKER_SOA_SIZE				( ( CM_MAX_POLYGON_EDGES + 4 ) & ~3 )	// room for the wrapped vertex, padded to a multiple of four
 #define CIRCLE_APPROXIMATION_LENGTH			64.0f
 
 #define	MAX_SUBMODELS						2048
 #define	TRACE_MODEL_HANDLE					MAX_SUBMODELS
 
+#define MAX_TRACE_CONTEXTS					16		// context 0 is used by the regular trace functions, the others by batch jobs
+#define TRACE_BATCH_JOB_QUERIES				8		// number of queries traced by a single batch job
+#define MAX_TRACE_BATCH_JOBS				256
+#define MAX_RECORDED_TRACES					65536	// traces recorded with cm_recordTraces for cm_testRecorded
+
 #define VERTEX_HASH_BOXSIZE					(1<<6)	// must be power of 2
 #define VERTEX_HASH_SIZE					(VERTEX_HASH_BOXSIZE*VERTEX_HASH_BOXSIZE)
 #define EDGE_HASH_SIZE						(1<<14)
@@ -103,6 +109,7 @@ typedef struct cm_polygonBlock_s {
 typedef struct cm_polygon_s {
 	idBounds				bounds;				// polygon bounds
 	int						checkcount;			// for multi-check avoidance
+	int						index;				// index into the trace context polygon check counts
 	int						contents;			// contents behind polygon
 	const idMaterial *		material;			// material
 	idPlane					plane;				// polygon plane
@@ -128,12 +135,14 @@ typedef struct cm_brushBlock_s {
 typedef struct cm_brush_s {
 	cm_brush_s() {
 		checkcount = 0;
+		index = 0;
 		contents = 0;
 		material = NULL;
 		primitiveNum = 0;
 		numPlanes = 0;
 	}
 	int						checkcount;			// for multi-check avoidance
+	int						index;				// index into the trace context brush check counts
 	idBounds				bounds;				// brush bounds
 	int						contents;			// contents of brush
 	const idMaterial *		material;			// material
@@ -179,6 +188,8 @@ typedef struct cm_model_s {
 	int						numEdges;			// number of edges
 	cm_edge_t *				edges;				// array with all edges used by the model
 	cm_node_t *				node;				// first node of spatial subdivision
+	int						numIndexedPolygons;	// number of polygons with an index for the trace contexts
+	int						numIndexedBrushes;	// number of brushes with an index for the trace contexts
 	// blocks with allocated memory
 	cm_nodeBlock_t *		nodeBlocks;			// list with blocks of nodes
 	cm_polygonRefBlock_t *	polygonRefBlocks;	// list with blocks of polygon references
@@ -238,6 +249,23 @@ typedef struct cm_trmPolygon_s {
 	idBounds rotationBounds;						// rotation bounds for this polygon
 } cm_trmPolygon_t;
 
+typedef struct cm_primitiveState_s {
+	int checkcount;									// for multi-check avoidance
+	unsigned long side;								// sidedness bits of a model vertex or edge
+	unsigned long sideSet;							// each bit tells if the sidedness has been calculated yet
+} cm_primitiveState_t;
+
+typedef struct cm_modelState_s {
+	int maxVertices;								// size of vertex state array
+	int maxEdges;									// size of edge state array
+	int maxPolygons;								// size of polygon check count array
+	int maxBrushes;									// size of brush check count array
+	cm_primitiveState_t *vertices;					// trace state for the model vertices
+	cm_primitiveState_t *edges;						// trace state for the model edges
+	int *polygons;									// check counts for the model polygons
+	int *brushes;									// check counts for the model brushes
+} cm_modelState_t;
+
 typedef struct cm_traceWork_s {
 	int numVerts;
 	cm_trmVertex_t vertices[MAX_TRACEMODEL_VERTS];	// trm vertices
@@ -246,6 +274,8 @@ typedef struct cm_traceWork_s {
 	int numPolys;
 	cm_trmPolygon_t polys[MAX_TRACEMODEL_POLYS];	// trm polygons
 	cm_model_t *model;								// model colliding with
+	cm_modelState_t *state;							// trace context state for the model colliding with
+	int checkCount;									// trace context check count for this trace
 	idVec3 start;									// start of trace
 	idVec3 end;										// end of trace
 	idVec3 dir;										// trace direction
@@ -262,6 +292,7 @@ typedef struct cm_traceWork_s {
 	bool axisIntersectsTrm;							// true if the rotation axis intersects the trace model
 	bool getContacts;								// true if retrieving contacts
 	bool quickExit;									// set to quickly stop the collision detection calculations
+	bool simdPlueckers;								// test the polygon edge Plueckers four at a time
 
 	idVec3 origin;									// origin of rotation in model space
 	idVec3 axis;									// rotation axis in model space
@@ -280,10 +311,96 @@ typedef struct cm_traceWork_s {
 	idPlane heartPlane2;
 	float maxDistFromHeartPlane2;
 	idPluecker polygonEdgePlueckerCache[CM_MAX_POLYGON_EDGES];
-	idPluecker polygonVertexPlueckerCache[CM_MAX_POLYGON_EDGES];
-	idVec3 polygonRotationOriginCache[CM_MAX_POLYGON_EDGES];
+	idPluecker polygonVertexPlueckerCache[CM_MAX_POLYGON_EDGES+1];
+	idVec3 polygonRotationOriginCache[CM_MAX_POLYGON_EDGES+1];
+													// the same Plueckers as structure of arrays for SIMD
+	ALIGN16( float polygonEdgePlueckerSoA[6][CM_PLUECKER_SOA_SIZE] );
+	ALIGN16( float polygonVertexPlueckerSoA[6][CM_PLUECKER_SOA_SIZE] );
 } cm_traceWork_t;
 
+/*
+================
+CM_VertexState, CM_EdgeState, CM_PolygonCheckcount, CM_BrushCheckcount
+
+  the state that changes while tracing is kept in the trace context instead of
+  the shared model data so traces can run concurrently on different threads
+================
+*/
+ID_INLINE cm_primitiveState_t *CM_VertexState( const cm_traceWork_t *tw, const cm_vertex_t *v ) {
+	return tw->state->vertices + ( v - tw->model->vertices );
+}
+
+ID_INLINE cm_primitiveState_t *CM_EdgeState( const cm_traceWork_t *tw, const cm_edge_t *e ) {
+	return tw->state->edges + ( e - tw->model->edges );
+}
+
+ID_INLINE int &CM_PolygonCheckcount( const cm_traceWork_t *tw, const cm_polygon_t *p ) {
+	return tw->state->polygons[p->index];
+}
+
+ID_INLINE int &CM_BrushCheckcount( const cm_traceWork_t *tw, const cm_brush_t *b ) {
+	return tw->state->brushes[b->index];
+}
+
+/*
+================
+CM_PlueckersToSoA, CM_PermutedInnerProducts, CM_PermutedInnerProductsReversed
+
+  SIMD polygon edge tests, the products are calculated in the same order as
+  idPluecker::PermutedInnerProduct so the results are bit identical to the scalar tests
+================
+*/
+void CM_PlueckersToSoA( float soa[6][CM_PLUECKER_SOA_SIZE], const idPluecker *plueckers, const int num );
+// products[i] = soa[i].PermutedInnerProduct( pl )
+void CM_PermutedInnerProducts( const float soa[6][CM_PLUECKER_SOA_SIZE], const int num, const idPluecker &pl, float *products );
+// products[i] = pl.PermutedInnerProduct( soa[i] )
+void CM_PermutedInnerProductsReversed( const float soa[6][CM_PLUECKER_SOA_SIZE], const int num, const idPluecker &pl, float *products );
+
+/*
+===============================================================================
+
+Trace contexts
+
+===============================================================================
+*/
+
+typedef struct cm_traceContext_s {
+	int						checkCount;			// for multi-check avoidance
+	idList<cm_modelState_t>	modelStates;		// trace state per model handle
+	cm_modelState_t			trmModelState;		// trace state for the trm model
+					// model, polygons and brush for trm model
+	cm_model_t *			trmModel;
+	cm_polygonRef_t *		trmPolygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t *			trmBrushes[1];
+					// for retrieving contact points
+	bool					getContacts;
+	contactInfo_t *			contacts;
+	int						maxContacts;
+	int						numContacts;
+					// trace work used by Translation and Rotation180
+	ALIGN16( cm_traceWork_t	translationWork );
+	ALIGN16( cm_traceWork_t	rotationWork );
+} cm_traceContext_t;
+
+typedef struct cm_recordedTrace_s {
+	bool					isRotation;			// true for a Rotation, false for a Translation
+	idVec3					start;
+	idVec3					end;				// end of a Translation
+	idRotation				rotation;			// rotation of a Rotation
+	int						trmNum;				// index into the recorded trace models, -1 for a point trace
+	idMat3					trmAxis;
+	int						contentMask;
+	cmHandle_t				model;
+	idVec3					modelOrigin;
+	idMat3					modelAxis;
+} cm_recordedTrace_t;
+
+typedef struct cm_traceBatch_s {
+	cmTraceQuery_t *		queries;			// queries traced by this job
+	int						numQueries;
+	bool					contents;			// get the contents instead of translating
+} cm_traceBatch_t;
+
 /*
 ===============================================================================
 
@@ -341,8 +458,16 @@ public:
 	int				Contacts( contactInfo_t *contacts, const int maxContacts, const idVec3 &start, const idVec6 &dir, const float depth,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
+	// translates a batch of trms on the job threads
+	void			TranslationBatch( cmTraceQuery_t *queries, int numQueries );
+	// gets the contents of a batch of trms on the job threads
+	void			ContentsBatch( cmTraceQuery_t *queries, int numQueries );
+	// runs the queries of a single batch job
+	void			RunTraceBatch( cm_traceBatch_t *batch );
 	// test collision detection
 	void			DebugOutput( const idVec3 &origin );
+	// replay the traces recorded with cm_recordTraces
+	void			TestRecordedTraces();
 	// draw a model
 	void			DrawModel( cmHandle_t model, const idVec3 &origin, const idMat3 &axis,
 											const idVec3 &viewOrigin, const float radius );
@@ -362,6 +487,9 @@ private:			// CollisionMap_translate.cpp
 	bool			TranslateTrmThroughPolygon( cm_traceWork_t *tw, cm_polygon_t *p );
 	void			SetupTranslationHeartPlanes( cm_traceWork_t *tw );
 	void			SetupTrm( cm_traceWork_t *tw, const idTraceModel *trm );
+	void			Translation( cm_traceContext_t *context, trace_t *results, const idVec3 &start, const idVec3 &end,
+								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 
 private:			// CollisionMap_rotate.cpp
 	int				CollisionBetweenEdgeBounds( cm_traceWork_t *tw, const idVec3 &va, const idVec3 &vb,
@@ -386,18 +514,24 @@ private:			// CollisionMap_rotate.cpp
 											cm_vertex_t *v, idVec3 &rotationOrigin );
 	bool			RotateTrmThroughPolygon( cm_traceWork_t *tw, cm_polygon_t *p );
 	void			BoundsForRotation( const idVec3 &origin, const idVec3 &axis, const idVec3 &start, const idVec3 &end, idBounds &bounds );
-	void			Rotation180( trace_t *results, const idVec3 &rorg, const idVec3 &axis,
+	void			Rotation180( cm_traceContext_t *context, trace_t *results, const idVec3 &rorg, const idVec3 &axis,
 									const float startAngle, const float endAngle, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis );
+	void			Rotation( cm_traceContext_t *context, trace_t *results, const idVec3 &start, const idRotation &rotation,
+								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 
 private:			// CollisionMap_contents.cpp
 	bool			TestTrmVertsInBrush( cm_traceWork_t *tw, cm_brush_t *b );
 	bool			TestTrmInPolygon( cm_traceWork_t *tw, cm_polygon_t *p );
 	cm_node_t *		PointNode( const idVec3 &p, cm_model_t *model );
-	int				PointContents( const idVec3 p, cmHandle_t model );
-	int				TransformedPointContents( const idVec3 &p, cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis );
-	int				ContentsTrm( trace_t *results, const idVec3 &start,
+	int				PointContents( cm_traceContext_t *context, const idVec3 p, cmHandle_t model );
+	int				TransformedPointContents( cm_traceContext_t *context, const idVec3 &p, cmHandle_t model, const idVec3 &origin, const idMat3 &modelAxis );
+	int				ContentsTrm( cm_traceContext_t *context, trace_t *results, const idVec3 &start,
+									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
+	int				Contents( cm_traceContext_t *context, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 
@@ -406,10 +540,21 @@ private:			// CollisionMap_trace.cpp
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
 	void			TraceThroughModel( cm_traceWork_t *tw );
 	void			RecurseProcBSP_r( trace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 );
+	void			RunBatch( cmTraceQuery_t *queries, int numQueries, bool contents );
+	void			TestTraceBatch( const cmTraceQuery_t *queries, int numQueries, bool contents );
 
 private:			// CollisionMap_load.cpp
 	void			Clear();
-	void			FreeTrmModelStructure();
+	void			FreeTrmModelStructure( cm_traceContext_t *context );
+					// trace contexts
+	cm_traceContext_t *AllocTraceContext();
+	void			FreeTraceContext( cm_traceContext_t *context );
+	void			FreeTraceContexts();
+	cm_traceContext_t *AcquireTraceContext();
+	void			ReleaseTraceContext( cm_traceContext_t *context );
+	cm_model_t *	GetTraceModel( cm_traceContext_t *context, cmHandle_t model );
+	void			SetupTraceState( cm_traceContext_t *context, cm_traceWork_t *tw, cmHandle_t model );
+	void			IndexModelPrimitives( cm_model_t *model );
 					// model deallocation
 	void			RemovePolygonReferences_r( cm_node_t *node, cm_polygon_t *p );
 	void			RemoveBrushReferences_r( cm_node_t *node, cm_brush_t *b );
@@ -449,7 +594,8 @@ private:			// CollisionMap_load.cpp
 	cm_brush_t *	AllocBrush( cm_model_t *model, int numPlanes );
 	void			AddPolygonToNode( cm_model_t *model, cm_node_t *node, cm_polygon_t *p );
 	void			AddBrushToNode( cm_model_t *model, cm_node_t *node, cm_brush_t *b );
-	void			SetupTrmModelStructure();
+	void			SetupTrmModelStructure( cm_traceContext_t *context );
+	cmHandle_t		SetupTrmModel( cm_traceContext_t *context, const idTraceModel &trm, const idMaterial *material );
 	void			R_FilterPolygonIntoTree( cm_model_t *model, cm_node_t *node, cm_polygonRef_t *pref, cm_polygon_t *p );
 	void			R_FilterBrushIntoTree( cm_model_t *model, cm_node_t *node, cm_brushRef_t *pref, cm_brush_t *b );
 	cm_node_t *		R_CreateAxialBSPTree( cm_model_t *model, cm_node_t *node, const idBounds &bounds );
@@ -510,6 +656,8 @@ private:			// CollisionMap_debug
 								const idVec3 &viewOrigin );
 	void			DrawNodePolygons( cm_model_t *model, cm_node_t *node, const idVec3 &origin, const idMat3 &axis,
 								const idVec3 &viewOrigin, const float radius );
+	void			RecordTrace( cm_recordedTrace_t &trace, const idTraceModel *trm );
+	void			FreeRecordedTraces();
 
 private:			// collision map data
 	idStr			mapName;
@@ -521,19 +669,25 @@ private:			// collision map data
 	int				maxModels;
 	int				numModels;
 	cm_model_t **	models;
-					// polygons and brush for trm model
-	cm_polygonRef_t*trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t *	trmBrushes[1];
+					// material for trm model polygons
 	const idMaterial *trmMaterial;
 					// for data pruning
 	int				numProcNodes;
 	cm_procNode_t *	procNodes;
-					// for retrieving contact points
-	bool			getContacts;
-	contactInfo_t *	contacts;
-	int				maxContacts;
-	int				numContacts;
+					// reentrant trace state, the public trace functions use context 0 and the batch jobs claim
+					// one of the others, the trm model of context 0 is stored in the last model slot
+	cm_traceContext_t *traceContexts[MAX_TRACE_CONTEXTS];
+	interlockedInt_t traceContextUsed[MAX_TRACE_CONTEXTS];
+	idParallelJobList *traceBatchJobs;
+	idList<cm_traceBatch_t> traceBatches;
+					// traces recorded with cm_recordTraces
+	idList<cm_recordedTrace_t> recordedTraces;
+	idList<idTraceModel *> recordedTrms;
 };
 
+extern idCollisionModelManagerLocal	collisionModelManagerLocal;
+
 // for debugging
 extern idCVar cm_debugCollision;
+extern idCVar cm_simdPlueckers;
+extern idCVar cm_recordTraces;
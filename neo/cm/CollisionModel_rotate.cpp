@@ -485,6 +485,7 @@ void idCollisionModelManagerLocal::RotateTrmEdgeThroughPolygon( cm_traceWork_t *
 	idVec3 collisionPoint, collisionNormal, origin, epsDir;
 	idPluecker epsPl;
 	idBounds bounds;
+	ALIGN16( float edgeProducts[CM_PLUECKER_SOA_SIZE] );
 
 	// if the trm is convex and the rotation axis intersects the trm
 	if ( tw->isConvex && tw->axisIntersectsTrm ) {
@@ -504,13 +505,18 @@ void idCollisionModelManagerLocal::RotateTrmEdgeThroughPolygon( cm_traceWork_t *
 		return;
 	}
 
+	if ( tw->simdPlueckers ) {
+		// test the trm edge against four polygon edges at once
+		CM_PermutedInnerProductsReversed( tw->polygonEdgePlueckerSoA, poly->numEdges, trmEdge->pl, edgeProducts );
+	}
+
 	// check edges for a collision
 	for ( i = 0; i < poly->numEdges; i++ ) {
 		edgeNum = poly->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
 
 		// if this edge is already checked
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		if ( CM_EdgeState( tw, edge )->checkcount == tw->checkCount ) {
 			continue;
 		}
 
@@ -539,7 +545,11 @@ void idCollisionModelManagerLocal::RotateTrmEdgeThroughPolygon( cm_traceWork_t *
 			continue;
 		}
 
-		f1 = trmEdge->pl.PermutedInnerProduct( tw->polygonEdgePlueckerCache[i] );
+		if ( tw->simdPlueckers ) {
+			f1 = edgeProducts[i];
+		} else {
+			f1 = trmEdge->pl.PermutedInnerProduct( tw->polygonEdgePlueckerCache[i] );
+		}
 
 		// pluecker coordinate for epsilon expanded edge
 		epsDir = edge->normal * (CM_CLIP_EPSILON+CM_PL_RANGE_EPSILON);
@@ -928,6 +938,7 @@ void idCollisionModelManagerLocal::RotateTrmVertexThroughPolygon( cm_traceWork_t
 	float tanHalfAngle;
 	idVec3 endDir, collisionPoint;
 	idPluecker pl;
+	ALIGN16( float edgeProducts[CM_PLUECKER_SOA_SIZE] );
 
 	// if the trm vertex is behind the polygon plane it cannot collide with the polygon within a 180 degrees rotation
 	if ( tw->isConvex && tw->axisIntersectsTrm && v->polygonSide ) {
@@ -953,15 +964,33 @@ void idCollisionModelManagerLocal::RotateTrmVertexThroughPolygon( cm_traceWork_t
 	if ( idMath::Fabs( tanHalfAngle ) < tw->maxTan ) {
 		// verify if 'collisionPoint' moving along 'endDir' moves between polygon edges
 		pl.FromRay( collisionPoint, endDir );
-		for ( i = 0; i < poly->numEdges; i++ ) {
-			if ( poly->edges[i] < 0 ) {
-				if ( pl.PermutedInnerProduct( tw->polygonEdgePlueckerCache[i] ) > 0.0f ) {
-					return;
+		if ( tw->simdPlueckers ) {
+			// test against four polygon edges at once
+			CM_PermutedInnerProductsReversed( tw->polygonEdgePlueckerSoA, poly->numEdges, pl, edgeProducts );
+			for ( i = 0; i < poly->numEdges; i++ ) {
+				if ( poly->edges[i] < 0 ) {
+					if ( edgeProducts[i] > 0.0f ) {
+						return;
+					}
+				}
+				else {
+					if ( edgeProducts[i] < 0.0f ) {
+						return;
+					}
 				}
 			}
-			else {
-				if ( pl.PermutedInnerProduct( tw->polygonEdgePlueckerCache[i] ) < 0.0f ) {
-					return;
+		}
+		else {
+			for ( i = 0; i < poly->numEdges; i++ ) {
+				if ( poly->edges[i] < 0 ) {
+					if ( pl.PermutedInnerProduct( tw->polygonEdgePlueckerCache[i] ) > 0.0f ) {
+						return;
+					}
+				}
+				else {
+					if ( pl.PermutedInnerProduct( tw->polygonEdgePlueckerCache[i] ) < 0.0f ) {
+						return;
+					}
 				}
 			}
 		}
@@ -1064,10 +1093,10 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 	idVec3 *rotationOrigin;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( CM_PolygonCheckcount( tw, p ) == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	CM_PolygonCheckcount( tw, p ) = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -1137,6 +1166,10 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 	// copy first to last so we can easily cycle through
 	tw->polygonRotationOriginCache[p->numEdges] = tw->polygonRotationOriginCache[0];
 
+	if ( tw->simdPlueckers ) {
+		CM_PlueckersToSoA( tw->polygonEdgePlueckerSoA, tw->polygonEdgePlueckerCache, p->numEdges );
+	}
+
 	// fast point rotation
 	if ( tw->pointTrace ) {
 		RotateTrmVertexThroughPolygon( tw, p, &tw->vertices[0], 0 );
@@ -1163,11 +1196,11 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
 
-			if ( e->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( CM_EdgeState( tw, e )->checkcount == tw->checkCount ) {
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			CM_EdgeState( tw, e )->checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if ( e->internal ) {
 				continue;
@@ -1178,11 +1211,11 @@ bool idCollisionModelManagerLocal::RotateTrmThroughPolygon( cm_traceWork_t *tw,
 				v = tw->model->vertices + e->vertexNum[k ^ INT32_SIGNBITSET( edgeNum )];
 
 				// if this vertex is already checked
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( CM_VertexState( tw, v )->checkcount == tw->checkCount ) {
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				CM_VertexState( tw, v )->checkcount = tw->checkCount;
 
 				// if the vertex is outside the trm rotation bounds
 				if ( !tw->bounds.ContainsPoint( v->p ) ) {
@@ -1251,7 +1284,7 @@ void idCollisionModelManagerLocal::BoundsForRotation( const idVec3 &origin, cons
 idCollisionModelManagerLocal::Rotation180
 ================
 */
-void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &rorg, const idVec3 &axis,
+void idCollisionModelManagerLocal::Rotation180( cm_traceContext_t *context, trace_t *results, const idVec3 &rorg, const idVec3 &axis,
 										const float startAngle, const float endAngle, const idVec3 &start,
 										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
@@ -1265,19 +1298,18 @@ void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &
 	cm_trmPolygon_t *poly;
 	cm_trmEdge_t *edge;
 	cm_trmVertex_t *vert;
-	ALIGN16( static cm_traceWork_t tw );
+	cm_traceWork_t &tw = context->rotationWork;
 
 	if ( model < 0 || model > MAX_SUBMODELS || model > idCollisionModelManagerLocal::maxModels ) {
 		idLib::Printf("idCollisionModelManagerLocal::Rotation180: invalid model handle\n");
 		return;
 	}
-	if ( !idCollisionModelManagerLocal::models[model] ) {
+	if ( !idCollisionModelManagerLocal::GetTraceModel( context, model ) ) {
 		idLib::Printf("idCollisionModelManagerLocal::Rotation180: invalid model\n");
 		return;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
-
+	tw.simdPlueckers = cm_simdPlueckers.GetBool();
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
 	tw.trace.c.type = CONTACT_NONE;
@@ -1290,7 +1322,8 @@ void idCollisionModelManagerLocal::Rotation180( trace_t *results, const idVec3 &
 	tw.angle = endAngle - startAngle;
 	assert( tw.angle > -180.0f && tw.angle < 180.0f );
 	tw.maxTan = initialTan = idMath::Fabs( tan( ( idMath::PI / 360.0f ) * tw.angle ) );
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::GetTraceModel( context, model );
+	idCollisionModelManagerLocal::SetupTraceState( context, &tw, model );
 	tw.start = start - modelOrigin;
 	// rotation axis, axis is assumed to be normalized
 	tw.axis = axis;
@@ -1616,7 +1649,7 @@ idCollisionModelManagerLocal::Rotation
 static int entered = 0;
 #endif
 
-void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &start, const idRotation &rotation,
+void idCollisionModelManagerLocal::Rotation( cm_traceContext_t *context, trace_t *results, const idVec3 &start, const idRotation &rotation,
 										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
 	idVec3 tmp;
@@ -1627,9 +1660,22 @@ void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &sta
 
 	memset( results, 0, sizeof( *results ) );
 
+	if ( cm_recordTraces.GetBool() && model != TRACE_MODEL_HANDLE && idLib::IsMainThread() ) {
+		cm_recordedTrace_t rec;
+		rec.isRotation = true;
+		rec.start = start;
+		rec.rotation = rotation;
+		rec.trmAxis = trmAxis;
+		rec.contentMask = contentMask;
+		rec.model = model;
+		rec.modelOrigin = modelOrigin;
+		rec.modelAxis = modelAxis;
+		idCollisionModelManagerLocal::RecordTrace( rec, trm );
+	}
+
 	// if special position test
 	if ( rotation.GetAngle() == 0.0f ) {
-		idCollisionModelManagerLocal::ContentsTrm( results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+		idCollisionModelManagerLocal::ContentsTrm( context, results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 		return;
 	}
 
@@ -1640,7 +1686,7 @@ void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &sta
 		if ( !entered ) {
 			entered = 1;
 			// if already messed up to begin with
-			if ( idCollisionModelManagerLocal::Contents( start, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
+			if ( idCollisionModelManagerLocal::Contents( context, start, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
 				startsolid = true;
 			}
 			entered = 0;
@@ -1661,7 +1707,7 @@ void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &sta
 		}
 		for ( lasta = 0.0f, a = stepa; fabs( a ) < fabs( maxa ) + 1.0f; lasta = a, a += stepa ) {
 			// partial rotation
-			idCollisionModelManagerLocal::Rotation180( results, rotation.GetOrigin(), rotation.GetVec(), lasta, a, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+			idCollisionModelManagerLocal::Rotation180( context, results, rotation.GetOrigin(), rotation.GetVec(), lasta, a, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 			// if there is a collision
 			if ( results->fraction < 1.0f ) {
 				// fraction of total rotation
@@ -1673,7 +1719,7 @@ void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &sta
 		return;
 	}
 
-	idCollisionModelManagerLocal::Rotation180( results, rotation.GetOrigin(), rotation.GetVec(), 0.0f, rotation.GetAngle(), start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+	idCollisionModelManagerLocal::Rotation180( context, results, rotation.GetOrigin(), rotation.GetVec(), 0.0f, rotation.GetAngle(), start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 
 #ifdef _DEBUG
 	// test for missed collisions
@@ -1681,16 +1727,27 @@ void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &sta
 		if ( !entered ) {
 			entered = 1;
 			// if the trm is stuck in the model
-			if ( idCollisionModelManagerLocal::Contents( results->endpos, trm, results->endAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
+			if ( idCollisionModelManagerLocal::Contents( context, results->endpos, trm, results->endAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
 				trace_t tr;
 
 				// test where the trm is stuck in the model
-				idCollisionModelManagerLocal::Contents( results->endpos, trm, results->endAxis, -1, model, modelOrigin, modelAxis );
+				idCollisionModelManagerLocal::Contents( context, results->endpos, trm, results->endAxis, -1, model, modelOrigin, modelAxis );
 				// re-run collision detection to find out where it failed
-				idCollisionModelManagerLocal::Rotation( &tr, start, rotation, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+				idCollisionModelManagerLocal::Rotation( context, &tr, start, rotation, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 			}
 			entered = 0;
 		}
 	}
 #endif
 }
+
+/*
+================
+idCollisionModelManagerLocal::Rotation
+================
+*/
+void idCollisionModelManagerLocal::Rotation( trace_t *results, const idVec3 &start, const idRotation &rotation,
+										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+	idCollisionModelManagerLocal::Rotation( traceContexts[0], results, start, rotation, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+}
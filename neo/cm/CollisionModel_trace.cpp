@@ -255,3 +255,163 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, tw->end );
 	}
 }
+
+/*
+===============================================================================
+
+Batched traces
+
+===============================================================================
+*/
+
+idCVar cm_testTraceBatch( "cm_testTraceBatch", "0", CVAR_GAME | CVAR_BOOL, "trace every TranslationBatch and ContentsBatch query again on the calling thread and report results that differ" );
+
+/*
+================
+CM_TraceBatchJob
+================
+*/
+static void CM_TraceBatchJob( cm_traceBatch_t *batch ) {
+	collisionModelManagerLocal.RunTraceBatch( batch );
+}
+
+REGISTER_PARALLEL_JOB( CM_TraceBatchJob, "CM_TraceBatchJob" );
+
+/*
+================
+idCollisionModelManagerLocal::RunTraceBatch
+
+  every query runs through the regular serial code path on a trace context
+  owned by the job, so the results are identical to tracing one at a time
+================
+*/
+void idCollisionModelManagerLocal::RunTraceBatch( cm_traceBatch_t *batch ) {
+	cm_traceContext_t *context = AcquireTraceContext();
+
+	for ( int i = 0; i < batch->numQueries; i++ ) {
+		cmTraceQuery_t &query = batch->queries[i];
+
+		cmHandle_t model = query.model;
+		if ( query.targetTrm != NULL ) {
+			model = SetupTrmModel( context, *query.targetTrm, query.targetMaterial );
+		}
+		if ( batch->contents ) {
+			query.contents = Contents( context, query.start, query.trm, query.trmAxis, query.contentMask, model, query.modelOrigin, query.modelAxis );
+		} else {
+			Translation( context, &query.results, query.start, query.end, query.trm, query.trmAxis, query.contentMask, model, query.modelOrigin, query.modelAxis );
+		}
+	}
+
+	ReleaseTraceContext( context );
+}
+
+/*
+================
+idCollisionModelManagerLocal::TestTraceBatch
+
+  traces the queries again with the regular trace functions and reports the
+  ones where the batch gave a different result
+================
+*/
+void idCollisionModelManagerLocal::TestTraceBatch( const cmTraceQuery_t *queries, int numQueries, bool contents ) {
+	trace_t results;
+	int numDifferent = 0;
+
+	for ( int i = 0; i < numQueries; i++ ) {
+		const cmTraceQuery_t &query = queries[i];
+
+		cmHandle_t model = query.model;
+		if ( query.targetTrm != NULL ) {
+			model = SetupTrmModel( *query.targetTrm, query.targetMaterial );
+		}
+
+		if ( contents ) {
+			const int serialContents = Contents( query.start, query.trm, query.trmAxis, query.contentMask, model, query.modelOrigin, query.modelAxis );
+			if ( serialContents != query.contents ) {
+				if ( numDifferent == 0 ) {
+					common->Warning( "cm_testTraceBatch: contents query %d at (%s) gave 0x%x in the batch and 0x%x serially",
+										i, query.start.ToString(), query.contents, serialContents );
+				}
+				numDifferent++;
+			}
+			continue;
+		}
+
+		Translation( &results, query.start, query.end, query.trm, query.trmAxis, query.contentMask, model, query.modelOrigin, query.modelAxis );
+
+		// Translation clears the results first so the padding compares equal as well
+		if ( memcmp( &results, &query.results, sizeof( results ) ) != 0 ) {
+			if ( numDifferent == 0 ) {
+				common->Warning( "cm_testTraceBatch: query %d from (%s) to (%s) gave fraction %f in the batch and %f serially",
+									i, query.start.ToString(), query.end.ToString(), query.results.fraction, results.fraction );
+			}
+			numDifferent++;
+		}
+	}
+
+	if ( numDifferent > 0 ) {
+		common->Warning( "cm_testTraceBatch: %d of %d batched %s queries differ from the serial ones", numDifferent, numQueries, contents ? "contents" : "translation" );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::RunBatch
+================
+*/
+void idCollisionModelManagerLocal::RunBatch( cmTraceQuery_t *queries, int numQueries, bool contents ) {
+	if ( numQueries <= 0 ) {
+		return;
+	}
+
+	// the batch and job lists are shared, batches are only started by the thread running the game,
+	// which is also the only thread using trace context 0
+	int numJobs = ( numQueries + TRACE_BATCH_JOB_QUERIES - 1 ) / TRACE_BATCH_JOB_QUERIES;
+	if ( numJobs > MAX_TRACE_BATCH_JOBS ) {
+		numJobs = MAX_TRACE_BATCH_JOBS;
+	}
+	const int queriesPerJob = ( numQueries + numJobs - 1 ) / numJobs;
+
+	traceBatches.SetNum( 0 );
+	for ( int first = 0; first < numQueries; first += queriesPerJob ) {
+		cm_traceBatch_t &batch = traceBatches.Alloc();
+		batch.queries = queries + first;
+		batch.numQueries = Min( queriesPerJob, numQueries - first );
+		batch.contents = contents;
+	}
+
+	// not worth the job overhead
+	if ( traceBatches.Num() == 1 || traceBatchJobs == NULL ) {
+		for ( int i = 0; i < traceBatches.Num(); i++ ) {
+			RunTraceBatch( &traceBatches[i] );
+		}
+	} else {
+		for ( int i = 0; i < traceBatches.Num(); i++ ) {
+			traceBatchJobs->AddJob( (jobRun_t)CM_TraceBatchJob, &traceBatches[i] );
+		}
+		traceBatchJobs->Submit();
+		traceBatchJobs->Wait();
+	}
+
+	if ( cm_testTraceBatch.GetBool() ) {
+		TestTraceBatch( queries, numQueries, contents );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TranslationBatch
+================
+*/
+void idCollisionModelManagerLocal::TranslationBatch( cmTraceQuery_t *queries, int numQueries ) {
+	RunBatch( queries, numQueries, false );
+}
+
+/*
+================
+idCollisionModelManagerLocal::ContentsBatch
+================
+*/
+void idCollisionModelManagerLocal::ContentsBatch( cmTraceQuery_t *queries, int numQueries ) {
+	RunBatch( queries, numQueries, true );
+}
@@ -202,7 +202,7 @@ CM_SetVertexSidedness
   stores for the given model vertex at which side of one of the trm edges it passes
 ================
 */
-ID_INLINE void CM_SetVertexSidedness( cm_vertex_t *v, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
+ID_INLINE void CM_SetVertexSidedness( cm_primitiveState_t *v, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
 	const int mask = 1 << bitNum;
 	if ( ( v->sideSet & mask ) == 0 ) {
 		const float fl = vpl.PermutedInnerProduct( epl );
@@ -218,7 +218,7 @@ CM_SetEdgeSidedness
   stores for the given model edge at which side one of the trm vertices
 ================
 */
-ID_INLINE void CM_SetEdgeSidedness( cm_edge_t *edge, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
+ID_INLINE void CM_SetEdgeSidedness( cm_primitiveState_t *edge, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
 	const int mask = 1 << bitNum;
 	if ( ( edge->sideSet & mask ) == 0 ) {
 		const float fl = vpl.PermutedInnerProduct( epl );
@@ -227,6 +227,119 @@ ID_INLINE void CM_SetEdgeSidedness( cm_edge_t *edge, const idPluecker &vpl, cons
 	}
 }
 
+/*
+================
+CM_SetSidedness
+
+  same as CM_SetVertexSidedness and CM_SetEdgeSidedness with a precalculated permuted inner product
+================
+*/
+ID_INLINE void CM_SetSidedness( cm_primitiveState_t *state, const float fl, const int bitNum ) {
+	const int mask = 1 << bitNum;
+	if ( ( state->sideSet & mask ) == 0 ) {
+		state->side = ( state->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );
+		state->sideSet |= mask;
+	}
+}
+
+/*
+================
+CM_PlueckersToSoA
+================
+*/
+void CM_PlueckersToSoA( float soa[6][CM_PLUECKER_SOA_SIZE], const idPluecker *plueckers, const int num ) {
+	int i, j;
+
+	for ( i = 0; i < num; i++ ) {
+		const float *p = plueckers[i].ToFloatPtr();
+		for ( j = 0; j < 6; j++ ) {
+			soa[j][i] = p[j];
+		}
+	}
+	// clear the padding so the SIMD loops never touch denormals or NaNs
+	for ( ; i & 3; i++ ) {
+		for ( j = 0; j < 6; j++ ) {
+			soa[j][i] = 0.0f;
+		}
+	}
+}
+
+/*
+================
+CM_PermutedInnerProducts_Generic
+
+  products[i] = sum over k of soa[rows[k]][i] * pl[coefs[k]]
+  the terms are added in order so the rounding matches idPluecker::PermutedInnerProduct
+================
+*/
+static void CM_PermutedInnerProducts_Generic( const float soa[6][CM_PLUECKER_SOA_SIZE], const int num, const float *pl,
+												const int rows[6], const int coefs[6], float *products ) {
+	const float *r0 = soa[rows[0]];
+	const float *r1 = soa[rows[1]];
+	const float *r2 = soa[rows[2]];
+	const float *r3 = soa[rows[3]];
+	const float *r4 = soa[rows[4]];
+	const float *r5 = soa[rows[5]];
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 c0 = _mm_load1_ps( pl + coefs[0] );
+	const __m128 c1 = _mm_load1_ps( pl + coefs[1] );
+	const __m128 c2 = _mm_load1_ps( pl + coefs[2] );
+	const __m128 c3 = _mm_load1_ps( pl + coefs[3] );
+	const __m128 c4 = _mm_load1_ps( pl + coefs[4] );
+	const __m128 c5 = _mm_load1_ps( pl + coefs[5] );
+
+	for ( int i = 0; i < num; i += 4 ) {
+		__m128 s = _mm_mul_ps( _mm_load_ps( r0 + i ), c0 );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_load_ps( r1 + i ), c1 ) );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_load_ps( r2 + i ), c2 ) );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_load_ps( r3 + i ), c3 ) );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_load_ps( r4 + i ), c4 ) );
+		s = _mm_add_ps( s, _mm_mul_ps( _mm_load_ps( r5 + i ), c5 ) );
+		_mm_store_ps( products + i, s );
+	}
+
+#else
+
+	const float c0 = pl[coefs[0]];
+	const float c1 = pl[coefs[1]];
+	const float c2 = pl[coefs[2]];
+	const float c3 = pl[coefs[3]];
+	const float c4 = pl[coefs[4]];
+	const float c5 = pl[coefs[5]];
+
+	for ( int i = 0; i < num; i++ ) {
+		products[i] = r0[i] * c0 + r1[i] * c1 + r2[i] * c2 + r3[i] * c3 + r4[i] * c4 + r5[i] * c5;
+	}
+
+#endif
+}
+
+// the order of the terms in idPluecker::PermutedInnerProduct: p[0] * a.p[4] + p[1] * a.p[5] + p[2] * a.p[3] + p[4] * a.p[0] + p[5] * a.p[1] + p[3] * a.p[2]
+static const int cm_permutedThis[6] = { 0, 1, 2, 4, 5, 3 };
+static const int cm_permutedOther[6] = { 4, 5, 3, 0, 1, 2 };
+
+/*
+================
+CM_PermutedInnerProducts
+
+  products must be 16 byte aligned with room for num rounded up to a multiple of four
+================
+*/
+void CM_PermutedInnerProducts( const float soa[6][CM_PLUECKER_SOA_SIZE], const int num, const idPluecker &pl, float *products ) {
+	CM_PermutedInnerProducts_Generic( soa, num, pl.ToFloatPtr(), cm_permutedThis, cm_permutedOther, products );
+}
+
+/*
+================
+CM_PermutedInnerProductsReversed
+================
+*/
+void CM_PermutedInnerProductsReversed( const float soa[6][CM_PLUECKER_SOA_SIZE], const int num, const idPluecker &pl, float *products ) {
+	CM_PermutedInnerProducts_Generic( soa, num, pl.ToFloatPtr(), cm_permutedOther, cm_permutedThis, products );
+}
+
 /*
 ================
 idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon
@@ -237,15 +350,25 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 	float f1, f2, dist, d1, d2;
 	idVec3 start, end, normal;
 	cm_edge_t *edge;
-	cm_vertex_t *v1, *v2;
+	cm_primitiveState_t *edgeState, *v1, *v2;
 	idPluecker *pl, epsPl;
+	ALIGN16( float edgeProducts[2][CM_PLUECKER_SOA_SIZE] );
+	ALIGN16( float vertexProducts[CM_PLUECKER_SOA_SIZE] );
+
+	if ( tw->simdPlueckers ) {
+		// test the trm edge against four polygon edges at once
+		CM_PermutedInnerProducts( tw->polygonEdgePlueckerSoA, poly->numEdges, tw->vertices[trmEdge->vertexNum[0]].pl, edgeProducts[0] );
+		CM_PermutedInnerProducts( tw->polygonEdgePlueckerSoA, poly->numEdges, tw->vertices[trmEdge->vertexNum[1]].pl, edgeProducts[1] );
+		CM_PermutedInnerProducts( tw->polygonVertexPlueckerSoA, poly->numEdges + 1, trmEdge->pl, vertexProducts );
+	}
 
 	// check edges for a collision
 	for ( i = 0; i < poly->numEdges; i++) {
 		edgeNum = poly->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		edgeState = CM_EdgeState( tw, edge );
 		// if this edge is already checked
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		if ( edgeState->checkcount == tw->checkCount ) {
 			continue;
 		}
 		// can never collide with internal edges
@@ -254,17 +377,27 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 		}
 		pl = &tw->polygonEdgePlueckerCache[i];
 		// get the sides at which the trm edge vertices pass the polygon edge
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0] );
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1] );
+		if ( tw->simdPlueckers ) {
+			CM_SetSidedness( edgeState, edgeProducts[0][i], trmEdge->vertexNum[0] );
+			CM_SetSidedness( edgeState, edgeProducts[1][i], trmEdge->vertexNum[1] );
+		} else {
+			CM_SetEdgeSidedness( edgeState, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0] );
+			CM_SetEdgeSidedness( edgeState, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1] );
+		}
 		// if the trm edge start and end vertex do not pass the polygon edge at different sides
-		if ( !(((edge->side >> trmEdge->vertexNum[0]) ^ (edge->side >> trmEdge->vertexNum[1])) & 1) ) {
+		if ( !(((edgeState->side >> trmEdge->vertexNum[0]) ^ (edgeState->side >> trmEdge->vertexNum[1])) & 1) ) {
 			continue;
 		}
 		// get the sides at which the polygon edge vertices pass the trm edge
-		v1 = tw->model->vertices + edge->vertexNum[INT32_SIGNBITSET( edgeNum )];
-		CM_SetVertexSidedness( v1, tw->polygonVertexPlueckerCache[i], trmEdge->pl, trmEdge->bitNum );
-		v2 = tw->model->vertices + edge->vertexNum[INT32_SIGNBITNOTSET( edgeNum )];
-		CM_SetVertexSidedness( v2, tw->polygonVertexPlueckerCache[i+1], trmEdge->pl, trmEdge->bitNum );
+		v1 = tw->state->vertices + edge->vertexNum[INT32_SIGNBITSET( edgeNum )];
+		v2 = tw->state->vertices + edge->vertexNum[INT32_SIGNBITNOTSET( edgeNum )];
+		if ( tw->simdPlueckers ) {
+			CM_SetSidedness( v1, vertexProducts[i], trmEdge->bitNum );
+			CM_SetSidedness( v2, vertexProducts[i+1], trmEdge->bitNum );
+		} else {
+			CM_SetVertexSidedness( v1, tw->polygonVertexPlueckerCache[i], trmEdge->pl, trmEdge->bitNum );
+			CM_SetVertexSidedness( v2, tw->polygonVertexPlueckerCache[i+1], trmEdge->pl, trmEdge->bitNum );
+		}
 		// if the polygon edge start and end vertex do not pass the trm edge at different sides
 		if ( !((v1->side ^ v2->side) & (1<<trmEdge->bitNum)) ) {
 			continue;
@@ -363,17 +496,31 @@ idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon
 void idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon( cm_traceWork_t *tw, cm_polygon_t *poly, cm_trmVertex_t *v, int bitNum ) {
 	int i, edgeNum;
 	float f;
-	cm_edge_t *edge;
+	cm_primitiveState_t *edge;
+	ALIGN16( float edgeProducts[CM_PLUECKER_SOA_SIZE] );
 
 	f = CM_TranslationPlaneFraction( poly->plane, v->p, v->endp );
 	if ( f < tw->trace.fraction ) {
 
-		for ( i = 0; i < poly->numEdges; i++ ) {
-			edgeNum = poly->edges[i];
-			edge = tw->model->edges + abs(edgeNum);
-			CM_SetEdgeSidedness( edge, tw->polygonEdgePlueckerCache[i], v->pl, bitNum );
-			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) ) {
-				return;
+		if ( tw->simdPlueckers ) {
+			// test the trm vertex against four polygon edges at once
+			CM_PermutedInnerProducts( tw->polygonEdgePlueckerSoA, poly->numEdges, v->pl, edgeProducts );
+			for ( i = 0; i < poly->numEdges; i++ ) {
+				edgeNum = poly->edges[i];
+				edge = tw->state->edges + abs(edgeNum);
+				CM_SetSidedness( edge, edgeProducts[i], bitNum );
+				if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) ) {
+					return;
+				}
+			}
+		} else {
+			for ( i = 0; i < poly->numEdges; i++ ) {
+				edgeNum = poly->edges[i];
+				edge = tw->state->edges + abs(edgeNum);
+				CM_SetEdgeSidedness( edge, tw->polygonEdgePlueckerCache[i], v->pl, bitNum );
+				if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) ) {
+					return;
+				}
 			}
 		}
 		if ( f < 0.0f ) {
@@ -407,6 +554,7 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t
 	int i, edgeNum;
 	float f;
 	cm_edge_t *edge;
+	cm_primitiveState_t *edgeState;
 	idPluecker pl;
 
 	f = CM_TranslationPlaneFraction( poly->plane, v->p, v->endp );
@@ -415,17 +563,18 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t
 		for ( i = 0; i < poly->numEdges; i++ ) {
 			edgeNum = poly->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
+			edgeState = CM_EdgeState( tw, edge );
 			// if we didn't yet calculate the sidedness for this edge
-			if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
+			if ( edgeState->checkcount != tw->checkCount ) {
 				float fl;
-				edge->checkcount = idCollisionModelManagerLocal::checkCount;
+				edgeState->checkcount = tw->checkCount;
 				pl.FromLine(tw->model->vertices[edge->vertexNum[0]].p, tw->model->vertices[edge->vertexNum[1]].p);
 				fl = v->pl.PermutedInnerProduct( pl );
-				edge->side = ( fl < 0.0f );
+				edgeState->side = ( fl < 0.0f );
 			}
 			// if the point passes the edge at the wrong side
 			//if ( (edgeNum > 0) == edge->side ) {
-			if ( INT32_SIGNBITSET( edgeNum ) ^ edge->side ) {
+			if ( INT32_SIGNBITSET( edgeNum ) ^ edgeState->side ) {
 				return;
 			}
 		}
@@ -460,16 +609,19 @@ void idCollisionModelManagerLocal::TranslateVertexThroughTrmPolygon( cm_traceWor
 	int i, edgeNum;
 	float f;
 	cm_trmEdge_t *edge;
+	cm_primitiveState_t *vertexState;
 
 	f = CM_TranslationPlaneFraction( trmpoly->plane, v->p, endp );
 	if ( f < tw->trace.fraction ) {
 
+		vertexState = CM_VertexState( tw, v );
+
 		for ( i = 0; i < trmpoly->numEdges; i++ ) {
 			edgeNum = trmpoly->edges[i];
 			edge = tw->edges + abs(edgeNum);
 
-			CM_SetVertexSidedness( v, pl, edge->pl, edge->bitNum );
-			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( v->side >> edge->bitNum ) & 1 ) ) {
+			CM_SetVertexSidedness( vertexState, pl, edge->pl, edge->bitNum );
+			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( vertexState->side >> edge->bitNum ) & 1 ) ) {
 				return;
 			}
 		}
@@ -512,10 +664,10 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 	cm_edge_t *e;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( CM_PolygonCheckcount( tw, p ) == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	CM_PolygonCheckcount( tw, p ) = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -569,8 +721,8 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
 			// reset sidedness cache if this is the first time we encounter this edge during this trace
-			if ( e->checkcount != idCollisionModelManagerLocal::checkCount ) {
-				e->sideSet = 0;
+			if ( CM_EdgeState( tw, e )->checkcount != tw->checkCount ) {
+				CM_EdgeState( tw, e )->sideSet = 0;
 			}
 			// pluecker coordinate for edge
 			tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[e->vertexNum[0]].p,
@@ -578,8 +730,8 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 
 			v = &tw->model->vertices[e->vertexNum[INT32_SIGNBITSET( edgeNum )]];
 			// reset sidedness cache if this is the first time we encounter this vertex during this trace
-			if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-				v->sideSet = 0;
+			if ( CM_VertexState( tw, v )->checkcount != tw->checkCount ) {
+				CM_VertexState( tw, v )->sideSet = 0;
 			}
 			// pluecker coordinate for vertex movement vector
 			tw->polygonVertexPlueckerCache[i].FromRay( v->p, -tw->dir );
@@ -587,6 +739,11 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 		// copy first to last so we can easily cycle through for the edges
 		tw->polygonVertexPlueckerCache[p->numEdges] = tw->polygonVertexPlueckerCache[0];
 
+		if ( tw->simdPlueckers ) {
+			CM_PlueckersToSoA( tw->polygonEdgePlueckerSoA, tw->polygonEdgePlueckerCache, p->numEdges );
+			CM_PlueckersToSoA( tw->polygonVertexPlueckerSoA, tw->polygonVertexPlueckerCache, p->numEdges + 1 );
+		}
+
 		// trace trm vertices through polygon
 		for ( i = 0; i < tw->numVerts; i++ ) {
 			bv = tw->vertices + i;
@@ -608,11 +765,11 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
 
-			if ( e->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( CM_EdgeState( tw, e )->checkcount == tw->checkCount ) {
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			CM_EdgeState( tw, e )->checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if ( e->internal ) {
 				continue;
@@ -622,11 +779,11 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 
 				v = tw->model->vertices + e->vertexNum[k ^ INT32_SIGNBITSET( edgeNum )];
 				// if this vertex is already checked
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( CM_VertexState( tw, v )->checkcount == tw->checkCount ) {
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				CM_VertexState( tw, v )->checkcount = tw->checkCount;
 
 				// if the vertex is outside the trace bounds
 				if ( !tw->bounds.ContainsPoint( v->p ) ) {
@@ -730,7 +887,7 @@ idCollisionModelManagerLocal::Translation
 static int entered = 0;
 #endif
 
-void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &start, const idVec3 &end,
+void idCollisionModelManagerLocal::Translation( cm_traceContext_t *context, trace_t *results, const idVec3 &start, const idVec3 &end,
 										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
 
@@ -742,7 +899,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	cm_trmPolygon_t *poly;
 	cm_trmEdge_t *edge;
 	cm_trmVertex_t *vert;
-	ALIGN16( static cm_traceWork_t tw );
+	cm_traceWork_t &tw = context->translationWork;
 
 	assert( ((byte *)&start) < ((byte *)results) || ((byte *)&start) >= (((byte *)results) + sizeof( trace_t )) );
 	assert( ((byte *)&end) < ((byte *)results) || ((byte *)&end) >= (((byte *)results) + sizeof( trace_t )) );
@@ -754,14 +911,27 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 		idLib::Printf("idCollisionModelManagerLocal::Translation: invalid model handle\n");
 		return;
 	}
-	if ( !idCollisionModelManagerLocal::models[model] ) {
+	if ( !idCollisionModelManagerLocal::GetTraceModel( context, model ) ) {
 		idLib::Printf("idCollisionModelManagerLocal::Translation: invalid model\n");
 		return;
 	}
 
+	if ( cm_recordTraces.GetBool() && !context->getContacts && model != TRACE_MODEL_HANDLE && idLib::IsMainThread() ) {
+		cm_recordedTrace_t rec;
+		rec.isRotation = false;
+		rec.start = start;
+		rec.end = end;
+		rec.trmAxis = trmAxis;
+		rec.contentMask = contentMask;
+		rec.model = model;
+		rec.modelOrigin = modelOrigin;
+		rec.modelAxis = modelAxis;
+		idCollisionModelManagerLocal::RecordTrace( rec, trm );
+	}
+
 	// if case special position test
 	if ( start[0] == end[0] && start[1] == end[1] && start[2] == end[2] ) {
-		idCollisionModelManagerLocal::ContentsTrm( results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+		idCollisionModelManagerLocal::ContentsTrm( context, results, start, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 		return;
 	}
 
@@ -769,10 +939,10 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	bool startsolid = false;
 	// test whether or not stuck to begin with
 	if ( cm_debugCollision.GetBool() ) {
-		if ( !entered && !idCollisionModelManagerLocal::getContacts ) {
+		if ( !entered && !context->getContacts ) {
 			entered = 1;
 			// if already messed up to begin with
-			if ( idCollisionModelManagerLocal::Contents( start, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
+			if ( idCollisionModelManagerLocal::Contents( context, start, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
 				startsolid = true;
 			}
 			entered = 0;
@@ -780,8 +950,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	}
 #endif
 
-	idCollisionModelManagerLocal::checkCount++;
-
+	tw.simdPlueckers = cm_simdPlueckers.GetBool();
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
 	tw.trace.c.type = CONTACT_NONE;
@@ -790,11 +959,12 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	tw.rotation = false;
 	tw.positionTest = false;
 	tw.quickExit = false;
-	tw.getContacts = idCollisionModelManagerLocal::getContacts;
-	tw.contacts = idCollisionModelManagerLocal::contacts;
-	tw.maxContacts = idCollisionModelManagerLocal::maxContacts;
+	tw.getContacts = context->getContacts;
+	tw.contacts = context->contacts;
+	tw.maxContacts = context->maxContacts;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::GetTraceModel( context, model );
+	idCollisionModelManagerLocal::SetupTraceState( context, &tw, model );
 	tw.start = start - modelOrigin;
 	tw.end = end - modelOrigin;
 	tw.dir = end - start;
@@ -857,7 +1027,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 			results->c.point += modelOrigin;
 			results->c.dist += modelOrigin * results->c.normal;
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
+		context->numContacts = tw.numContacts;
 		return;
 	}
 
@@ -1044,7 +1214,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 				tw.contacts[i].dist += modelOrigin * tw.contacts[i].normal;
 			}
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
+		context->numContacts = tw.numContacts;
 	} else {
 		// store results
 		*results = tw.trace;
@@ -1069,19 +1239,30 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 #ifdef _DEBUG
 	// test for missed collisions
 	if ( cm_debugCollision.GetBool() ) {
-		if ( !entered && !idCollisionModelManagerLocal::getContacts ) {
+		if ( !entered && !context->getContacts ) {
 			entered = 1;
 			// if the trm is stuck in the model
-			if ( idCollisionModelManagerLocal::Contents( results->endpos, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
+			if ( idCollisionModelManagerLocal::Contents( context, results->endpos, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
 				trace_t tr;
 
 				// test where the trm is stuck in the model
-				idCollisionModelManagerLocal::Contents( results->endpos, trm, trmAxis, -1, model, modelOrigin, modelAxis );
+				idCollisionModelManagerLocal::Contents( context, results->endpos, trm, trmAxis, -1, model, modelOrigin, modelAxis );
 				// re-run collision detection to find out where it failed
-				idCollisionModelManagerLocal::Translation( &tr, start, end, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+				idCollisionModelManagerLocal::Translation( context, &tr, start, end, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
 			}
 			entered = 0;
 		}
 	}
 #endif
 }
+
+/*
+================
+idCollisionModelManagerLocal::Translation
+================
+*/
+void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &start, const idVec3 &end,
+										const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
+										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+	idCollisionModelManagerLocal::Translation( traceContexts[0], results, start, end, trm, trmAxis, contentMask, model, modelOrigin, modelAxis );
+}
@@ -245,6 +245,9 @@ public:
 
 	// thinking
 	virtual void			Think();
+							// queue world traces Think will need with gameLocal.QueueThinkTrace, they are traced
+							// together on the job threads before the think pass when g_batchThinkTraces is set
+	virtual void			QueueThinkTraces() {}
 	bool					CheckDormant();	// dormant == on the active list, but out of PVS
 	virtual	void			DormantBegin();	// called when entity becomes dormant
 	virtual	void			DormantEnd();		// called when entity wakes from being dormant
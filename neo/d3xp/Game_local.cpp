@@ -186,6 +186,7 @@ idGameLocal::idGameLocal
 ============
 */
 idGameLocal::idGameLocal() {
+	parallelAnimJobs = NULL;
 	Clear();
 }
 
@@ -211,6 +212,11 @@ void idGameLocal::Clear() {
 	activeEntities.Clear();
 	numEntitiesToDeactivate = 0;
 	sortPushers = false;
+	thinkTraces.Clear();
+	thinkTraceFrame = -1;
+	thinkTraceBatchCRC = 0;
+	thinkTraceSerialCRC = 0;
+	numThinkTraceChecks = 0;
 	sortTeamMasters = false;
 	persistentLevelInfo.Clear();
 	memset( globalShaderParms, 0, sizeof( globalShaderParms ) );
@@ -323,6 +329,8 @@ void idGameLocal::Init() {
 	idEvent::Init();
 	idClass::Init();
 
+	parallelAnimJobs = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_PARALLEL_ANIM_JOBS, 0, NULL );
+
 	InitConsoleCommands();
 
 	shellHandler = new (TAG_SWF) idMenuHandler_Shell();
@@ -393,6 +401,15 @@ void idGameLocal::Shutdown() {
 
 	idEvent::Shutdown();
 
+	thinkTraces.Clear();
+
+	if ( parallelAnimJobs != NULL ) {
+		parallelJobManager->FreeJobList( parallelAnimJobs );
+		parallelAnimJobs = NULL;
+	}
+	parallelAnimators.Clear();
+	parallelAnimBatches.Clear();
+
 	delete[] locationEntities;
 	locationEntities = NULL;
 
@@ -2235,6 +2252,200 @@ void idGameLocal::RunTimeGroup2( idUserCmdMgr & userCmdMgr ) {
 	SelectTimeGroup( false );
 }
 
+/*
+================
+idGameLocal::QueueThinkTrace
+
+  Only valid from idEntity::QueueThinkTraces. Returns the number to pass to GetThinkTrace.
+================
+*/
+int idGameLocal::QueueThinkTrace( const idVec3 &start, const idVec3 &end, const idClipModel *mdl, const idMat3 &trmAxis, int contentMask ) {
+	clip.SetupWorldQuery( thinkTraces.Alloc(), start, end, mdl, trmAxis, contentMask );
+	return thinkTraces.Num() - 1;
+}
+
+/*
+================
+idGameLocal::GetThinkTrace
+
+  Returns NULL if the trace was not queued in this frame's think trace batch.
+================
+*/
+const cmTraceQuery_t *idGameLocal::GetThinkTrace( int num, int frame ) const {
+	if ( frame != framenum || frame != thinkTraceFrame || num < 0 || num >= thinkTraces.Num() ) {
+		return NULL;
+	}
+	return &thinkTraces[num];
+}
+
+/*
+================
+CRC32_UpdateTrace
+================
+*/
+static void CRC32_UpdateTrace( unsigned long &crc, const trace_t &trace ) {
+	CRC32_UpdateChecksum( crc, &trace.fraction, sizeof( trace.fraction ) );
+	CRC32_UpdateChecksum( crc, trace.endpos.ToFloatPtr(), sizeof( idVec3 ) );
+	CRC32_UpdateChecksum( crc, trace.endAxis.ToFloatPtr(), sizeof( idMat3 ) );
+	if ( trace.fraction < 1.0f ) {
+		CRC32_UpdateChecksum( crc, &trace.c.type, sizeof( trace.c.type ) );
+		CRC32_UpdateChecksum( crc, trace.c.point.ToFloatPtr(), sizeof( idVec3 ) );
+		CRC32_UpdateChecksum( crc, trace.c.normal.ToFloatPtr(), sizeof( idVec3 ) );
+		CRC32_UpdateChecksum( crc, &trace.c.dist, sizeof( trace.c.dist ) );
+		CRC32_UpdateChecksum( crc, &trace.c.contents, sizeof( trace.c.contents ) );
+		CRC32_UpdateChecksum( crc, &trace.c.material, sizeof( trace.c.material ) );
+		CRC32_UpdateChecksum( crc, &trace.c.modelFeature, sizeof( trace.c.modelFeature ) );
+		CRC32_UpdateChecksum( crc, &trace.c.trmFeature, sizeof( trace.c.trmFeature ) );
+	}
+}
+
+/*
+================
+idGameLocal::CheckThinkTrace
+
+  Called by idClip with g_batchThinkTraces 2 for every precomputed trace that is used.
+================
+*/
+void idGameLocal::CheckThinkTrace( const trace_t &batch, const trace_t &serial ) {
+	CRC32_UpdateTrace( thinkTraceBatchCRC, batch );
+	CRC32_UpdateTrace( thinkTraceSerialCRC, serial );
+	numThinkTraceChecks++;
+}
+
+/*
+================
+idGameLocal::RunThinkTraceBatch
+
+  Lets the time group 1 entities that will think this frame queue the world traces
+  their Think needs and traces them all on the job threads. The world doesn't move
+  during the frame, so a precomputed trace is only used by idClip::Translation when
+  the trace Think does matches it exactly, and the results are the same as a serial run.
+  Think itself still runs serially, only the traces are moved to the job threads.
+================
+*/
+void idGameLocal::RunThinkTraceBatch() {
+	idEntity *ent;
+
+	thinkTraces.SetNum( 0 );
+	for ( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( ent->timeGroup != TIME_GROUP1 || ent->entityNumber < MAX_PLAYERS ) {
+			continue;
+		}
+		if ( inCinematic && g_cinematic.GetBool() && !ent->cinematic ) {
+			continue;
+		}
+		ent->QueueThinkTraces();
+	}
+
+	if ( thinkTraces.Num() > 0 ) {
+		collisionModelManager->TranslationBatch( thinkTraces.Ptr(), thinkTraces.Num() );
+	}
+	thinkTraceFrame = framenum;
+
+	CRC32_InitChecksum( thinkTraceBatchCRC );
+	CRC32_InitChecksum( thinkTraceSerialCRC );
+	numThinkTraceChecks = 0;
+}
+
+/*
+================
+ParallelAnimationJob
+================
+*/
+static void ParallelAnimationJob( parallelAnimBatch_t * batch ) {
+	for ( int i = 0; i < batch->numAnimators; i++ ) {
+		batch->animators[i]->CreateFrameParallel( batch->time );
+	}
+}
+
+REGISTER_PARALLEL_JOB( ParallelAnimationJob, "ParallelAnimationJob" );
+
+/*
+================
+idGameLocal::RunParallelAnimation
+
+  Builds the frames of the animating time group 1 entities in the player PVS on the
+  job threads, so the render callbacks only have to pick up the finished joints.
+  Each job only writes to its own animators, and any animation change made after
+  this point calls idAnimator::ForceUpdate, which drops the prebuilt frame.
+================
+*/
+void idGameLocal::RunParallelAnimation() {
+	idEntity *ent;
+
+	// the debug output of CreateFrame isn't thread safe
+	if ( g_debugAnim.GetInteger() != -1 ) {
+		return;
+	}
+
+	parallelAnimators.SetNum( 0 );
+	for ( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( ent->timeGroup != TIME_GROUP1 || ent->GetModelDefHandle() == -1 || ent->IsHidden() ) {
+			continue;
+		}
+		idAnimator *animator = ent->GetAnimator();
+		if ( animator == NULL || !animator->NeedsFrame( time ) ) {
+			continue;
+		}
+		if ( !InPlayerPVS( ent ) ) {
+			continue;
+		}
+		parallelAnimators.Append( animator );
+	}
+
+	const int numAnimators = parallelAnimators.Num();
+	if ( numAnimators == 0 ) {
+		return;
+	}
+
+	const int batchSize = Max( PARALLEL_ANIM_BATCH_SIZE, ( numAnimators + MAX_PARALLEL_ANIM_JOBS - 1 ) / MAX_PARALLEL_ANIM_JOBS );
+
+	parallelAnimBatches.SetNum( 0 );
+	for ( int i = 0; i < numAnimators; i += batchSize ) {
+		parallelAnimBatch_t & batch = parallelAnimBatches.Alloc();
+		batch.animators = &parallelAnimators[i];
+		batch.numAnimators = Min( batchSize, numAnimators - i );
+		batch.time = time;
+	}
+
+	for ( int i = 0; i < parallelAnimBatches.Num(); i++ ) {
+		parallelAnimJobs->AddJob( ( jobRun_t )ParallelAnimationJob, &parallelAnimBatches[i] );
+	}
+	parallelAnimJobs->Submit();
+	parallelAnimJobs->Wait();
+}
+
+/*
+================
+idGameLocal::GetWorldStateHash
+
+  Checksum over the state of all spawned entities, printed with g_thinkStateHash
+  so a g_batchThinkTraces run of a demo can be compared frame by frame with a serial run.
+================
+*/
+unsigned long idGameLocal::GetWorldStateHash() {
+	unsigned long crc;
+	idEntity *ent;
+
+	CRC32_InitChecksum( crc );
+	for ( ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		CRC32_UpdateChecksum( crc, &ent->entityNumber, sizeof( ent->entityNumber ) );
+		CRC32_UpdateChecksum( crc, &ent->thinkFlags, sizeof( ent->thinkFlags ) );
+		CRC32_UpdateChecksum( crc, &ent->health, sizeof( ent->health ) );
+
+		const idPhysics *phys = ent->GetPhysics();
+		if ( phys != NULL ) {
+			CRC32_UpdateChecksum( crc, phys->GetOrigin().ToFloatPtr(), sizeof( idVec3 ) );
+			CRC32_UpdateChecksum( crc, phys->GetAxis().ToFloatPtr(), sizeof( idMat3 ) );
+			CRC32_UpdateChecksum( crc, phys->GetLinearVelocity().ToFloatPtr(), sizeof( idVec3 ) );
+			CRC32_UpdateChecksum( crc, phys->GetAngularVelocity().ToFloatPtr(), sizeof( idVec3 ) );
+		}
+	}
+	CRC32_FinishChecksum( crc );
+
+	return crc;
+}
+
 /*
 ================
 idGameLocal::RunEntityThink
@@ -2359,6 +2570,11 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 		timer_think.Clear();
 		timer_think.Start();
 
+		// trace the world traces Think will need on the job threads
+		if ( g_batchThinkTraces.GetInteger() != 0 ) {
+			RunThinkTraceBatch();
+		}
+
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
@@ -2441,6 +2657,11 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 
 		timer_events.Stop();
 
+		// build the animation frames of the visible animating entities on the job threads
+		if ( g_parallelAnimation.GetBool() ) {
+			RunParallelAnimation();
+		}
+
 		// free the player pvs
 		FreePlayerPVS();
 
@@ -2456,6 +2677,19 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 				timer_think.Milliseconds(), timer_events.Milliseconds(), num );
 		}
 
+		if ( g_batchThinkTraces.GetInteger() == 2 && numThinkTraceChecks > 0 ) {
+			CRC32_FinishChecksum( thinkTraceBatchCRC );
+			CRC32_FinishChecksum( thinkTraceSerialCRC );
+			if ( thinkTraceBatchCRC != thinkTraceSerialCRC ) {
+				Warning( "game %d: %d precomputed think traces hash to %08lx instead of %08lx", time, numThinkTraceChecks, thinkTraceBatchCRC, thinkTraceSerialCRC );
+			}
+			numThinkTraceChecks = 0;
+		}
+
+		if ( g_thinkStateHash.GetBool() ) {
+			Printf( "game %d: state hash %08lx\n", time, GetWorldStateHash() );
+		}
+
 		BuildReturnValue( ret );
 	}
 
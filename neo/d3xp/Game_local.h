@@ -159,6 +159,15 @@ typedef struct {
 	int			team;			
 } spawnSpot_t;
 
+const int MAX_PARALLEL_ANIM_JOBS		= 64;
+const int PARALLEL_ANIM_BATCH_SIZE		= 4;		// minimum number of animators per animation job
+
+typedef struct {
+	idAnimator **	animators;
+	int				numAnimators;
+	int				time;
+} parallelAnimBatch_t;
+
 //============================================================================
 
 class idEventQueue {
@@ -529,6 +538,11 @@ public:
 
 	const char *			GetMPPlayerDefName() const;
 
+							// world traces batched before the think pass, see idEntity::QueueThinkTraces
+	int						QueueThinkTrace( const idVec3 &start, const idVec3 &end, const idClipModel *mdl, const idMat3 &trmAxis, int contentMask );
+	const cmTraceQuery_t *	GetThinkTrace( int num, int frame ) const;
+	void					CheckThinkTrace( const trace_t &batch, const trace_t &serial );
+
 private:
 	const static int		INITIAL_SPAWN_COUNT = 1;
 
@@ -597,6 +611,16 @@ private:
 	idArray< int, MAX_PLAYERS >	lastCmdRunTimeOnClient;
 	idArray< int, MAX_PLAYERS >	lastCmdRunTimeOnServer;
 
+	idList<cmTraceQuery_t>	thinkTraces;			// world traces queued by idEntity::QueueThinkTraces
+	int						thinkTraceFrame;		// frame the think traces were traced in
+	unsigned long			thinkTraceBatchCRC;		// with g_batchThinkTraces 2 the precomputed traces used are
+	unsigned long			thinkTraceSerialCRC;	// hashed against the same traces done serially
+	int						numThinkTraceChecks;
+
+	idParallelJobList *		parallelAnimJobs;		// builds the animation frames of visible animating entities
+	idList<idAnimator *>	parallelAnimators;
+	idList<parallelAnimBatch_t> parallelAnimBatches;
+
 	void					Clear();
 							// returns true if the entity shouldn't be spawned at all in this game type or difficulty level
 	bool					InhibitEntitySpawn( idDict &spawnArgs );
@@ -611,6 +635,9 @@ private:
 	void					FreePlayerPVS();
 	void					UpdateGravity();
 	void					SortActiveEntityList();
+	void					RunThinkTraceBatch();
+	void					RunParallelAnimation();
+	unsigned long			GetWorldStateHash();
 	void					ShowTargets();
 	void					RunDebugInfo();
 
@@ -57,6 +57,12 @@ idAASLocal::idAASLocal
 */
 idAASLocal::idAASLocal() {
 	file = NULL;
+	routingTableBuffer = NULL;
+	routingTableData = NULL;
+	routingTableFileSize = 0;
+	routingTableClusterOffsets = NULL;
+	routingTableInvalid = NULL;
+	numRoutingTableInvalid = 0;
 }
 
 /*
@@ -58,6 +58,12 @@ private:
 };
 
 
+typedef struct aasRoutingTable_s {
+	int							travelFlags;			// travel flags the table was built for
+	const int *					rowOffsets;				// offset in the row data of each intra-cluster row followed by each portal row
+} aasRoutingTable_t;
+
+
 class idRoutingUpdate {
 	friend class idAASLocal;
 
@@ -118,6 +124,7 @@ public:
 	virtual void				ShowWalkPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const;
+	virtual bool				WriteRoutingTables();
 
 private:
 	idAASFile *					file;
@@ -137,6 +144,16 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle *, TAG_AAS>	obstacleList;			// list with obstacles
+	mappedFile_t				routingTableMapping;	// precomputed routing tables when the file could be mapped
+	byte *						routingTableBuffer;		// precomputed routing tables read into memory otherwise
+	const byte *				routingTableData;		// compressed rows of all the routing tables
+	int							routingTableFileSize;	// size of the routing table file
+	idList<aasRoutingTable_t, TAG_AAS>	routingTables;	// one table per travel flags combination
+	idList<int, TAG_AAS>		routingTableRowOffsets;	// row offsets of all tables
+	idList<int, TAG_AAS>		routingTablePortalRows;	// portal table row for each area, -1 if there is none
+	int *						routingTableClusterOffsets;	// first intra-cluster row of each cluster
+	int *						routingTableInvalid;	// per cluster number of disabled areas and obstacles invalidating the tables
+	int							numRoutingTableInvalid;	// total over all clusters
 
 private:	// routing
 	bool						SetupRouting();
@@ -156,7 +173,7 @@ private:	// routing
 	int							ClusterAreaNum( int clusterNum, int areaNum ) const;
 	void						UpdateAreaRoutingCache( idRoutingCache *areaCache ) const;
 	idRoutingCache *			GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
-	void						UpdatePortalRoutingCache( idRoutingCache *portalCache ) const;
+	void						UpdatePortalRoutingCache( idRoutingCache *portalCache, byte *portalSides = NULL ) const;
 	idRoutingCache *			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
 	void						RemoveRoutingCacheUsingArea( int areaNum );
 	void						DisableArea( int areaNum );
@@ -164,6 +181,15 @@ private:	// routing
 	bool						SetAreaState_r( int nodeNum, const idBounds &bounds, const int areaContents, bool disabled );
 	void						GetBoundsAreas_r( int nodeNum, const idBounds &bounds, idList<int> &areas ) const;
 	void						SetObstacleState( const idRoutingObstacle *obstacle, bool enable );
+	void						RoutingTableFileName( idStr &fileName ) const;
+	void						SetupRoutingTableOffsets();
+	bool						LoadRoutingTables();
+	void						FreeRoutingTables();
+	void						InvalidateRoutingTables( int areaNum, int count );
+	const aasRoutingTable_t *	GetRoutingTable( int travelFlags ) const;
+	bool						ReadRoutingTableRow( const aasRoutingTable_t *table, int rowNum, int trailerSize, idRoutingCache *cache ) const;
+	bool						ReadAreaRoutingTable( idRoutingCache *cache, int clusterAreaNum ) const;
+	bool						ReadPortalRoutingTable( idRoutingCache *cache ) const;
 
 private:	// pathing
 	bool						EdgeSplitPoint( idVec3 &split, int edgeNum, const idPlane &plane ) const;
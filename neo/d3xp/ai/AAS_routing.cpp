@@ -40,6 +40,129 @@ If you have questions concerning this license or the applicable additional terms
 
 #define LEDGE_TRAVELTIME_PANALTY	250
 
+#define AAS_ROUTING_IDENT			( ( 'R' << 24 ) + ( 'T' << 16 ) + ( 'S' << 8 ) + 'A' )
+#define AAS_ROUTING_VERSION			3
+#define AAS_ROUTING_FILE_EXT		".routes"
+#define AAS_ROUTING_MAX_CLUSTER_AREAS	1024	// clusters with more reachable areas are left to the dynamic cache
+
+#define AAS_ROUTING_ROW_PACKED_REACH	1		// row flag: all reachabilities fit in 4 bits
+
+// portal rows are followed by a bit per portal which is set when the travel time was calculated through the back cluster
+#define AAS_ROUTING_PORTAL_SIDES_SIZE( numPortals )	( ( ( numPortals ) + 7 ) >> 3 )
+
+// the travel flags the precomputed routing tables are built for, as used by idAI
+static const int aasRoutingTableTravelFlags[] = {
+	TFL_WALK|TFL_AIR,
+	TFL_WALK|TFL_AIR|TFL_FLY
+};
+
+typedef struct aasRoutingHeader_s {
+	int							ident;
+	int							version;
+	unsigned int				crc;					// crc of the .aas file the tables are built for
+	int							numAreas;
+	int							numClusters;
+	int							numPortals;
+	int							numAreaRows;			// sum of the number of reachable areas of all clusters
+	int							numPortalRows;			// number of areas with a row in the portal tables
+	int							numTables;
+	int							dataSize;				// size of the compressed rows of all tables
+} aasRoutingHeader_t;
+
+/*
+============
+AAS_EncodeRoutingRow
+
+  Travel times are stored as zigzag coded deltas to the previous travel time in
+  7 bit groups, the reachabilities follow packed in 4 bits when they all fit.
+============
+*/
+static void AAS_EncodeRoutingRow( idList<byte> &data, const unsigned short *travelTimes, const byte *reachabilities, int size ) {
+	int i, delta, flags;
+	unsigned int code;
+
+	flags = AAS_ROUTING_ROW_PACKED_REACH;
+	for ( i = 0; i < size; i++ ) {
+		if ( reachabilities[i] > 15 ) {
+			flags = 0;
+			break;
+		}
+	}
+	data.Append( (byte)flags );
+
+	for ( i = 0; i < size; i++ ) {
+		delta = (int)travelTimes[i] - ( i > 0 ? (int)travelTimes[i - 1] : 0 );
+		code = ( delta < 0 ) ? ( ( (unsigned int)-delta << 1 ) - 1 ) : ( (unsigned int)delta << 1 );
+		while ( code >= 0x80 ) {
+			data.Append( (byte)( code | 0x80 ) );
+			code >>= 7;
+		}
+		data.Append( (byte)code );
+	}
+
+	if ( flags & AAS_ROUTING_ROW_PACKED_REACH ) {
+		for ( i = 0; i < size; i += 2 ) {
+			data.Append( (byte)( reachabilities[i] | ( i + 1 < size ? reachabilities[i + 1] << 4 : 0 ) ) );
+		}
+	} else {
+		for ( i = 0; i < size; i++ ) {
+			data.Append( reachabilities[i] );
+		}
+	}
+}
+
+/*
+============
+AAS_DecodeRoutingRow
+
+  returns false if the row is malformed
+============
+*/
+static bool AAS_DecodeRoutingRow( const byte *row, int length, unsigned short *travelTimes, byte *reachabilities, int size ) {
+	int i, shift, travelTime;
+	unsigned int code;
+	const byte *end = row + length;
+
+	if ( row >= end ) {
+		return false;
+	}
+	const int flags = *row++;
+
+	travelTime = 0;
+	for ( i = 0; i < size; i++ ) {
+		code = 0;
+		for ( shift = 0; ; shift += 7 ) {
+			if ( row >= end || shift > 14 ) {
+				return false;
+			}
+			code |= ( *row & 0x7F ) << shift;
+			if ( !( *row++ & 0x80 ) ) {
+				break;
+			}
+		}
+		travelTime += ( code & 1 ) ? -(int)( ( code + 1 ) >> 1 ) : (int)( code >> 1 );
+		if ( travelTime < 0 || travelTime > 0xFFFF ) {
+			return false;
+		}
+		travelTimes[i] = (unsigned short)travelTime;
+	}
+
+	if ( flags & AAS_ROUTING_ROW_PACKED_REACH ) {
+		if ( end - row != ( size + 1 ) / 2 ) {
+			return false;
+		}
+		for ( i = 0; i < size; i++ ) {
+			reachabilities[i] = ( row[i >> 1] >> ( ( i & 1 ) << 2 ) ) & 15;
+		}
+	} else {
+		if ( end - row != size ) {
+			return false;
+		}
+		memcpy( reachabilities, row, size );
+	}
+	return true;
+}
+
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -213,6 +336,8 @@ void idAASLocal::SetupRoutingCache() {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+
+	SetupRoutingTableOffsets();
 }
 
 /*
@@ -277,6 +402,11 @@ void idAASLocal::ShutdownRoutingCache() {
 	portalUpdate = NULL;
 	Mem_Free( goalAreaTravelTimes );
 	goalAreaTravelTimes = NULL;
+	Mem_Free( routingTableClusterOffsets );
+	routingTableClusterOffsets = NULL;
+	Mem_Free( routingTableInvalid );
+	routingTableInvalid = NULL;
+	numRoutingTableInvalid = 0;
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
@@ -290,6 +420,7 @@ idAASLocal::SetupRouting
 bool idAASLocal::SetupRouting() {
 	CalculateAreaTravelTimes();
 	SetupRoutingCache();
+	LoadRoutingTables();
 	return true;
 }
 
@@ -301,6 +432,7 @@ idAASLocal::ShutdownRouting
 void idAASLocal::ShutdownRouting() {
 	DeleteAreaTravelTimes();
 	ShutdownRoutingCache();
+	FreeRoutingTables();
 }
 
 /*
@@ -331,6 +463,484 @@ void idAASLocal::RoutingStats() const {
 	gameLocal.Printf( "%6d area travel times (%d KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%d KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%d KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
+	gameLocal.Printf( "%6d precomputed routing tables (%d KB%s)%s\n", routingTables.Num(), routingTableFileSize >> 10,
+						routingTableMapping.data != NULL ? ", mapped" : "", numRoutingTableInvalid ? " partly invalidated" : "" );
+}
+
+/*
+============
+idAASLocal::RoutingTableFileName
+============
+*/
+void idAASLocal::RoutingTableFileName( idStr &fileName ) const {
+	fileName = "generated/";
+	fileName.AppendPath( file->GetName() );
+	fileName += AAS_ROUTING_FILE_EXT;
+}
+
+/*
+============
+idAASLocal::SetupRoutingTableOffsets
+
+  the intra-cluster rows of all clusters are stored back to back, one row for each reachable area of the cluster
+============
+*/
+void idAASLocal::SetupRoutingTableOffsets() {
+	int i;
+
+	routingTableClusterOffsets = (int *) Mem_Alloc( ( file->GetNumClusters() + 1 ) * sizeof( int ), TAG_AAS );
+	routingTableClusterOffsets[0] = 0;
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		routingTableClusterOffsets[i + 1] = routingTableClusterOffsets[i] + file->GetCluster( i ).numReachableAreas;
+	}
+
+	routingTableInvalid = (int *) Mem_ClearedAlloc( file->GetNumClusters() * sizeof( int ), TAG_AAS );
+	numRoutingTableInvalid = 0;
+}
+
+/*
+============
+idAASLocal::LoadRoutingTables
+
+  The loose file is mapped when possible so rows are only paged in when they are used,
+  otherwise it is read with a single file read. Rows are decompressed into the routing
+  cache when they are needed.
+============
+*/
+bool idAASLocal::LoadRoutingTables() {
+	int i, j, length, numAreaRows, numRows, numInts;
+	const byte *buffer;
+	const int *ints;
+	aasRoutingHeader_t header;
+	idStr fileName;
+
+	FreeRoutingTables();
+
+	RoutingTableFileName( fileName );
+	if ( Sys_MapFile( fileSystem->RelativePathToOSPath( fileName, "fs_basepath" ), routingTableMapping ) ) {
+		buffer = routingTableMapping.data;
+		length = (int)Min( routingTableMapping.length, (size_t)INT_MAX );
+	} else {
+		length = fileSystem->ReadFile( fileName, (void **)&routingTableBuffer );
+		if ( length <= 0 || routingTableBuffer == NULL ) {
+			routingTableBuffer = NULL;
+			return false;
+		}
+		buffer = routingTableBuffer;
+	}
+
+	if ( length < (int)sizeof( aasRoutingHeader_t ) ) {
+		gameLocal.Warning( "%s is truncated", fileName.c_str() );
+		FreeRoutingTables();
+		return false;
+	}
+	memcpy( &header, buffer, sizeof( header ) );
+	idSwap::LittleArray( (int *)&header, sizeof( header ) / sizeof( int ) );
+
+	numAreaRows = routingTableClusterOffsets[file->GetNumClusters()];
+	if ( header.ident != AAS_ROUTING_IDENT || header.version != AAS_ROUTING_VERSION || header.crc != file->GetCRC() ||
+			header.numAreas != file->GetNumAreas() || header.numClusters != file->GetNumClusters() ||
+				header.numPortals != file->GetNumPortals() || header.numAreaRows != numAreaRows ) {
+		gameLocal.Warning( "%s is out of date, run aasBuildRoutingTables", fileName.c_str() );
+		FreeRoutingTables();
+		return false;
+	}
+
+	numRows = numAreaRows + header.numPortalRows;
+	numInts = header.numAreas + header.numTables + header.numTables * ( numRows + 1 );
+	if ( header.numPortalRows < 0 || header.numPortalRows > header.numAreas || header.dataSize < 0 ||
+			header.numTables < 0 || header.numTables > (int)( sizeof( aasRoutingTableTravelFlags ) / sizeof( aasRoutingTableTravelFlags[0] ) ) ||
+				length != (int)sizeof( aasRoutingHeader_t ) + numInts * (int)sizeof( int ) + header.dataSize ) {
+		gameLocal.Warning( "%s has the wrong size", fileName.c_str() );
+		FreeRoutingTables();
+		return false;
+	}
+
+	ints = (const int *)( buffer + sizeof( aasRoutingHeader_t ) );
+
+	// the portal rows index the portal tables, so an invalid one would read outside of them
+	routingTablePortalRows.SetNum( header.numAreas );
+	memcpy( routingTablePortalRows.Ptr(), ints, header.numAreas * sizeof( int ) );
+	idSwap::LittleArray( routingTablePortalRows.Ptr(), header.numAreas );
+	ints += header.numAreas;
+	for ( i = 0; i < header.numAreas; i++ ) {
+		if ( routingTablePortalRows[i] < -1 || routingTablePortalRows[i] >= header.numPortalRows ) {
+			gameLocal.Warning( "%s has an invalid portal row for area %d", fileName.c_str(), i );
+			FreeRoutingTables();
+			return false;
+		}
+	}
+
+	routingTableRowOffsets.SetNum( header.numTables * ( numRows + 1 ) );
+	memcpy( routingTableRowOffsets.Ptr(), ints + header.numTables, routingTableRowOffsets.Num() * sizeof( int ) );
+	idSwap::LittleArray( routingTableRowOffsets.Ptr(), routingTableRowOffsets.Num() );
+
+	routingTables.SetNum( header.numTables );
+	for ( i = 0; i < header.numTables; i++ ) {
+		aasRoutingTable_t &table = routingTables[i];
+		table.travelFlags = ints[i];
+		idSwap::Little( table.travelFlags );
+		table.rowOffsets = routingTableRowOffsets.Ptr() + i * ( numRows + 1 );
+		for ( j = 0; j < numRows; j++ ) {
+			if ( table.rowOffsets[j] < 0 || table.rowOffsets[j] > table.rowOffsets[j + 1] ) {
+				break;
+			}
+		}
+		if ( j < numRows || table.rowOffsets[numRows] > header.dataSize ) {
+			gameLocal.Warning( "%s has invalid row offsets", fileName.c_str() );
+			FreeRoutingTables();
+			return false;
+		}
+	}
+
+	routingTableData = buffer + sizeof( aasRoutingHeader_t ) + numInts * sizeof( int );
+	routingTableFileSize = length;
+	return true;
+}
+
+/*
+============
+idAASLocal::FreeRoutingTables
+
+  rows that were already read into the routing cache stay valid
+============
+*/
+void idAASLocal::FreeRoutingTables() {
+	Sys_UnmapFile( routingTableMapping );
+	if ( routingTableBuffer != NULL ) {
+		fileSystem->FreeFile( routingTableBuffer );
+		routingTableBuffer = NULL;
+	}
+	routingTableData = NULL;
+	routingTableFileSize = 0;
+	routingTables.Clear();
+	routingTableRowOffsets.Clear();
+	routingTablePortalRows.Clear();
+}
+
+/*
+============
+idAASLocal::WriteRoutingTables
+
+  Builds the routing tables with the dynamic routing cache for all reachable goal areas.
+  Rows of clusters with more than AAS_ROUTING_MAX_CLUSTER_AREAS reachable areas are
+  left empty so the size of the file stays bounded.
+
+  The tables are built for the static state of the .aas file. Areas disabled by doors are
+  enabled while the tables are calculated and disabled again afterwards.
+============
+*/
+bool idAASLocal::WriteRoutingTables() {
+	int i, j, n, side, clusterNum, goalClusterNum, numReachableAreas, numAreaRows, numRows, numTables;
+	idList<int> portalRows, fileRows, clusterRowAreas, rowOffsets, disabledAreas;
+	idList<byte> data, portalSides;
+	int64 uncompressedSize;
+	aasRoutingHeader_t header;
+	idRoutingCache *cache;
+	idStr fileName;
+	idFile *f;
+	bool written;
+
+	if ( !file ) {
+		return false;
+	}
+
+	// remove all runtime changes to the routing
+	for ( n = 1; n < file->GetNumAreas(); n++ ) {
+		if ( file->GetArea( n ).travelFlags & TFL_INVALID ) {
+			disabledAreas.Append( n );
+			EnableArea( n );
+		}
+	}
+	// obstacles that are present don't set TFL_INVALID on any reachabilities ( see SetObstacleState ), only their invalidation is lifted
+	for ( i = 0; i < obstacleList.Num(); i++ ) {
+		for ( j = 0; j < obstacleList[i]->areas.Num(); j++ ) {
+			InvalidateRoutingTables( obstacleList[i]->areas[j], -1 );
+		}
+	}
+	assert( numRoutingTableInvalid == 0 );
+
+	// calculate everything with the dynamic cache
+	FreeRoutingTables();
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		DeleteClusterCache( i );
+	}
+	DeletePortalCache();
+
+	// every area that can be a goal gets a row in the portal tables
+	portalRows.SetNum( file->GetNumAreas() );
+	header.numPortalRows = 0;
+	for ( n = 0; n < file->GetNumAreas(); n++ ) {
+		if ( n > 0 && ( file->GetArea( n ).flags & (AREA_REACHABLE_WALK|AREA_REACHABLE_FLY) ) ) {
+			portalRows[n] = header.numPortalRows++;
+		} else {
+			portalRows[n] = -1;
+		}
+	}
+
+	// the goal area for every row of the intra-cluster tables
+	numAreaRows = routingTableClusterOffsets[file->GetNumClusters()];
+	clusterRowAreas.SetNum( numAreaRows );
+	memset( clusterRowAreas.Ptr(), 0, numAreaRows * sizeof( int ) );
+	for ( n = 1; n < file->GetNumAreas(); n++ ) {
+		clusterNum = file->GetArea( n ).cluster;
+		if ( clusterNum > 0 ) {
+			if ( file->GetArea( n ).clusterAreaNum < file->GetCluster( clusterNum ).numReachableAreas ) {
+				clusterRowAreas[routingTableClusterOffsets[clusterNum] + file->GetArea( n ).clusterAreaNum] = n;
+			}
+		} else {
+			// portal areas are part of both clusters
+			const aasPortal_t &portal = file->GetPortal( -clusterNum );
+			for ( side = 0; side < 2; side++ ) {
+				if ( portal.clusterAreaNum[side] < file->GetCluster( portal.clusters[side] ).numReachableAreas ) {
+					clusterRowAreas[routingTableClusterOffsets[portal.clusters[side]] + portal.clusterAreaNum[side]] = n;
+				}
+			}
+		}
+	}
+
+	numTables = sizeof( aasRoutingTableTravelFlags ) / sizeof( aasRoutingTableTravelFlags[0] );
+	numRows = numAreaRows + header.numPortalRows;
+	rowOffsets.SetNum( numTables * ( numRows + 1 ) );
+	portalSides.SetNum( AAS_ROUTING_PORTAL_SIDES_SIZE( file->GetNumPortals() ) );
+	data.SetGranularity( 65536 );
+	uncompressedSize = 0;
+
+	for ( i = 0; i < numTables; i++ ) {
+		const int travelFlags = aasRoutingTableTravelFlags[i];
+		int *offsets = rowOffsets.Ptr() + i * ( numRows + 1 );
+
+		// intra-cluster tables
+		for ( clusterNum = 0; clusterNum < file->GetNumClusters(); clusterNum++ ) {
+			numReachableAreas = file->GetCluster( clusterNum ).numReachableAreas;
+			for ( j = 0; j < numReachableAreas; j++ ) {
+				const int row = routingTableClusterOffsets[clusterNum] + j;
+				offsets[row] = data.Num();
+				n = clusterRowAreas[row];
+				if ( n == 0 || numReachableAreas > AAS_ROUTING_MAX_CLUSTER_AREAS ) {
+					continue;
+				}
+				while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
+					DeleteOldestCache();
+				}
+				cache = GetAreaRoutingCache( clusterNum, n, travelFlags );
+				AAS_EncodeRoutingRow( data, cache->travelTimes, cache->reachabilities, numReachableAreas );
+				uncompressedSize += numReachableAreas * ( sizeof( unsigned short ) + sizeof( byte ) );
+			}
+		}
+
+		// portal tables
+		for ( n = 0; n < file->GetNumAreas(); n++ ) {
+			if ( portalRows[n] < 0 ) {
+				continue;
+			}
+			// same as RouteToGoalArea, a portal goal area is part of the front cluster
+			goalClusterNum = file->GetArea( n ).cluster;
+			if ( goalClusterNum < 0 ) {
+				goalClusterNum = file->GetPortal( -goalClusterNum ).clusters[0];
+			}
+			while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
+				DeleteOldestCache();
+			}
+			// the portal cache is not kept, every goal area is only used once
+			cache = new (TAG_AAS) idRoutingCache( file->GetNumPortals() );
+			cache->type = CACHETYPE_PORTAL;
+			cache->cluster = goalClusterNum;
+			cache->areaNum = n;
+			cache->startTravelTime = 1;
+			cache->travelFlags = travelFlags;
+			UpdatePortalRoutingCache( cache, portalSides.Ptr() );
+			offsets[numAreaRows + portalRows[n]] = data.Num();
+			AAS_EncodeRoutingRow( data, cache->travelTimes, cache->reachabilities, file->GetNumPortals() );
+			data.Append( portalSides );
+			uncompressedSize += file->GetNumPortals() * ( sizeof( unsigned short ) + sizeof( byte ) );
+			delete cache;
+		}
+
+		offsets[numRows] = data.Num();
+	}
+
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		DeleteClusterCache( i );
+	}
+	DeletePortalCache();
+
+	RoutingTableFileName( fileName );
+	f = fileSystem->OpenFileWrite( fileName, "fs_basepath" );
+	written = ( f != NULL );
+	if ( f == NULL ) {
+		gameLocal.Warning( "Couldn't open %s for writing", fileName.c_str() );
+	} else {
+		header.ident = AAS_ROUTING_IDENT;
+		header.version = AAS_ROUTING_VERSION;
+		header.crc = file->GetCRC();
+		header.numAreas = file->GetNumAreas();
+		header.numClusters = file->GetNumClusters();
+		header.numPortals = file->GetNumPortals();
+		header.numAreaRows = numAreaRows;
+		header.numTables = numTables;
+		header.dataSize = data.Num();
+		idSwap::LittleArray( (int *)&header, sizeof( header ) / sizeof( int ) );
+		f->Write( &header, sizeof( header ) );
+		fileRows = portalRows;
+		idSwap::LittleArray( fileRows.Ptr(), fileRows.Num() );
+		f->Write( fileRows.Ptr(), fileRows.Num() * sizeof( int ) );
+		for ( i = 0; i < numTables; i++ ) {
+			int travelFlags = aasRoutingTableTravelFlags[i];
+			idSwap::Little( travelFlags );
+			f->Write( &travelFlags, sizeof( travelFlags ) );
+		}
+		idSwap::LittleArray( rowOffsets.Ptr(), rowOffsets.Num() );
+		f->Write( rowOffsets.Ptr(), rowOffsets.Num() * sizeof( int ) );
+		f->Write( data.Ptr(), data.Num() );
+
+		gameLocal.Printf( "Wrote %s (%d KB, %d KB uncompressed)\n", fileName.c_str(), f->Length() >> 10, (int)( uncompressedSize >> 10 ) );
+		fileSystem->CloseFile( f );
+	}
+
+	// put the runtime changes back, the rows they invalidate are calculated with the dynamic cache again
+	for ( i = 0; i < obstacleList.Num(); i++ ) {
+		for ( j = 0; j < obstacleList[i]->areas.Num(); j++ ) {
+			InvalidateRoutingTables( obstacleList[i]->areas[j], 1 );
+			RemoveRoutingCacheUsingArea( obstacleList[i]->areas[j] );
+		}
+	}
+	for ( i = 0; i < disabledAreas.Num(); i++ ) {
+		DisableArea( disabledAreas[i] );
+	}
+
+	// the previous tables are loaded again if the file couldn't be written
+	return LoadRoutingTables() && written;
+}
+
+/*
+============
+idAASLocal::InvalidateRoutingTables
+
+  count is positive when areas are disabled or obstacles added and negative when they are enabled or removed again
+============
+*/
+void idAASLocal::InvalidateRoutingTables( int areaNum, int count ) {
+	int clusterNum;
+
+	clusterNum = file->GetArea( areaNum ).cluster;
+	if ( clusterNum >= 0 ) {
+		routingTableInvalid[clusterNum] += count;
+	}
+	else {
+		// a portal is part of both the front and back cluster
+		routingTableInvalid[file->GetPortal( -clusterNum ).clusters[0]] += count;
+		routingTableInvalid[file->GetPortal( -clusterNum ).clusters[1]] += count;
+	}
+	numRoutingTableInvalid += count;
+	assert( numRoutingTableInvalid >= 0 );
+}
+
+/*
+============
+idAASLocal::GetRoutingTable
+============
+*/
+const aasRoutingTable_t *idAASLocal::GetRoutingTable( int travelFlags ) const {
+	int i;
+
+	if ( routingTableData == NULL || !aas_useRoutingTables.GetBool() ) {
+		return NULL;
+	}
+	for ( i = 0; i < routingTables.Num(); i++ ) {
+		if ( routingTables[i].travelFlags == travelFlags ) {
+			return &routingTables[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+============
+idAASLocal::ReadRoutingTableRow
+
+  decompresses a row of the precomputed routing tables into the cache, returns false if the row is not in the tables
+  trailerSize is the number of bytes stored after the encoded row
+============
+*/
+bool idAASLocal::ReadRoutingTableRow( const aasRoutingTable_t *table, int rowNum, int trailerSize, idRoutingCache *cache ) const {
+	const int offset = table->rowOffsets[rowNum];
+	const int length = table->rowOffsets[rowNum + 1] - offset;
+
+	if ( length == 0 ) {
+		return false;
+	}
+	if ( length <= trailerSize || !AAS_DecodeRoutingRow( routingTableData + offset, length - trailerSize, cache->travelTimes, cache->reachabilities, cache->size ) ) {
+		gameLocal.Warning( "routing table row %d for %s is corrupt", rowNum, file->GetName() );
+		memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+		memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+		return false;
+	}
+	return true;
+}
+
+/*
+============
+idAASLocal::ReadAreaRoutingTable
+
+  reads the precomputed intra-cluster travel times, returns false if the tables are not valid for the cluster
+============
+*/
+bool idAASLocal::ReadAreaRoutingTable( idRoutingCache *cache, int clusterAreaNum ) const {
+	const aasRoutingTable_t *table;
+
+	if ( routingTableInvalid[cache->cluster] ) {
+		return false;
+	}
+	table = GetRoutingTable( cache->travelFlags );
+	if ( table == NULL || clusterAreaNum >= cache->size ) {
+		return false;
+	}
+	return ReadRoutingTableRow( table, routingTableClusterOffsets[cache->cluster] + clusterAreaNum, 0, cache );
+}
+
+/*
+============
+idAASLocal::ReadPortalRoutingTable
+
+  reads the precomputed portal travel times, returns false if the tables are not valid for the goal area
+
+  Disabled areas and obstacles only make travel times longer or remove routes, and they
+  only change the intra-cluster travel times of their own clusters. A row stays valid as
+  long as none of its portal travel times was calculated through such a cluster.
+============
+*/
+bool idAASLocal::ReadPortalRoutingTable( idRoutingCache *cache ) const {
+	int i, rowNum, side;
+	const aasRoutingTable_t *table;
+	const byte *sides;
+
+	table = GetRoutingTable( cache->travelFlags );
+	if ( table == NULL || routingTablePortalRows[cache->areaNum] < 0 ) {
+		return false;
+	}
+	rowNum = routingTableClusterOffsets[file->GetNumClusters()] + routingTablePortalRows[cache->areaNum];
+	if ( !ReadRoutingTableRow( table, rowNum, AAS_ROUTING_PORTAL_SIDES_SIZE( cache->size ), cache ) ) {
+		return false;
+	}
+	if ( !numRoutingTableInvalid ) {
+		return true;
+	}
+
+	sides = routingTableData + table->rowOffsets[rowNum + 1] - AAS_ROUTING_PORTAL_SIDES_SIZE( cache->size );
+	for ( i = 1; i < cache->size; i++ ) {
+		if ( cache->travelTimes[i] == 0 ) {
+			continue;
+		}
+		side = ( sides[i >> 3] >> ( i & 7 ) ) & 1;
+		if ( routingTableInvalid[file->GetPortal( i ).clusters[side]] ) {
+			// the dynamic update starts from a cleared cache
+			memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+			memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+			return false;
+		}
+	}
+	return true;
 }
 
 /*
@@ -368,6 +978,7 @@ void idAASLocal::DisableArea( int areaNum ) {
 
 	file->SetAreaTravelFlag( areaNum, TFL_INVALID );
 
+	InvalidateRoutingTables( areaNum, 1 );
 	RemoveRoutingCacheUsingArea( areaNum );
 }
 
@@ -385,6 +996,7 @@ void idAASLocal::EnableArea( int areaNum ) {
 
 	file->RemoveAreaTravelFlag( areaNum, TFL_INVALID );
 
+	InvalidateRoutingTables( areaNum, -1 );
 	RemoveRoutingCacheUsingArea( areaNum );
 }
 
@@ -489,6 +1101,8 @@ void idAASLocal::SetObstacleState( const idRoutingObstacle *obstacle, bool enabl
 
 	for ( i = 0; i < obstacle->areas.Num(); i++ ) {
 
+		// AddObstacle passes true and RemoveObstacle false
+		InvalidateRoutingTables( obstacle->areas[i], enable ? 1 : -1 );
 		RemoveRoutingCacheUsingArea( obstacle->areas[i] );
 
 		area = &file->GetArea( obstacle->areas[i] );
@@ -855,7 +1469,10 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 			clusterCache->prev = cache;
 		}
 		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
-		UpdateAreaRoutingCache( cache );
+		// use the precomputed routing tables if they are still valid for this cluster
+		if ( !ReadAreaRoutingTable( cache, clusterAreaNum ) ) {
+			UpdateAreaRoutingCache( cache );
+		}
 	}
 	LinkCache( cache );
 	return cache;
@@ -864,9 +1481,11 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 /*
 ============
 idAASLocal::UpdatePortalRoutingCache
+
+  portalSides optionally receives the cluster the travel time of each portal was calculated through
 ============
 */
-void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
+void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache, byte *portalSides ) const {
 	int i, portalNum, clusterAreaNum;
 	unsigned short t;
 	const aasPortal_t *portal;
@@ -874,6 +1493,10 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 	idRoutingCache *cache;
 	idRoutingUpdate *updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
 
+	if ( portalSides != NULL ) {
+		memset( portalSides, 0, AAS_ROUTING_PORTAL_SIDES_SIZE( portalCache->size ) );
+	}
+
 	curUpdate = &portalUpdate[ file->GetNumPortals() ];
 	curUpdate->cluster = portalCache->cluster;
 	curUpdate->areaNum = portalCache->areaNum;
@@ -927,9 +1550,15 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 				nextUpdate = &portalUpdate[portalNum];
 				if ( portal->clusters[0] == curUpdate->cluster ) {
 					nextUpdate->cluster = portal->clusters[1];
+					if ( portalSides != NULL ) {
+						portalSides[portalNum >> 3] &= ~( 1 << ( portalNum & 7 ) );
+					}
 				}
 				else {
 					nextUpdate->cluster = portal->clusters[0];
+					if ( portalSides != NULL ) {
+						portalSides[portalNum >> 3] |= ( 1 << ( portalNum & 7 ) );
+					}
 				}
 				nextUpdate->areaNum = portal->areaNum;
 				// add travel time through the actual portal area for the next update
@@ -981,7 +1610,10 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 			portalCacheIndex[areaNum]->prev = cache;
 		}
 		portalCacheIndex[areaNum] = cache;
-		UpdatePortalRoutingCache( cache );
+		// use the precomputed routing tables unless disabled areas or obstacles changed the row
+		if ( !ReadPortalRoutingTable( cache ) ) {
+			UpdatePortalRoutingCache( cache );
+		}
 	}
 	LinkCache( cache );
 	return cache;
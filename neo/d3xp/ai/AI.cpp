@@ -1094,6 +1094,15 @@ void idAI::DormantEnd() {
 	idActor::DormantEnd();
 }
 
+/*
+=====================
+idAI::QueueThinkTraces
+=====================
+*/
+void idAI::QueueThinkTraces() {
+	physicsObj.QueueGroundTrace();
+}
+
 /*
 =====================
 idAI::Think
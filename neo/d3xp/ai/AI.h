@@ -443,6 +443,7 @@ protected:
 	virtual	void			DormantBegin();	// called when entity becomes dormant
 	virtual	void			DormantEnd();		// called when entity wakes from being dormant
 	void					Think();
+	virtual void			QueueThinkTraces();
 	void					Activate( idEntity *activator );
 public:
 	int						ReactionTo( const idEntity *ent );
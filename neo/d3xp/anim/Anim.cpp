@@ -34,9 +34,14 @@ If you have questions concerning this license or the applicable additional terms
 #include "../Game_local.h"
 
 idCVar binaryLoadAnim( "binaryLoadAnim", "1", 0, "enable binary load/write of idMD5Anim" );
+idCVar binaryCompressAnim( "binaryCompressAnim", "0", 0, "quantize the frames of idMD5Anim and drop the components that don't change" );
+idCVar binaryCompressAnimTranslationError( "binaryCompressAnimTranslationError", "0.01", CVAR_FLOAT, "max error of a translation component with binaryCompressAnim, picks 8, 12 or 16 bits per component or drops it when constant" );
+idCVar binaryCompressAnimRotationError( "binaryCompressAnimRotationError", "0.0002", CVAR_FLOAT, "max error of a quaternion component with binaryCompressAnim, picks 8, 12 or 16 bits per component or drops it when constant" );
 
 static const byte B_ANIM_MD5_VERSION = 101;
 static const unsigned int B_ANIM_MD5_MAGIC = ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'D' << 8 ) | B_ANIM_MD5_VERSION;
+static const byte B_ANIM_MD5_PACKED_VERSION = 102;
+static const unsigned int B_ANIM_MD5_PACKED_MAGIC = ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'Q' << 8 ) | B_ANIM_MD5_PACKED_VERSION;
 
 static const int JOINT_FRAME_PAD	= 1;	// one extra to be able to read one more float than is necessary
 
@@ -60,6 +65,9 @@ idMD5Anim::idMD5Anim() {
 	frameRate	= 24;
 	animLength	= 0;
 	numAnimatedComponents = 0;
+	compressed	= false;
+	numSlots8	= 0;
+	numSlots12	= 0;
 	totaldelta.Zero();
 }
 
@@ -90,6 +98,17 @@ void idMD5Anim::Free() {
 	jointInfo.Clear();
 	bounds.Clear();
 	componentFrames.Clear();
+
+	compressed = false;
+	componentBase.Clear();
+	componentSlot.Clear();
+	slotBias.Clear();
+	slotScale.Clear();
+	slotComponent.Clear();
+	quantizedFrames.Clear();
+	numSlots8 = 0;
+	numSlots12 = 0;
+	jointErrors.Clear();
 }
 
 /*
@@ -158,6 +177,8 @@ idMD5Anim::Allocated
 */
 size_t idMD5Anim::Allocated() const {
 	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size += componentBase.Allocated() + componentSlot.Allocated() + slotBias.Allocated() + slotScale.Allocated() + slotComponent.Allocated();
+	size += quantizedFrames.Allocated() + jointErrors.Allocated();
 	return size;
 }
 
@@ -181,6 +202,9 @@ bool idMD5Anim::LoadAnim( const char * filename ) {
 	idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
 	if ( binaryLoadAnim.GetBool() && LoadBinary( file, sourceTimeStamp ) ) {
 		name = filename;
+		if ( binaryCompressAnim.GetBool() ) {
+			Compress();
+		}
 		if ( cvarSystem->GetCVarBool( "fs_buildresources" ) ) {
 			// for resource gathering write this anim to the preload file for this map
 			fileSystem->AddAnimPreload( name );
@@ -351,6 +375,10 @@ bool idMD5Anim::LoadAnim( const char * filename ) {
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 
+	if ( binaryCompressAnim.GetBool() ) {
+		Compress();
+	}
+
 	if ( binaryLoadAnim.GetBool() ) {
 		idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
 		idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
@@ -374,7 +402,13 @@ bool idMD5Anim::LoadBinary( idFile * file, ID_TIME_T sourceTimeStamp ) {
 
 	unsigned int magic = 0;
 	file->ReadBig( magic );
-	if ( magic != B_ANIM_MD5_MAGIC ) {
+	if ( magic != B_ANIM_MD5_MAGIC && magic != B_ANIM_MD5_PACKED_MAGIC ) {
+		return false;
+	}
+
+	// regenerate the file when the compression setting has changed
+	const bool packed = ( magic == B_ANIM_MD5_PACKED_MAGIC );
+	if ( !fileSystem->InProductionMode() && packed != binaryCompressAnim.GetBool() ) {
 		return false;
 	}
 
@@ -429,10 +463,48 @@ bool idMD5Anim::LoadBinary( idFile * file, ID_TIME_T sourceTimeStamp ) {
 		j.w = 0.0f;
 	}
 
-	file->ReadBig( num );
-	componentFrames.SetNum( num + JOINT_FRAME_PAD );
-	for ( int i = 0; i < componentFrames.Num(); i++ ) {
-		file->ReadFloat( componentFrames[i] );
+	if ( packed ) {
+		componentFrames.Clear();
+
+		file->ReadBig( num );
+		componentBase.SetNum( num );
+		componentSlot.SetNum( num );
+		file->ReadBigArray( componentBase.Ptr(), num );
+		file->ReadBigArray( componentSlot.Ptr(), num );
+
+		file->ReadBig( num );
+		slotBias.SetNum( num );
+		slotScale.SetNum( num );
+		slotComponent.SetNum( num );
+		file->ReadBigArray( slotBias.Ptr(), num );
+		file->ReadBigArray( slotScale.Ptr(), num );
+		file->ReadBigArray( slotComponent.Ptr(), num );
+
+		file->ReadBig( numSlots8 );
+		file->ReadBig( numSlots12 );
+		file->ReadBig( num );
+		if ( numSlots8 < 0 || numSlots12 < 0 || numSlots8 + numSlots12 > slotBias.Num() ||
+				num != numFrames * QuantizedFrameSize( numSlots8, numSlots12, slotBias.Num() ) ) {
+			return false;
+		}
+		quantizedFrames.SetNum( num );
+		file->Read( quantizedFrames.Ptr(), num );
+
+		file->ReadBig( num );
+		jointErrors.SetNum( num );
+		for ( int i = 0; i < num; i++ ) {
+			file->ReadBig( jointErrors[i].x );
+			file->ReadBig( jointErrors[i].y );
+		}
+
+		compressed = true;
+	} else {
+		file->ReadBig( num );
+		componentFrames.SetNum( num + JOINT_FRAME_PAD );
+		for ( int i = 0; i < componentFrames.Num(); i++ ) {
+			file->ReadFloat( componentFrames[i] );
+		}
+		compressed = false;
 	}
 
 	//file->ReadString( name );
@@ -453,7 +525,7 @@ void idMD5Anim::WriteBinary( idFile * file, ID_TIME_T sourceTimeStamp ) {
 		return;
 	}
 
-	file->WriteBig( B_ANIM_MD5_MAGIC );
+	file->WriteBig( compressed ? B_ANIM_MD5_PACKED_MAGIC : B_ANIM_MD5_MAGIC );
 	file->WriteBig( sourceTimeStamp );
 
 	file->WriteBig( numFrames );
@@ -489,9 +561,31 @@ void idMD5Anim::WriteBinary( idFile * file, ID_TIME_T sourceTimeStamp ) {
 		file->WriteVec3( j.t );
 	}
 
-	file->WriteBig( componentFrames.Num() - JOINT_FRAME_PAD );
-	for ( int i = 0; i < componentFrames.Num(); i++ ) {
-		file->WriteFloat( componentFrames[i] );
+	if ( compressed ) {
+		file->WriteBig( componentBase.Num() );
+		file->WriteBigArray( componentBase.Ptr(), componentBase.Num() );
+		file->WriteBigArray( componentSlot.Ptr(), componentSlot.Num() );
+
+		file->WriteBig( slotBias.Num() );
+		file->WriteBigArray( slotBias.Ptr(), slotBias.Num() );
+		file->WriteBigArray( slotScale.Ptr(), slotScale.Num() );
+		file->WriteBigArray( slotComponent.Ptr(), slotComponent.Num() );
+
+		file->WriteBig( numSlots8 );
+		file->WriteBig( numSlots12 );
+		file->WriteBig( quantizedFrames.Num() );
+		file->Write( quantizedFrames.Ptr(), quantizedFrames.Num() );
+
+		file->WriteBig( jointErrors.Num() );
+		for ( int i = 0; i < jointErrors.Num(); i++ ) {
+			file->WriteBig( jointErrors[i].x );
+			file->WriteBig( jointErrors[i].y );
+		}
+	} else {
+		file->WriteBig( componentFrames.Num() - JOINT_FRAME_PAD );
+		for ( int i = 0; i < componentFrames.Num(); i++ ) {
+			file->WriteFloat( componentFrames[i] );
+		}
 	}
 
 	//file->WriteString( name );
@@ -499,6 +593,335 @@ void idMD5Anim::WriteBinary( idFile * file, ID_TIME_T sourceTimeStamp ) {
 	//file->WriteBig( ref_count );
 }
 
+/*
+====================
+QuantizedFrameSize
+
+The 8 bit slots come first, then the 12 bit slots packed in pairs into 3 bytes, then the 16 bit slots.
+====================
+*/
+static int QuantizedFrameSize( const int numSlots8, const int numSlots12, const int numSlots ) {
+	return numSlots8 + ( ( numSlots12 + 1 ) >> 1 ) * 3 + ( numSlots - numSlots8 - numSlots12 ) * 2;
+}
+
+/*
+====================
+GetQuantizedSlot
+====================
+*/
+static ID_INLINE int GetQuantizedSlot( const byte * frame, int slot, const int numSlots8, const int numSlots12 ) {
+	if ( slot < numSlots8 ) {
+		return frame[slot];
+	}
+	slot -= numSlots8;
+	if ( slot < numSlots12 ) {
+		const byte * p = frame + numSlots8 + ( slot >> 1 ) * 3;
+		return ( slot & 1 ) ? ( ( p[1] >> 4 ) | ( p[2] << 4 ) ) : ( p[0] | ( ( p[1] & 0x0F ) << 8 ) );
+	}
+	const byte * p = frame + numSlots8 + ( ( numSlots12 + 1 ) >> 1 ) * 3 + ( slot - numSlots12 ) * 2;
+	return p[0] | ( p[1] << 8 );
+}
+
+/*
+====================
+SetQuantizedSlot
+====================
+*/
+static void SetQuantizedSlot( byte * frame, int slot, const int numSlots8, const int numSlots12, const int value ) {
+	if ( slot < numSlots8 ) {
+		frame[slot] = (byte)value;
+		return;
+	}
+	slot -= numSlots8;
+	if ( slot < numSlots12 ) {
+		byte * p = frame + numSlots8 + ( slot >> 1 ) * 3;
+		if ( slot & 1 ) {
+			p[1] = (byte)( ( p[1] & 0x0F ) | ( ( value & 0x0F ) << 4 ) );
+			p[2] = (byte)( value >> 4 );
+		} else {
+			p[0] = (byte)value;
+			p[1] = (byte)( ( p[1] & 0xF0 ) | ( value >> 8 ) );
+		}
+		return;
+	}
+	byte * p = frame + numSlots8 + ( ( numSlots12 + 1 ) >> 1 ) * 3 + ( slot - numSlots12 ) * 2;
+	p[0] = (byte)value;
+	p[1] = (byte)( value >> 8 );
+}
+
+/*
+====================
+DecompressFrame
+
+Dequantizes one frame of a compressed anim into the layout of an uncompressed frame.
+====================
+*/
+static void DecompressFrame( float * components, const byte * frame, const float * componentBase,
+							const float * slotBias, const float * slotScale, const int * slotComponent, const int numComponents,
+							const int numSlots, const int numSlots8, const int numSlots12 ) {
+	// the constant components
+	memcpy( components, componentBase, numComponents * sizeof( components[0] ) );
+
+	// unpack the slots of each width
+	int * quantized = (int *)_alloca16( ( numSlots + 3 ) * sizeof( quantized[0] ) );
+	int i = 0;
+	for ( ; i < numSlots8; i++ ) {
+		quantized[i] = frame[i];
+	}
+	const byte * p = frame + numSlots8;
+	for ( int j = 0; j < numSlots12; j += 2, p += 3 ) {
+		quantized[i++] = p[0] | ( ( p[1] & 0x0F ) << 8 );
+		if ( j + 1 < numSlots12 ) {
+			quantized[i++] = ( p[1] >> 4 ) | ( p[2] << 4 );
+		}
+	}
+	for ( ; i < numSlots; i++, p += 2 ) {
+		quantized[i] = p[0] | ( p[1] << 8 );
+	}
+
+	i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	ALIGN16( float values[4] );
+
+	for ( ; i + 3 < numSlots; i += 4 ) {
+		const __m128 v = _mm_cvtepi32_ps( _mm_load_si128( (const __m128i *)( quantized + i ) ) );
+		_mm_store_ps( values, _mm_add_ps( _mm_loadu_ps( slotBias + i ), _mm_mul_ps( v, _mm_loadu_ps( slotScale + i ) ) ) );
+		components[slotComponent[i+0]] = values[0];
+		components[slotComponent[i+1]] = values[1];
+		components[slotComponent[i+2]] = values[2];
+		components[slotComponent[i+3]] = values[3];
+	}
+
+#endif
+
+	for ( ; i < numSlots; i++ ) {
+		components[slotComponent[i]] = slotBias[i] + (float)quantized[i] * slotScale[i];
+	}
+}
+
+/*
+====================
+idMD5Anim::GetFrameComponents
+
+Returns a pointer to the components of a frame, decompressing them into the buffer when
+the anim is compressed. The buffer needs room for numComponents + JOINT_FRAME_PAD floats.
+====================
+*/
+const float * idMD5Anim::GetFrameComponents( int framenum, int firstComponent, int numComponents, float *buffer ) const {
+	if ( !compressed ) {
+		return &componentFrames[ numAnimatedComponents * framenum + firstComponent ];
+	}
+
+	numComponents = Min( numComponents, numAnimatedComponents - firstComponent );
+
+	const int numSlots = slotBias.Num();
+	const byte * frame = quantizedFrames.Ptr() + framenum * QuantizedFrameSize( numSlots8, numSlots12, numSlots );
+
+	if ( firstComponent == 0 && numComponents == numAnimatedComponents ) {
+		DecompressFrame( buffer, frame, componentBase.Ptr(), slotBias.Ptr(), slotScale.Ptr(), slotComponent.Ptr(), numComponents, numSlots, numSlots8, numSlots12 );
+	} else {
+		for ( int i = 0; i < numComponents; i++ ) {
+			const int slot = componentSlot[ firstComponent + i ];
+			if ( slot < 0 ) {
+				buffer[i] = componentBase[ firstComponent + i ];
+			} else {
+				buffer[i] = slotBias[slot] + (float)GetQuantizedSlot( frame, slot, numSlots8, numSlots12 ) * slotScale[slot];
+			}
+		}
+	}
+	buffer[numComponents] = 0.0f;
+
+	return buffer;
+}
+
+/*
+====================
+idMD5Anim::Compress
+
+Components that stay within the error bound over the whole anim are stored once. The
+others are quantized over their range with the fewest bits out of 8, 12 and 16 that
+keep the quantization error within the bound. The largest error of each joint is kept
+for listAnimCompression.
+====================
+*/
+void idMD5Anim::Compress() {
+	if ( compressed || numAnimatedComponents == 0 || numFrames == 0 ) {
+		return;
+	}
+
+	const float translationError = Max( binaryCompressAnimTranslationError.GetFloat(), 0.0f );
+	const float rotationError = Max( binaryCompressAnimRotationError.GetFloat(), 0.0f );
+
+	// find the joint and the type of each component
+	idList<int> componentJoint;
+	idList<bool> componentIsRotation;
+	componentJoint.SetNum( numAnimatedComponents );
+	componentIsRotation.SetNum( numAnimatedComponents );
+	for ( int i = 0; i < jointInfo.Num(); i++ ) {
+		const jointAnimInfo_t & info = jointInfo[i];
+		int component = info.firstComponent;
+		for ( int bit = ANIM_BIT_TX; bit <= ANIM_BIT_QZ; bit++ ) {
+			if ( info.animBits & BIT( bit ) ) {
+				componentJoint[component] = i;
+				componentIsRotation[component] = ( bit >= ANIM_BIT_QX );
+				component++;
+			}
+		}
+	}
+
+	// pick the number of bits for each component, 0 when it is constant
+	idList<int> componentBits;
+	idList<float> componentMin;
+	idList<float> componentMax;
+	componentBits.SetNum( numAnimatedComponents );
+	componentMin.SetNum( numAnimatedComponents );
+	componentMax.SetNum( numAnimatedComponents );
+	componentBase.SetNum( numAnimatedComponents );
+	componentSlot.SetNum( numAnimatedComponents );
+
+	for ( int i = 0; i < numAnimatedComponents; i++ ) {
+		float minValue = idMath::INFINITY;
+		float maxValue = -idMath::INFINITY;
+		for ( int j = 0; j < numFrames; j++ ) {
+			const float value = componentFrames[ j * numAnimatedComponents + i ];
+			minValue = Min( minValue, value );
+			maxValue = Max( maxValue, value );
+		}
+		componentMin[i] = minValue;
+		componentMax[i] = maxValue;
+
+		// the quantization error is half a step
+		const float maxError = componentIsRotation[i] ? rotationError : translationError;
+		const float range = maxValue - minValue;
+		if ( range <= 2.0f * maxError ) {
+			componentBits[i] = 0;
+		} else if ( range <= 2.0f * maxError * 255.0f ) {
+			componentBits[i] = 8;
+		} else if ( range <= 2.0f * maxError * 4095.0f ) {
+			componentBits[i] = 12;
+		} else {
+			componentBits[i] = 16;
+		}
+	}
+
+	// the slots are sorted by the number of bits
+	slotBias.Clear();
+	slotScale.Clear();
+	slotComponent.Clear();
+	numSlots8 = numSlots12 = 0;
+
+	for ( int i = 0; i < numAnimatedComponents; i++ ) {
+		if ( componentBits[i] == 0 ) {
+			componentBase[i] = ( componentMin[i] + componentMax[i] ) * 0.5f;
+			componentSlot[i] = -1;
+		}
+	}
+	for ( int bits = 8; bits <= 16; bits += 4 ) {
+		for ( int i = 0; i < numAnimatedComponents; i++ ) {
+			if ( componentBits[i] != bits ) {
+				continue;
+			}
+			componentBase[i] = componentMin[i];
+			componentSlot[i] = slotBias.Append( componentMin[i] );
+			slotScale.Append( ( componentMax[i] - componentMin[i] ) / (float)( ( 1 << bits ) - 1 ) );
+			slotComponent.Append( i );
+			if ( bits == 8 ) {
+				numSlots8++;
+			} else if ( bits == 12 ) {
+				numSlots12++;
+			}
+		}
+	}
+
+	const int numSlots = slotBias.Num();
+	const int frameSize = QuantizedFrameSize( numSlots8, numSlots12, numSlots );
+	quantizedFrames.SetNum( numFrames * frameSize );
+	memset( quantizedFrames.Ptr(), 0, quantizedFrames.Num() );
+	for ( int j = 0; j < numFrames; j++ ) {
+		byte * frame = quantizedFrames.Ptr() + j * frameSize;
+		for ( int i = 0; i < numSlots; i++ ) {
+			const int maxQuantized = ( 1 << componentBits[ slotComponent[i] ] ) - 1;
+			const float value = componentFrames[ j * numAnimatedComponents + slotComponent[i] ];
+			SetQuantizedSlot( frame, i, numSlots8, numSlots12, idMath::ClampInt( 0, maxQuantized, idMath::Ftoi( ( value - slotBias[i] ) / slotScale[i] + 0.5f ) ) );
+		}
+	}
+
+	// measure the error against the source frames
+	jointErrors.SetNum( jointInfo.Num() );
+	for ( int i = 0; i < jointErrors.Num(); i++ ) {
+		jointErrors[i].Zero();
+	}
+	for ( int j = 0; j < numFrames; j++ ) {
+		const byte * frame = quantizedFrames.Ptr() + j * frameSize;
+		for ( int i = 0; i < numAnimatedComponents; i++ ) {
+			const int slot = componentSlot[i];
+			float value;
+			if ( slot < 0 ) {
+				value = componentBase[i];
+			} else {
+				value = slotBias[slot] + (float)GetQuantizedSlot( frame, slot, numSlots8, numSlots12 ) * slotScale[slot];
+			}
+			const float error = idMath::Fabs( value - componentFrames[ j * numAnimatedComponents + i ] );
+			idVec2 & jointError = jointErrors[ componentJoint[i] ];
+			if ( componentIsRotation[i] ) {
+				jointError.y = Max( jointError.y, error );
+			} else {
+				jointError.x = Max( jointError.x, error );
+			}
+		}
+	}
+
+	componentFrames.Clear();
+	compressed = true;
+}
+
+/*
+====================
+idMD5Anim::GetCompressionInfo
+
+numCurves gets the number of animated components stored with 8, 12 and 16 bits
+====================
+*/
+void idMD5Anim::GetCompressionInfo( size_t &rawSize, size_t &packedSize, idVec2 &maxError, int numCurves[3] ) const {
+	rawSize = ( numAnimatedComponents * numFrames + JOINT_FRAME_PAD ) * sizeof( float );
+	maxError.Zero();
+	numCurves[0] = numCurves[1] = numCurves[2] = 0;
+	if ( !compressed ) {
+		packedSize = componentFrames.Num() * sizeof( float );
+		return;
+	}
+
+	packedSize = componentBase.Num() * sizeof( float ) + componentSlot.Num() * sizeof( int );
+	packedSize += slotBias.Num() * ( sizeof( float ) + sizeof( float ) + sizeof( int ) ) + quantizedFrames.Num();
+	for ( int i = 0; i < jointErrors.Num(); i++ ) {
+		maxError.x = Max( maxError.x, jointErrors[i].x );
+		maxError.y = Max( maxError.y, jointErrors[i].y );
+	}
+	numCurves[0] = numSlots8;
+	numCurves[1] = numSlots12;
+	numCurves[2] = slotBias.Num() - numSlots8 - numSlots12;
+}
+
+/*
+====================
+idMD5Anim::PrintJointErrors
+====================
+*/
+void idMD5Anim::PrintJointErrors() const {
+	if ( !compressed ) {
+		gameLocal.Printf( "'%s' is not compressed\n", name.c_str() );
+		return;
+	}
+
+	gameLocal.Printf( "translation rotation joint\n" );
+	for ( int i = 0; i < jointErrors.Num(); i++ ) {
+		const char * jointName = ( jointInfo[i].nameIndex >= 0 ) ? animationLib.JointName( jointInfo[i].nameIndex ) : "";
+		gameLocal.Printf( "%11.5f %8.6f %s\n", jointErrors[i].x, jointErrors[i].y, jointName );
+	}
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -613,8 +1036,10 @@ void idMD5Anim::GetOrigin( idVec3 &offset, int time, int cyclecount ) const {
 	frameBlend_t frame;
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float buffer1[6 + JOINT_FRAME_PAD];
+	float buffer2[6 + JOINT_FRAME_PAD];
+	const float *componentPtr1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, 3, buffer1 );
+	const float *componentPtr2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, 3, buffer2 );
 
 	if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 		offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -653,8 +1078,10 @@ void idMD5Anim::GetOriginRotation( idQuat &rotation, int time, int cyclecount )
 	frameBlend_t frame;
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float	*jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float	*jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float buffer1[6 + JOINT_FRAME_PAD];
+	float buffer2[6 + JOINT_FRAME_PAD];
+	const float	*jointframe1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, 6, buffer1 );
+	const float	*jointframe2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, 6, buffer2 );
 
 	if ( animBits & ANIM_TX ) {
 		jointframe1++;
@@ -765,8 +1192,10 @@ void idMD5Anim::GetBounds( idBounds &bnds, int time, int cyclecount ) const {
 	// origin position
 	idVec3 offset = baseFrame[ 0 ].t;
 	if ( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) ) {
-		const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		float buffer1[6 + JOINT_FRAME_PAD];
+		float buffer2[6 + JOINT_FRAME_PAD];
+		const float *componentPtr1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, 3, buffer1 );
+		const float *componentPtr2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, 3, buffer2 );
 
 		if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 			offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -868,8 +1297,15 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 	idJointQuat * blendJoints = (idJointQuat *)_alloca16( baseFrame.Num() * sizeof( blendJoints[ 0 ] ) );
 	int * lerpIndex = (int *)_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 
-	const float * frame1 = &componentFrames[frame.frame1 * numAnimatedComponents];
-	const float * frame2 = &componentFrames[frame.frame2 * numAnimatedComponents];
+	float * buffer1 = NULL;
+	float * buffer2 = NULL;
+	if ( compressed ) {
+		buffer1 = (float *)_alloca16( ( numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( buffer1[ 0 ] ) );
+		buffer2 = (float *)_alloca16( ( numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( buffer2[ 0 ] ) );
+	}
+
+	const float * frame1 = GetFrameComponents( frame.frame1, 0, numAnimatedComponents, buffer1 );
+	const float * frame2 = GetFrameComponents( frame.frame2, 0, numAnimatedComponents, buffer2 );
 
 	int numLerpJoints = DecodeInterpolatedFrames( joints, blendJoints, lerpIndex, frame1, frame2, jointInfo.Ptr(), index, numIndexes );
 
@@ -941,7 +1377,12 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 		return;
 	}
 
-	const float * frame = &componentFrames[framenum * numAnimatedComponents];
+	float * buffer = NULL;
+	if ( compressed ) {
+		buffer = (float *)_alloca16( ( numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( buffer[ 0 ] ) );
+	}
+
+	const float * frame = GetFrameComponents( framenum, 0, numAnimatedComponents, buffer );
 
 	DecodeSingleFrame( joints, frame, jointInfo.Ptr(), index, numIndexes );
 }
@@ -1152,6 +1593,50 @@ void idAnimManager::ListAnims() const {
 	gameLocal.Printf( "%d memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
+/*
+================
+idAnimManager::ListAnimCompression
+================
+*/
+void idAnimManager::ListAnimCompression( const char *animname ) const {
+	size_t	totalRaw = 0;
+	size_t	totalPacked = 0;
+	int		totalCurves[3] = { 0, 0, 0 };
+	int		num = 0;
+
+	for( int i = 0; i < animations.Num(); i++ ) {
+		idMD5Anim * const *animptr = animations.GetIndex( i );
+		if ( animptr == NULL || *animptr == NULL ) {
+			continue;
+		}
+		const idMD5Anim *anim = *animptr;
+		if ( animname != NULL && animname[0] != '\0' && idStr::Icmp( anim->Name(), animname ) != 0 ) {
+			continue;
+		}
+
+		size_t rawSize, packedSize;
+		idVec2 maxError;
+		int numCurves[3];
+		anim->GetCompressionInfo( rawSize, packedSize, maxError, numCurves );
+		gameLocal.Printf( "%8d -> %8d bytes (%5.2f:1) : %4d / %4d / %4d curves : max error %.5f / %.6f : %s\n", (int)rawSize, (int)packedSize,
+			packedSize ? (float)rawSize / packedSize : 0.0f, numCurves[0], numCurves[1], numCurves[2], maxError.x, maxError.y, anim->Name() );
+		if ( animname != NULL && animname[0] != '\0' ) {
+			anim->PrintJointErrors();
+		}
+
+		totalRaw += rawSize;
+		totalPacked += packedSize;
+		for ( int j = 0; j < 3; j++ ) {
+			totalCurves[j] += numCurves[j];
+		}
+		num++;
+	}
+
+	gameLocal.Printf( "\n%d anims: %d KB of frames, %d KB compressed, achieved ratio %.2f:1\n", num, (int)( totalRaw >> 10 ), (int)( totalPacked >> 10 ),
+		totalPacked ? (float)totalRaw / totalPacked : 0.0f );
+	gameLocal.Printf( "%d 8 bit, %d 12 bit and %d 16 bit curves\n", totalCurves[0], totalCurves[1], totalCurves[2] );
+}
+
 /*
 ================
 idAnimManager::FlushUnusedAnims
@@ -202,6 +202,19 @@ private:
 	idList<jointAnimInfo_t, TAG_MD5_ANIM>	jointInfo;
 	idList<idJointQuat, TAG_MD5_ANIM>		baseFrame;
 	idList<float, TAG_MD5_ANIM>			componentFrames;
+
+	// quantized frames used instead of componentFrames when the anim is compressed
+	bool					compressed;
+	idList<float, TAG_MD5_ANIM>			componentBase;		// constant value or quantization bias of each component
+	idList<int, TAG_MD5_ANIM>			componentSlot;		// index of each component in a quantized frame, -1 when constant
+	idList<float, TAG_MD5_ANIM>			slotBias;
+	idList<float, TAG_MD5_ANIM>			slotScale;
+	idList<int, TAG_MD5_ANIM>			slotComponent;
+	idList<byte, TAG_MD5_ANIM>			quantizedFrames;	// per frame the 8 bit slots, then the 12 bit slots packed in pairs, then the 16 bit slots
+	int						numSlots8;
+	int						numSlots12;
+	idList<idVec2, TAG_MD5_ANIM>		jointErrors;		// max translation and rotation error of each joint after compression
+
 	idStr					name;
 	idVec3					totaldelta;
 	mutable int				ref_count;
@@ -217,6 +230,10 @@ public:
 	bool					LoadAnim( const char *filename );
 	bool					LoadBinary( idFile * file, ID_TIME_T sourceTimeStamp );
 	void					WriteBinary( idFile * file, ID_TIME_T sourceTimeStamp );
+	void					Compress();
+	bool					IsCompressed() const { return compressed; }
+	void					GetCompressionInfo( size_t &rawSize, size_t &packedSize, idVec2 &maxError, int numCurves[3] ) const;
+	void					PrintJointErrors() const;
 
 	void					IncreaseRefs() const;
 	void					DecreaseRefs() const;
@@ -237,6 +254,9 @@ public:
 	void					GetOrigin( idVec3 &offset, int currentTime, int cyclecount ) const;
 	void					GetOriginRotation( idQuat &rotation, int time, int cyclecount ) const;
 	void					GetBounds( idBounds &bounds, int currentTime, int cyclecount ) const;
+
+private:
+	const float *			GetFrameComponents( int framenum, int firstComponent, int numComponents, float *buffer ) const;
 };
 
 /*
@@ -491,6 +511,8 @@ public:
 	void						ForceUpdate();
 	void						ClearForceUpdate();
 	bool						CreateFrame( int animtime, bool force );
+	bool						NeedsFrame( int animtime ) const;
+	void						CreateFrameParallel( int animtime );
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -550,6 +572,7 @@ private:
 
 	mutable int					lastTransformTime;		// mutable because the value is updated in CreateFrame
 	mutable bool				stoppedAnimatingUpdate;
+	int							parallelFrameTime;		// time of a frame built by the parallel animation stage that hasn't been reported as an update yet
 	bool						removeOriginOffset;
 	bool						forceUpdate;
 
@@ -583,6 +606,7 @@ public:
 	void						Preload( const idPreloadManifest &manifest );
 	void						ReloadAnims();
 	void						ListAnims() const;
+	void						ListAnimCompression( const char *animname ) const;
 	int							JointIndex( const char *name );
 	const char *				JointName( int index ) const;
 
@@ -3096,6 +3096,7 @@ idAnimator::idAnimator() {
 	joints					= NULL;
 	lastTransformTime		= -1;
 	stoppedAnimatingUpdate	= false;
+	parallelFrameTime		= -1;
 	removeOriginOffset		= false;
 	forceUpdate				= false;
 
@@ -3246,6 +3247,7 @@ void idAnimator::Restore( idRestoreGame *savefile ) {
 	savefile->ReadInt( lastTransformTime );
 	savefile->ReadBool( stoppedAnimatingUpdate );
 	savefile->ReadBool( forceUpdate );
+	parallelFrameTime = -1;
 	savefile->ReadBounds( frameBounds );
 
 	savefile->ReadFloat( AFPoseBlendWeight );
@@ -3680,6 +3682,13 @@ void idAnimator::SetJointPos( jointHandle_t jointnum, jointModTransform_t transf
 		jointMod->mat.Identity();
 		jointMod->transform_axis = JOINTMOD_NONE;
 		jointMods.Insert( jointMod, i );
+	} else if ( jointMod->transform_pos == transform_type && jointMod->pos == pos ) {
+		// animation controllers set the same value every frame while nothing moves,
+		// keep the current frame which may have been built by the parallel animation stage
+		if ( entity ) {
+			entity->BecomeActive( TH_ANIMATE );
+		}
+		return;
 	}
 
 	jointMod->pos = pos;
@@ -3720,6 +3729,12 @@ void idAnimator::SetJointAxis( jointHandle_t jointnum, jointModTransform_t trans
 		jointMod->pos.Zero();
 		jointMod->transform_pos = JOINTMOD_NONE;
 		jointMods.Insert( jointMod, i );
+	} else if ( jointMod->transform_axis == transform_type && jointMod->mat == mat ) {
+		// same as SetJointPos, an unchanged joint mod keeps the current frame
+		if ( entity ) {
+			entity->BecomeActive( TH_ANIMATE );
+		}
+		return;
 	}
 
 	jointMod->mat = mat;
@@ -4280,6 +4295,11 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 
 	if ( !force && !r_showSkel.GetInteger() ) {
 		if ( lastTransformTime == currentTime ) {
+			if ( parallelFrameTime == currentTime ) {
+				// the frame was built by the parallel animation stage, so report it as updated once
+				parallelFrameTime = -1;
+				return true;
+			}
 			return false;
 		}
 		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
@@ -4495,6 +4515,44 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	return true;
 }
 
+/*
+=====================
+idAnimator::NeedsFrame
+
+Returns true if CreateFrame would build a new frame for the given time.
+=====================
+*/
+bool idAnimator::NeedsFrame( int currentTime ) const {
+	if ( !modelDef || !modelDef->ModelHandle() ) {
+		return false;
+	}
+
+	if ( lastTransformTime == currentTime ) {
+		return false;
+	}
+
+	if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+		return false;
+	}
+
+	return true;
+}
+
+/*
+=====================
+idAnimator::CreateFrameParallel
+
+Builds the frame on a job thread ahead of the render callback. Only touches the
+animator's own state, so any number of animators can be built at the same time.
+The next CreateFrame for the same time returns true without rebuilding the joints.
+=====================
+*/
+void idAnimator::CreateFrameParallel( int currentTime ) {
+	if ( CreateFrame( currentTime, false ) ) {
+		parallelFrameTime = currentTime;
+	}
+}
+
 /*
 =====================
 idAnimator::ForceUpdate
@@ -4502,6 +4560,7 @@ idAnimator::ForceUpdate
 */
 void idAnimator::ForceUpdate() {
 	lastTransformTime = -1;
+	parallelFrameTime = -1;
 	forceUpdate = true;
 }
 
@@ -172,6 +172,8 @@ class idSaveGame;
 class idRestoreGame;
 
 class idClass {
+	friend class idEvent;
+
 public:
 	ABSTRACT_PROTOTYPE( idClass );
 
@@ -246,6 +248,8 @@ private:
 
 	void						Event_SafeRemove();
 
+	idLinkList<idEvent>			eventList;		// events scheduled on this object, so they can be cancelled without searching the queues
+
 	static bool					initialized;
 	static idList<idTypeInfo *, TAG_IDCLASS>	types;
 	static idList<idTypeInfo *, TAG_IDCLASS>	typenums;
@@ -208,6 +208,307 @@ const idEventDef *idEventDef::FindEvent( const char *name ) {
 	return NULL;
 }
 
+/***********************************************************************
+
+  idEventWheel
+
+  Hierarchical timing wheel for the scheduled events. Level 0 has a slot
+  for every millisecond, every slot of a higher level covers the whole
+  range of the level below it. When the wheel reaches a higher level slot
+  its events are moved down, so scheduling and cancelling are O(1) instead
+  of a walk through a time sorted list.
+
+  Events are always serviced in time order, and in scheduling order for
+  events with the same time, exactly like the old sorted list.
+
+***********************************************************************/
+
+#define EVENT_WHEEL_BITS0			8
+#define EVENT_WHEEL_BITS			6
+#define EVENT_WHEEL_SIZE0			( 1 << EVENT_WHEEL_BITS0 )
+#define EVENT_WHEEL_SIZE			( 1 << EVENT_WHEEL_BITS )
+#define EVENT_WHEEL_LEVELS			3			// levels above level 0, events further out go in the overflow list
+
+#define EVENT_BLOCK_SIZE			1024		// events are allocated in blocks of this many when the free list runs out
+
+class idEventWheel {
+public:
+							idEventWheel();
+
+	void					Clear();
+	void					Add( idEvent *event, int now );
+	void					Remove( idEvent *event );
+	idEvent *				NextDue( int now );
+	int						Num() const { return numEvents; }
+	void					GetSorted( idList<idEvent *> &list ) const;
+
+private:
+	idLinkList<idEvent>		slots0[ EVENT_WHEEL_SIZE0 ];
+	idLinkList<idEvent>		slots[ EVENT_WHEEL_LEVELS ][ EVENT_WHEEL_SIZE ];
+	idLinkList<idEvent>		overflow;
+	int						currentTime;	// earliest time not serviced yet, earlier events are kept in its slot
+	int						numEvents;
+
+	void					Insert( idEvent *event );
+	void					InsertSorted( idLinkList<idEvent> &slot, idEvent *event );
+	void					Reinsert( idLinkList<idEvent> &slot );
+	void					Cascade();
+	void					Rebase( int now );
+};
+
+class idSort_EventOrder : public idSort_Quick< idEvent *, idSort_EventOrder > {
+public:
+	int Compare( idEvent * const & a, idEvent * const & b ) const {
+		if ( a->time != b->time ) {
+			return a->time - b->time;
+		}
+		return a->sequence - b->sequence;
+	}
+};
+
+/*
+================
+idEventWheel::idEventWheel
+================
+*/
+idEventWheel::idEventWheel() {
+	currentTime = 0;
+	numEvents = 0;
+}
+
+/*
+================
+idEventWheel::Clear
+
+Only unlinks the events, they have to be freed by the caller
+================
+*/
+void idEventWheel::Clear() {
+	for ( int i = 0; i < EVENT_WHEEL_SIZE0; i++ ) {
+		slots0[ i ].Clear();
+	}
+	for ( int i = 0; i < EVENT_WHEEL_LEVELS; i++ ) {
+		for ( int j = 0; j < EVENT_WHEEL_SIZE; j++ ) {
+			slots[ i ][ j ].Clear();
+		}
+	}
+	overflow.Clear();
+
+	currentTime = 0;
+	numEvents = 0;
+}
+
+/*
+================
+idEventWheel::Add
+================
+*/
+void idEventWheel::Add( idEvent *event, int now ) {
+	if ( numEvents == 0 ) {
+		currentTime = Min( now, event->time );
+	} else if ( now < currentTime ) {
+		// the game time went backwards
+		Rebase( now );
+	}
+
+	event->queue = this;
+	numEvents++;
+	Insert( event );
+}
+
+/*
+================
+idEventWheel::Remove
+================
+*/
+void idEventWheel::Remove( idEvent *event ) {
+	assert( event->queue == this );
+	event->eventNode.Remove();
+	event->queue = NULL;
+	numEvents--;
+}
+
+/*
+================
+idEventWheel::Insert
+================
+*/
+void idEventWheel::Insert( idEvent *event ) {
+	const int delta = event->time - currentTime;
+
+	// events for earlier times go in the current slot, in front of the ones for the current time
+	if ( delta < EVENT_WHEEL_SIZE0 ) {
+		InsertSorted( slots0[ Max( event->time, currentTime ) & ( EVENT_WHEEL_SIZE0 - 1 ) ], event );
+		return;
+	}
+
+	int shift = EVENT_WHEEL_BITS0;
+	for ( int level = 0; level < EVENT_WHEEL_LEVELS; level++ ) {
+		if ( ( delta >> ( shift + EVENT_WHEEL_BITS ) ) == 0 ) {
+			event->eventNode.AddToEnd( slots[ level ][ ( event->time >> shift ) & ( EVENT_WHEEL_SIZE - 1 ) ] );
+			return;
+		}
+		shift += EVENT_WHEEL_BITS;
+	}
+
+	event->eventNode.AddToEnd( overflow );
+}
+
+/*
+================
+idEventWheel::InsertSorted
+
+Level 0 slots are kept sorted by time and sequence. Events are almost always
+scheduled after everything already in the slot, so this searches from the end.
+================
+*/
+void idEventWheel::InsertSorted( idLinkList<idEvent> &slot, idEvent *event ) {
+	idEvent *prev = slot.Prev();
+	while( prev != NULL ) {
+		if ( ( prev->time < event->time ) || ( ( prev->time == event->time ) && ( prev->sequence < event->sequence ) ) ) {
+			break;
+		}
+		prev = prev->eventNode.Prev();
+	}
+
+	if ( prev != NULL ) {
+		event->eventNode.InsertAfter( prev->eventNode );
+	} else {
+		event->eventNode.AddToFront( slot );
+	}
+}
+
+/*
+================
+idEventWheel::Reinsert
+================
+*/
+void idEventWheel::Reinsert( idLinkList<idEvent> &slot ) {
+	idLinkList<idEvent> moving;
+	idEvent *event;
+
+	// move them out first, overflow events can go right back into the same list
+	while( ( event = slot.Next() ) != NULL ) {
+		event->eventNode.AddToEnd( moving );
+	}
+	while( ( event = moving.Next() ) != NULL ) {
+		event->eventNode.Remove();
+		Insert( event );
+	}
+}
+
+/*
+================
+idEventWheel::Cascade
+
+Called when currentTime reaches the start of a level 1 slot
+================
+*/
+void idEventWheel::Cascade() {
+	int shift = EVENT_WHEEL_BITS0;
+	for ( int level = 0; level < EVENT_WHEEL_LEVELS; level++ ) {
+		const int index = ( currentTime >> shift ) & ( EVENT_WHEEL_SIZE - 1 );
+		Reinsert( slots[ level ][ index ] );
+		if ( index != 0 ) {
+			return;
+		}
+		shift += EVENT_WHEEL_BITS;
+	}
+	Reinsert( overflow );
+}
+
+/*
+================
+idEventWheel::Rebase
+
+Rebuilds the wheel around a new time, keeping the event order
+================
+*/
+void idEventWheel::Rebase( int now ) {
+	idList<idEvent *> events;
+	GetSorted( events );
+
+	for ( int i = 0; i < events.Num(); i++ ) {
+		events[ i ]->eventNode.Remove();
+	}
+
+	currentTime = now;
+	if ( events.Num() > 0 ) {
+		currentTime = Min( now, events[ 0 ]->time );
+	}
+
+	for ( int i = 0; i < events.Num(); i++ ) {
+		Insert( events[ i ] );
+	}
+}
+
+/*
+================
+idEventWheel::NextDue
+
+Returns the next event to service at time now, or NULL if there are none left.
+The event stays in the queue.
+================
+*/
+idEvent *idEventWheel::NextDue( int now ) {
+	if ( numEvents == 0 ) {
+		return NULL;
+	}
+
+	if ( now < currentTime ) {
+		// the game time went backwards
+		Rebase( now );
+	}
+
+	while( 1 ) {
+		idEvent *event = slots0[ currentTime & ( EVENT_WHEEL_SIZE0 - 1 ) ].Next();
+		if ( event != NULL ) {
+			return ( event->time <= now ) ? event : NULL;
+		}
+
+		// stop at now, so events scheduled for now while servicing go in this slot
+		if ( currentTime >= now ) {
+			return NULL;
+		}
+
+		currentTime++;
+		if ( ( currentTime & ( EVENT_WHEEL_SIZE0 - 1 ) ) == 0 ) {
+			Cascade();
+		}
+	}
+}
+
+/*
+================
+idEventWheel::GetSorted
+
+Lists the events in the order they will be serviced
+================
+*/
+void idEventWheel::GetSorted( idList<idEvent *> &list ) const {
+	idEvent *event;
+
+	list.SetNum( 0, numEvents );
+	for ( int i = 0; i < EVENT_WHEEL_SIZE0; i++ ) {
+		for ( event = slots0[ i ].Next(); event != NULL; event = event->eventNode.Next() ) {
+			list.Append( event );
+		}
+	}
+	for ( int i = 0; i < EVENT_WHEEL_LEVELS; i++ ) {
+		for ( int j = 0; j < EVENT_WHEEL_SIZE; j++ ) {
+			for ( event = slots[ i ][ j ].Next(); event != NULL; event = event->eventNode.Next() ) {
+				list.Append( event );
+			}
+		}
+	}
+	for ( event = overflow.Next(); event != NULL; event = event->eventNode.Next() ) {
+		list.Append( event );
+	}
+	assert( list.Num() == numEvents );
+
+	list.SortWithTemplate( idSort_EventOrder() );
+}
+
 /***********************************************************************
 
   idEvent
@@ -215,21 +516,57 @@ const idEventDef *idEventDef::FindEvent( const char *name ) {
 ***********************************************************************/
 
 static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
-static idLinkList<idEvent> FastEventQueue;
-static idEvent EventPool[ MAX_EVENTS ];
+static idEventWheel EventQueue;
+static idEventWheel FastEventQueue;
+static idList<idEvent *, TAG_EVENTS> EventBlocks;
+static int EventSequence;
 
 bool idEvent::initialized = false;
 
 idDynamicBlockAlloc<byte, 16 * 1024, 256>	idEvent::eventDataAllocator;
 
+/*
+================
+idEvent::idEvent
+================
+*/
+idEvent::idEvent() {
+	eventdef	= NULL;
+	data		= NULL;
+	time		= 0;
+	sequence	= 0;
+	object		= NULL;
+	typeinfo	= NULL;
+	queue		= NULL;
+	eventNode.SetOwner( this );
+	objectNode.SetOwner( this );
+}
+
 /*
 ================
 idEvent::~idEvent()
 ================
 */
 idEvent::~idEvent() {
-	Free();
+	// the nodes unlink themselves
+	if ( data ) {
+		eventDataAllocator.Free( data );
+		data = NULL;
+	}
+}
+
+/*
+================
+idEvent::AllocBlock
+================
+*/
+void idEvent::AllocBlock() {
+	idEvent *block = new (TAG_EVENTS) idEvent[ EVENT_BLOCK_SIZE ];
+	EventBlocks.Append( block );
+
+	for ( int i = 0; i < EVENT_BLOCK_SIZE; i++ ) {
+		block[ i ].eventNode.AddToEnd( FreeEvents );
+	}
 }
 
 /*
@@ -247,7 +584,7 @@ idEvent *idEvent::Alloc( const idEventDef *evdef, int numargs, va_list args ) {
 	const char	*materialName;
 
 	if ( FreeEvents.IsListEmpty() ) {
-		gameLocal.Error( "idEvent::Alloc : No more free events" );
+		AllocBlock();
 	}
 
 	ev = FreeEvents.Next();
@@ -357,12 +694,28 @@ void idEvent::CopyArgs( const idEventDef *evdef, int numargs, va_list args, int
 	}
 }
 
+/*
+================
+idEvent::Unlink
+
+Takes the event out of its queue and its object's event list
+================
+*/
+void idEvent::Unlink() {
+	if ( queue != NULL ) {
+		queue->Remove( this );
+	}
+	objectNode.Remove();
+}
+
 /*
 ================
 idEvent::Free
 ================
 */
 void idEvent::Free() {
+	Unlink();
+
 	if ( data ) {
 		eventDataAllocator.Free( data );
 		data = NULL;
@@ -370,6 +723,7 @@ void idEvent::Free() {
 
 	eventdef	= NULL;
 	time		= 0;
+	sequence	= 0;
 	object		= NULL;
 	typeinfo	= NULL;
 
@@ -383,47 +737,26 @@ idEvent::Schedule
 ================
 */
 void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
-	idEvent *event;
-
 	assert( initialized );
 	if ( !initialized ) {
 		return;
 	}
 
+	Unlink();
+
 	object = obj;
 	typeinfo = type;
+	sequence = EventSequence++;
 
-	// wraps after 24 days...like I care. ;)
-	this->time = gameLocal.time + time;
-
-	eventNode.Remove();
+	objectNode.AddToEnd( obj->eventList );
 
+	// wraps after 24 days...like I care. ;)
 	if ( obj->IsType( idEntity::Type ) && ( ( (idEntity*)(obj) )->timeGroup == TIME_GROUP2 ) ) {
-		event = FastEventQueue.Next();
-		while( ( event != NULL ) && ( this->time >= event->time ) ) {
-			event = event->eventNode.Next();
-		}
-
-		if ( event ) {
-			eventNode.InsertBefore( event->eventNode );
-		} else {
-			eventNode.AddToEnd( FastEventQueue );
-		}
-
-		return;
+		this->time = gameLocal.time + time;
+		FastEventQueue.Add( this, gameLocal.fast.time );
 	} else {
 		this->time = gameLocal.slow.time + time;
-	}
-
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) ) {
-		event = event->eventNode.Next();
-	}
-
-	if ( event ) {
-		eventNode.InsertBefore( event->eventNode );
-	} else {
-		eventNode.AddToEnd( EventQueue );
+		EventQueue.Add( this, gameLocal.time );
 	}
 }
 
@@ -440,21 +773,10 @@ void idEvent::CancelEvents( const idClass *obj, const idEventDef *evdef ) {
 		return;
 	}
 
-	for( event = EventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
-		}
-	}
-
-	for( event = FastEventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
+	for( event = obj->eventList.Next(); event != NULL; event = next ) {
+		next = event->objectNode.Next();
+		if ( !evdef || ( evdef == event->eventdef ) ) {
+			event->Free();
 		}
 	}
 }
@@ -466,27 +788,38 @@ idEvent::ClearEventList
 */
 void idEvent::ClearEventList() {
 	int i;
+	int j;
 
 	//
 	// initialize lists
 	//
 	FreeEvents.Clear();
 	EventQueue.Clear();
-   
+	FastEventQueue.Clear();
+	EventSequence = 0;
+
+	if ( EventBlocks.Num() == 0 ) {
+		AllocBlock();
+	}
+
 	// 
 	// add the events to the free list
 	//
-	for( i = 0; i < MAX_EVENTS; i++ ) {
-		EventPool[ i ].Free();
+	for( i = 0; i < EventBlocks.Num(); i++ ) {
+		for( j = 0; j < EVENT_BLOCK_SIZE; j++ ) {
+			// the queues are already cleared
+			EventBlocks[ i ][ j ].queue = NULL;
+			EventBlocks[ i ][ j ].Free();
+		}
 	}
 }
 
 /*
 ================
-idEvent::ServiceEvents
+idEvent::ServiceQueue
 ================
 */
-void idEvent::ServiceEvents() {
+void idEvent::ServiceQueue( idEventWheel &queue, int now, bool updatePacifier ) {
 	idEvent		*event;
 	int			num;
 	int			args[ D_EVENT_MAXARGS ];
@@ -500,16 +833,11 @@ void idEvent::ServiceEvents() {
 	const char  *materialName;
 
 	num = 0;
-	while( !EventQueue.IsListEmpty() ) {
-		event = EventQueue.Next();
-		assert( event );
-
-		if ( event->time > gameLocal.time ) {
-			break;
+	while( ( event = queue.NextDue( now ) ) != NULL ) {
+		if ( updatePacifier ) {
+			common->UpdateLevelLoadPacifier();
 		}
 
-		common->UpdateLevelLoadPacifier();
-
 		// copy the data into the local args array and set up pointers
 		ev = event->eventdef;
 		formatspec = ev->GetArgFormat();
@@ -556,9 +884,9 @@ void idEvent::ServiceEvents() {
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		event->Unlink();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -582,103 +910,22 @@ void idEvent::ServiceEvents() {
 	}
 }
 
+/*
+================
+idEvent::ServiceEvents
+================
+*/
+void idEvent::ServiceEvents() {
+	ServiceQueue( EventQueue, gameLocal.time, true );
+}
+
 /*
 ================
 idEvent::ServiceFastEvents
 ================
 */
 void idEvent::ServiceFastEvents() {
-	idEvent	*event;
-	int		num;
-	int			args[ D_EVENT_MAXARGS ];
-	int			offset;
-	int			i;
-	int			numargs;
-	const char	*formatspec;
-	trace_t		**tracePtr;
-	const idEventDef *ev;
-	byte		*data;
-	const char  *materialName;
-
-	num = 0;
-	while( !FastEventQueue.IsListEmpty() ) {
-		event = FastEventQueue.Next();
-		assert( event );
-
-		if ( event->time > gameLocal.fast.time ) {
-			break;
-		}
-
-		// copy the data into the local args array and set up pointers
-		ev = event->eventdef;
-		formatspec = ev->GetArgFormat();
-		numargs = ev->GetNumArgs();
-		for( i = 0; i < numargs; i++ ) {
-			offset = ev->GetArgOffset( i );
-			data = event->data;
-			switch( formatspec[ i ] ) {
-			case D_EVENT_FLOAT :
-			case D_EVENT_INTEGER :
-				args[ i ] = *reinterpret_cast<int *>( &data[ offset ] );
-				break;
-
-			case D_EVENT_VECTOR :
-				*reinterpret_cast<idVec3 **>( &args[ i ] ) = reinterpret_cast<idVec3 *>( &data[ offset ] );
-				break;
-
-			case D_EVENT_STRING :
-				*reinterpret_cast<const char **>( &args[ i ] ) = reinterpret_cast<const char *>( &data[ offset ] );
-				break;
-
-			case D_EVENT_ENTITY :
-			case D_EVENT_ENTITY_NULL :
-				*reinterpret_cast<idEntity **>( &args[ i ] ) = reinterpret_cast< idEntityPtr<idEntity> * >( &data[ offset ] )->GetEntity();
-				break;
-
-			case D_EVENT_TRACE :
-				tracePtr = reinterpret_cast<trace_t **>( &args[ i ] );
-				if ( *reinterpret_cast<bool *>( &data[ offset ] ) ) {
-					*tracePtr = reinterpret_cast<trace_t *>( &data[ offset + sizeof( bool ) ] );
-
-					if ( ( *tracePtr )->c.material != NULL ) {
-						// look up the material name to get the material pointer
-						materialName = reinterpret_cast<const char *>( &data[ offset + sizeof( bool ) + sizeof( trace_t ) ] );
-						( *tracePtr )->c.material = declManager->FindMaterial( materialName, true );
-					}
-				} else {
-					*tracePtr = NULL;
-				}
-				break;
-
-			default:
-				gameLocal.Error( "idEvent::ServiceFastEvents : Invalid arg format '%s' string for '%s' event.", formatspec, ev->GetName() );
-			}
-		}
-
-		// the event is removed from its list so that if then object
-		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
-		assert( event->object );
-		event->object->ProcessEventArgPtr( ev, args );
-
-#if 0
-		// event functions may never leave return values on the FPU stack
-		// enable this code to check if any event call left values on the FPU stack
-		if ( !sys->FPU_StackIsEmpty() ) {
-			gameLocal.Error( "idEvent::ServiceEvents %d: %s left a value on the FPU stack\n", num, event->eventdef->GetName() );
-		}
-#endif
-
-		// return the event to the free list
-		event->Free();
-
-		// Don't allow ourselves to stay in here too long.  An abnormally high number
-		// of events being processed is evidence of an infinite loop of events.
-		num++;
-		if ( num > MAX_EVENTSPERFRAME ) {
-			gameLocal.Error( "Event overflow.  Possible infinite loop in script." );
-		}
-	}
+	ServiceQueue( FastEventQueue, gameLocal.fast.time, false );
 }
 
 /*
@@ -729,6 +976,12 @@ void idEvent::Shutdown() {
 	}
 
 	ClearEventList();
+
+	FreeEvents.Clear();
+	for ( int i = 0; i < EventBlocks.Num(); i++ ) {
+		delete[] EventBlocks[ i ];
+	}
+	EventBlocks.Clear();
 	
 	eventDataAllocator.Shutdown();
 
@@ -748,11 +1001,14 @@ void idEvent::Save( idSaveGame *savefile ) {
 	byte *dataPtr;
 	bool validTrace;
 	const char	*format;
+	idList<idEvent *> events;
 
-	savefile->WriteInt( EventQueue.Num() );
+	// write the events in the order they will be serviced
+	EventQueue.GetSorted( events );
+	savefile->WriteInt( events.Num() );
 
-	event = EventQueue.Next();
-	while( event != NULL ) {
+	for( int e = 0; e < events.Num(); e++ ) {
+		event = events[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -796,22 +1052,20 @@ void idEvent::Save( idSaveGame *savefile ) {
 			}
 		}
 		assert( size == (int)event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 
 	// Save the Fast EventQueue
-	savefile->WriteInt( FastEventQueue.Num() );
+	FastEventQueue.GetSorted( events );
+	savefile->WriteInt( events.Num() );
 
-	event = FastEventQueue.Next();
-	while( event != NULL ) {
+	for( int e = 0; e < events.Num(); e++ ) {
+		event = events[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
 		savefile->WriteObject( event->object );
 		savefile->WriteInt( event->eventdef->GetArgSize() );
 		savefile->Write( event->data, event->eventdef->GetArgSize() );
-
-		event = event->eventNode.Next();
 	}
 }
 
@@ -832,12 +1086,11 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 	for ( i = 0; i < num; i++ ) {
 		if ( FreeEvents.IsListEmpty() ) {
-			gameLocal.Error( "idEvent::Restore : No more free events" );
+			AllocBlock();
 		}
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -859,6 +1112,13 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		savefile->ReadObject( event->object );
 
+		// the events were saved in service order, so scheduling them in the same order keeps it
+		event->sequence = EventSequence++;
+		if ( event->object != NULL ) {
+			event->objectNode.AddToEnd( event->object->eventList );
+		}
+		EventQueue.Add( event, gameLocal.time );
+
 		// read the args
 		savefile->ReadInt( argsize );
 		if ( argsize != (int)event->eventdef->GetArgSize() ) {
@@ -914,12 +1174,11 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 	for ( i = 0; i < num; i++ ) {
 		if ( FreeEvents.IsListEmpty() ) {
-			gameLocal.Error( "idEvent::Restore : No more free events" );
+			AllocBlock();
 		}
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( FastEventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -941,6 +1200,13 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		savefile->ReadObject( event->object );
 
+		// the events were saved in service order, so scheduling them in the same order keeps it
+		event->sequence = EventSequence++;
+		if ( event->object != NULL ) {
+			event->objectNode.AddToEnd( event->object->eventList );
+		}
+		FastEventQueue.Add( event, gameLocal.fast.time );
+
 		// read the args
 		savefile->ReadInt( argsize );
 		if ( argsize != (int)event->eventdef->GetArgSize() ) {
@@ -84,23 +84,34 @@ public:
 
 class idSaveGame;
 class idRestoreGame;
+class idEventWheel;
 
 class idEvent {
+	friend class idEventWheel;
+	friend class idSort_EventOrder;
+
 private:
 	const idEventDef			*eventdef;
 	byte						*data;
 	int							time;
+	int							sequence;		// schedule order, keeps events with the same time in order
 	idClass						*object;
 	const idTypeInfo			*typeinfo;
+	idEventWheel				*queue;			// queue the event is scheduled in, NULL when free
 
-	idLinkList<idEvent>			eventNode;
+	idLinkList<idEvent>			eventNode;		// timing wheel slot, or the free list
+	idLinkList<idEvent>			objectNode;		// object's list of pending events
 
 	static idDynamicBlockAlloc<byte, 16 * 1024, 256> eventDataAllocator;
 
+	void						Unlink();
+	static void					AllocBlock();
+	static void					ServiceQueue( idEventWheel &queue, int now, bool updatePacifier );
 
 public:
 	static bool					initialized;
 
+								idEvent();
 								~idEvent();
 
 	static idEvent				*Alloc( const idEventDef *evdef, int numargs, va_list args );
@@ -1313,6 +1313,19 @@ static void Cmd_ListCollisionModels_f( const idCmdArgs &args ) {
 	collisionModelManager->ListModels();
 }
 
+/*
+==================
+Cmd_ClipBenchmark_f
+==================
+*/
+static void Cmd_ClipBenchmark_f( const idCmdArgs &args ) {
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	gameLocal.clip.Benchmark( args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 10 );
+}
+
 /*
 ==================
 Cmd_CollisionModelInfo_f
@@ -1354,6 +1367,15 @@ static void Cmd_ReloadAnims_f( const idCmdArgs &args ) {
 	animationLib.ReloadAnims();
 }
 
+/*
+==================
+Cmd_ListAnimCompression_f
+==================
+*/
+static void Cmd_ListAnimCompression_f( const idCmdArgs &args ) {
+	animationLib.ListAnimCompression( args.Argc() > 1 ? args.Argv( 1 ) : NULL );
+}
+
 /*
 ==================
 Cmd_ListAnims_f
@@ -1427,6 +1449,26 @@ static void Cmd_AASStats_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_AASBuildRoutingTables_f
+==================
+*/
+static void Cmd_AASBuildRoutingTables_f( const idCmdArgs &args ) {
+	int i;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	for ( i = 0; i < gameLocal.NumAAS(); i++ ) {
+		idAAS *aas = gameLocal.GetAAS( i );
+		if ( aas ) {
+			aas->WriteRoutingTables();
+		}
+	}
+}
+
 /*
 ==================
 Cmd_TestDamage_f
@@ -1940,6 +1982,15 @@ static void Cmd_DisasmScript_f( const idCmdArgs &args ) {
 	gameLocal.program.Disassemble();
 }
 
+/*
+==================
+Cmd_CheckScriptDecode_f
+==================
+*/
+static void Cmd_CheckScriptDecode_f( const idCmdArgs &args ) {
+	gameLocal.program.CheckDecodedStatements();
+}
+
 /*
 ==================
 Cmd_TestSave_f
@@ -2319,6 +2370,9 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "game_memory",			idClass::DisplayInfo_f,		CMD_FL_GAME,				"displays game class info" );
 	cmdSystem->AddCommand( "listClasses",			idClass::ListClasses_f,		CMD_FL_GAME,				"lists game classes" );
 	cmdSystem->AddCommand( "listThreads",			idThread::ListThreads_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"lists script threads" );
+	cmdSystem->AddCommand( "scriptProfile",			idScriptProfiler::ScriptProfile_f,		CMD_FL_GAME,	"prints script functions and events sorted by time, set g_scriptProfile 1 to collect" );
+	cmdSystem->AddCommand( "scriptProfileDump",		idScriptProfiler::ScriptProfileDump_f,	CMD_FL_GAME,	"writes the script profile as collapsed stacks for flamegraph.pl" );
+	cmdSystem->AddCommand( "scriptProfileReset",	idScriptProfiler::ScriptProfileReset_f,	CMD_FL_GAME,	"clears the collected script profile" );
 	cmdSystem->AddCommand( "listEntities",			Cmd_EntityList_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"lists game entities" );
 	cmdSystem->AddCommand( "listActiveEntities",	Cmd_ActiveEntityList_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"lists active game entities" );
 	cmdSystem->AddCommand( "listMonsters",			idAI::List_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"lists monsters" );
@@ -2370,9 +2424,12 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "script",				Cmd_Script_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"executes a line of script" );
 	cmdSystem->AddCommand( "listCollisionModels",	Cmd_ListCollisionModels_f,	CMD_FL_GAME,				"lists collision models" );
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
+	cmdSystem->AddCommand( "clipBenchmark",			Cmd_ClipBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"replays the clip queries recorded with g_clipRecordQueries against the clip sectors and the aabb tree" );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
+	cmdSystem->AddCommand( "listAnimCompression",	Cmd_ListAnimCompression_f,	CMD_FL_GAME,				"lists the compression ratio, curve bit widths and max error of the loaded animations, or the joint errors of one animation" );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
+	cmdSystem->AddCommand( "aasBuildRoutingTables",	Cmd_AASBuildRoutingTables_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"writes the precomputed routing tables for the loaded AAS files" );
 	cmdSystem->AddCommand( "testDamage",			Cmd_TestDamage_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a damage def", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "weaponSplat",			Cmd_WeaponSplat_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"projects a blood splat on the player weapon" );
 	cmdSystem->AddCommand( "saveSelected",			Cmd_SaveSelected_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"saves the selected entity to the .map file" );
@@ -2387,6 +2444,7 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "gameError",				Cmd_GameError_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"causes a game error" );
 
 	cmdSystem->AddCommand( "disasmScript",			Cmd_DisasmScript_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"disassembles script" );
+	cmdSystem->AddCommand( "checkScriptDecode",		Cmd_CheckScriptDecode_f,	CMD_FL_GAME,				"compares the decoded script instructions with the statements of every compiled function" );
 	cmdSystem->AddCommand( "recordViewNotes",		Cmd_RecordViewNotes_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"record the current view position with notes" );
 	cmdSystem->AddCommand( "showViewNotes",			Cmd_ShowViewNotes_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"show any view notes for the current map, successive calls will cycle to the next note" );
 	cmdSystem->AddCommand( "closeViewNotes",		Cmd_CloseViewNotes_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"close the view showing any notes for this map" );
@@ -83,6 +83,8 @@ idCVar g_gravity(					"g_gravity",		DEFAULT_GRAVITY_STRING, CVAR_GAME | CVAR_FLO
 idCVar g_skipFX(					"g_skipFX",					"0",			CVAR_GAME | CVAR_BOOL, "" );
 
 idCVar g_disasm(					"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
+idCVar g_scriptProfile(				"g_scriptProfile",			"0",			CVAR_GAME | CVAR_BOOL, "collect script function and event timings for scriptProfile and scriptProfileDump" );
+idCVar g_scriptFastPath(			"g_scriptFastPath",			"1",			CVAR_GAME | CVAR_INTEGER, "run the common script opcodes from the pre-decoded instruction stream, 0 uses only the statement switch, 2 runs both and warns when they differ", 0, 2 );
 idCVar g_debugBounds(				"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
 idCVar g_debugAnim(					"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
 idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -109,6 +111,8 @@ idCVar g_showTriggers(				"g_showTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "dra
 idCVar g_showCollisionWorld(		"g_showCollisionWorld",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionModels(		"g_showCollisionModels",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionTraces(		"g_showCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_clipTree(					"g_clipTree",				"1",			CVAR_GAME | CVAR_BOOL, "link clip models into a dynamic aabb tree instead of the static clip sectors, takes effect on map load" );
+idCVar g_clipRecordQueries(			"g_clipRecordQueries",		"0",			CVAR_GAME | CVAR_BOOL, "record the bounds of clip model queries for clipBenchmark" );
 idCVar g_maxShowDistance(			"g_maxShowDistance",		"128",			CVAR_GAME | CVAR_FLOAT, "" );
 idCVar g_showEntityInfo(			"g_showEntityInfo",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showviewpos(				"g_showviewpos",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -119,6 +123,9 @@ idCVar g_showEnemies(				"g_showEnemies",			"0",			CVAR_GAME | CVAR_BOOL, "draws
 
 idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "displays timing information for each game frame" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
+idCVar g_batchThinkTraces(			"g_batchThinkTraces",		"0",			CVAR_GAME | CVAR_INTEGER, "trace the world traces queued by thinking entities on the job threads before the think pass, 2 = also trace them serially and warn when the results differ", 0, 2 );
+idCVar g_parallelAnimation(		"g_parallelAnimation",		"0",			CVAR_GAME | CVAR_BOOL, "build the animation frames of animating entities in the player PVS on the job threads at the end of the game frame" );
+idCVar g_thinkStateHash(			"g_thinkStateHash",			"0",			CVAR_GAME | CVAR_BOOL, "print a hash of the entity state after each game frame, used to check that g_batchThinkTraces runs match serial runs" );
 
 idCVar g_debugShockwave(			"g_debugShockwave",			"0",			CVAR_GAME | CVAR_BOOL, "Debug the shockwave" );
 
@@ -307,6 +314,7 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_useRoutingTables(		"aas_useRoutingTables",		"1",			CVAR_GAME | CVAR_BOOL, "use the precomputed routing tables written with aasBuildRoutingTables before the dynamic routing cache" );
 
 idCVar g_countDown(					"g_countDown",				"15",			CVAR_GAME | CVAR_INTEGER | CVAR_ARCHIVE, "pregame countdown in seconds", 4, 3600 );
 idCVar g_gameReviewPause(			"g_gameReviewPause",		"10",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_INTEGER | CVAR_ARCHIVE, "scores review time in seconds (at end game)", 2, 3600 );
@@ -45,6 +45,8 @@ extern idCVar	g_projectileLights;
 extern idCVar	g_muzzleFlash;
 
 extern idCVar	g_disasm;
+extern idCVar	g_scriptFastPath;
+extern idCVar	g_scriptProfile;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
 extern idCVar	g_debugMove;
@@ -69,6 +71,8 @@ extern idCVar	g_showTriggers;
 extern idCVar	g_showCollisionWorld;
 extern idCVar	g_showCollisionModels;
 extern idCVar	g_showCollisionTraces;
+extern idCVar	g_clipTree;
+extern idCVar	g_clipRecordQueries;
 extern idCVar	g_maxShowDistance;
 extern idCVar	g_showEntityInfo;
 extern idCVar	g_showviewpos;
@@ -79,6 +83,9 @@ extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
 extern idCVar	g_timeentities;
+extern idCVar	g_batchThinkTraces;
+extern idCVar	g_parallelAnimation;
+extern idCVar	g_thinkStateHash;
 
 extern idCVar	ai_debugScript;
 extern idCVar	ai_debugMove;
@@ -249,6 +256,7 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_useRoutingTables;
 
 extern idCVar	net_clientPredictGUI;
 
@@ -50,6 +50,19 @@ typedef struct clipLink_s {
 	struct clipLink_s *		nextLink;
 } clipLink_t;
 
+#define CLIP_TREE_NULL_NODE				-1
+#define CLIP_TREE_FAT_MARGIN			8.0f		// leaves are enlarged so small moves don't change the tree
+#define CLIP_TREE_MAX_STACK				256
+#define MAX_RECORDED_CLIP_QUERIES		( 1 << 18 )
+
+typedef struct clipTreeNode_s {
+	idBounds				bounds;			// enlarged bounds for leaves, union of the children otherwise
+	idClipModel *			clipModel;		// NULL for internal nodes
+	int						parent;			// next free node when on the free list
+	int						children[2];	// CLIP_TREE_NULL_NODE for leaves
+	int						height;			// 0 for leaves, -1 for free nodes
+} clipTreeNode_t;
+
 typedef struct trmCache_s {
 	idTraceModel			trm;
 	int						refCount;
@@ -358,6 +371,8 @@ void idClipModel::Init() {
 	renderModelHandle = -1;
 	traceModelIndex = -1;
 	clipLinks = NULL;
+	treeClip = NULL;
+	treeNode = CLIP_TREE_NULL_NODE;
 	touchCount = -1;
 }
 
@@ -434,6 +449,8 @@ idClipModel::idClipModel( const idClipModel *model ) {
 	}
 	renderModelHandle = model->renderModelHandle;
 	clipLinks = NULL;
+	treeClip = NULL;
+	treeNode = CLIP_TREE_NULL_NODE;
 	touchCount = -1;
 }
 
@@ -473,7 +490,7 @@ void idClipModel::Save( idSaveGame *savefile ) const {
 	}
 	savefile->WriteInt( traceModelIndex );
 	savefile->WriteInt( renderModelHandle );
-	savefile->WriteBool( clipLinks != NULL );
+	savefile->WriteBool( IsLinked() );
 	savefile->WriteInt( touchCount );
 }
 
@@ -514,6 +531,8 @@ void idClipModel::Restore( idRestoreGame *savefile ) {
 	// the render model will be set when the clip model is linked
 	renderModelHandle = -1;
 	clipLinks = NULL;
+	treeClip = NULL;
+	treeNode = CLIP_TREE_NULL_NODE;
 	touchCount = -1;
 
 	if ( linked ) {
@@ -527,7 +546,7 @@ idClipModel::SetPosition
 ================
 */
 void idClipModel::SetPosition( const idVec3 &newOrigin, const idMat3 &newAxis ) {
-	if ( clipLinks ) {
+	if ( IsLinked() ) {
 		Unlink();	// unlink from old position
 	}
 	origin = newOrigin;
@@ -576,6 +595,10 @@ idClipModel::Unlink
 void idClipModel::Unlink() {
 	clipLink_t *link;
 
+	if ( treeNode != CLIP_TREE_NULL_NODE ) {
+		treeClip->UnlinkTree( this );
+	}
+
 	for ( link = clipLinks; link; link = clipLinks ) {
 		clipLinks = link->nextLink;
 		if ( link->prevInSector ) {
@@ -639,6 +662,9 @@ void idClipModel::Link( idClip &clp ) {
 	}
 
 	if ( bounds.IsCleared() ) {
+		if ( treeNode != CLIP_TREE_NULL_NODE ) {
+			Unlink();
+		}
 		return;
 	}
 
@@ -657,6 +683,11 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 
+	if ( clp.useTree ) {
+		clp.LinkTree( this );
+		return;
+	}
+
 	Link_r( clp.clipSectors );
 }
 
@@ -707,6 +738,12 @@ idClip::idClip
 idClip::idClip() {
 	numClipSectors = 0;
 	clipSectors = NULL;
+	useTree = false;
+	treeNodes = NULL;
+	maxTreeNodes = 0;
+	numTreeNodes = 0;
+	treeRoot = CLIP_TREE_NULL_NODE;
+	treeFreeList = CLIP_TREE_NULL_NODE;
 	worldBounds.Zero();
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
@@ -775,6 +812,8 @@ void idClip::Init() {
 	memset( clipSectors, 0, MAX_SECTORS * sizeof( clipSector_t ) );
 	numClipSectors = 0;
 	touchCount = -1;
+	useTree = g_clipTree.GetBool();
+	recordedQueries.Clear();
 	// get world map bounds
 	h = collisionModelManager->LoadModel( "worldMap" );
 	collisionModelManager->GetModelBounds( h, worldBounds );
@@ -801,6 +840,9 @@ void idClip::Shutdown() {
 	delete[] clipSectors;
 	clipSectors = NULL;
 
+	ClearTree();
+	recordedQueries.Clear();
+
 	// free the trace model used for the temporaryClipModel
 	if ( temporaryClipModel.traceModelIndex != -1 ) {
 		idClipModel::FreeTraceModel( temporaryClipModel.traceModelIndex );
@@ -816,6 +858,385 @@ void idClip::Shutdown() {
 	clipLinkAllocator.Shutdown();
 }
 
+/*
+===============================================================
+
+	idClip dynamic AABB tree
+
+	Every linked clip model is a leaf with bounds enlarged by
+	CLIP_TREE_FAT_MARGIN, so a model that moves a little stays in
+	its leaf and relinking is free. The tree is kept height balanced
+	with rotations and inserts pick the sibling that grows the
+	surface area the least.
+
+===============================================================
+*/
+
+/*
+================
+ClipTree_Area
+
+  half the surface area, only used to compare the cost of tree layouts
+================
+*/
+static ID_INLINE float ClipTree_Area( const idBounds &bounds ) {
+	const idVec3 size = bounds[1] - bounds[0];
+	return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+}
+
+/*
+================
+ClipTree_Contains
+================
+*/
+static ID_INLINE bool ClipTree_Contains( const idBounds &outer, const idBounds &inner ) {
+	return	inner[0][0] >= outer[0][0] && inner[0][1] >= outer[0][1] && inner[0][2] >= outer[0][2] &&
+			inner[1][0] <= outer[1][0] && inner[1][1] <= outer[1][1] && inner[1][2] <= outer[1][2];
+}
+
+/*
+================
+idClip::AllocTreeNode
+================
+*/
+int idClip::AllocTreeNode() {
+	if ( treeFreeList == CLIP_TREE_NULL_NODE ) {
+		const int newMaxNodes = Max( 256, maxTreeNodes * 2 );
+		clipTreeNode_t *newNodes = new (TAG_PHYSICS_CLIP) clipTreeNode_t[newMaxNodes];
+		if ( treeNodes != NULL ) {
+			memcpy( newNodes, treeNodes, maxTreeNodes * sizeof( clipTreeNode_t ) );
+			delete[] treeNodes;
+		}
+		for ( int i = maxTreeNodes; i < newMaxNodes; i++ ) {
+			newNodes[i].parent = ( i + 1 < newMaxNodes ) ? i + 1 : CLIP_TREE_NULL_NODE;
+			newNodes[i].height = -1;
+		}
+		treeFreeList = maxTreeNodes;
+		treeNodes = newNodes;
+		maxTreeNodes = newMaxNodes;
+	}
+
+	const int nodeNum = treeFreeList;
+	clipTreeNode_t &node = treeNodes[nodeNum];
+	treeFreeList = node.parent;
+	node.clipModel = NULL;
+	node.parent = CLIP_TREE_NULL_NODE;
+	node.children[0] = CLIP_TREE_NULL_NODE;
+	node.children[1] = CLIP_TREE_NULL_NODE;
+	node.height = 0;
+	numTreeNodes++;
+	return nodeNum;
+}
+
+/*
+================
+idClip::FreeTreeNode
+================
+*/
+void idClip::FreeTreeNode( int nodeNum ) {
+	clipTreeNode_t &node = treeNodes[nodeNum];
+	node.clipModel = NULL;
+	node.parent = treeFreeList;
+	node.height = -1;
+	treeFreeList = nodeNum;
+	numTreeNodes--;
+}
+
+/*
+================
+idClip::InsertTreeLeaf
+================
+*/
+void idClip::InsertTreeLeaf( int leaf ) {
+	if ( treeRoot == CLIP_TREE_NULL_NODE ) {
+		treeRoot = leaf;
+		treeNodes[leaf].parent = CLIP_TREE_NULL_NODE;
+		return;
+	}
+
+	// find the cheapest sibling for the new leaf
+	const idBounds leafBounds = treeNodes[leaf].bounds;
+	int index = treeRoot;
+	while ( treeNodes[index].children[0] != CLIP_TREE_NULL_NODE ) {
+		const clipTreeNode_t &node = treeNodes[index];
+
+		const float area = ClipTree_Area( node.bounds );
+		const float combinedArea = ClipTree_Area( node.bounds + leafBounds );
+
+		// cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+
+		// minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * ( combinedArea - area );
+
+		float childCost[2];
+		for ( int i = 0; i < 2; i++ ) {
+			const clipTreeNode_t &child = treeNodes[node.children[i]];
+			childCost[i] = ClipTree_Area( child.bounds + leafBounds ) + inheritanceCost;
+			if ( child.children[0] != CLIP_TREE_NULL_NODE ) {
+				childCost[i] -= ClipTree_Area( child.bounds );
+			}
+		}
+
+		if ( cost < childCost[0] && cost < childCost[1] ) {
+			break;
+		}
+
+		index = ( childCost[0] < childCost[1] ) ? node.children[0] : node.children[1];
+	}
+
+	const int sibling = index;
+
+	// create a new parent, this may move the node array
+	const int newParent = AllocTreeNode();
+	const int oldParent = treeNodes[sibling].parent;
+	treeNodes[newParent].parent = oldParent;
+	treeNodes[newParent].bounds = leafBounds + treeNodes[sibling].bounds;
+	treeNodes[newParent].height = treeNodes[sibling].height + 1;
+	treeNodes[newParent].children[0] = sibling;
+	treeNodes[newParent].children[1] = leaf;
+	treeNodes[sibling].parent = newParent;
+	treeNodes[leaf].parent = newParent;
+
+	if ( oldParent != CLIP_TREE_NULL_NODE ) {
+		if ( treeNodes[oldParent].children[0] == sibling ) {
+			treeNodes[oldParent].children[0] = newParent;
+		} else {
+			treeNodes[oldParent].children[1] = newParent;
+		}
+	} else {
+		treeRoot = newParent;
+	}
+
+	// walk back up fixing heights and bounds
+	for ( index = treeNodes[leaf].parent; index != CLIP_TREE_NULL_NODE; index = treeNodes[index].parent ) {
+		index = BalanceTreeNode( index );
+
+		clipTreeNode_t &node = treeNodes[index];
+		const clipTreeNode_t &child0 = treeNodes[node.children[0]];
+		const clipTreeNode_t &child1 = treeNodes[node.children[1]];
+		node.height = 1 + Max( child0.height, child1.height );
+		node.bounds = child0.bounds + child1.bounds;
+	}
+}
+
+/*
+================
+idClip::RemoveTreeLeaf
+================
+*/
+void idClip::RemoveTreeLeaf( int leaf ) {
+	if ( leaf == treeRoot ) {
+		treeRoot = CLIP_TREE_NULL_NODE;
+		return;
+	}
+
+	const int parent = treeNodes[leaf].parent;
+	const int grandParent = treeNodes[parent].parent;
+	const int sibling = ( treeNodes[parent].children[0] == leaf ) ? treeNodes[parent].children[1] : treeNodes[parent].children[0];
+
+	if ( grandParent == CLIP_TREE_NULL_NODE ) {
+		treeRoot = sibling;
+		treeNodes[sibling].parent = CLIP_TREE_NULL_NODE;
+		FreeTreeNode( parent );
+		return;
+	}
+
+	// connect the sibling to the grand parent and remove the parent
+	if ( treeNodes[grandParent].children[0] == parent ) {
+		treeNodes[grandParent].children[0] = sibling;
+	} else {
+		treeNodes[grandParent].children[1] = sibling;
+	}
+	treeNodes[sibling].parent = grandParent;
+	FreeTreeNode( parent );
+
+	for ( int index = grandParent; index != CLIP_TREE_NULL_NODE; index = treeNodes[index].parent ) {
+		index = BalanceTreeNode( index );
+
+		clipTreeNode_t &node = treeNodes[index];
+		const clipTreeNode_t &child0 = treeNodes[node.children[0]];
+		const clipTreeNode_t &child1 = treeNodes[node.children[1]];
+		node.height = 1 + Max( child0.height, child1.height );
+		node.bounds = child0.bounds + child1.bounds;
+	}
+}
+
+/*
+================
+idClip::BalanceTreeNode
+
+  Rotates the higher child of node A up if the children heights differ by more than one.
+  Returns the node that took the place of A.
+================
+*/
+int idClip::BalanceTreeNode( int iA ) {
+	clipTreeNode_t *A = &treeNodes[iA];
+	if ( A->children[0] == CLIP_TREE_NULL_NODE || A->height < 2 ) {
+		return iA;
+	}
+
+	const int iB = A->children[0];
+	const int iC = A->children[1];
+	clipTreeNode_t *B = &treeNodes[iB];
+	clipTreeNode_t *C = &treeNodes[iC];
+
+	const int balance = C->height - B->height;
+
+	if ( balance > 1 ) {
+		// rotate C up
+		const int iF = C->children[0];
+		const int iG = C->children[1];
+		clipTreeNode_t *F = &treeNodes[iF];
+		clipTreeNode_t *G = &treeNodes[iG];
+
+		C->children[0] = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		if ( C->parent != CLIP_TREE_NULL_NODE ) {
+			if ( treeNodes[C->parent].children[0] == iA ) {
+				treeNodes[C->parent].children[0] = iC;
+			} else {
+				treeNodes[C->parent].children[1] = iC;
+			}
+		} else {
+			treeRoot = iC;
+		}
+
+		if ( F->height > G->height ) {
+			C->children[1] = iF;
+			A->children[1] = iG;
+			G->parent = iA;
+			A->bounds = B->bounds + G->bounds;
+			C->bounds = A->bounds + F->bounds;
+			A->height = 1 + Max( B->height, G->height );
+			C->height = 1 + Max( A->height, F->height );
+		} else {
+			C->children[1] = iG;
+			A->children[1] = iF;
+			F->parent = iA;
+			A->bounds = B->bounds + F->bounds;
+			C->bounds = A->bounds + G->bounds;
+			A->height = 1 + Max( B->height, F->height );
+			C->height = 1 + Max( A->height, G->height );
+		}
+		return iC;
+	}
+
+	if ( balance < -1 ) {
+		// rotate B up
+		const int iD = B->children[0];
+		const int iE = B->children[1];
+		clipTreeNode_t *D = &treeNodes[iD];
+		clipTreeNode_t *E = &treeNodes[iE];
+
+		B->children[0] = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		if ( B->parent != CLIP_TREE_NULL_NODE ) {
+			if ( treeNodes[B->parent].children[0] == iA ) {
+				treeNodes[B->parent].children[0] = iB;
+			} else {
+				treeNodes[B->parent].children[1] = iB;
+			}
+		} else {
+			treeRoot = iB;
+		}
+
+		if ( D->height > E->height ) {
+			B->children[1] = iD;
+			A->children[0] = iE;
+			E->parent = iA;
+			A->bounds = C->bounds + E->bounds;
+			B->bounds = A->bounds + D->bounds;
+			A->height = 1 + Max( C->height, E->height );
+			B->height = 1 + Max( A->height, D->height );
+		} else {
+			B->children[1] = iE;
+			A->children[0] = iD;
+			D->parent = iA;
+			A->bounds = C->bounds + D->bounds;
+			B->bounds = A->bounds + E->bounds;
+			A->height = 1 + Max( C->height, D->height );
+			B->height = 1 + Max( A->height, E->height );
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+/*
+================
+idClip::LinkTree
+
+  the absolute bounds of the clip model must be up to date
+================
+*/
+void idClip::LinkTree( idClipModel *clipModel ) {
+	int leaf = clipModel->treeNode;
+
+	if ( leaf != CLIP_TREE_NULL_NODE ) {
+		// still inside the enlarged bounds so nothing changes
+		if ( ClipTree_Contains( treeNodes[leaf].bounds, clipModel->absBounds ) ) {
+			return;
+		}
+		RemoveTreeLeaf( leaf );
+	} else {
+		leaf = AllocTreeNode();
+		treeNodes[leaf].clipModel = clipModel;
+		clipModel->treeClip = this;
+		clipModel->treeNode = leaf;
+	}
+
+	treeNodes[leaf].bounds = clipModel->absBounds.Expand( CLIP_TREE_FAT_MARGIN );
+	InsertTreeLeaf( leaf );
+}
+
+/*
+================
+idClip::UnlinkTree
+================
+*/
+void idClip::UnlinkTree( idClipModel *clipModel ) {
+	const int leaf = clipModel->treeNode;
+
+	assert( treeNodes[leaf].clipModel == clipModel );
+
+	RemoveTreeLeaf( leaf );
+	FreeTreeNode( leaf );
+	clipModel->treeClip = NULL;
+	clipModel->treeNode = CLIP_TREE_NULL_NODE;
+}
+
+/*
+================
+idClip::ClearTree
+================
+*/
+void idClip::ClearTree() {
+	delete[] treeNodes;
+	treeNodes = NULL;
+	maxTreeNodes = 0;
+	numTreeNodes = 0;
+	treeRoot = CLIP_TREE_NULL_NODE;
+	treeFreeList = CLIP_TREE_NULL_NODE;
+}
+
+/*
+================
+idClip::GetTreeHeight
+================
+*/
+int idClip::GetTreeHeight() const {
+	if ( treeRoot == CLIP_TREE_NULL_NODE ) {
+		return 0;
+	}
+	return treeNodes[treeRoot].height;
+}
+
 /*
 ====================
 idClip::ClipModelsTouchingBounds_r
@@ -881,6 +1302,73 @@ void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listPa
 	}
 }
 
+/*
+====================
+idClip::ClipModelsTouchingBounds_Tree
+====================
+*/
+void idClip::ClipModelsTouchingBounds_Tree( listParms_t &parms ) const {
+	int stack[CLIP_TREE_MAX_STACK];
+	int stackSize;
+
+	if ( treeRoot == CLIP_TREE_NULL_NODE ) {
+		return;
+	}
+
+	stack[0] = treeRoot;
+	stackSize = 1;
+
+	while( stackSize > 0 ) {
+		const clipTreeNode_t &node = treeNodes[stack[--stackSize]];
+
+		if ( !node.bounds.IntersectsBounds( parms.bounds ) ) {
+			continue;
+		}
+
+		if ( node.children[0] != CLIP_TREE_NULL_NODE ) {
+			if ( stackSize + 2 > CLIP_TREE_MAX_STACK ) {
+				assert( false );
+				gameLocal.Warning( "idClip::ClipModelsTouchingBounds_Tree: stack overflow" );
+				return;
+			}
+			stack[stackSize++] = node.children[1];
+			stack[stackSize++] = node.children[0];
+			continue;
+		}
+
+		idClipModel	*check = node.clipModel;
+
+		// if the clip model is enabled
+		if ( !check->enabled ) {
+			continue;
+		}
+
+		// if the clip model does not have any contents we are looking for
+		if ( !( check->contents & parms.contentMask ) ) {
+			continue;
+		}
+
+		// if the bounds really do overlap
+		if (	check->absBounds[0][0] > parms.bounds[1][0] ||
+				check->absBounds[1][0] < parms.bounds[0][0] ||
+				check->absBounds[0][1] > parms.bounds[1][1] ||
+				check->absBounds[1][1] < parms.bounds[0][1] ||
+				check->absBounds[0][2] > parms.bounds[1][2] ||
+				check->absBounds[1][2] < parms.bounds[0][2] ) {
+			continue;
+		}
+
+		if ( parms.count >= parms.maxCount ) {
+			gameLocal.Warning( "idClip::ClipModelsTouchingBounds_Tree: max count" );
+			return;
+		}
+
+		check->touchCount = touchCount;
+		parms.list[parms.count] = check;
+		parms.count++;
+	}
+}
+
 /*
 ================
 idClip::ClipModelsTouchingBounds
@@ -904,8 +1392,18 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 	parms.count = 0;
 	parms.maxCount = maxCount;
 
+	if ( g_clipRecordQueries.GetBool() && recordedQueries.Num() < MAX_RECORDED_CLIP_QUERIES ) {
+		clipQuery_t &query = recordedQueries.Alloc();
+		query.bounds = bounds;
+		query.contentMask = contentMask;
+	}
+
 	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
+	if ( useTree ) {
+		ClipModelsTouchingBounds_Tree( parms );
+	} else {
+		ClipModelsTouchingBounds_r( clipSectors, parms );
+	}
 
 	return parms.count;
 }
@@ -1133,13 +1631,35 @@ void idClip::TranslationEntities( trace_t &results, const idVec3 &start, const i
 	}
 }
 
+/*
+============
+idClip::SetupWorldQuery
+============
+*/
+void idClip::SetupWorldQuery( cmTraceQuery_t &query, const idVec3 &start, const idVec3 &end,
+						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask ) const {
+	memset( &query, 0, sizeof( query ) );
+	query.start = start;
+	query.end = end;
+	query.trm = TraceModelForClipModel( mdl );
+	query.trmAxis = trmAxis;
+	query.contentMask = contentMask;
+	query.model = 0;
+	query.modelOrigin = vec3_origin;
+	query.modelAxis = mat3_default;
+}
+
 /*
 ============
 idClip::Translation
+
+  If worldQuery was set up with SetupWorldQuery for exactly the same trace its
+  precomputed result is used instead of tracing the world again.
 ============
 */
 bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &end,
-						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
+						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity,
+						const cmTraceQuery_t *worldQuery ) {
 	int i, num;
 	idClipModel *touch, *clipModelList[MAX_GENTITIES];
 	idBounds traceBounds;
@@ -1155,8 +1675,18 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 
 	if ( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD ) {
 		// test world
-		idClip::numTranslations++;
-		collisionModelManager->Translation( &results, start, end, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
+		if ( worldQuery != NULL && worldQuery->model == 0 && worldQuery->targetTrm == NULL && worldQuery->trm == trm &&
+				worldQuery->contentMask == contentMask && worldQuery->start == start && worldQuery->end == end && worldQuery->trmAxis == trmAxis ) {
+			results = worldQuery->results;
+			if ( g_batchThinkTraces.GetInteger() == 2 ) {
+				idClip::numTranslations++;
+				collisionModelManager->Translation( &trace, start, end, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
+				gameLocal.CheckThinkTrace( results, trace );
+			}
+		} else {
+			idClip::numTranslations++;
+			collisionModelManager->Translation( &results, start, end, trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
+		}
 		results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
 		if ( results.fraction == 0.0f ) {
 			return true;		// blocked immediately by the world
@@ -1691,9 +2221,113 @@ idClip::PrintStatistics
 void idClip::PrintStatistics() {
 	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d\n",
 					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts );
+	if ( useTree ) {
+		gameLocal.Printf( "aabb tree: %d nodes, height %d\n", numTreeNodes, GetTreeHeight() );
+	}
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
 
+/*
+============
+idClip::GetLinkedClipModels
+============
+*/
+int idClip::GetLinkedClipModels( idList<idClipModel *> &list ) const {
+	list.SetNum( 0 );
+
+	if ( useTree ) {
+		for ( int i = 0; i < maxTreeNodes; i++ ) {
+			if ( treeNodes[i].height == 0 && treeNodes[i].clipModel != NULL ) {
+				list.Append( treeNodes[i].clipModel );
+			}
+		}
+		return list.Num();
+	}
+
+	// models can be linked into multiple sectors
+	touchCount++;
+	for ( int i = 0; i < numClipSectors; i++ ) {
+		for ( clipLink_t *link = clipSectors[i].clipLinks; link; link = link->nextInSector ) {
+			if ( link->clipModel->touchCount == touchCount ) {
+				continue;
+			}
+			link->clipModel->touchCount = touchCount;
+			list.Append( link->clipModel );
+		}
+	}
+	return list.Num();
+}
+
+/*
+============
+idClip::SetUseTree
+============
+*/
+void idClip::SetUseTree( bool newUseTree ) {
+	idList<idClipModel *> linked;
+
+	if ( newUseTree == useTree ) {
+		return;
+	}
+
+	GetLinkedClipModels( linked );
+	for ( int i = 0; i < linked.Num(); i++ ) {
+		linked[i]->Unlink();
+	}
+
+	useTree = newUseTree;
+
+	for ( int i = 0; i < linked.Num(); i++ ) {
+		linked[i]->Link( *this );
+	}
+}
+
+/*
+============
+idClip::Benchmark
+
+  Replays the queries recorded with g_clipRecordQueries against the clip sectors and the aabb tree.
+============
+*/
+void idClip::Benchmark( int repeat ) {
+	idClipModel	*clipModelList[MAX_GENTITIES];
+	int			numReturned[2];
+
+	if ( recordedQueries.Num() == 0 ) {
+		gameLocal.Printf( "no clip queries recorded, set g_clipRecordQueries 1 and play for a while\n" );
+		return;
+	}
+
+	g_clipRecordQueries.SetBool( false );
+
+	const bool oldUseTree = useTree;
+	repeat = Max( repeat, 1 );
+
+	for ( int pass = 0; pass < 2; pass++ ) {
+		SetUseTree( pass == 1 );
+
+		numReturned[pass] = 0;
+		const uint64 startTime = Sys_Microseconds();
+		for ( int r = 0; r < repeat; r++ ) {
+			for ( int i = 0; i < recordedQueries.Num(); i++ ) {
+				numReturned[pass] += ClipModelsTouchingBounds( recordedQueries[i].bounds, recordedQueries[i].contentMask, clipModelList, MAX_GENTITIES );
+			}
+		}
+		const uint64 endTime = Sys_Microseconds();
+
+		const int numQueries = recordedQueries.Num() * repeat;
+		gameLocal.Printf( "%-12s: %7d queries in %6.1f ms, %6.3f usec per query, %d clip models returned\n",
+					useTree ? "aabb tree" : "clip sectors", numQueries, ( endTime - startTime ) * 0.001f,
+					(float)( endTime - startTime ) / numQueries, numReturned[pass] );
+	}
+
+	if ( numReturned[0] != numReturned[1] ) {
+		gameLocal.Warning( "idClip::Benchmark: the clip sectors and the aabb tree returned a different number of clip models" );
+	}
+
+	SetUseTree( oldUseTree );
+}
+
 /*
 ============
 idClip::DrawClipModels
@@ -124,6 +124,8 @@ private:
 	int						renderModelHandle;		// render model def handle
 
 	struct clipLink_s *		clipLinks;				// links into sectors
+	idClip *				treeClip;				// clip the model is linked into when using the AABB tree
+	int						treeNode;				// leaf in the AABB tree, -1 if not in the tree
 	int						touchCount;
 
 	void					Init();			// initialize
@@ -221,7 +223,7 @@ ID_INLINE bool idClipModel::IsTraceModel() const {
 }
 
 ID_INLINE bool idClipModel::IsLinked() const {
-	return ( clipLinks != NULL );
+	return ( clipLinks != NULL || treeNode != -1 );
 }
 
 ID_INLINE bool idClipModel::IsEnabled() const {
@@ -246,6 +248,11 @@ ID_INLINE const idTraceModel *idClipModel::GetTraceModel() const {
 //
 //===============================================================
 
+typedef struct clipQuery_s {
+	idBounds				bounds;
+	int						contentMask;
+} clipQuery_t;
+
 class idClip {
 
 	friend class idClipModel;
@@ -258,7 +265,8 @@ public:
 
 	// clip versus the rest of the world
 	bool					Translation( trace_t &results, const idVec3 &start, const idVec3 &end,
-								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity,
+								const cmTraceQuery_t *worldQuery = NULL );
 	bool					Rotation( trace_t &results, const idVec3 &start, const idRotation &rotation,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
 	bool					Motion( trace_t &results, const idVec3 &start, const idVec3 &end, const idRotation &rotation,
@@ -274,6 +282,11 @@ public:
 	bool					TraceBounds( trace_t &results, const idVec3 &start, const idVec3 &end, const idBounds &bounds,
 								int contentMask, const idEntity *passEntity );
 
+	// sets up the world part of a translation so it can be traced ahead of time with
+	// collisionModelManager->TranslationBatch and passed to Translation as worldQuery
+	void					SetupWorldQuery( cmTraceQuery_t &query, const idVec3 &start, const idVec3 &end,
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask ) const;
+
 	// clip versus a specific model
 	void					TranslationModel( trace_t &results, const idVec3 &start, const idVec3 &end,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask,
@@ -302,14 +315,25 @@ public:
 	const idBounds &		GetWorldBounds() const;
 	idClipModel *			DefaultClipModel();
 
+							// switch between the dynamic AABB tree and the static clip sectors, relinks all clip models
+	void					SetUseTree( bool useTree );
+	bool					UsesTree() const;
+
 							// stats and debug drawing
 	void					PrintStatistics();
+	void					Benchmark( int repeat );
 	void					DrawClipModels( const idVec3 &eye, const float radius, const idEntity *passEntity );
 	bool					DrawModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, int lifetime ) const;
 
 private:
 	int						numClipSectors;
 	struct clipSector_s *	clipSectors;
+	bool					useTree;				// use the dynamic AABB tree instead of the clip sectors
+	struct clipTreeNode_s *	treeNodes;
+	int						maxTreeNodes;
+	int						numTreeNodes;
+	int						treeRoot;
+	int						treeFreeList;
 	idBounds				worldBounds;
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
@@ -321,10 +345,24 @@ private:
 	int						numRenderModelTraces;
 	int						numContents;
 	int						numContacts;
+	mutable idList<clipQuery_t> recordedQueries;	// recorded with g_clipRecordQueries for Benchmark
 
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	void					ClipModelsTouchingBounds_Tree( struct listParms_s &parms ) const;
+	int						GetLinkedClipModels( idList<idClipModel *> &list ) const;
+
+							// dynamic AABB tree
+	int						AllocTreeNode();
+	void					FreeTreeNode( int nodeNum );
+	void					InsertTreeLeaf( int leaf );
+	void					RemoveTreeLeaf( int leaf );
+	int						BalanceTreeNode( int nodeNum );
+	void					LinkTree( idClipModel *clipModel );
+	void					UnlinkTree( idClipModel *clipModel );
+	void					ClearTree();
+	int						GetTreeHeight() const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
@@ -350,4 +388,8 @@ ID_INLINE idClipModel *idClip::DefaultClipModel() {
 	return &defaultClipModel;
 }
 
+ID_INLINE bool idClip::UsesTree() const {
+	return useTree;
+}
+
 #endif /* !__CLIP_H__ */
@@ -52,7 +52,8 @@ void idPhysics_Monster::CheckGround( monsterPState_t &state ) {
 	}
 
 	down = state.origin + gravityNormal * CONTACT_EPSILON;
-	gameLocal.clip.Translation( groundTrace, state.origin, down, clipModel, clipModel->GetAxis(), clipMask, self );
+	gameLocal.clip.Translation( groundTrace, state.origin, down, clipModel, clipModel->GetAxis(), clipMask, self,
+								gameLocal.GetThinkTrace( groundTraceNum, groundTraceFrame ) );
 
 	if ( groundTrace.fraction == 1.0f ) {
 		state.onGround = false;
@@ -263,6 +264,8 @@ idPhysics_Monster::idPhysics_Monster() {
 	useVelocityMove = false;
 	noImpact = false;
 	blockingEntity = NULL;
+	groundTraceNum = -1;
+	groundTraceFrame = -1;
 }
 
 /*
@@ -441,6 +444,24 @@ void idPhysics_Monster::DisableImpact() {
 	noImpact = true;
 }
 
+/*
+================
+idPhysics_Monster::QueueGroundTrace
+
+  Only queues the trace when Evaluate will get to the ground check. If the
+  state changes before then the query no longer matches and is ignored.
+================
+*/
+void idPhysics_Monster::QueueGroundTrace() {
+	groundTraceNum = -1;
+	if ( masterEntity || current.atRest >= 0 || gravityNormal == vec3_zero || clipModel == NULL ) {
+		return;
+	}
+	groundTraceNum = gameLocal.QueueThinkTrace( current.origin, current.origin + gravityNormal * CONTACT_EPSILON,
+												clipModel, clipModel->GetAxis(), clipMask );
+	groundTraceFrame = gameLocal.framenum;
+}
+
 /*
 ================
 idPhysics_Monster::Evaluate
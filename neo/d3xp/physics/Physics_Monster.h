@@ -89,6 +89,8 @@ public:
 							// enable/disable activation by impact
 	void					EnableImpact();
 	void					DisableImpact();
+							// queue the world part of the next ground check with gameLocal.QueueThinkTrace
+	void					QueueGroundTrace();
 
 public:	// common physics interface
 	bool					Evaluate( int timeStepMSec, int endTimeMSec );
@@ -146,6 +148,10 @@ private:
 	monsterMoveResult_t		moveResult;
 	idEntity *				blockingEntity;
 
+	// ground trace queued for the think trace batch
+	int						groundTraceNum;
+	int						groundTraceFrame;
+
 private:
 	void					CheckGround( monsterPState_t &state );
 	monsterMoveResult_t		SlideMove( idVec3 &start, idVec3 &velocity, const idVec3 &delta );
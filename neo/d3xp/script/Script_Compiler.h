@@ -195,6 +195,17 @@ enum {
 	NUM_OPCODES
 };
 
+// superinstructions, only created by idProgram::DecodeStatements for a comparison
+// that is directly followed by an OP_IFNOT on its result
+enum {
+	OP_EQ_F_IFNOT = NUM_OPCODES + 1,
+	OP_NE_F_IFNOT,
+	OP_LT_IFNOT,
+	OP_LE_IFNOT,
+	OP_GT_IFNOT,
+	OP_GE_IFNOT
+};
+
 class idCompiler {
 private:
 	static bool		punctuationValid[ 256 ];
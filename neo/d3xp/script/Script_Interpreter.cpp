@@ -33,6 +33,284 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../Game_local.h"
 
+/*
+===============================================================================
+
+	idScriptProfiler
+
+===============================================================================
+*/
+
+idScriptProfiler	scriptProfiler;
+
+/*
+================
+idScriptProfiler::idScriptProfiler
+================
+*/
+idScriptProfiler::idScriptProfiler() {
+	generation = 0;
+	enabled = false;
+}
+
+/*
+================
+idScriptProfiler::Clear
+
+Function pointers are only valid for the current program, so this is called when the program is restarted
+================
+*/
+void idScriptProfiler::Clear() {
+	nodes.Clear();
+	nodeHash.Clear();
+
+	scriptProfileNode_t &root = nodes.Alloc();
+	root.func = NULL;
+	root.parent = 0;
+	root.calls = 0;
+	root.selfTime = 0;
+
+	generation++;
+}
+
+/*
+================
+idScriptProfiler::IsEnabled
+================
+*/
+bool idScriptProfiler::IsEnabled() {
+	const bool enable = g_scriptProfile.GetBool();
+	if ( enable != enabled ) {
+		enabled = enable;
+		if ( nodes.Num() == 0 ) {
+			Clear();
+		}
+		// the call paths weren't tracked while disabled
+		generation++;
+	}
+	return enabled;
+}
+
+/*
+================
+idScriptProfiler::NodeKey
+================
+*/
+int idScriptProfiler::NodeKey( int parent, const function_t *func ) const {
+	return parent ^ (int)( ( (UINT_PTR)func ) >> 4 );
+}
+
+/*
+================
+idScriptProfiler::GetChild
+
+Returns the node for func called from parent, adding it the first time
+================
+*/
+int idScriptProfiler::GetChild( int parent, const function_t *func ) {
+	const int key = NodeKey( parent, func );
+	for ( int i = nodeHash.First( key ); i != -1; i = nodeHash.Next( i ) ) {
+		if ( nodes[ i ].func == func && nodes[ i ].parent == parent ) {
+			return i;
+		}
+	}
+
+	scriptProfileNode_t &node = nodes.Alloc();
+	node.func = func;
+	node.parent = parent;
+	node.calls = 0;
+	node.selfTime = 0;
+
+	const int index = nodes.Num() - 1;
+	nodeHash.Add( key, index );
+	return index;
+}
+
+/*
+================
+idScriptProfiler::BuildPath
+================
+*/
+void idScriptProfiler::BuildPath( int node, idStr &path ) const {
+	if ( node == 0 ) {
+		return;
+	}
+	BuildPath( nodes[ node ].parent, path );
+	if ( path.Length() ) {
+		path += ";";
+	}
+	path += nodes[ node ].func->Name();
+}
+
+typedef struct scriptProfileTotal_s {
+	const function_t *	func;
+	int					calls;
+	uint64				selfTime;
+	uint64				totalTime;
+} scriptProfileTotal_t;
+
+class idSort_ScriptProfileTotal : public idSort_Quick< scriptProfileTotal_t, idSort_ScriptProfileTotal > {
+public:
+	int Compare( const scriptProfileTotal_t & a, const scriptProfileTotal_t & b ) const {
+		if ( a.selfTime != b.selfTime ) {
+			return ( a.selfTime > b.selfTime ) ? -1 : 1;
+		}
+		return ( a.totalTime > b.totalTime ) ? -1 : ( a.totalTime < b.totalTime ) ? 1 : 0;
+	}
+};
+
+/*
+================
+idScriptProfiler::PrintReport
+
+Prints functions and events sorted by exclusive time. The inclusive time of a
+recursive function only counts its outermost calls.
+================
+*/
+void idScriptProfiler::PrintReport( int maxLines ) const {
+	idList<uint64> subtreeTime;
+	idList<scriptProfileTotal_t> totals;
+	idHashIndex totalHash;
+	uint64 allTime = 0;
+
+	// children are always added after their parent
+	subtreeTime.SetNum( nodes.Num() );
+	for ( int i = 0; i < nodes.Num(); i++ ) {
+		subtreeTime[ i ] = nodes[ i ].selfTime;
+	}
+	for ( int i = nodes.Num() - 1; i > 0; i-- ) {
+		subtreeTime[ nodes[ i ].parent ] += subtreeTime[ i ];
+	}
+
+	for ( int i = 1; i < nodes.Num(); i++ ) {
+		const scriptProfileNode_t &node = nodes[ i ];
+		const int key = (int)( ( (UINT_PTR)node.func ) >> 4 );
+
+		int t;
+		for ( t = totalHash.First( key ); t != -1; t = totalHash.Next( t ) ) {
+			if ( totals[ t ].func == node.func ) {
+				break;
+			}
+		}
+		if ( t == -1 ) {
+			scriptProfileTotal_t &total = totals.Alloc();
+			total.func = node.func;
+			total.calls = 0;
+			total.selfTime = 0;
+			total.totalTime = 0;
+			t = totals.Num() - 1;
+			totalHash.Add( key, t );
+		}
+
+		scriptProfileTotal_t &total = totals[ t ];
+		total.calls += node.calls;
+		total.selfTime += node.selfTime;
+		allTime += node.selfTime;
+
+		bool recursive = false;
+		for ( int p = node.parent; p != 0; p = nodes[ p ].parent ) {
+			if ( nodes[ p ].func == node.func ) {
+				recursive = true;
+				break;
+			}
+		}
+		if ( !recursive ) {
+			total.totalTime += subtreeTime[ i ];
+		}
+	}
+
+	totals.SortWithTemplate( idSort_ScriptProfileTotal() );
+
+	for ( int pass = 0; pass < 2; pass++ ) {
+		const bool events = ( pass == 1 );
+
+		gameLocal.Printf( "\n%s:\n", events ? "events" : "functions" );
+		gameLocal.Printf( "   calls   excl ms   incl ms  excl %%  name\n" );
+
+		int lines = 0;
+		for ( int i = 0; i < totals.Num() && lines < maxLines; i++ ) {
+			const scriptProfileTotal_t &total = totals[ i ];
+			if ( ( total.func->eventdef != NULL ) != events ) {
+				continue;
+			}
+			gameLocal.Printf( "%8d %9.2f %9.2f %6.1f%%  %s\n", total.calls, total.selfTime * 0.001f, total.totalTime * 0.001f,
+				allTime ? 100.0f * total.selfTime / allTime : 0.0f, total.func->Name() );
+			lines++;
+		}
+	}
+
+	gameLocal.Printf( "\n%.2f ms of script time in %d call paths\n", allTime * 0.001f, nodes.Num() - 1 );
+}
+
+/*
+================
+idScriptProfiler::WriteCollapsedStacks
+
+Writes one "caller;callee microseconds" line per call path, the input format of flamegraph.pl
+================
+*/
+void idScriptProfiler::WriteCollapsedStacks( const char *fileName ) const {
+	idFile *file = fileSystem->OpenFileWrite( fileName, "fs_savepath" );
+	if ( file == NULL ) {
+		gameLocal.Warning( "Couldn't open %s", fileName );
+		return;
+	}
+
+	idStr path;
+	int numLines = 0;
+	for ( int i = 1; i < nodes.Num(); i++ ) {
+		if ( nodes[ i ].selfTime == 0 ) {
+			continue;
+		}
+		path.Clear();
+		BuildPath( i, path );
+		file->Printf( "%s %llu\n", path.c_str(), nodes[ i ].selfTime );
+		numLines++;
+	}
+
+	fileSystem->CloseFile( file );
+	gameLocal.Printf( "wrote %d call paths to %s\n", numLines, fileName );
+}
+
+/*
+================
+idScriptProfiler::ScriptProfile_f
+================
+*/
+void idScriptProfiler::ScriptProfile_f( const idCmdArgs &args ) {
+	int maxLines = 30;
+	if ( args.Argc() > 1 ) {
+		maxLines = atoi( args.Argv( 1 ) );
+	}
+	if ( !g_scriptProfile.GetBool() ) {
+		gameLocal.Printf( "g_scriptProfile is not set, showing the data collected so far\n" );
+	}
+	scriptProfiler.PrintReport( maxLines );
+}
+
+/*
+================
+idScriptProfiler::ScriptProfileDump_f
+================
+*/
+void idScriptProfiler::ScriptProfileDump_f( const idCmdArgs &args ) {
+	idStr fileName = "scriptprofile.txt";
+	if ( args.Argc() > 1 ) {
+		fileName = args.Argv( 1 );
+		fileName.DefaultFileExtension( ".txt" );
+	}
+	scriptProfiler.WriteCollapsedStacks( fileName );
+}
+
+/*
+================
+idScriptProfiler::ScriptProfileReset_f
+================
+*/
+void idScriptProfiler::ScriptProfileReset_f( const idCmdArgs &args ) {
+	scriptProfiler.Clear();
+}
+
 /*
 ================
 idInterpreter::idInterpreter()
@@ -150,6 +428,9 @@ void idInterpreter::Restore( idRestoreGame *savefile ) {
 	savefile->ReadBool( threadDying );
 	savefile->ReadBool( terminateOnExit );
 	savefile->ReadBool( debug );
+
+	profileGeneration = -1;
+	profileTime = 0;
 }
 
 /*
@@ -174,6 +455,11 @@ void idInterpreter::Reset() {
 
 	threadDying 	= false;
 	doneProcessing	= true;
+
+	// an empty call stack is always at the root of the profile
+	profileNode = 0;
+	profileGeneration = scriptProfiler.GetGeneration();
+	profileTime = 0;
 }
 
 /*
@@ -597,6 +883,10 @@ void idInterpreter::EnterFunction( const function_t *func, bool clearStack ) {
 		}
 	}
 
+	if ( scriptProfiler.IsEnabled() ) {
+		ProfileEnter( func );
+	}
+
 	currentFunction = func;
 	assert( !func->eventdef );
 	NextInstruction( func->firstStatement );
@@ -673,6 +963,10 @@ void idInterpreter::LeaveFunction( idVarDef *returnDef ) {
 	localstackBase = stack->stackbase;
 	NextInstruction( stack->s );
 
+	if ( scriptProfiler.IsEnabled() ) {
+		ProfileLeave();
+	}
+
 	if ( !callStackDepth ) {
 		// all done
 		doneProcessing = true;
@@ -798,7 +1092,15 @@ void idInterpreter::CallEvent( const function_t *func, int argsize ) {
 	}
 
 	popParms = argsize;
-	eventEntity->ProcessEventArgPtr( evdef, data );
+	if ( scriptProfiler.IsEnabled() ) {
+		const function_t *caller = currentFunction;
+		const int callerDepth = callStackDepth;
+		ProfileEnter( func );
+		eventEntity->ProcessEventArgPtr( evdef, data );
+		ProfileLeaveEvent( caller, callerDepth );
+	} else {
+		eventEntity->ProcessEventArgPtr( evdef, data );
+	}
 
 	if ( !multiFrameEvent ) {
 		if ( popParms ) {
@@ -929,13 +1231,539 @@ void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
 	}
 
 	popParms = argsize;
-	thread->ProcessEventArgPtr( evdef, data );
+	if ( scriptProfiler.IsEnabled() ) {
+		const function_t *caller = currentFunction;
+		const int callerDepth = callStackDepth;
+		ProfileEnter( func );
+		thread->ProcessEventArgPtr( evdef, data );
+		ProfileLeaveEvent( caller, callerDepth );
+	} else {
+		thread->ProcessEventArgPtr( evdef, data );
+	}
 	if ( popParms ) {
 		PopParms( popParms );
 	}
 	popParms = 0;
 }
 
+/*
+====================
+idInterpreter::ProfileSync
+
+Finds the profile node for the current call stack after the profiler was
+turned on, cleared, or the stack was changed behind its back
+====================
+*/
+void idInterpreter::ProfileSync() {
+	if ( profileGeneration == scriptProfiler.GetGeneration() ) {
+		return;
+	}
+
+	profileNode = 0;
+	if ( callStackDepth > 0 ) {
+		// callStack[ i ].f is the caller of frame i, frame 0 was entered from outside the script
+		for ( int i = 1; i < callStackDepth; i++ ) {
+			if ( callStack[ i ].f != NULL ) {
+				profileNode = scriptProfiler.GetChild( profileNode, callStack[ i ].f );
+			}
+		}
+		if ( currentFunction != NULL ) {
+			profileNode = scriptProfiler.GetChild( profileNode, currentFunction );
+		}
+	}
+	profileGeneration = scriptProfiler.GetGeneration();
+}
+
+/*
+====================
+idInterpreter::ProfileCharge
+====================
+*/
+void idInterpreter::ProfileCharge() {
+	if ( profileTime != 0 && profileGeneration == scriptProfiler.GetGeneration() ) {
+		const uint64 now = Sys_Microseconds();
+		scriptProfiler.AddTime( profileNode, now - profileTime );
+		profileTime = now;
+	}
+}
+
+/*
+====================
+idInterpreter::ProfileEnter
+====================
+*/
+void idInterpreter::ProfileEnter( const function_t *func ) {
+	if ( profileGeneration != scriptProfiler.GetGeneration() ) {
+		// resynced from the call stack by the next Execute
+		return;
+	}
+	ProfileCharge();
+	profileNode = scriptProfiler.GetChild( profileNode, func );
+	scriptProfiler.AddCall( profileNode );
+}
+
+/*
+====================
+idInterpreter::ProfileLeave
+====================
+*/
+void idInterpreter::ProfileLeave() {
+	if ( profileGeneration != scriptProfiler.GetGeneration() ) {
+		return;
+	}
+	ProfileCharge();
+	profileNode = scriptProfiler.GetParent( profileNode );
+}
+
+/*
+====================
+idInterpreter::ProfileLeaveEvent
+
+Some events start script functions on this interpreter, in which case the
+node is rebuilt from the call stack instead of popping the event's node
+====================
+*/
+void idInterpreter::ProfileLeaveEvent( const function_t *caller, int callerDepth ) {
+	ProfileLeave();
+	if ( currentFunction != caller || callStackDepth != callerDepth ) {
+		profileGeneration = -1;
+		ProfileSync();
+	}
+}
+
+/*
+====================
+idInterpreter::FusedIfNot
+
+Second half of a fused comparison, stores the result and runs the OP_IFNOT
+that tests it, counted like any other statement
+====================
+*/
+ID_INLINE void idInterpreter::FusedIfNot( const scriptInstruction_t *in, float result, int &runaway ) {
+	varEval_t var_c = GetOperand( in->c, in->stackC );
+	*var_c.floatPtr = result;
+
+	instructionPointer++;
+	if ( !--runaway ) {
+		Error( "runaway loop error" );
+	}
+	in = &gameLocal.program.GetInstruction( instructionPointer );
+	if ( *var_c.intPtr == 0 ) {
+		NextInstruction( instructionPointer + in->b.jumpOffset );
+	}
+}
+
+/*
+====================
+idInterpreter::ExecuteDecoded
+
+Runs the simple opcodes straight from the decoded instruction. Returns false
+for everything that has to go through the statement switch in Execute.
+====================
+*/
+ID_INLINE bool idInterpreter::ExecuteDecoded( const scriptInstruction_t *in, int &runaway ) {
+	varEval_t	var_a;
+	varEval_t	var_b;
+	varEval_t	var_c;
+
+	switch( in->op ) {
+	case OP_EQ_F_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		FusedIfNot( in, ( *var_a.floatPtr == *var_b.floatPtr ), runaway );
+		return true;
+
+	case OP_NE_F_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		FusedIfNot( in, ( *var_a.floatPtr != *var_b.floatPtr ), runaway );
+		return true;
+
+	case OP_LT_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		FusedIfNot( in, ( *var_a.floatPtr < *var_b.floatPtr ), runaway );
+		return true;
+
+	case OP_LE_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		FusedIfNot( in, ( *var_a.floatPtr <= *var_b.floatPtr ), runaway );
+		return true;
+
+	case OP_GT_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		FusedIfNot( in, ( *var_a.floatPtr > *var_b.floatPtr ), runaway );
+		return true;
+
+	case OP_GE_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		FusedIfNot( in, ( *var_a.floatPtr >= *var_b.floatPtr ), runaway );
+		return true;
+
+	case OP_IFNOT:
+		var_a = GetOperand( in->a, in->stackA );
+		if ( *var_a.intPtr == 0 ) {
+			NextInstruction( instructionPointer + in->b.jumpOffset );
+		}
+		return true;
+
+	case OP_IF:
+		var_a = GetOperand( in->a, in->stackA );
+		if ( *var_a.intPtr != 0 ) {
+			NextInstruction( instructionPointer + in->b.jumpOffset );
+		}
+		return true;
+
+	case OP_GOTO:
+		NextInstruction( instructionPointer + in->a.jumpOffset );
+		return true;
+
+	case OP_ADD_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
+		return true;
+
+	case OP_ADD_V:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
+		return true;
+
+	case OP_SUB_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
+		return true;
+
+	case OP_SUB_V:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
+		return true;
+
+	case OP_MUL_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
+		return true;
+
+	case OP_MUL_V:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
+		return true;
+
+	case OP_EQ_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
+		return true;
+
+	case OP_NE_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
+		return true;
+
+	case OP_LT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
+		return true;
+
+	case OP_LE:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
+		return true;
+
+	case OP_GT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
+		return true;
+
+	case OP_GE:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
+		return true;
+
+	case OP_AND:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
+		return true;
+
+	case OP_OR:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
+		return true;
+
+	case OP_NOT_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
+		return true;
+
+	case OP_NOT_BOOL:
+		var_a = GetOperand( in->a, in->stackA );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = ( *var_a.intPtr == 0 );
+		return true;
+
+	case OP_NEG_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_c = GetOperand( in->c, in->stackC );
+		*var_c.floatPtr = -*var_a.floatPtr;
+		return true;
+
+	case OP_UADD_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.floatPtr += *var_a.floatPtr;
+		return true;
+
+	case OP_USUB_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.floatPtr -= *var_a.floatPtr;
+		return true;
+
+	case OP_UMUL_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.floatPtr *= *var_a.floatPtr;
+		return true;
+
+	case OP_UINC_F:
+		var_a = GetOperand( in->a, in->stackA );
+		( *var_a.floatPtr )++;
+		return true;
+
+	case OP_UDEC_F:
+		var_a = GetOperand( in->a, in->stackA );
+		( *var_a.floatPtr )--;
+		return true;
+
+	case OP_STORE_F:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.floatPtr = *var_a.floatPtr;
+		return true;
+
+	case OP_STORE_V:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.vectorPtr = *var_a.vectorPtr;
+		return true;
+
+	case OP_STORE_ENT:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.entityNumberPtr = *var_a.entityNumberPtr;
+		return true;
+
+	case OP_STORE_BOOL:
+		var_a = GetOperand( in->a, in->stackA );
+		var_b = GetOperand( in->b, in->stackB );
+		*var_b.intPtr = *var_a.intPtr;
+		return true;
+
+	case OP_PUSH_F:
+		var_a = GetOperand( in->a, in->stackA );
+		Push( *var_a.intPtr );
+		return true;
+
+	case OP_PUSH_ENT:
+		var_a = GetOperand( in->a, in->stackA );
+		Push( *var_a.entityNumberPtr );
+		return true;
+
+	case OP_PUSH_V:
+		var_a = GetOperand( in->a, in->stackA );
+		Push( *reinterpret_cast<int *>( &var_a.vectorPtr->x ) );
+		Push( *reinterpret_cast<int *>( &var_a.vectorPtr->y ) );
+		Push( *reinterpret_cast<int *>( &var_a.vectorPtr->z ) );
+		return true;
+
+	default:
+		// everything else, including all calls and object access, goes through the statement switch
+		return false;
+	}
+}
+
+/*
+====================
+idInterpreter::GetFastPathResult
+
+Where ExecuteDecoded writes the result of an instruction, size is 0 for
+branches and pushes. Returns false for the opcodes it doesn't handle.
+====================
+*/
+bool idInterpreter::GetFastPathResult( const scriptInstruction_t *in, varEval_t &result, int &size ) {
+	switch( in->op ) {
+	case OP_EQ_F_IFNOT:
+	case OP_NE_F_IFNOT:
+	case OP_LT_IFNOT:
+	case OP_LE_IFNOT:
+	case OP_GT_IFNOT:
+	case OP_GE_IFNOT:
+	case OP_ADD_F:
+	case OP_SUB_F:
+	case OP_MUL_F:
+	case OP_MUL_V:
+	case OP_EQ_F:
+	case OP_NE_F:
+	case OP_LT:
+	case OP_LE:
+	case OP_GT:
+	case OP_GE:
+	case OP_AND:
+	case OP_OR:
+	case OP_NOT_F:
+	case OP_NOT_BOOL:
+	case OP_NEG_F:
+		result = GetOperand( in->c, in->stackC );
+		size = sizeof( float );
+		return true;
+
+	case OP_ADD_V:
+	case OP_SUB_V:
+		result = GetOperand( in->c, in->stackC );
+		size = sizeof( idVec3 );
+		return true;
+
+	case OP_UADD_F:
+	case OP_USUB_F:
+	case OP_UMUL_F:
+	case OP_STORE_F:
+	case OP_STORE_ENT:
+	case OP_STORE_BOOL:
+		result = GetOperand( in->b, in->stackB );
+		size = sizeof( int );
+		return true;
+
+	case OP_STORE_V:
+		result = GetOperand( in->b, in->stackB );
+		size = sizeof( idVec3 );
+		return true;
+
+	case OP_UINC_F:
+	case OP_UDEC_F:
+		result = GetOperand( in->a, in->stackA );
+		size = sizeof( float );
+		return true;
+
+	case OP_IFNOT:
+	case OP_IF:
+	case OP_GOTO:
+	case OP_PUSH_F:
+	case OP_PUSH_ENT:
+	case OP_PUSH_V:
+		result.bytePtr = NULL;
+		size = 0;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/*
+====================
+idInterpreter::StartFastPathCheck
+
+Runs the decoded instruction and keeps what it did, then puts the interpreter
+back so the statement switch runs the same statements from the same state.
+====================
+*/
+void idInterpreter::StartFastPathCheck( const scriptInstruction_t *in, scriptFastPathCheck_t &check, int &runaway ) {
+	varEval_t	result;
+	int			size;
+	byte		saved[ sizeof( idVec3 ) ];
+
+	if ( !GetFastPathResult( in, result, size ) ) {
+		return;
+	}
+
+	const int savedInstructionPointer = instructionPointer;
+	const int savedLocalstackUsed = localstackUsed;
+	const int savedRunaway = runaway;
+	if ( size > 0 ) {
+		memcpy( saved, result.bytePtr, size );
+	}
+
+	ExecuteDecoded( in, runaway );
+
+	check.statement = savedInstructionPointer;
+	check.op = in->op;
+	check.instructionPointer = instructionPointer;
+	check.localstackUsed = localstackUsed;
+	check.runaway = runaway;
+	check.result = result.bytePtr;
+	check.resultSize = size;
+	if ( size > 0 ) {
+		memcpy( check.resultData, result.bytePtr, size );
+	}
+	check.pushedSize = localstackUsed - savedLocalstackUsed;
+	if ( check.pushedSize > 0 ) {
+		memcpy( check.pushedData, &localstack[ savedLocalstackUsed ], check.pushedSize );
+	}
+
+	instructionPointer = savedInstructionPointer;
+	localstackUsed = savedLocalstackUsed;
+	runaway = savedRunaway;
+	if ( size > 0 ) {
+		memcpy( result.bytePtr, saved, size );
+	}
+
+	// a fused instruction covers the comparison and the OP_IFNOT after it
+	check.statementsLeft = ( in->op > NUM_OPCODES ) ? 2 : 1;
+}
+
+/*
+====================
+idInterpreter::FinishFastPathCheck
+
+Compares the interpreter state the statement switch left with the one the
+decoded instruction left in StartFastPathCheck.
+====================
+*/
+void idInterpreter::FinishFastPathCheck( const scriptFastPathCheck_t &check, int runaway ) {
+	bool same = ( instructionPointer == check.instructionPointer ) && ( localstackUsed == check.localstackUsed ) && ( runaway == check.runaway );
+	if ( same && check.resultSize > 0 ) {
+		same = ( memcmp( check.result, check.resultData, check.resultSize ) == 0 );
+	}
+	if ( same && check.pushedSize > 0 ) {
+		same = ( memcmp( &localstack[ localstackUsed - check.pushedSize ], check.pushedData, check.pushedSize ) == 0 );
+	}
+
+	if ( !same ) {
+		const statement_t &st = gameLocal.program.GetStatement( check.statement );
+		gameLocal.Warning( "%s(%d): g_scriptFastPath: decoded op %d differs from the statement switch running %s", gameLocal.program.GetFilename( st.file ), st.linenumber, check.op, idCompiler::opcodes[ st.op ].name );
+	}
+}
+
 /*
 ====================
 idInterpreter::Execute
@@ -947,6 +1775,7 @@ bool idInterpreter::Execute() {
 	varEval_t	var_c;
 	varEval_t	var;
 	statement_t	*st;
+	scriptFastPathCheck_t check;
 	int 		runaway;
 	idThread	*newThread;
 	float		floatVal;
@@ -964,14 +1793,36 @@ bool idInterpreter::Execute() {
 
 	runaway = 5000000;
 
+	const int fastPath = g_scriptFastPath.GetInteger();
+	check.statementsLeft = 0;
+
+	const bool profiling = scriptProfiler.IsEnabled();
+	if ( profiling ) {
+		ProfileSync();
+		profileTime = Sys_Microseconds();
+	}
+
 	doneProcessing = false;
 	while( !doneProcessing && !threadDying ) {
+		if ( check.statementsLeft != 0 && --check.statementsLeft == 0 ) {
+			FinishFastPathCheck( check, runaway );
+		}
+
 		instructionPointer++;
 
 		if ( !--runaway ) {
 			Error( "runaway loop error" );
 		}
 
+		// the simple opcodes run straight from the decoded instruction
+		if ( fastPath == 1 ) {
+			if ( ExecuteDecoded( &gameLocal.program.GetInstruction( instructionPointer ), runaway ) ) {
+				continue;
+			}
+		} else if ( fastPath == 2 && check.statementsLeft == 0 ) {
+			StartFastPathCheck( &gameLocal.program.GetInstruction( instructionPointer ), check, runaway );
+		}
+
 		// next statement
 		st = &gameLocal.program.GetStatement( instructionPointer );
 
@@ -1839,5 +2690,10 @@ bool idInterpreter::Execute() {
 		}
 	}
 
+	if ( profiling ) {
+		ProfileCharge();
+		profileTime = 0;
+	}
+
 	return threadDying;
 }
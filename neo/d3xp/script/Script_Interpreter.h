@@ -39,6 +39,73 @@ typedef struct prstack_s {
 	int 				stackbase;
 } prstack_t;
 
+/*
+===============================================================================
+
+	idScriptProfiler
+
+	Instrumented profiler for the script VM, turned on with g_scriptProfile.
+	Time is charged to the nodes of a call tree, one node per function on a
+	call path, so script threads don't collect time while they are waiting.
+	Event calls are leaf nodes under the function that called them.
+
+===============================================================================
+*/
+
+typedef struct scriptProfileNode_s {
+	const function_t *	func;			// script function, or the event's function_t for event calls
+	int					parent;
+	int					calls;
+	uint64				selfTime;		// microseconds spent in this node, not counting children
+} scriptProfileNode_t;
+
+class idScriptProfiler {
+public:
+						idScriptProfiler();
+
+	void				Clear();
+	bool				IsEnabled();
+	int					GetGeneration() const { return generation; }
+
+	int					GetChild( int parent, const function_t *func );
+	int					GetParent( int node ) const { return nodes[ node ].parent; }
+	void				AddCall( int node ) { nodes[ node ].calls++; }
+	void				AddTime( int node, uint64 time ) { nodes[ node ].selfTime += time; }
+
+	void				PrintReport( int maxLines ) const;
+	void				WriteCollapsedStacks( const char *fileName ) const;
+
+	static void			ScriptProfile_f( const idCmdArgs &args );
+	static void			ScriptProfileDump_f( const idCmdArgs &args );
+	static void			ScriptProfileReset_f( const idCmdArgs &args );
+
+private:
+	idList<scriptProfileNode_t, TAG_SCRIPT>	nodes;		// node 0 is the root of every call path
+	idHashIndex			nodeHash;
+	int					generation;		// bumped whenever the interpreters have to rebuild their node
+	bool				enabled;
+
+	int					NodeKey( int parent, const function_t *func ) const;
+	void				BuildPath( int node, idStr &path ) const;
+};
+
+extern idScriptProfiler	scriptProfiler;
+
+// g_scriptFastPath 2 state, what the decoded instruction did before the statement switch runs it again
+typedef struct scriptFastPathCheck_s {
+	int					statementsLeft;		// statements the switch runs before the compare, 0 when idle
+	int					statement;
+	int					op;
+	int					instructionPointer;
+	int					localstackUsed;
+	int					runaway;
+	byte *				result;				// NULL for branches and pushes
+	int					resultSize;
+	byte				resultData[ sizeof( idVec3 ) ];
+	int					pushedSize;
+	byte				pushedData[ sizeof( idVec3 ) ];
+} scriptFastPathCheck_t;
+
 class idInterpreter {
 private:
 	prstack_t			callStack[ MAX_STACK_DEPTH ];
@@ -59,6 +126,16 @@ private:
 
 	idThread			*thread;
 
+	int					profileNode;		// scriptProfiler node of the current function
+	int					profileGeneration;
+	uint64				profileTime;		// start of the time not yet charged to profileNode, 0 outside Execute
+
+	void				ProfileSync();
+	void				ProfileCharge();
+	void				ProfileEnter( const function_t *func );
+	void				ProfileLeave();
+	void				ProfileLeaveEvent( const function_t *caller, int callerDepth );
+
 	void				PopParms( int numParms );
 	void				PushString( const char *string );
 	void				Push( int value );
@@ -67,10 +144,17 @@ private:
 	void				SetString( idVarDef *def, const char *from );
 	const char			*GetString( idVarDef *def );
 	varEval_t			GetVariable( idVarDef *def );
+	varEval_t			GetOperand( varEval_t operand, bool onStack );
 	idEntity			*GetEntity( int entnum ) const;
 	idScriptObject		*GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
 
+	void				FusedIfNot( const scriptInstruction_t *in, float result, int &runaway );
+	bool				ExecuteDecoded( const scriptInstruction_t *in, int &runaway );
+	bool				GetFastPathResult( const scriptInstruction_t *in, varEval_t &result, int &size );
+	void				StartFastPathCheck( const scriptInstruction_t *in, scriptFastPathCheck_t &check, int &runaway );
+	void				FinishFastPathCheck( const scriptFastPathCheck_t &check, int runaway );
+
 	void				LeaveFunction( idVarDef *returnDef );
 	void				CallEvent( const function_t *func, int argsize );
 	void				CallSysEvent( const function_t *func, int argsize );
@@ -227,6 +311,20 @@ ID_INLINE varEval_t idInterpreter::GetVariable( idVarDef *def ) {
 	}
 }
 
+/*
+====================
+idInterpreter::GetOperand
+
+Same as GetVariable for an operand of a decoded scriptInstruction_t
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetOperand( varEval_t operand, bool onStack ) {
+	if ( onStack ) {
+		operand.intPtr = ( int * )&localstack[ localstackBase + operand.stackOffset ];
+	}
+	return operand;
+}
+
 /*
 ================
 idInterpreter::GetEntity
@@ -1584,6 +1584,8 @@ void idProgram::BeginCompilation() {
 
 	FreeData();
 
+	scriptProfiler.Clear();
+
 	try {
 		// make the first statement a return for a "NULL" function
 		statement = AllocStatement();
@@ -1691,6 +1693,8 @@ void idProgram::FinishCompilation() {
 	top_defs		= varDefs.Num();
 	top_files		= fileList.Num();
 
+	DecodeStatements( false );
+
 	variableDefaults.Clear();
 	variableDefaults.SetNum( numVariables );
 
@@ -1755,6 +1759,169 @@ void idProgram::CompileStats() {
 	gameLocal.Printf( " Thread size: %d bytes\n\n", sizeof( idThread ) );
 }
 
+/*
+================
+DecodeOperand
+================
+*/
+static void DecodeOperand( const idVarDef *def, varEval_t &value, bool &onStack ) {
+	if ( def == NULL ) {
+		value.intPtr = NULL;
+		onStack = false;
+	} else if ( def->initialized == idVarDef::stackVariable ) {
+		value.intPtr = NULL;
+		value.stackOffset = def->value.stackOffset;
+		onStack = true;
+	} else {
+		value = def->value;
+		onStack = false;
+	}
+}
+
+/*
+================
+CheckDecodedOperand
+
+Compares a decoded operand with what idInterpreter::GetVariable does for the def
+================
+*/
+static bool CheckDecodedOperand( const idVarDef *def, const varEval_t &value, bool onStack ) {
+	if ( def == NULL ) {
+		return !onStack && value.intPtr == NULL;
+	}
+	if ( def->initialized == idVarDef::stackVariable ) {
+		return onStack && value.stackOffset == def->value.stackOffset;
+	}
+	return !onStack && memcmp( &value, &def->value, sizeof( value ) ) == 0;
+}
+
+/*
+================
+idProgram::CheckDecodedStatements
+
+Walks every compiled function and compares each decoded instruction with the
+statement it was made from, including whether a comparison was fused with the
+OP_IFNOT after it. Returns the number of mismatches.
+================
+*/
+int idProgram::CheckDecodedStatements() const {
+	int numChecked = 0;
+	int numFused = 0;
+	int numErrors = 0;
+
+	if ( instructions.Num() != statements.Num() ) {
+		gameLocal.Warning( "%d decoded instructions for %d statements", instructions.Num(), statements.Num() );
+		return 1;
+	}
+
+	for ( int i = 0; i < functions.Num(); i++ ) {
+		const function_t *func = &functions[ i ];
+		if ( func->eventdef ) {
+			continue;
+		}
+
+		for ( int j = 0; j < func->numStatements; j++ ) {
+			const int num = func->firstStatement + j;
+			const statement_t &st = statements[ num ];
+			const scriptInstruction_t &in = instructions[ num ];
+
+			int fusedOp = -1;
+			if ( j < func->numStatements - 1 ) {
+				const statement_t &next = statements[ num + 1 ];
+				if ( next.op == OP_IFNOT && next.a == st.c && st.c != NULL ) {
+					switch( st.op ) {
+					case OP_EQ_F:	fusedOp = OP_EQ_F_IFNOT; break;
+					case OP_NE_F:	fusedOp = OP_NE_F_IFNOT; break;
+					case OP_LT:		fusedOp = OP_LT_IFNOT; break;
+					case OP_LE:		fusedOp = OP_LE_IFNOT; break;
+					case OP_GT:		fusedOp = OP_GT_IFNOT; break;
+					case OP_GE:		fusedOp = OP_GE_IFNOT; break;
+					default:		break;
+					}
+				}
+			}
+
+			const int expectedOp = ( fusedOp != -1 ) ? fusedOp : st.op;
+			const char *error = NULL;
+			if ( in.op != expectedOp ) {
+				error = "op";
+			} else if ( !CheckDecodedOperand( st.a, in.a, in.stackA ) ) {
+				error = "a";
+			} else if ( !CheckDecodedOperand( st.b, in.b, in.stackB ) ) {
+				error = "b";
+			} else if ( !CheckDecodedOperand( st.c, in.c, in.stackC ) ) {
+				error = "c";
+			}
+
+			if ( error != NULL ) {
+				gameLocal.Warning( "%s(%d): %s statement %d (%s): decoded %s differs", fileList[ st.file ].c_str(), st.linenumber, func->Name(), num, idCompiler::opcodes[ st.op ].name, error );
+				numErrors++;
+			}
+			if ( fusedOp != -1 ) {
+				numFused++;
+			}
+			numChecked++;
+		}
+	}
+
+	gameLocal.Printf( "%d statements checked, %d fused, %d mismatches\n", numChecked, numFused, numErrors );
+	return numErrors;
+}
+
+/*
+================
+idProgram::DecodeStatements
+
+Decodes the statements added since the last call so the interpreter doesn't
+have to look through the defs for every operand, and fuses comparisons with
+the OP_IFNOT that tests them. Jumps can still land on the OP_IFNOT itself,
+so it keeps its own instruction.
+================
+*/
+void idProgram::DecodeStatements( bool compileFailed ) {
+	int first = instructions.Num();
+	instructions.SetNum( statements.Num() );
+
+	for ( int i = first; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[ i ];
+		scriptInstruction_t &in = instructions[ i ];
+
+		if ( compileFailed ) {
+			// the defs used by a failed compile may already be freed, these are never executed anyway
+			memset( &in, 0, sizeof( in ) );
+			in.op = OP_BREAK;
+			continue;
+		}
+
+		in.op = st.op;
+		DecodeOperand( st.a, in.a, in.stackA );
+		DecodeOperand( st.b, in.b, in.stackB );
+		DecodeOperand( st.c, in.c, in.stackC );
+	}
+
+	if ( compileFailed ) {
+		return;
+	}
+
+	for ( int i = first; i < statements.Num() - 1; i++ ) {
+		const statement_t &st = statements[ i ];
+		const statement_t &next = statements[ i + 1 ];
+		if ( next.op != OP_IFNOT || next.a != st.c || st.c == NULL ) {
+			continue;
+		}
+
+		switch( st.op ) {
+		case OP_EQ_F:	instructions[ i ].op = OP_EQ_F_IFNOT; break;
+		case OP_NE_F:	instructions[ i ].op = OP_NE_F_IFNOT; break;
+		case OP_LT:		instructions[ i ].op = OP_LT_IFNOT; break;
+		case OP_LE:		instructions[ i ].op = OP_LE_IFNOT; break;
+		case OP_GT:		instructions[ i ].op = OP_GT_IFNOT; break;
+		case OP_GE:		instructions[ i ].op = OP_GE_IFNOT; break;
+		default:		break;
+		}
+	}
+}
+
 /*
 ================
 idProgram::CompileText
@@ -1787,12 +1954,15 @@ bool idProgram::CompileText( const char *source, const char *text, bool console
 	catch( idCompileError &err ) {
 		if ( console ) {
 			gameLocal.Printf( "%s\n", err.GetError() );
+			DecodeStatements( true );
 			return false;
 		} else {
 			gameLocal.Error( "%s\n", err.GetError() );
 		}
 	};
 
+	DecodeStatements( false );
+
 	if ( !console ) {
 		CompileStats();
 	}
@@ -1881,6 +2051,7 @@ void idProgram::FreeData() {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	instructions.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -2076,6 +2247,10 @@ void idProgram::Restart() {
 	functions.SetNum( top_functions	);
 
 	statements.SetNum( top_statements );
+	instructions.SetNum( top_statements );
+
+	// the profile refers to functions that may be gone now
+	scriptProfiler.Clear();
 	fileList.SetNum( top_files );
 	filename.Clear();
 	
@@ -2119,6 +2294,7 @@ idProgram::idProgram
 idProgram::idProgram() {
 	varDefs.SetGranularity( 256 );
 	varDefNames.SetGranularity( 256 );
+	instructions.SetGranularity( 4096 );
 
 	FreeData();
 }
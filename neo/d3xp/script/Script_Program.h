@@ -422,6 +422,17 @@ typedef struct statement_s {
 	unsigned short	file;
 } statement_t;
 
+// pre-decoded copy of a statement for the interpreter, with the operand defs already resolved
+typedef struct scriptInstruction_s {
+	unsigned short	op;				// statement op, or a fused op made from this statement and the next one
+	bool			stackA;			// operand holds a stack offset instead of a pointer
+	bool			stackB;
+	bool			stackC;
+	varEval_t		a;
+	varEval_t		b;
+	varEval_t		c;
+} scriptInstruction_t;
+
 /***********************************************************************
 
 idProgram
@@ -444,6 +455,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idList<scriptInstruction_t, TAG_SCRIPT>		instructions;	// statements decoded for idInterpreter::Execute
 	idList<idTypeDef *, TAG_SCRIPT>				types;
 	idHashIndex									typesHash;
 	idList<idVarDefName *, TAG_SCRIPT>			varDefNames;
@@ -459,6 +471,7 @@ private:
 	int											top_files;
 
 	void										CompileStats();
+	void										DecodeStatements( bool compileFailed );
 
 public:
 	idVarDef									*returnDef;
@@ -512,6 +525,8 @@ public:
 	statement_t									*AllocStatement();
 	statement_t									&GetStatement( int index );
 	int											NumStatements() { return statements.Num(); }
+	const scriptInstruction_t					&GetInstruction( int index ) const;
+	int											CheckDecodedStatements() const;
 
 	int 										GetReturnedInteger();
 
@@ -533,6 +548,15 @@ ID_INLINE statement_t &idProgram::GetStatement( int index ) {
 	return statements[ index ];
 }
 
+/*
+================
+idProgram::GetInstruction
+================
+*/
+ID_INLINE const scriptInstruction_t &idProgram::GetInstruction( int index ) const {
+	return instructions[ index ];
+}
+
 /*
 ================
 idProgram::GetFunction
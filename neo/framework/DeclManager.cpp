@@ -63,6 +63,10 @@ missing reload over a previously explicit definition
 */
 
 #define USE_COMPRESSED_DECLS
+
+#define DECL_CACHE_FILENAME			"generated/decls.cache"
+static const int DECL_CACHE_MAGIC	= ( 'D' << 24 ) | ( 'C' << 16 ) | ( 'C' << 8 ) | 'H';
+static const int DECL_CACHE_VERSION	= 1;
 //#define GET_HUFFMAN_FREQUENCIES
 
 class idDeclType {
@@ -79,6 +83,25 @@ public:
 	declType_t					defaultType;
 };
 
+// Location of a single decl inside its source file, as found by the lexer.
+struct declCacheEntry_t {
+	int							type;
+	idStr						name;
+	int							offset;
+	int							size;
+	int							line;
+};
+
+// Everything idDeclFile::LoadAndParse learns from lexing a file. Valid for as
+// long as the file text has the same checksum.
+class idDeclCacheFile {
+public:
+	idStr						fileName;
+	int							checksum;
+	int							numLines;
+	idList<declCacheEntry_t>	decls;
+};
+
 class idDeclFile;
 
 class idDeclLocal : public idDeclBase {
@@ -160,8 +183,18 @@ public:
 								idDeclFile( const char *fileName, declType_t defaultType );
 
 	void						Reload( bool force );
+	bool						NeedsReload( bool force ) const;
 	int							LoadAndParse();
 
+								// LoadAndParse split so the scan of many files can run on the job threads
+	bool						ReadSource();
+	void						ScanSource( bool quiet = false );
+	bool						ScanHadMessages() const { return scanHadMessages; }
+	int							RegisterDecls();
+
+private:
+	void						AddDecl( declType_t type, const idStr & name, const char * buffer, int offset, int size, int line );
+
 public:
 	idStr						fileName;
 	declType_t					defaultType;
@@ -172,6 +205,14 @@ public:
 	int							numLines;
 
 	idDeclLocal *				decls;
+
+private:
+	char *						loadBuffer;		// file text between ReadSource and RegisterDecls
+	int							loadLength;
+	int							scannedChecksum;
+	const idDeclCacheFile *		scanned;		// decl locations found by ScanSource
+	idDeclCacheFile *			scannedFile;	// newly lexed locations, handed to the decl cache
+	bool						scanHadMessages;	// a quiet scan suppressed lexer warnings or errors
 };
 
 class idDeclManagerLocal : public idDeclManager {
@@ -218,6 +259,9 @@ public:
 
 	virtual void					Touch( const idDecl * decl );
 
+	const idDeclCacheFile *		FindCachedFile( const char * fileName, int fileChecksum );
+	void						UpdateCachedFile( idDeclCacheFile * cacheFile );
+
 public:
 	static void					MakeNameCanonical( const char *name, char *result, int maxLength );
 	idDeclLocal *				FindTypeWithoutParsing( declType_t type, const char *name, bool makeDefault = true );
@@ -243,14 +287,28 @@ private:
 	int							indent;			// for MediaPrint
 	bool						insideLevelLoad;
 
+	idList<idDeclCacheFile *, TAG_IDLIB_LIST_DECL>	declCache;
+	idHashIndex					declCacheHash;
+	bool						declCacheLoaded;
+	bool						declCacheDirty;
+
 	static idCVar				decl_show;
+	static idCVar				decl_useCache;
+	static idCVar				decl_parallelParse;
 
 private:
+	void						LoadDeclCache();
+	void						SaveDeclCache();
+	void						FreeDeclCache();
+	void						LoadAndParseFiles( const idList<idDeclFile *> & files );
+
 	static void					ListDecls_f( const idCmdArgs &args );
 	static void					ReloadDecls_f( const idCmdArgs &args );
 	static void					TouchDecl_f( const idCmdArgs &args );
 };
 
+idCVar idDeclManagerLocal::decl_useCache( "decl_useCache", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "skip lexing decl files that haven't changed since the index in " DECL_CACHE_FILENAME " was written" );
+idCVar idDeclManagerLocal::decl_parallelParse( "decl_parallelParse", "1", CVAR_SYSTEM | CVAR_BOOL, "scan decl files on the job threads when several are loaded at once" );
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 
 idDeclManagerLocal	declManagerLocal;
@@ -563,6 +621,12 @@ idDeclFile::idDeclFile( const char *fileName, declType_t defaultType ) {
 	this->fileSize = 0;
 	this->numLines = 0;
 	this->decls = NULL;
+	this->loadBuffer = NULL;
+	this->loadLength = 0;
+	this->scannedChecksum = 0;
+	this->scanned = NULL;
+	this->scanHadMessages = false;
+	this->scannedFile = NULL;
 }
 
 /*
@@ -578,6 +642,12 @@ idDeclFile::idDeclFile() {
 	this->fileSize = 0;
 	this->numLines = 0;
 	this->decls = NULL;
+	this->loadBuffer = NULL;
+	this->loadLength = 0;
+	this->scannedChecksum = 0;
+	this->scanned = NULL;
+	this->scanHadMessages = false;
+	this->scannedFile = NULL;
 }
 
 /*
@@ -588,18 +658,32 @@ ForceReload will cause it to reload even if the timestamp hasn't changed
 ================
 */
 void idDeclFile::Reload( bool force ) {
+	if ( !NeedsReload( force ) ) {
+		return;
+	}
+
+	// parse the text
+	LoadAndParse();
+}
+
+/*
+================
+idDeclFile::NeedsReload
+
+Returns false if the timestamp hasn't changed and the reload isn't forced
+================
+*/
+bool idDeclFile::NeedsReload( bool force ) const {
 	// check for an unchanged timestamp
 	if ( !force && timestamp != 0 ) {
 		ID_TIME_T	testTimeStamp;
 		fileSystem->ReadFile( fileName, NULL, &testTimeStamp );
 
 		if ( testTimeStamp == timestamp ) {
-			return;
+			return false;
 		}
 	}
-
-	// parse the text
-	LoadAndParse();
+	return true;
 }
 
 /*
@@ -612,41 +696,75 @@ This is used during both the initial load, and any reloads
 int c_savedMemory = 0;
 
 int idDeclFile::LoadAndParse() {
+	if ( !ReadSource() ) {
+		return 0;
+	}
+	ScanSource();
+	return RegisterDecls();
+}
+
+/*
+================
+idDeclFile::ReadSource
+
+Loads the file text. Must be called from the main thread.
+================
+*/
+bool idDeclFile::ReadSource() {
+	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
+	loadLength = fileSystem->ReadFile( fileName, (void **)&loadBuffer, &timestamp );
+	if ( loadLength == -1 ) {
+		loadBuffer = NULL;
+		common->FatalError( "couldn't load %s", fileName.c_str() );
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idDeclFile::ScanSource
+
+Checksums the text and finds where each decl is, either from the decl cache or
+by lexing the file. Only touches this file and read only manager state, so it
+is safe to run for several files at once on the job threads.
+
+Warnings can't be printed from the job threads, so those scans are quiet and
+only flag the file with scanHadMessages, the main thread lexes it again to
+report them.
+================
+*/
+void idDeclFile::ScanSource( bool quiet ) {
 	int			i, numTypes;
 	idLexer		src;
 	idToken		token;
 	int			startMarker;
-	char *		buffer;
-	int			length, size;
+	int			size;
 	int			sourceLine;
 	idStr		name;
-	idDeclLocal *newDecl;
-	bool		reparse;
 
-	// load the text
-	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
-	length = fileSystem->ReadFile( fileName, (void **)&buffer, &timestamp );
-	if ( length == -1 ) {
-		common->FatalError( "couldn't load %s", fileName.c_str() );
-		return 0;
-	}
+	delete scannedFile;
+	scanned = NULL;
+	scannedFile = NULL;
+	scanHadMessages = false;
 
-	if ( !src.LoadMemory( buffer, length, fileName ) ) {
-		Mem_Free( buffer );
-		idLib::Error( "Couldn't parse %s", fileName.c_str() );
-		return 0;
-	}
+	scannedChecksum = MD5_BlockChecksum( loadBuffer, loadLength );
 
-	// mark all the defs that were from the last reload of this file
-	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
-		decl->redefinedInReload = false;
+	// unchanged files reuse the decl locations found the last time they were lexed
+	scanned = declManagerLocal.FindCachedFile( fileName, scannedChecksum );
+	if ( scanned != NULL ) {
+		return;
 	}
 
-	src.SetFlags( DECL_LEXER_FLAGS );
+	if ( !src.LoadMemory( loadBuffer, loadLength, fileName ) ) {
+		return;
+	}
 
-	checksum = MD5_BlockChecksum( buffer, length );
+	src.SetFlags( quiet ? ( DECL_LEXER_FLAGS | LEXFL_NOERRORS | LEXFL_NOWARNINGS ) : DECL_LEXER_FLAGS );
 
-	fileSize = length;
+	scannedFile = new (TAG_DECL) idDeclCacheFile;
+	scannedFile->fileName = fileName;
+	scannedFile->checksum = scannedChecksum;
 
 	// scan through, identifying each individual declaration
 	while( 1 ) {
@@ -728,49 +846,61 @@ int idDeclFile::LoadAndParse() {
 		src.SkipBracedSection();
 		size = src.GetFileOffset() - startMarker;
 
-		// look it up, possibly getting a newly created default decl
-		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
-		if ( newDecl ) {
-			// update the existing copy
-			if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-								name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
-				continue;
-			}
-			if ( newDecl->declState != DS_UNPARSED ) {
-				reparse = true;
-			}
-		} else {
-			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
-			newDecl->nextInFile = this->decls;
-			this->decls = newDecl;
-		}
+		declCacheEntry_t & entry = scannedFile->decls.Alloc();
+		entry.type = identifiedType;
+		entry.name = name;
+		entry.offset = startMarker;
+		entry.size = size;
+		entry.line = sourceLine;
+	}
 
-		newDecl->redefinedInReload = true;
+	scannedFile->numLines = src.GetLineNum();
+	scanned = scannedFile;
 
-		if ( newDecl->textSource ) {
-			Mem_Free( newDecl->textSource );
-			newDecl->textSource = NULL;
-		}
+	scanHadMessages = quiet && ( src.HadWarning() || src.HadError() );
+}
 
-		newDecl->SetTextLocal( buffer + startMarker, size );
-		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
-		newDecl->sourceLine = sourceLine;
-		newDecl->declState = DS_UNPARSED;
+/*
+================
+idDeclFile::RegisterDecls
 
-		// if it is currently in use, reparse it immedaitely
-		if ( reparse ) {
-			newDecl->ParseLocal();
-		}
+Creates or updates the decls found by ScanSource. Must be called from the main
+thread, in file registration order, so decl indexes don't depend on job timing.
+================
+*/
+int idDeclFile::RegisterDecls() {
+	if ( scanned == NULL ) {
+		Mem_Free( loadBuffer );
+		loadBuffer = NULL;
+		delete scannedFile;
+		scannedFile = NULL;
+		idLib::Error( "Couldn't parse %s", fileName.c_str() );
+		return 0;
 	}
 
-	numLines = src.GetLineNum();
+	// mark all the defs that were from the last reload of this file
+	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
+		decl->redefinedInReload = false;
+	}
+
+	checksum = scannedChecksum;
+	fileSize = loadLength;
+
+	for ( int i = 0; i < scanned->decls.Num(); i++ ) {
+		const declCacheEntry_t & entry = scanned->decls[i];
+		AddDecl( (declType_t)entry.type, entry.name, loadBuffer, entry.offset, entry.size, entry.line );
+	}
+	numLines = scanned->numLines;
 
-	Mem_Free( buffer );
+	if ( scannedFile != NULL ) {
+		declManagerLocal.UpdateCachedFile( scannedFile );
+	}
+	scanned = NULL;
+	scannedFile = NULL;
+
+	Mem_Free( loadBuffer );
+	loadBuffer = NULL;
+	loadLength = 0;
 
 	// any defs that weren't redefinedInReload should now be defaulted
 	for ( idDeclLocal *decl = decls ; decl ; decl = decl->nextInFile ) {
@@ -785,6 +915,55 @@ int idDeclFile::LoadAndParse() {
 	return checksum;
 }
 
+/*
+================
+idDeclFile::AddDecl
+
+Creates or updates the decl found at the given location in the file text.
+================
+*/
+void idDeclFile::AddDecl( declType_t type, const idStr & name, const char * buffer, int offset, int size, int line ) {
+	bool reparse = false;
+
+	// look it up, possibly getting a newly created default decl
+	idDeclLocal * newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, false );
+	if ( newDecl ) {
+		// update the existing copy
+		if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
+			idLib::Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), line, declManagerLocal.GetDeclNameFromType( type ),
+							name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+			return;
+		}
+		if ( newDecl->declState != DS_UNPARSED ) {
+			reparse = true;
+		}
+	} else {
+		// allow it to be created as a default, then add it to the per-file list
+		newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, true );
+		newDecl->nextInFile = this->decls;
+		this->decls = newDecl;
+	}
+
+	newDecl->redefinedInReload = true;
+
+	if ( newDecl->textSource ) {
+		Mem_Free( newDecl->textSource );
+		newDecl->textSource = NULL;
+	}
+
+	newDecl->SetTextLocal( buffer + offset, size );
+	newDecl->sourceFile = this;
+	newDecl->sourceTextOffset = offset;
+	newDecl->sourceTextLength = size;
+	newDecl->sourceLine = line;
+	newDecl->declState = DS_UNPARSED;
+
+	// if it is currently in use, reparse it immedaitely
+	if ( reparse ) {
+		newDecl->ParseLocal();
+	}
+}
+
 /*
 ====================================================================================
 
@@ -805,6 +984,8 @@ void idDeclManagerLocal::Init() {
 	idLib::Printf( "----- Initializing Decls -----\n" );
 
 	checksum = 0;
+	declCacheLoaded = false;
+	declCacheDirty = false;
 
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
@@ -889,6 +1070,9 @@ void idDeclManagerLocal::Shutdown() {
 	int			i, j;
 	idDeclLocal *decl;
 
+	SaveDeclCache();
+	FreeDeclCache();
+
 	// free decls
 	for ( i = 0; i < DECL_MAX_TYPES; i++ ) {
 		for ( j = 0; j < linearLists[i].Num(); j++ ) {
@@ -925,9 +1109,15 @@ idDeclManagerLocal::Reload
 ===================
 */
 void idDeclManagerLocal::Reload( bool force ) {
+	idList<idDeclFile *> changedFiles;
+
 	for ( int i = 0; i < loadedFiles.Num(); i++ ) {
-		loadedFiles[i]->Reload( force );
+		if ( loadedFiles[i]->NeedsReload( force ) ) {
+			changedFiles.Append( loadedFiles[i] );
+		}
 	}
+
+	LoadAndParseFiles( changedFiles );
 }
 
 /*
@@ -957,10 +1147,183 @@ idDeclManagerLocal::EndLevelLoad
 void idDeclManagerLocal::EndLevelLoad() {
 	insideLevelLoad = false;
 
+	// by now every decl folder has been registered
+	SaveDeclCache();
+
 	// we don't need to do anything here, but the image manager, model manager,
 	// and sound sample manager will need to free media that was not referenced
 }
 
+/*
+===================
+idDeclManagerLocal::LoadDeclCache
+===================
+*/
+void idDeclManagerLocal::LoadDeclCache() {
+	declCacheLoaded = true;
+
+	idFileLocal file( fileSystem->OpenFileRead( DECL_CACHE_FILENAME ) );
+	if ( file == NULL ) {
+		return;
+	}
+
+	int magic = 0;
+	int version = 0;
+	int numTypes = 0;
+	int numFiles = 0;
+	file->ReadBig( magic );
+	file->ReadBig( version );
+	file->ReadBig( numTypes );
+	if ( magic != DECL_CACHE_MAGIC || version != DECL_CACHE_VERSION || numTypes != DECL_MAX_TYPES ) {
+		idLib::Printf( "%s is out of date, decl files will be lexed\n", DECL_CACHE_FILENAME );
+		return;
+	}
+
+	file->ReadBig( numFiles );
+	if ( numFiles < 0 ) {
+		return;
+	}
+
+	for ( int i = 0; i < numFiles; i++ ) {
+		idDeclCacheFile * cacheFile = new (TAG_DECL) idDeclCacheFile;
+		int numDecls = 0;
+		file->ReadString( cacheFile->fileName );
+		file->ReadBig( cacheFile->checksum );
+		file->ReadBig( cacheFile->numLines );
+		file->ReadBig( numDecls );
+		if ( numDecls < 0 || numDecls > file->Length() ) {
+			delete cacheFile;
+			FreeDeclCache();
+			return;
+		}
+
+		cacheFile->decls.SetNum( numDecls );
+		for ( int j = 0; j < numDecls; j++ ) {
+			declCacheEntry_t & entry = cacheFile->decls[j];
+			file->ReadBig( entry.type );
+			file->ReadString( entry.name );
+			file->ReadBig( entry.offset );
+			file->ReadBig( entry.size );
+			file->ReadBig( entry.line );
+			if ( entry.type < 0 || entry.type >= DECL_MAX_TYPES ) {
+				delete cacheFile;
+				FreeDeclCache();
+				return;
+			}
+		}
+
+		declCacheHash.Add( declCacheHash.GenerateKey( cacheFile->fileName, false ), declCache.Append( cacheFile ) );
+	}
+}
+
+/*
+===================
+idDeclManagerLocal::SaveDeclCache
+===================
+*/
+void idDeclManagerLocal::SaveDeclCache() {
+	if ( !declCacheDirty || !decl_useCache.GetBool() ) {
+		return;
+	}
+	declCacheDirty = false;
+
+	idFileLocal file( fileSystem->OpenFileWrite( DECL_CACHE_FILENAME, "fs_savepath" ) );
+	if ( file == NULL ) {
+		idLib::Warning( "Couldn't write %s", DECL_CACHE_FILENAME );
+		return;
+	}
+
+	const int numFiles = declCache.Num();
+
+	file->WriteBig( DECL_CACHE_MAGIC );
+	file->WriteBig( DECL_CACHE_VERSION );
+	file->WriteBig( (int)DECL_MAX_TYPES );
+	file->WriteBig( numFiles );
+
+	for ( int i = 0; i < declCache.Num(); i++ ) {
+		const idDeclCacheFile * cacheFile = declCache[i];
+		file->WriteString( cacheFile->fileName );
+		file->WriteBig( cacheFile->checksum );
+		file->WriteBig( cacheFile->numLines );
+		file->WriteBig( cacheFile->decls.Num() );
+		for ( int j = 0; j < cacheFile->decls.Num(); j++ ) {
+			const declCacheEntry_t & entry = cacheFile->decls[j];
+			file->WriteBig( entry.type );
+			file->WriteString( entry.name );
+			file->WriteBig( entry.offset );
+			file->WriteBig( entry.size );
+			file->WriteBig( entry.line );
+		}
+	}
+}
+
+/*
+===================
+idDeclManagerLocal::FreeDeclCache
+===================
+*/
+void idDeclManagerLocal::FreeDeclCache() {
+	declCache.DeleteContents( true );
+	declCacheHash.Free();
+}
+
+/*
+===================
+idDeclManagerLocal::FindCachedFile
+
+Returns the decl locations for fileName if its text hasn't changed since they were stored.
+===================
+*/
+const idDeclCacheFile * idDeclManagerLocal::FindCachedFile( const char * fileName, int fileChecksum ) {
+	if ( !decl_useCache.GetBool() ) {
+		return NULL;
+	}
+
+	if ( !declCacheLoaded ) {
+		LoadDeclCache();
+	}
+
+	const int key = declCacheHash.GenerateKey( fileName, false );
+	for ( int i = declCacheHash.First( key ); i != -1; i = declCacheHash.Next( i ) ) {
+		const idDeclCacheFile * cacheFile = declCache[i];
+		if ( cacheFile != NULL && cacheFile->fileName.Icmp( fileName ) == 0 ) {
+			return ( cacheFile->checksum == fileChecksum ) ? cacheFile : NULL;
+		}
+	}
+	return NULL;
+}
+
+/*
+===================
+idDeclManagerLocal::UpdateCachedFile
+
+Takes ownership of cacheFile and replaces any previous entry for the same file.
+===================
+*/
+void idDeclManagerLocal::UpdateCachedFile( idDeclCacheFile * cacheFile ) {
+	if ( !decl_useCache.GetBool() ) {
+		delete cacheFile;
+		return;
+	}
+
+	if ( !declCacheLoaded ) {
+		LoadDeclCache();
+	}
+
+	declCacheDirty = true;
+
+	const int key = declCacheHash.GenerateKey( cacheFile->fileName, false );
+	for ( int i = declCacheHash.First( key ); i != -1; i = declCacheHash.Next( i ) ) {
+		if ( declCache[i] != NULL && declCache[i]->fileName.Icmp( cacheFile->fileName ) == 0 ) {
+			delete declCache[i];
+			declCache[i] = cacheFile;
+			return;
+		}
+	}
+
+	declCacheHash.Add( key, declCache.Append( cacheFile ) );
+}
+
 /*
 ===================
 idDeclManagerLocal::RegisterDeclType
@@ -1016,6 +1379,9 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 	// scan for decl files
 	fileList = fileSystem->ListFiles( declFolder->folder, declFolder->extension, true );
 
+	idList<idDeclFile *> folderFiles;
+	folderFiles.SetNum( 0, fileList->GetNumFiles() );
+
 	// load and parse decl files
 	for ( i = 0; i < fileList->GetNumFiles(); i++ ) {
 		fileName = declFolder->folder + "/" + fileList->GetFile( i );
@@ -1032,10 +1398,71 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 			df = new (TAG_DECL) idDeclFile( fileName, defaultType );
 			loadedFiles.Append( df );
 		}
-		df->LoadAndParse();
+		folderFiles.Append( df );
 	}
 
 	fileSystem->FreeFileList( fileList );
+
+	LoadAndParseFiles( folderFiles );
+}
+
+/*
+===================
+DeclScanJob
+===================
+*/
+static void DeclScanJob( idDeclFile * declFile ) {
+	declFile->ScanSource( true );
+}
+
+REGISTER_PARALLEL_JOB( DeclScanJob, "DeclScanJob" );
+
+/*
+===================
+idDeclManagerLocal::LoadAndParseFiles
+
+Same result as calling LoadAndParse on each file in order. Reading the files and
+creating the decls stay on the main thread, only the lexing of each file to find
+its decls runs on the job threads.
+===================
+*/
+void idDeclManagerLocal::LoadAndParseFiles( const idList<idDeclFile *> & files ) {
+	if ( files.Num() == 0 ) {
+		return;
+	}
+
+	if ( files.Num() == 1 || !decl_parallelParse.GetBool() ) {
+		for ( int i = 0; i < files.Num(); i++ ) {
+			files[i]->LoadAndParse();
+		}
+		return;
+	}
+
+	// the scan jobs only read the decl cache, so make sure it is loaded up front
+	if ( decl_useCache.GetBool() && !declCacheLoaded ) {
+		LoadDeclCache();
+	}
+
+	// the file system isn't thread safe
+	for ( int i = 0; i < files.Num(); i++ ) {
+		files[i]->ReadSource();
+	}
+
+	idParallelJobList * scanJobs = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, files.Num(), 0, NULL );
+	for ( int i = 0; i < files.Num(); i++ ) {
+		scanJobs->AddJob( (jobRun_t)DeclScanJob, files[i] );
+	}
+	scanJobs->Submit();
+	scanJobs->Wait();
+	parallelJobManager->FreeJobList( scanJobs );
+
+	// register in file order so decl indexes and the checksum match a serial load
+	for ( int i = 0; i < files.Num(); i++ ) {
+		if ( files[i]->ScanHadMessages() ) {
+			files[i]->ScanSource();
+		}
+		files[i]->RegisterDecls();
+	}
 }
 
 /*
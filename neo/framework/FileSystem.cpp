@@ -312,6 +312,12 @@ idFileSystemLocal::StartPreload
 ================
 */
 void idFileSystemLocal::StartPreload( const idStrList & _preload ) {
+	idResourceCacheEntry rc;
+	for ( int i = 0; i < _preload.Num(); i++ ) {
+		if ( GetResourceCacheEntry( _preload[ i ], rc ) ) {
+			resourceFiles[ rc.containerIndex ]->Prefetch( rc );
+		}
+	}
 }
 
 /*
@@ -533,7 +539,11 @@ void idFileSystemLocal::BeginLevelLoad( const char *name, char *_blockBuffer, in
 	manifestName.StripPath();
 	
 	if ( resourceFiles.Num() > 0 ) {
-		AddResourceFile( va( "%s.resources", manifestName.c_str() ) );
+		// the map container is ordered by load, so read ahead all of it
+		const int idx = AddResourceFile( va( "%s.resources", manifestName.c_str() ) );
+		if ( idx >= 0 ) {
+			resourceFiles[ idx ]->PrefetchAll();
+		}
 	}
 
 }
@@ -2734,6 +2744,11 @@ idFile * idFileSystemLocal::GetResourceFile( const char *fileName, bool memFile
 		if ( fs_debugResources.GetBool() ) {
 			idLib::Printf( "RES: loading file %s\n", rc.filename.c_str() );
 		}
+		// zero copy view into a mapped container
+		idFile * mappedFile = resourceFiles[ rc.containerIndex ]->OpenFile( rc );
+		if ( mappedFile != NULL ) {
+			return mappedFile;
+		}
 		idFile_InnerResource *file = new idFile_InnerResource( rc.filename, resourceFiles[ rc.containerIndex ]->resourceFile, rc.offset, rc.length );
 		if ( file != NULL && ( memFile || rc.length <= resourceBufferAvailable ) || rc.length < 8 * 1024 * 1024 ) {
 			byte *buf = NULL;
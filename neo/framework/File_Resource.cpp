@@ -29,6 +29,13 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 #pragma hdrstop
 
+// every container is mapped whole, which a 32 bit address space has no room for
+#if defined( ID_PC_WIN64 )
+idCVar fs_mapResources( "fs_mapResources", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "Memory map resource containers and serve files without copying them" );
+#else
+idCVar fs_mapResources( "fs_mapResources", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "Memory map resource containers and serve files without copying them" );
+#endif
+
 /*
 ================================================================================================
 
@@ -72,6 +79,14 @@ bool idResourceContainer::Init( const char *_fileName, uint8 containerIndex ) {
 
 	fileName = _fileName;
 
+	// _ordered.resources is already read completely into memory
+	Sys_UnmapFile( mapping );
+	if ( fs_mapResources.GetBool() && resourceFile->GetFullPath() != NULL && idStr::Icmp( _fileName, "_ordered.resources" ) != 0 ) {
+		if ( !Sys_MapFile( resourceFile->GetFullPath(), mapping ) ) {
+			idLib::Warning( "Unable to map resource file %s, falling back to buffered reads", _fileName );
+		}
+	}
+
 	resourceFile->ReadBig( tableOffset );
 	resourceFile->ReadBig( tableLength );
 	// read this into a memory buffer with a single read
@@ -113,6 +128,63 @@ bool idResourceContainer::Init( const char *_fileName, uint8 containerIndex ) {
 }
 
 
+/*
+========================
+idResourceContainer::OpenFile
+========================
+*/
+idFile * idResourceContainer::OpenFile( const char * _fileName ) {
+	idStrStatic< MAX_OSPATH > canonical = _fileName;
+	canonical.BackSlashesToSlashes();
+	canonical.ToLower();
+
+	const int key = cacheHash.GenerateKey( canonical, false );
+	for ( int index = cacheHash.GetFirst( key ); index != idHashIndex::NULL_INDEX; index = cacheHash.GetNext( index ) ) {
+		const idResourceCacheEntry & rt = cacheTable[ index ];
+		if ( idStr::Icmp( rt.filename, canonical ) == 0 ) {
+			return OpenFile( rt );
+		}
+	}
+	return NULL;
+}
+
+/*
+========================
+idResourceContainer::OpenFile
+
+When the container is mapped the returned file reads directly from the mapping,
+so it must not outlive the container.
+========================
+*/
+idFile * idResourceContainer::OpenFile( const idResourceCacheEntry & rt ) {
+	if ( !IsMapped() || rt.offset < 0 || (size_t)rt.offset + rt.length > mapping.length ) {
+		return NULL;
+	}
+	return new (TAG_IDFILE) idFile_Memory( rt.filename, (const char *)mapping.data + rt.offset, rt.length );
+}
+
+/*
+========================
+idResourceContainer::Prefetch
+========================
+*/
+void idResourceContainer::Prefetch( const idResourceCacheEntry & rt ) const {
+	if ( IsMapped() ) {
+		Sys_PrefetchMappedFile( mapping, rt.offset, rt.length );
+	}
+}
+
+/*
+========================
+idResourceContainer::PrefetchAll
+========================
+*/
+void idResourceContainer::PrefetchAll() const {
+	if ( IsMapped() ) {
+		Sys_PrefetchMappedFile( mapping, 0, mapping.length );
+	}
+}
+
 /*
 ========================
 idResourceContainer::WriteManifestFile 
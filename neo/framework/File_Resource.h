@@ -80,6 +80,7 @@ public:
 		numFileResources = 0;
 	}
 	~idResourceContainer() {
+		Sys_UnmapFile( mapping );
 		delete resourceFile;
 		cacheTable.Clear();
 	}
@@ -90,12 +91,18 @@ public:
 	static void ExtractResourceFile ( const char * fileName, const char * outPath, bool copyWavs );
 	static void UpdateResourceFile( const char *filename, const idStrList &filesToAdd );
 	idFile *OpenFile( const char *fileName );
+	idFile *OpenFile( const idResourceCacheEntry & rt );
 	const char * GetFileName() const { return fileName.c_str(); }
+	// true when files are served as views straight into the mapped container
+	bool IsMapped() const { return mapping.data != NULL; }
+	void Prefetch( const idResourceCacheEntry & rt ) const;
+	void PrefetchAll() const;
 	void SetContainerIndex( const int & _idx );
 	void ReOpen();
 private:
 	idStrStatic< 256 > fileName;
 	idFile *	resourceFile;			// open file handle
+	mappedFile_t mapping;				// whole container mapped read only, if fs_mapResources
 	// offset should probably be a 64 bit value for development, but 4 gigs won't fit on
 	// a DVD layer, so it isn't a retail limitation.
 	int		tableOffset;			// table offset
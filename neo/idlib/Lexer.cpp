@@ -243,6 +243,8 @@ void idLexer::Warning( const char *str, ... ) {
 	char text[MAX_STRING_CHARS];
 	va_list ap;
 
+	hadWarning = true;
+
 	if ( idLexer::flags & LEXFL_NOWARNINGS ) {
 		return;
 	}
@@ -1832,6 +1834,7 @@ idLexer::idLexer() {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 }
 
 /*
@@ -1853,6 +1856,7 @@ idLexer::idLexer( int flags ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 }
 
 /*
@@ -1868,6 +1872,7 @@ idLexer::idLexer( const char *filename, int flags, bool OSPath ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 	idLexer::LoadFile( filename, OSPath );
 }
 
@@ -1884,6 +1889,7 @@ idLexer::idLexer( const char *ptr, int length, const char *name, int flags ) {
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::hadWarning = false;
 	idLexer::LoadMemory( ptr, length, name );
 }
 
@@ -1914,3 +1920,12 @@ bool idLexer::HadError() const {
 	return hadError;
 }
 
+/*
+================
+idLexer::HadWarning
+================
+*/
+bool idLexer::HadWarning() const {
+	return hadWarning;
+}
+
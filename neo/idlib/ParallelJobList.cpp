@@ -105,6 +105,153 @@ idParallelJobRegistration::idParallelJobRegistration( jobRun_t function, const c
 	RegisterJob( function, name );
 }
 
+/*
+================================================================================================
+
+	Job timeline capture
+
+	Records the start and end time, the thread and the job list of every executed job,
+	as well as the time host threads spend waiting for job lists. The capture is written
+	as a Chrome trace JSON file that can be loaded in chrome://tracing or Perfetto.
+
+================================================================================================
+*/
+
+struct jobTimelineEvent_t {
+	jobRun_t		function;		// NULL for a host thread waiting on a job list
+	uint64			startTime;
+	uint64			endTime;		// written last, zero if the event was never completed
+	uintptr_t		threadId;
+	short			unit;
+	short			listId;
+};
+
+static idCVar jobs_timelineMaxEvents( "jobs_timelineMaxEvents", "262144", CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of jobs recorded by jobs_captureTimeline", 1024, 16 * 1024 * 1024 );
+
+static jobTimelineEvent_t *		timelineEvents;
+static int						timelineMaxEvents;
+static idSysInterlockedInteger	timelineNumEvents;
+static volatile bool			timelineCapturing;
+static uint64					timelineStartTime;
+
+/*
+========================
+GetTimelineListName
+========================
+*/
+static const char * GetTimelineListName( int listId ) {
+	if ( listId >= 0 && listId < (int)( sizeof( jobNames ) / sizeof( jobNames[0] ) ) && jobNames[listId][0] != '\0' ) {
+		return jobNames[listId];
+	}
+	return va( "JOBLIST_%d", listId );
+}
+
+/*
+========================
+RecordTimelineEvent
+========================
+*/
+static void RecordTimelineEvent( jobRun_t function, jobListId_t listId, int unit, uint64 startTime, uint64 endTime ) {
+	if ( !timelineCapturing ) {
+		return;
+	}
+	const int index = timelineNumEvents.Increment() - 1;
+	if ( index >= timelineMaxEvents ) {
+		return;
+	}
+	jobTimelineEvent_t & event = timelineEvents[index];
+	event.function = function;
+	event.startTime = startTime;
+	event.threadId = Sys_GetCurrentThreadID();
+	event.unit = (short)unit;
+	event.listId = (short)listId;
+	SYS_MEMORYBARRIER;
+	event.endTime = endTime;
+}
+
+/*
+========================
+StartTimelineCapture
+========================
+*/
+static void StartTimelineCapture() {
+	assert( !timelineCapturing );
+
+	const int maxEvents = jobs_timelineMaxEvents.GetInteger();
+	if ( timelineEvents == NULL || timelineMaxEvents != maxEvents ) {
+		Mem_Free( timelineEvents );
+		timelineEvents = (jobTimelineEvent_t *)Mem_Alloc( maxEvents * sizeof( jobTimelineEvent_t ), TAG_JOBLIST );
+		timelineMaxEvents = maxEvents;
+	}
+	memset( timelineEvents, 0, timelineMaxEvents * sizeof( jobTimelineEvent_t ) );
+	timelineNumEvents.SetValue( 0 );
+	timelineStartTime = Sys_Microseconds();
+
+	SYS_MEMORYBARRIER;
+	timelineCapturing = true;
+}
+
+/*
+========================
+StopTimelineCapture
+
+The event buffer is kept around until the next capture so a job that is still
+finishing up never writes into freed memory.
+========================
+*/
+static void StopTimelineCapture( const char * fileName ) {
+	timelineCapturing = false;
+	SYS_MEMORYBARRIER;
+
+	const int numEvents = Min( timelineNumEvents.GetValue(), timelineMaxEvents );
+	if ( timelineNumEvents.GetValue() > timelineMaxEvents ) {
+		idLib::Warning( "job timeline dropped %d events, increase jobs_timelineMaxEvents", timelineNumEvents.GetValue() - timelineMaxEvents );
+	}
+
+	idFile * file = idLib::fileSystem->OpenFileWrite( fileName );
+	if ( file == NULL ) {
+		idLib::Warning( "couldn't open %s for writing", fileName );
+		return;
+	}
+
+	file->Printf( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+	file->Printf( "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"jobs\"}}" );
+
+	int numWritten = 0;
+	for ( int i = 0; i < numEvents; i++ ) {
+		const jobTimelineEvent_t & event = timelineEvents[i];
+		if ( event.endTime == 0 ) {
+			continue;
+		}
+		const char * name = ( event.function != NULL ) ? GetJobName( event.function ) : va( "Wait %s", GetTimelineListName( event.listId ) );
+		file->Printf( ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":0,\"tid\":%llu,\"args\":{\"unit\":%d}}",
+			name, GetTimelineListName( event.listId ), (int64)( event.startTime - timelineStartTime ), (int64)( event.endTime - event.startTime ),
+			(uint64)event.threadId, event.unit );
+		numWritten++;
+	}
+
+	file->Printf( "\n]}\n" );
+	delete file;
+
+	idLib::Printf( "wrote %d jobs to %s\n", numWritten, fileName );
+}
+
+/*
+========================
+jobs_captureTimeline
+========================
+*/
+CONSOLE_COMMAND( jobs_captureTimeline, "starts recording every executed job, run again to stop and write a Chrome trace JSON file", 0 ) {
+	if ( !timelineCapturing ) {
+		StartTimelineCapture();
+		idLib::Printf( "capturing job timeline, run jobs_captureTimeline again to stop\n" );
+		return;
+	}
+	idStr fileName = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "jobs_timeline.json";
+	fileName.DefaultFileExtension( ".json" );
+	StopTimelineCapture( fileName.c_str() );
+}
+
 int globalSpuLocalStoreActive;
 void * globalSpuLocalStoreStart;
 void * globalSpuLocalStoreEnd;
@@ -138,18 +285,22 @@ struct threadJobListState_t {
 									version( 0xFFFFFFFF ),
 									signalIndex( 0 ),
 									lastJobIndex( 0 ),
-									nextJobIndex( -1 ) {}
+									nextJobIndex( -1 ),
+									stealSegment( 0 ) {}
 								threadJobListState_t( int _version ) :
 									jobList( NULL ),
 									version( _version ),
 									signalIndex( 0 ),
 									lastJobIndex( 0 ),
-									nextJobIndex( -1 ) {}
+									nextJobIndex( -1 ),
+									stealSegment( 0 ) {}
 	idParallelJobList_Threads *	jobList;
 	int							version;
 	int							signalIndex;
 	int							lastJobIndex;
 	int							nextJobIndex;
+	int							stealSegment;		// work-stealing only: segment the thread is currently draining
+	idRandom					stealRandom;		// work-stealing only: picks the victim queue to steal from
 };
 
 struct threadStats_t {
@@ -171,7 +322,8 @@ public:
 	//------------------------
 	// These are called from the one thread that manages this list.
 	//------------------------
-	ID_INLINE void			AddJob( jobRun_t function, void * data );
+	ID_INLINE int			AddJob( jobRun_t function, void * data );
+	void					AddDependency( int job, int predecessor );
 	ID_INLINE void			InsertSyncPoint( jobSyncType_t syncType );
 	void					Submit( idParallelJobList_Threads * waitForJobList_, int parallelism );
 	void					Wait();
@@ -195,6 +347,9 @@ public:
 
 	bool					WaitForOtherJobList();
 
+	// Called by the manager before the list is handed to the job threads.
+	bool					PrepareWorkStealing( int numQueues );
+
 	//------------------------
 	// This is thread safe and called from the job threads.
 	//------------------------
@@ -227,8 +382,17 @@ private:
 		jobRun_t	function;
 		void *		data;
 		int			executed;
+		int			signalIndex;		// signal group whose count is decremented when the job completes
+		int			numPredecessors;
+		int			firstSuccessor;		// index into jobEdges, -1 if no other job waits for this one
+		idSysInterlockedInteger	pendingPredecessors;	// predecessors still running plus one for the fetch
+	};
+	struct jobEdge_t {
+		int			job;				// successor that waits for the job owning this edge
+		int			next;				// next edge of the same job, -1 if last
 	};
 	idList< job_t, TAG_JOBLIST >		jobList;
+	idList< jobEdge_t, TAG_JOBLIST >	jobEdges;
 	idList< idSysInterlockedInteger, TAG_JOBLIST >	signalJobCount;
 	idSysInterlockedInteger				currentJob;
 	idSysInterlockedInteger				fetchLock;
@@ -237,7 +401,32 @@ private:
 	threadStats_t						deferredThreadStats;
 	threadStats_t						threadStats;
 
+	// work-stealing scheduler state, only valid when numStealQueues > 0
+	static const int		MAX_STEAL_SEGMENT_JOBS = 0x7FFF;	// queue ranges are packed as two 16-bit offsets
+
+	struct stealSegment_t {
+		int			firstJob;		// index into stealJobs
+		int			numJobs;
+		int			waitSignalIndex;// signal group that has to be done before the segment can start, -1 if none
+	};
+	struct stealQueue_t {
+		idSysInterlockedInteger	range;	// ( begin << 16 ) | end offsets into the segment
+		byte		pad[CACHE_LINE_SIZE - sizeof( idSysInterlockedInteger )];
+	};
+	int									numStealQueues;
+	idList< int, TAG_JOBLIST >				stealJobs;	// indices into jobList
+	idList< stealSegment_t, TAG_JOBLIST >	stealSegments;
+	idList< stealQueue_t, TAG_JOBLIST >		stealQueues;
+	idSysInterlockedInteger				stealJobsRemaining;
+
+	bool					JobsPending() const;
+	void					ExecuteJob( unsigned int threadNum, int jobIndex );
+	ID_INLINE bool			ReleaseJob( int jobIndex );
+	bool					FinishJob( int jobIndex );
+	int						RunReadyJob( unsigned int threadNum, int jobIndex );
+	int						FetchStealJob( unsigned int threadNum, threadJobListState_t & state );
 	int						RunJobsInternal( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
+	int						RunStealJobsInternal( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
 
 	static void				Nop( void * data ) {}
 
@@ -265,7 +454,8 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	lastSignalJob( 0 ),
 	waitForGuard( NULL ),
 	currentDoneGuard( 0 ),
-	jobList() {
+	jobList(),
+	numStealQueues( 0 ) {
 
 	assert( listPriority != JOBLIST_PRIORITY_NONE );
 
@@ -294,7 +484,7 @@ idParallelJobList_Threads::~idParallelJobList_Threads() {
 idParallelJobList_Threads::AddJob
 ========================
 */
-ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void * data ) {
+ID_INLINE int idParallelJobList_Threads::AddJob( jobRun_t function, void * data ) {
 	assert( done );
 #if defined( _DEBUG )
 	// make sure there isn't already a job with the same function and data in the list
@@ -309,6 +499,9 @@ ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void * data
 		job.function = function;
 		job.data = data;
 		job.executed = 0;
+		job.signalIndex = signalJobCount.Num();
+		job.numPredecessors = 0;
+		job.firstSuccessor = -1;
 	} else {
 		// debug output to show us what is overflowing
 		int currentJobCount[MAX_REGISTERED_JOBS] = {};
@@ -331,6 +524,33 @@ ID_INLINE void idParallelJobList_Threads::AddJob( jobRun_t function, void * data
 		}
 		idLib::Error( "Can't add job '%s', too many jobs %d", GetJobName( function ), jobList.Num() );
 	}
+	return jobList.Num() - 1;
+}
+
+/*
+========================
+idParallelJobList_Threads::AddDependency
+
+The predecessor has to be added before the job, which keeps the job graph free of cycles.
+========================
+*/
+void idParallelJobList_Threads::AddDependency( int job, int predecessor ) {
+	assert( done );
+	if ( job < 0 || job >= jobList.Num() ) {
+		idLib::Error( "Can't add dependency, invalid job handle %d", job );
+	}
+	if ( predecessor < 0 || predecessor >= job ) {
+		const char * predecessorName = ( predecessor >= 0 && predecessor < jobList.Num() ) ? GetJobName( jobList[predecessor].function ) : "invalid";
+		idLib::Error( "Job '%s' can't wait for job '%s', predecessors have to be added to the list first", GetJobName( jobList[job].function ), predecessorName );
+	}
+
+	jobEdge_t & edge = jobEdges.Alloc();
+	edge.job = job;
+	edge.next = jobList[predecessor].firstSuccessor;
+	jobList[predecessor].firstSuccessor = jobEdges.Num() - 1;
+
+	jobList[job].numPredecessors++;
+	jobList[job].pendingPredecessors.SetValue( jobList[job].numPredecessors + 1 );
 }
 
 /*
@@ -351,6 +571,9 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 				job_t & job = jobList.Alloc();
 				job.function = Nop;
 				job.data = & JOB_SIGNAL;
+				job.signalIndex = signalJobCount.Num();
+				job.numPredecessors = 0;
+				job.firstSuccessor = -1;
 				hasSignal = true;
 			}
 			break;
@@ -360,6 +583,9 @@ ID_INLINE void idParallelJobList_Threads::InsertSyncPoint( jobSyncType_t syncTyp
 				job_t & job = jobList.Alloc();
 				job.function = Nop;
 				job.data = & JOB_SYNCHRONIZE;
+				job.signalIndex = signalJobCount.Num();
+				job.numPredecessors = 0;
+				job.firstSuccessor = -1;
 				hasSignal = false;
 				numSyncs++;
 			}
@@ -409,6 +635,12 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads * waitForJobLi
 	job_t & job = jobList.Alloc();
 	job.function = Nop;
 	job.data = & JOB_LIST_DONE;
+	job.signalIndex = signalJobCount.Num() - 1;
+	job.numPredecessors = 0;
+	job.firstSuccessor = -1;
+
+	// the manager decides whether this submission uses the work-stealing scheduler
+	numStealQueues = 0;
 
 	if ( threaded ) {
 		// hand over to the manager
@@ -436,7 +668,7 @@ void idParallelJobList_Threads::Wait() {
 		bool waited = false;
 		uint64 waitStart = Sys_Microseconds();
 
-		while ( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 ) {
+		while ( JobsPending() ) {
 			Sys_Yield();
 			waited = true;
 		}
@@ -447,12 +679,18 @@ void idParallelJobList_Threads::Wait() {
 		}
 
 		jobList.SetNum( 0 );
+		jobEdges.SetNum( 0 );
 		signalJobCount.SetNum( 0 );
 		numSyncs = 0;
 		lastSignalJob = 0;
+		numStealQueues = 0;
 
 		uint64 waitEnd = Sys_Microseconds();
 		deferredThreadStats.waitTime = waited ? ( waitEnd - waitStart ) : 0;
+
+		if ( waited ) {
+			RecordTimelineEvent( NULL, GetId(), -1, waitStart, waitEnd );
+		}
 	}
 	memcpy( & threadStats, & deferredThreadStats, sizeof( threadStats ) );
 	done = true;
@@ -464,7 +702,7 @@ idParallelJobList_Threads::TryWait
 ========================
 */
 bool idParallelJobList_Threads::TryWait() {
-	if ( jobList.Num() == 0 || signalJobCount[signalJobCount.Num() - 1].GetValue() <= 0 ) {
+	if ( jobList.Num() == 0 || !JobsPending() ) {
 		Wait();
 		return true;
 	}
@@ -480,6 +718,19 @@ bool idParallelJobList_Threads::IsSubmitted() const {
 	return !done;
 }
 
+/*
+========================
+idParallelJobList_Threads::JobsPending
+========================
+*/
+bool idParallelJobList_Threads::JobsPending() const {
+	if ( numStealQueues > 0 ) {
+		// with work-stealing, jobs from earlier signal groups may still be queued after the last group completed
+		return ( stealJobsRemaining.GetValue() > 0 );
+	}
+	return ( signalJobCount[signalJobCount.Num() - 1].GetValue() > 0 );
+}
+
 /*
 ========================
 idParallelJobList_Threads::GetTotalProcessingTimeMicroSec
@@ -536,6 +787,105 @@ volatile jobRun_t longJobFunc;
 volatile void * longJobData;
 #endif
 
+/*
+========================
+idParallelJobList_Threads::ExecuteJob
+========================
+*/
+void idParallelJobList_Threads::ExecuteJob( unsigned int threadNum, int jobIndex ) {
+	uint64 jobStart = Sys_Microseconds();
+
+	jobList[jobIndex].function( jobList[jobIndex].data );
+	jobList[jobIndex].executed = 1;
+
+	uint64 jobEnd = Sys_Microseconds();
+	deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
+
+	RecordTimelineEvent( jobList[jobIndex].function, GetId(), threadNum, jobStart, jobEnd );
+
+#ifndef _DEBUG
+	if ( jobs_longJobMicroSec.GetInteger() > 0 ) {
+		if ( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
+			&& GetId() != JOBLIST_UTILITY ) {
+			longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
+			longJobFunc = jobList[jobIndex].function;
+			longJobData = jobList[jobIndex].data;
+			const char * jobName = GetJobName( jobList[jobIndex].function );
+			const char * jobListName = GetJobListName( GetId() );
+			idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
+		}
+	}
+#endif
+}
+
+/*
+========================
+idParallelJobList_Threads::ReleaseJob
+
+Returns true if the job has no outstanding predecessors and should be run by the caller.
+========================
+*/
+ID_INLINE bool idParallelJobList_Threads::ReleaseJob( int jobIndex ) {
+	return ( jobList[jobIndex].numPredecessors == 0 || jobList[jobIndex].pendingPredecessors.Decrement() == 0 );
+}
+
+/*
+========================
+idParallelJobList_Threads::FinishJob
+
+Returns true if this was the very last job of the job list.
+========================
+*/
+bool idParallelJobList_Threads::FinishJob( int jobIndex ) {
+	const int signalIndex = jobList[jobIndex].signalIndex;
+
+	if ( numStealQueues > 0 ) {
+		signalJobCount[signalIndex].Decrement();
+		if ( stealJobsRemaining.Decrement() == 0 ) {
+			deferredThreadStats.endTime = Sys_Microseconds();
+			doneGuards[currentDoneGuard].Decrement();
+			return true;
+		}
+		return false;
+	}
+
+	// decrease the job count for the current signal
+	if ( signalJobCount[signalIndex].Decrement() == 0 ) {
+		if ( signalIndex == signalJobCount.Num() - 1 ) {
+			deferredThreadStats.endTime = Sys_Microseconds();
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+========================
+idParallelJobList_Threads::RunReadyJob
+
+Executes a job whose predecessors are all done. Successors for which this was the
+last outstanding predecessor are executed right away on the same thread.
+========================
+*/
+int idParallelJobList_Threads::RunReadyJob( unsigned int threadNum, int jobIndex ) {
+	ExecuteJob( threadNum, jobIndex );
+
+	const int firstSuccessor = jobList[jobIndex].firstSuccessor;
+
+	int result = RUN_PROGRESS;
+	if ( FinishJob( jobIndex ) ) {
+		result |= RUN_DONE;
+	}
+
+	for ( int edge = firstSuccessor; edge != -1; edge = jobEdges[edge].next ) {
+		const int successor = jobEdges[edge].job;
+		if ( ReleaseJob( successor ) ) {
+			result |= RunReadyJob( threadNum, successor );
+		}
+	}
+	return result;
+}
+
 /*
 ========================
 idParallelJobList_Threads::RunJobsInternal
@@ -625,41 +975,190 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 			return ( result | RUN_DONE );
 		}
 
+		// a job that still waits for predecessors is run by the thread finishing the last of them
+		if ( !ReleaseJob( state.nextJobIndex ) ) {
+			continue;
+		}
+
 		// execute the next job
-		{
-			uint64 jobStart = Sys_Microseconds();
+		result |= RunReadyJob( threadNum, state.nextJobIndex );
 
-			jobList[state.nextJobIndex].function( jobList[state.nextJobIndex].data );
-			jobList[state.nextJobIndex].executed = 1;
+		// if this was the very last job of the job list
+		if ( ( result & RUN_DONE ) != 0 ) {
+			return result;
+		}
 
-			uint64 jobEnd = Sys_Microseconds();
-			deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
+	} while( ! singleJob );
 
-#ifndef _DEBUG
-			if ( jobs_longJobMicroSec.GetInteger() > 0 ) {
-				if ( jobEnd - jobStart > jobs_longJobMicroSec.GetInteger()
-					&& GetId() != JOBLIST_UTILITY ) {
-					longJobTime = ( jobEnd - jobStart ) * ( 1.0f / 1000.0f );
-					longJobFunc = jobList[state.nextJobIndex].function;
-					longJobData = jobList[state.nextJobIndex].data;
-					const char * jobName = GetJobName( jobList[state.nextJobIndex].function );
-					const char * jobListName = GetJobListName( GetId() );
-					idLib::Printf( "%1.1f milliseconds for a single '%s' job from job list %s on thread %d\n", longJobTime, jobName, jobListName, threadNum );
-				}
+	return result;
+}
+
+/*
+========================
+idParallelJobList_Threads::PrepareWorkStealing
+
+Instead of having all threads contend on the single currentJob index, the jobs are
+split into segments at the synchronization points and each segment is dealt out over
+one queue per thread. A thread pops jobs from the front of its own queue and, once that
+runs dry, steals from the back of the queues of randomly picked other threads. The
+segments are processed in order so the sync point semantics are the same as before.
+========================
+*/
+bool idParallelJobList_Threads::PrepareWorkStealing( int numQueues ) {
+	numStealQueues = 0;
+
+	if ( numQueues <= 1 || jobList.Num() == 0 ) {
+		return false;
+	}
+
+	stealJobs.SetNum( 0 );
+	stealSegments.SetNum( 0 );
+
+	int signalIndex = 0;
+	int currentSegment = stealSegments.Append( stealSegment_t() );
+	stealSegments[currentSegment].firstJob = 0;
+	stealSegments[currentSegment].numJobs = 0;
+	stealSegments[currentSegment].waitSignalIndex = -1;
+
+	for ( int i = 0; i < jobList.Num(); i++ ) {
+		if ( jobList[i].data == & JOB_SIGNAL ) {
+			signalIndex++;
+		} else if ( jobList[i].data == & JOB_SYNCHRONIZE ) {
+			assert( signalIndex > 0 );
+			currentSegment = stealSegments.Append( stealSegment_t() );
+			stealSegments[currentSegment].firstJob = stealJobs.Num();
+			stealSegments[currentSegment].numJobs = 0;
+			stealSegments[currentSegment].waitSignalIndex = signalIndex - 1;
+		} else if ( jobList[i].data != & JOB_LIST_DONE ) {
+			if ( stealSegments[currentSegment].numJobs >= MAX_STEAL_SEGMENT_JOBS ) {
+				// too many jobs between two sync points, fall back to the shared job index
+				return false;
 			}
-#endif
+			assert( jobList[i].signalIndex == signalIndex );
+			stealJobs.Append( i );
+			stealSegments[currentSegment].numJobs++;
 		}
+	}
+	assert( signalIndex == signalJobCount.Num() - 1 );
 
-		result |= RUN_PROGRESS;
+	// the signal counts only track real jobs because the sync points are not executed as dummy jobs
+	for ( int i = 0; i < signalJobCount.Num(); i++ ) {
+		signalJobCount[i].SetValue( 0 );
+	}
+	for ( int i = 0; i < stealJobs.Num(); i++ ) {
+		signalJobCount[jobList[stealJobs[i]].signalIndex].Increment();
+	}
+
+	stealQueues.SetNum( stealSegments.Num() * numQueues );
+	for ( int i = 0; i < stealSegments.Num(); i++ ) {
+		const int numJobs = stealSegments[i].numJobs;
+		for ( int j = 0; j < numQueues; j++ ) {
+			const int begin = numJobs * j / numQueues;
+			const int end = numJobs * ( j + 1 ) / numQueues;
+			stealQueues[i * numQueues + j].range.SetValue( ( begin << 16 ) | end );
+		}
+	}
+
+	stealJobsRemaining.SetValue( stealJobs.Num() );
+	numStealQueues = numQueues;
+	return true;
+}
+
+/*
+========================
+idParallelJobList_Threads::FetchStealJob
+
+Returns an index into stealJobs or -1 if all queues of the current segment are empty.
+========================
+*/
+int idParallelJobList_Threads::FetchStealJob( unsigned int threadNum, threadJobListState_t & state ) {
+	const stealSegment_t & segment = stealSegments[state.stealSegment];
+	stealQueue_t * queues = & stealQueues[state.stealSegment * numStealQueues];
+	const int owner = threadNum % numStealQueues;
+
+	// pop from the front of our own queue
+	for ( ; ; ) {
+		const int range = queues[owner].range.GetValue();
+		const int begin = range >> 16;
+		const int end = range & 0xFFFF;
+		if ( begin >= end ) {
+			break;
+		}
+		if ( queues[owner].range.CompareExchange( range, ( ( begin + 1 ) << 16 ) | end ) == range ) {
+			return segment.firstJob + begin;
+		}
+	}
 
-		// decrease the job count for the current signal
-		if ( signalJobCount[state.signalIndex].Decrement() == 0 ) {
-			// if this was the very last job of the job list
-			if ( state.signalIndex == signalJobCount.Num() - 1 ) {
-				deferredThreadStats.endTime = Sys_Microseconds();
-				return ( result | RUN_DONE );
+	// steal from the back of the queue of a random other thread
+	const int firstVictim = state.stealRandom.RandomInt( numStealQueues );
+	for ( int i = 0; i < numStealQueues; i++ ) {
+		const int victim = ( firstVictim + i ) % numStealQueues;
+		if ( victim == owner ) {
+			continue;
+		}
+		for ( ; ; ) {
+			const int range = queues[victim].range.GetValue();
+			const int begin = range >> 16;
+			const int end = range & 0xFFFF;
+			if ( begin >= end ) {
+				break;
+			}
+			if ( queues[victim].range.CompareExchange( range, ( begin << 16 ) | ( end - 1 ) ) == range ) {
+				return segment.firstJob + end - 1;
 			}
 		}
+	}
+	return -1;
+}
+
+/*
+========================
+idParallelJobList_Threads::RunStealJobsInternal
+========================
+*/
+int idParallelJobList_Threads::RunStealJobsInternal( unsigned int threadNum, threadJobListState_t & state, bool singleJob ) {
+	if ( state.version != version.GetValue() ) {
+		// trying to run an old version of this list that is already done
+		return RUN_DONE;
+	}
+
+	assert( threadNum < MAX_THREADS );
+
+	if ( deferredThreadStats.startTime == 0 ) {
+		deferredThreadStats.startTime = Sys_Microseconds();	// first time any thread is running jobs from this list
+	}
+
+	int result = RUN_OK;
+
+	do {
+		if ( state.stealSegment >= stealSegments.Num() ) {
+			return ( result | RUN_DONE );
+		}
+
+		const int waitSignalIndex = stealSegments[state.stealSegment].waitSignalIndex;
+		if ( waitSignalIndex >= 0 && signalJobCount[waitSignalIndex].GetValue() > 0 ) {
+			// stalled on a synchronization point
+			return ( result | RUN_STALLED );
+		}
+
+		const int stealJob = FetchStealJob( threadNum, state );
+		if ( stealJob < 0 ) {
+			// nothing left to grab in this segment, any remaining jobs are being executed by other threads
+			state.stealSegment++;
+			continue;
+		}
+
+		// a job that still waits for predecessors is run by the thread finishing the last of them
+		if ( !ReleaseJob( stealJobs[stealJob] ) ) {
+			continue;
+		}
+
+		result |= RunReadyJob( threadNum, stealJobs[stealJob] );
+
+		// if this was the very last job of the job list
+		if ( ( result & RUN_DONE ) != 0 ) {
+			return result;
+		}
 
 	} while( ! singleJob );
 
@@ -676,7 +1175,12 @@ int idParallelJobList_Threads::RunJobs( unsigned int threadNum, threadJobListSta
 
 	numThreadsExecuting.Increment();
 
-	int result = RunJobsInternal( threadNum, state, singleJob );
+	int result;
+	if ( numStealQueues > 0 ) {
+		result = RunStealJobsInternal( threadNum, state, singleJob );
+	} else {
+		result = RunJobsInternal( threadNum, state, singleJob );
+	}
 
 	numThreadsExecuting.Decrement();
 
@@ -732,9 +1236,30 @@ idParallelJobList::~idParallelJobList() {
 idParallelJobList::AddJob
 ========================
 */
-void idParallelJobList::AddJob( jobRun_t function, void * data ) {
+jobHandle_t idParallelJobList::AddJob( jobRun_t function, void * data ) {
 	assert( IsRegisteredJob( function ) );
-	jobListThreads->AddJob( function, data );
+	return jobListThreads->AddJob( function, data );
+}
+
+/*
+========================
+idParallelJobList::AddJob
+========================
+*/
+jobHandle_t idParallelJobList::AddJob( jobRun_t function, void * data, jobHandle_t predecessor ) {
+	assert( IsRegisteredJob( function ) );
+	jobHandle_t job = jobListThreads->AddJob( function, data );
+	jobListThreads->AddDependency( job, predecessor );
+	return job;
+}
+
+/*
+========================
+idParallelJobList::AddDependency
+========================
+*/
+void idParallelJobList::AddDependency( jobHandle_t job, jobHandle_t predecessor ) {
+	jobListThreads->AddDependency( job, predecessor );
 }
 
 /*
@@ -1001,6 +1526,8 @@ int idJobThread::Run() {
 			threadJobListState[numJobLists].signalIndex = 0;
 			threadJobListState[numJobLists].lastJobIndex = 0;
 			threadJobListState[numJobLists].nextJobIndex = -1;
+			threadJobListState[numJobLists].stealSegment = 0;
+			threadJobListState[numJobLists].stealRandom.SetSeed( threadNum * 1103 + firstJobList );
 			numJobLists++;
 			firstJobList++;
 		}
@@ -1090,8 +1617,11 @@ extern void Sys_CPUCount( int & logicalNum, int & coreNum, int & packageNum );
 //
 // Hyperthreading is not dead yet.  Intel's Core i7 Processor is quad-core with HT for 8 logicals.
 
-// DOOM3: We don't have that many jobs, so just set this fairly low so we don't spin up a ton of idle threads
-#define MAX_JOB_THREADS		2
+// DOOM3: We don't have that many jobs, so default to a low number of threads. Init starts one
+// job thread per logical core up to MAX_JOB_THREADS. Default job lists use jobs_numThreads of them,
+// JOBLIST_PARALLELISM_MAX_THREADS lists use all of them, and lists running on at least
+// jobs_stealMinThreads threads use the work-stealing scheduler.
+#define MAX_JOB_THREADS		16
 #define NUM_JOB_THREADS		"2"
 #define JOB_THREAD_CORES	{	CORE_ANY, CORE_ANY, CORE_ANY, CORE_ANY,	\
 								CORE_ANY, CORE_ANY, CORE_ANY, CORE_ANY,	\
@@ -1104,6 +1634,7 @@ extern void Sys_CPUCount( int & logicalNum, int & coreNum, int & packageNum );
 
 
 idCVar jobs_numThreads( "jobs_numThreads", NUM_JOB_THREADS, CVAR_INTEGER | CVAR_NOCHEAT, "number of threads used to crunch through jobs", 0, MAX_JOB_THREADS );
+idCVar jobs_stealMinThreads( "jobs_stealMinThreads", "4", CVAR_INTEGER | CVAR_NOCHEAT, "job lists running on at least this many threads use the work-stealing scheduler instead of a shared job index, 0 = never", 0, MAX_JOB_THREADS );
 
 class idParallelJobManagerLocal : public idParallelJobManager {
 public:
@@ -1127,6 +1658,7 @@ public:
 
 private:
 	idJobThread						threads[MAX_JOB_THREADS];
+	int								numJobThreads;			// threads started by Init, never more than the logical core count
 	unsigned int					maxThreads;
 	int								numPhysicalCpuCores;
 	int								numLogicalCpuCores;
@@ -1156,12 +1688,14 @@ void idParallelJobManagerLocal::Init() {
 	core_t cores[] = JOB_THREAD_CORES;
 	assert( sizeof( cores ) / sizeof( cores[0] ) >= MAX_JOB_THREADS );
 
-	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+	Sys_CPUCount( numLogicalCpuCores, numPhysicalCpuCores, numCpuPackages );
+
+	// more threads than logical cores would only time slice against each other
+	numJobThreads = idMath::ClampInt( 1, MAX_JOB_THREADS, numLogicalCpuCores );
+	for ( int i = 0; i < numJobThreads; i++ ) {
 		threads[i].Start( cores[i], i );
 	}
-	maxThreads = jobs_numThreads.GetInteger();
-
-	Sys_CPUCount( numPhysicalCpuCores, numLogicalCpuCores, numCpuPackages );
+	maxThreads = idMath::ClampInt( 0, numJobThreads, jobs_numThreads.GetInteger() );
 }
 
 /*
@@ -1170,7 +1704,7 @@ idParallelJobManagerLocal::Shutdown
 ========================
 */
 void idParallelJobManagerLocal::Shutdown() {
-	for ( int i = 0; i < MAX_JOB_THREADS; i++ ) {
+	for ( int i = 0; i < numJobThreads; i++ ) {
 		threads[i].StopThread();
 	}
 }
@@ -1266,7 +1800,7 @@ idParallelJobManagerLocal::Submit
 */
 void idParallelJobManagerLocal::Submit( idParallelJobList_Threads * jobList, int parallelism ) {
 	if ( jobs_numThreads.IsModified() ) {
-		maxThreads = idMath::ClampInt( 0, MAX_JOB_THREADS, jobs_numThreads.GetInteger() );
+		maxThreads = idMath::ClampInt( 0, numJobThreads, jobs_numThreads.GetInteger() );
 		jobs_numThreads.ClearModified();
 	}
 
@@ -1277,12 +1811,13 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads * jobList, int
 	} else if ( parallelism == JOBLIST_PARALLELISM_MAX_CORES ) {
 		numThreads = numLogicalCpuCores;
 	} else if ( parallelism == JOBLIST_PARALLELISM_MAX_THREADS ) {
-		numThreads = MAX_JOB_THREADS;
-	} else if ( parallelism > MAX_JOB_THREADS ) {
-		numThreads = MAX_JOB_THREADS;
+		numThreads = numJobThreads;
 	} else {
 		numThreads = parallelism;
 	}
+	if ( numThreads > numJobThreads ) {
+		numThreads = numJobThreads;
+	}
 
 	if ( numThreads <= 0 ) {
 		threadJobListState_t state( jobList->GetVersion() );
@@ -1290,6 +1825,12 @@ void idParallelJobManagerLocal::Submit( idParallelJobList_Threads * jobList, int
 		return;
 	}
 
+	// with many threads the shared job index becomes a point of contention
+	const int stealMinThreads = jobs_stealMinThreads.GetInteger();
+	if ( stealMinThreads > 0 && numThreads >= stealMinThreads ) {
+		jobList->PrepareWorkStealing( numThreads );
+	}
+
 	for ( int i = 0; i < numThreads; i++ ) {
 		threads[i].AddJobList( jobList );
 		threads[i].SignalWork();
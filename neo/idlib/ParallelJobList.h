@@ -33,6 +33,9 @@ class idColor;
 
 typedef void ( * jobRun_t )( void * );
 
+// identifies a job within the job list it was added to, only valid until the list is waited on
+typedef int jobHandle_t;
+
 enum jobSyncType_t {
 	SYNC_NONE,
 	SYNC_SIGNAL,
@@ -75,13 +78,22 @@ order to outweigh any job switching overhead. On the other
 hand a job should consume no more than a couple of
 100,000 clock cycles to maintain a good load balance over
 multiple processing units.
+
+Besides sync points, a job can wait for individual jobs that
+were added to the same list before it. Such a job is started
+by the thread that finishes its last predecessor, so the rest
+of the list doesn't have to wait for the whole batch.
 ================================================
 */
 class idParallelJobList {
 	friend class idParallelJobManagerLocal;
 public:
 
-	void					AddJob( jobRun_t function, void * data );
+	jobHandle_t				AddJob( jobRun_t function, void * data );
+	// Add a job that won't start before the given job from this list has finished.
+	jobHandle_t				AddJob( jobRun_t function, void * data, jobHandle_t predecessor );
+	// Make a job wait for another job that was added to this list before it.
+	void					AddDependency( jobHandle_t job, jobHandle_t predecessor );
 	CellSpursJob128 *		AddJobSPURS();
 	void					InsertSyncPoint( jobSyncType_t syncType );
 
@@ -267,9 +267,22 @@ private:
 	void		CreateSampler();
 
 	static void EmptyGarbage();
+#if !defined( ID_USE_AMD_ALLOCATOR )
+	// Moves a few images out of the sparsest memory block. Records copies into commandBuffer,
+	// which must be outside of a render pass.
+	static void DefragmentImages( VkCommandBuffer commandBuffer );
+#endif
 #endif
 
 private:
+#if defined( ID_VULKAN )
+	void		GetImageCreateInfo( VkImageCreateInfo & createInfo ) const;
+	void		CreateImageView( VkImage image, VkImageView & view ) const;
+#if !defined( ID_USE_AMD_ALLOCATOR )
+	bool		MoveAllocation( VkCommandBuffer commandBuffer );
+#endif
+#endif
+
 	// parameters that define this image
 	idStr				m_imgName;				// game path, including extension (except for cube maps), may be an image program
 	cubeFiles_t			m_cubeFiles;			// If this is a cube map, and if so, what kind
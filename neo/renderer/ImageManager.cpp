@@ -638,7 +638,18 @@ void idImageManager::Preload( const idPreloadManifest &manifest, const bool & ma
 		int	start = Sys_Milliseconds();
 		int numLoaded = 0;
 
-		//fileSystem->StartPreload( preloadImageFiles );
+		// let mapped resource containers start paging the images in
+		idStrList preloadImageFiles;
+		for ( int i = 0; i < manifest.NumResources(); i++ ) {
+			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
+			if ( p.resType == PRELOAD_IMAGE && !ExcludePreloadImage( p.resourceName ) ) {
+				idStr generatedName;
+				idBinaryImage::GetGeneratedFileName( generatedName, p.resourceName );
+				preloadImageFiles.Append( generatedName );
+			}
+		}
+		fileSystem->StartPreload( preloadImageFiles );
+
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			if ( p.resType == PRELOAD_IMAGE && !ExcludePreloadImage( p.resourceName ) ) {
@@ -646,7 +657,7 @@ void idImageManager::Preload( const idPreloadManifest &manifest, const bool & ma
 				numLoaded++;
 			}
 		}
-		//fileSystem->StopPreload();
+		fileSystem->StopPreload();
 		int	end = Sys_Milliseconds();
 		idLib::Printf( "%05d images preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
 		idLib::Printf( "----------------------------------------\n" );
@@ -558,6 +558,7 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 		int numLoaded = 0;
 		idList< preloadSort_t > preloadSort;
 		preloadSort.Resize( manifest.NumResources() );
+		idStrList preloadFiles;
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			idResourceCacheEntry rc;
@@ -580,12 +581,16 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 					ps.idx = i;
 					ps.ofs = rc.offset;
 					preloadSort.Append( ps );
+					preloadFiles.Append( filename.c_str() );
 				}
 			}
 		}
 		
 		preloadSort.SortWithTemplate( idSort_Preload() );
 
+		// let mapped resource containers start paging these in
+		fileSystem->StartPreload( preloadFiles );
+
 		for ( int i = 0; i < preloadSort.Num(); i++ ) {
 			const preloadSort_t & ps = preloadSort[ i ];
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( ps.idx );
@@ -599,6 +604,7 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 			}
 			numLoaded++;
 		}
+		fileSystem->StopPreload();
 
 		int	end = Sys_Milliseconds();
 		idLib::Printf( "%05d models preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
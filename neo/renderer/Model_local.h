@@ -201,6 +201,8 @@ public:
 
 	virtual bool				SupportsBinaryModel() { return true; }
 
+	int							BenchmarkSkinning( int iterations, bool generic, uint64 & microseconds ) const;
+
 private:
 	idList<idMD5Joint, TAG_MODEL>	joints;
 	idList<idJointQuat, TAG_MODEL>	defaultPose;
@@ -48,6 +48,7 @@ extern idCVar r_jointNameOffset;
 extern idCVar r_useCachedDynamicModels;
 extern idCVar r_skipSuppress;
 extern idCVar r_showSkel;
+extern idCVar com_forceGenericSIMD;
 
 #ifdef ID_WIN_X86_SSE2_INTRIN
 
@@ -420,10 +421,10 @@ void idMD5Mesh::ParseMesh( idLexer &parser, int numJoints, const idJointMat *joi
 
 /*
 ============
-TransformVertsAndTangents
+TransformVertsAndTangents_Generic
 ============
 */
-void TransformVertsAndTangents( idDrawVert * targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints ) {
+static void TransformVertsAndTangents_Generic( idDrawVert * targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints ) {
 	for( int i = 0; i < numVerts; i++ ) {
 		const idDrawVert & base = baseVerts[i];
 
@@ -450,6 +451,144 @@ void TransformVertsAndTangents( idDrawVert * targetVerts, const int numVerts, co
 	}
 }
 
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+/*
+============
+BlendJoints_SSE2
+
+Blends the three rows of the joints that influence a vertex. The weights are sorted
+from large to small when the mesh is built, so the blend stops at the first zero weight.
+============
+*/
+static ID_INLINE void BlendJoints_SSE2( const float * jointFloats, const idDrawVert & base, __m128 & r0, __m128 & r1, __m128 & r2 ) {
+	const float * j0 = jointFloats + base.color[0] * 12;
+	const __m128 w0 = _mm_set1_ps( base.color2[0] * ( 1.0f / 255.0f ) );
+	r0 = _mm_mul_ps( _mm_load_ps( j0 + 0 ), w0 );
+	r1 = _mm_mul_ps( _mm_load_ps( j0 + 4 ), w0 );
+	r2 = _mm_mul_ps( _mm_load_ps( j0 + 8 ), w0 );
+
+	if ( base.color2[1] != 0 ) {
+		const float * j1 = jointFloats + base.color[1] * 12;
+		const __m128 w1 = _mm_set1_ps( base.color2[1] * ( 1.0f / 255.0f ) );
+		r0 = _mm_add_ps( r0, _mm_mul_ps( _mm_load_ps( j1 + 0 ), w1 ) );
+		r1 = _mm_add_ps( r1, _mm_mul_ps( _mm_load_ps( j1 + 4 ), w1 ) );
+		r2 = _mm_add_ps( r2, _mm_mul_ps( _mm_load_ps( j1 + 8 ), w1 ) );
+
+		if ( base.color2[2] != 0 ) {
+			const float * j2 = jointFloats + base.color[2] * 12;
+			const __m128 w2 = _mm_set1_ps( base.color2[2] * ( 1.0f / 255.0f ) );
+			r0 = _mm_add_ps( r0, _mm_mul_ps( _mm_load_ps( j2 + 0 ), w2 ) );
+			r1 = _mm_add_ps( r1, _mm_mul_ps( _mm_load_ps( j2 + 4 ), w2 ) );
+			r2 = _mm_add_ps( r2, _mm_mul_ps( _mm_load_ps( j2 + 8 ), w2 ) );
+
+			if ( base.color2[3] != 0 ) {
+				const float * j3 = jointFloats + base.color[3] * 12;
+				const __m128 w3 = _mm_set1_ps( base.color2[3] * ( 1.0f / 255.0f ) );
+				r0 = _mm_add_ps( r0, _mm_mul_ps( _mm_load_ps( j3 + 0 ), w3 ) );
+				r1 = _mm_add_ps( r1, _mm_mul_ps( _mm_load_ps( j3 + 4 ), w3 ) );
+				r2 = _mm_add_ps( r2, _mm_mul_ps( _mm_load_ps( j3 + 8 ), w3 ) );
+			}
+		}
+	}
+}
+
+/*
+============
+TransformVertsAndTangents_SSE2
+
+Skins four verts per iteration. Every vertex gathers its own joints, so the blend
+is done one vertex at a time. The blended rows of the four verts are then transposed,
+so every output component is computed for all four verts at once. The last group
+repeats the final vertex to fill the unused lanes and only writes the real verts.
+============
+*/
+static void TransformVertsAndTangents_SSE2( idDrawVert * targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints ) {
+	const float * jointFloats = joints->ToFloatPtr();
+
+	assert_16_byte_aligned( jointFloats );
+
+	__m128 rows[3][4];
+	ALIGN16( float xyz[3][4] );
+	ALIGN16( float normal[3][4] );
+	ALIGN16( float tangent[3][4] );
+	idVec3 n[4];
+	idVec3 t[4];
+
+	for ( int i = 0; i < numVerts; i += 4 ) {
+		const idDrawVert * base[4];
+		for ( int j = 0; j < 4; j++ ) {
+			base[j] = &baseVerts[ Min( i + j, numVerts - 1 ) ];
+			BlendJoints_SSE2( jointFloats, *base[j], rows[0][j], rows[1][j], rows[2][j] );
+			n[j] = base[j]->GetNormal();
+			t[j] = base[j]->GetTangent();
+		}
+
+		// rows[k][c] now holds column c of row k for each of the four verts
+		_MM_TRANSPOSE4_PS( rows[0][0], rows[0][1], rows[0][2], rows[0][3] );
+		_MM_TRANSPOSE4_PS( rows[1][0], rows[1][1], rows[1][2], rows[1][3] );
+		_MM_TRANSPOSE4_PS( rows[2][0], rows[2][1], rows[2][2], rows[2][3] );
+
+		const __m128 px = _mm_setr_ps( base[0]->xyz.x, base[1]->xyz.x, base[2]->xyz.x, base[3]->xyz.x );
+		const __m128 py = _mm_setr_ps( base[0]->xyz.y, base[1]->xyz.y, base[2]->xyz.y, base[3]->xyz.y );
+		const __m128 pz = _mm_setr_ps( base[0]->xyz.z, base[1]->xyz.z, base[2]->xyz.z, base[3]->xyz.z );
+		const __m128 nx = _mm_setr_ps( n[0].x, n[1].x, n[2].x, n[3].x );
+		const __m128 ny = _mm_setr_ps( n[0].y, n[1].y, n[2].y, n[3].y );
+		const __m128 nz = _mm_setr_ps( n[0].z, n[1].z, n[2].z, n[3].z );
+		const __m128 tx = _mm_setr_ps( t[0].x, t[1].x, t[2].x, t[3].x );
+		const __m128 ty = _mm_setr_ps( t[0].y, t[1].y, t[2].y, t[3].y );
+		const __m128 tz = _mm_setr_ps( t[0].z, t[1].z, t[2].z, t[3].z );
+
+		for ( int k = 0; k < 3; k++ ) {
+			const __m128 * r = rows[k];
+
+			__m128 p = _mm_add_ps( r[3], _mm_mul_ps( r[0], px ) );
+			p = _mm_add_ps( p, _mm_mul_ps( r[1], py ) );
+			p = _mm_add_ps( p, _mm_mul_ps( r[2], pz ) );
+
+			__m128 vn = _mm_mul_ps( r[0], nx );
+			vn = _mm_add_ps( vn, _mm_mul_ps( r[1], ny ) );
+			vn = _mm_add_ps( vn, _mm_mul_ps( r[2], nz ) );
+
+			__m128 vt = _mm_mul_ps( r[0], tx );
+			vt = _mm_add_ps( vt, _mm_mul_ps( r[1], ty ) );
+			vt = _mm_add_ps( vt, _mm_mul_ps( r[2], tz ) );
+
+			_mm_store_ps( xyz[k], p );
+			_mm_store_ps( normal[k], vn );
+			_mm_store_ps( tangent[k], vt );
+		}
+
+		const int count = Min( 4, numVerts - i );
+		for ( int j = 0; j < count; j++ ) {
+			idDrawVert & target = targetVerts[i + j];
+			target.xyz.Set( xyz[0][j], xyz[1][j], xyz[2][j] );
+			target.SetNormal( normal[0][j], normal[1][j], normal[2][j] );
+			target.SetTangent( tangent[0][j], tangent[1][j], tangent[2][j] );
+			target.tangent[3] = base[j]->tangent[3];
+		}
+	}
+}
+
+#endif
+
+/*
+============
+TransformVertsAndTangents
+
+com_forceGenericSIMD selects the generic path at run time.
+============
+*/
+static void TransformVertsAndTangents( idDrawVert * targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints, bool generic ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+	if ( !generic ) {
+		TransformVertsAndTangents_SSE2( targetVerts, numVerts, baseVerts, joints );
+		return;
+	}
+#endif
+	TransformVertsAndTangents_Generic( targetVerts, numVerts, baseVerts, joints );
+}
+
 /*
 ====================
 idMD5Mesh::UpdateSurface
@@ -508,7 +647,7 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 			assert( tri->verts != NULL );	// quiet analyze warning
 			memcpy( tri->verts, deformInfo->verts, deformInfo->numOutputVerts * sizeof( deformInfo->verts[0] ) );	// copy over the texture coordinates
 		}
-		TransformVertsAndTangents( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted );
+		TransformVertsAndTangents( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted, com_forceGenericSIMD.GetBool() );
 		tri->referencedVerts = false;
 	}
 	tri->tangentsCalculated = true;
@@ -1308,6 +1447,84 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 	return staticModel;
 }
 
+/*
+====================
+idRenderModelMD5::BenchmarkSkinning
+
+Skins every mesh of the model in its default pose with the generic or the SIMD
+CPU skinning path. Returns the number of skinned verts and adds the time spent
+to microseconds.
+====================
+*/
+int idRenderModelMD5::BenchmarkSkinning( int iterations, bool generic, uint64 & microseconds ) const {
+	const int numSkinJoints = SIMD_ROUND_JOINTS( joints.Num() );
+	idJointMat * skinJoints = (idJointMat *)_alloca16( numSkinJoints * sizeof( skinJoints[0] ) );
+	for ( int i = 0; i < numSkinJoints; i++ ) {
+		skinJoints[i].Identity();
+	}
+
+	int maxVerts = 0;
+	for ( int i = 0; i < meshes.Num(); i++ ) {
+		maxVerts = Max( maxVerts, meshes[i].deformInfo->numOutputVerts );
+	}
+
+	idTempArray< idDrawVert > verts( maxVerts );
+
+	int numVerts = 0;
+	const uint64 start = Sys_Microseconds();
+	for ( int n = 0; n < iterations; n++ ) {
+		for ( int i = 0; i < meshes.Num(); i++ ) {
+			const deformInfo_t * deform = meshes[i].deformInfo;
+			TransformVertsAndTangents( verts.Ptr(), deform->numOutputVerts, deform->verts, skinJoints, generic );
+			numVerts += deform->numOutputVerts;
+		}
+	}
+	microseconds += Sys_Microseconds() - start;
+
+	return numVerts;
+}
+
+/*
+====================
+benchmarkSkinning
+====================
+*/
+CONSOLE_COMMAND( benchmarkSkinning, "skins every md5mesh under a folder with the generic and the SIMD CPU path and reports the verts per second", NULL ) {
+	const char * path = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "models";
+	const int iterations = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : 100;
+
+	idFileList * files = fileSystem->ListFilesTree( path, ".md5mesh", true );
+
+	idList< idRenderModelMD5 * > models;
+	for ( int i = 0; i < files->GetNumFiles(); i++ ) {
+		idRenderModel * model = renderModelManager->FindModel( files->GetFile( i ) );
+		if ( model == NULL || model->IsDefaultModel() || model->IsDynamicModel() != DM_CACHED ) {
+			continue;
+		}
+		models.Append( static_cast< idRenderModelMD5 * >( model ) );
+	}
+
+	fileSystem->FreeFileList( files );
+
+	double vertsPerSecond[2];
+	for ( int generic = 1; generic >= 0; generic-- ) {
+		int64 numVerts = 0;
+		uint64 microseconds = 0;
+		for ( int i = 0; i < models.Num(); i++ ) {
+			numVerts += models[i]->BenchmarkSkinning( iterations, generic != 0, microseconds );
+		}
+
+		const double seconds = microseconds * 1e-6;
+		vertsPerSecond[generic] = ( seconds > 0.0 ) ? numVerts / seconds : 0.0;
+		idLib::Printf( "%7s: skinned %d md5meshes %d times: %lld verts in %.1f ms, %.2f million verts/sec\n", generic ? "generic" : "SIMD",
+						models.Num(), iterations, numVerts, microseconds * 1e-3, vertsPerSecond[generic] * 1e-6 );
+	}
+
+	if ( vertsPerSecond[1] > 0.0 ) {
+		idLib::Printf( "SIMD path is %.2f times the generic path\n", vertsPerSecond[0] / vertsPerSecond[1] );
+	}
+}
+
 /*
 ====================
 idRenderModelMD5::IsDynamicModel
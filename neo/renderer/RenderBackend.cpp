@@ -1891,7 +1891,10 @@ void idRenderBackend::FillDepthBufferFast( drawSurf_t **drawSurfs, int numDrawSu
 	const drawSurf_t ** perforatedSurfaces = (const drawSurf_t ** )_alloca( numDrawSurfs * sizeof( drawSurf_t * ) );
 	int numPerforatedSurfaces = 0;
 
-	// draw all the opaque surfaces and build up a list of perforated surfaces that
+	const drawSurf_t ** opaqueSurfaces = (const drawSurf_t ** )_alloca( numDrawSurfs * sizeof( drawSurf_t * ) );
+	int numOpaqueSurfaces = 0;
+
+	// build up a list of the opaque surfaces and a list of perforated surfaces that
 	// we will defer drawing until all opaque surfaces are done
 	GL_State( GLS_DEFAULT );
 
@@ -1911,29 +1914,46 @@ void idRenderBackend::FillDepthBufferFast( drawSurf_t **drawSurfs, int numDrawSu
 			continue;
 		}
 
-		// set polygon offset?
+		opaqueSurfaces[ numOpaqueSurfaces ] = surf;
+		numOpaqueSurfaces++;
+	}
 
-		// set mvp matrix
-		if ( surf->space != m_currentSpace ) {
-			RB_SetMVP( surf->space->mvp );
-			m_currentSpace = surf->space;
-		}
+	// the opaque surfaces only need the mvp and one of two programs,
+	// so they can be recorded on the job threads
+	bool opaqueDrawn = false;
+#if defined( ID_VULKAN )
+	opaqueDrawn = FillDepthBufferParallel( opaqueSurfaces, numOpaqueSurfaces );
+#endif
 
-		renderLog.OpenBlock( shader->GetName() );
+	if ( !opaqueDrawn ) {
+		for ( int i = 0; i < numOpaqueSurfaces; i++ ) {
+			const drawSurf_t * surf = opaqueSurfaces[ i ];
+			const idMaterial * shader = surf->material;
 
-		if ( surf->jointCache ) {
-			renderProgManager.BindProgram( BUILTIN_DEPTH_SKINNED );
-		} else {
-			renderProgManager.BindProgram( BUILTIN_DEPTH );
-		}
+			// set polygon offset?
 
-		// must render with less-equal for Z-Cull to work properly
-		assert( ( m_glStateBits & GLS_DEPTHFUNC_BITS ) == GLS_DEPTHFUNC_LESS );
+			// set mvp matrix
+			if ( surf->space != m_currentSpace ) {
+				RB_SetMVP( surf->space->mvp );
+				m_currentSpace = surf->space;
+			}
 
-		// draw it solid
-		DrawElementsWithCounters( surf );
+			renderLog.OpenBlock( shader->GetName() );
 
-		renderLog.CloseBlock();
+			if ( surf->jointCache ) {
+				renderProgManager.BindProgram( BUILTIN_DEPTH_SKINNED );
+			} else {
+				renderProgManager.BindProgram( BUILTIN_DEPTH );
+			}
+
+			// must render with less-equal for Z-Cull to work properly
+			assert( ( m_glStateBits & GLS_DEPTHFUNC_BITS ) == GLS_DEPTHFUNC_LESS );
+
+			// draw it solid
+			DrawElementsWithCounters( surf );
+
+			renderLog.CloseBlock();
+		}
 	}
 
 	// draw all perforated surfaces with the general code path
@@ -2127,6 +2147,11 @@ void idRenderBackend::RenderInteractions( const drawSurf_t *surfList, const view
 		allSurfaces.Append( walk );
 	}
 
+#if defined( ID_VULKAN )
+	// everything below still runs here, only the command recording moves to the jobs
+	const bool parallelDraws = BeginParallelDraws( allSurfaces.Num() * lightShader->GetNumStages() );
+#endif
+
 	bool lightDepthBoundsDisabled = false;
 
 	for ( int lightStageNum = 0; lightStageNum < lightShader->GetNumStages(); lightStageNum++ ) {
@@ -2331,6 +2356,12 @@ void idRenderBackend::RenderInteractions( const drawSurf_t *surfList, const view
 		}
 	}
 
+#if defined( ID_VULKAN )
+	if ( parallelDraws ) {
+		EndParallelDraws();
+	}
+#endif
+
 	if ( useLightDepthBounds && lightDepthBoundsDisabled ) {
 		GL_DepthBoundsTest( vLight->scissorRect.zmin, vLight->scissorRect.zmax );
 	}
@@ -3167,6 +3198,14 @@ void idRenderBackend::StencilShadowPass( const drawSurf_t *drawSurfs, const view
 	// process the chain of shadows with the current rendering state
 	m_currentSpace = NULL;
 
+#if defined( ID_VULKAN )
+	int numShadowSurfs = 0;
+	for ( const drawSurf_t * drawSurf = drawSurfs; drawSurf != NULL; drawSurf = drawSurf->nextOnLight ) {
+		numShadowSurfs++;
+	}
+	const bool parallelDraws = BeginParallelDraws( numShadowSurfs );
+#endif
+
 	for ( const drawSurf_t * drawSurf = drawSurfs; drawSurf != NULL; drawSurf = drawSurf->nextOnLight ) {
 		if ( drawSurf->scissorRect.IsEmpty() ) {
 			continue;	// !@# FIXME: find out why this is sometimes being hit!
@@ -3248,6 +3287,12 @@ void idRenderBackend::StencilShadowPass( const drawSurf_t *drawSurfs, const view
 		DrawStencilShadowPass( drawSurf, renderZPass );
 	}
 
+#if defined( ID_VULKAN )
+	if ( parallelDraws ) {
+		EndParallelDraws();
+	}
+#endif
+
 	// cleanup the shadow specific rendering state
 
 	GL_State( m_glStateBits & ~( GLS_CULL_MASK ) | GLS_CULL_FRONTSIDED );
@@ -138,8 +138,11 @@ struct vulkanContext_t {
 	VkDevice						device;
 	VkQueue							graphicsQueue;
 	VkQueue							presentQueue;
+	VkQueue							transferQueue;
 	int								graphicsFamilyIdx;
 	int								presentFamilyIdx;
+	int								transferFamilyIdx;
+	bool							memoryBudgetAvailable;
 	VkDebugReportCallbackEXT		callback;
 
 	idList< const char * >			instanceExtensions;
@@ -158,6 +161,7 @@ struct vulkanContext_t {
 	VkPresentModeKHR				presentMode;
 	VkFormat						depthFormat;
 	VkRenderPass					renderPass;
+	VkRenderPass					renderPassResume;
 	VkPipelineCache					pipelineCache;
 	VkSampleCountFlagBits			sampleCount;
 	bool							supersampling;
@@ -241,6 +245,11 @@ private:
 
 	void				FillDepthBufferGeneric( const drawSurf_t * const * drawSurfs, int numDrawSurfs );
 	void				FillDepthBufferFast( drawSurf_t ** drawSurfs, int numDrawSurfs );
+#if defined( ID_VULKAN )
+	bool				FillDepthBufferParallel( const drawSurf_t * const * drawSurfs, int numDrawSurfs );
+	bool				BeginParallelDraws( int numExpectedDraws );
+	void				EndParallelDraws();
+#endif
 
 	void				T_BlendLight( const drawSurf_t * drawSurfs, const viewLight_t * vLight );
 	void				BlendLight( const drawSurf_t * drawSurfs, const drawSurf_t * drawSurfs2, const viewLight_t * vLight );
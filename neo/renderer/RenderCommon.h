@@ -58,6 +58,11 @@ const int INITIAL_DRAWSURFS			= 2048;
 
 static const int MAX_RENDER_CROPS	= 8;
 
+// the front end job list gets an R_AddSingleModel job and a chained
+// R_AddSingleModelShadows job for every visible view entity
+const int MAX_FRONTEND_VIEW_ENTITIES	= 2048;
+const int MAX_FRONTEND_JOBS			= MAX_FRONTEND_VIEW_ENTITIES * 2;
+
 // Guis
 const int MAX_RENDERENTITY_GUI		= 3;
 // default size of the drawSurfs list for guis, will
@@ -75,6 +80,9 @@ static const int MAX_DESC_UNIFORM_BUFFERS	= 8192;
 static const int MAX_DESC_IMAGE_SAMPLERS	= 12384;
 static const int MAX_DESC_SET_WRITES		= 32;
 static const int MAX_DESC_SET_UNIFORMS		= 48;
+static const int MAX_RECORD_CONTEXTS		= 8;
+static const int MAX_RECORD_CONTEXT_SETS	= 2048;
+static const int MAX_RECORD_CONTEXT_IMAGES	= 5;		// samplers per set, the interaction programs use the most
 static const int MAX_IMAGE_PARMS			= 16;
 static const int MAX_UBO_PARMS				= 2;
 #endif
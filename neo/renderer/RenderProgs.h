@@ -243,6 +243,24 @@ struct renderProg_t {
 	idList< pipelineState_t >	pipelines;
 };
 
+/*
+================================================
+vkRecordContext_t
+
+State for a job recording draws into its own secondary command buffer. The
+uniforms and image parms start as a copy of the render thread's and the parm
+block range is reserved up front, so nothing in here is shared between jobs.
+================================================
+*/
+struct vkRecordContext_t {
+	VkCommandBuffer		commandBuffer;
+	VkDescriptorPool	descriptorPool;
+	int					parmBufferOffset;
+	int					parmBufferEnd;
+	idVec4				uniforms[ RENDERPARM_TOTAL ];
+	idImage *			imageParms[ MAX_IMAGE_PARMS ];
+};
+
 #elif defined( ID_OPENGL )
 static const GLuint INVALID_PROGID = 0xFFFFFFFF;
 
@@ -299,6 +317,7 @@ public:
 	void	SetRenderParms( renderParm_t rp, const float * values, int numValues );
 	
 	const renderProg_t & GetCurrentRenderProg() const { return m_renderProgs[ m_current ]; }
+	int		GetCurrentRenderProgIndex() const { return m_current; }
 	int		FindShader( const char * name, rpStage_t stage );
 	void	BindProgram( int index );
 	void	Unbind();
@@ -306,6 +325,17 @@ public:
 	void	CommitCurrent( uint64 stateBits );
 	int		FindProgram( const char * name, int vIndex, int fIndex );
 
+#if defined( ID_VULKAN )
+	// parallel command buffer recording, everything but CommitRecordContext with a context must be called from the render thread
+	VkPipeline	PreparePipeline( int index, uint64 stateBits );
+	int			GetParmBlockBytes( int index ) const;
+	int			GetRecordParmCount( int index ) const;
+	int			GetRecordImageCount( int index ) const;
+	void		CaptureRecordParms( int index, idVec4 * parms ) const;
+	bool		BeginRecordContexts( vkRecordContext_t * contexts, int numContexts, int maxDrawsPerContext, int parmBytesPerDraw );
+	void		CommitRecordContext( vkRecordContext_t * context, int index, VkPipeline pipeline, vertCacheHandle_t jointCacheHandle, const idVec4 * parms = NULL );
+#endif
+
 private:
 	void	LoadShader( int index );
 	void	LoadShader( shader_t & shader );
@@ -313,7 +343,12 @@ private:
 #if defined( ID_OPENGL )
 	void	LoadGLSLProgram( const int programIndex, const int vertexShaderIndex, const int fragmentShaderIndex );
 #elif defined( ID_VULKAN )
-	void	AllocParmBlockBuffer( const idList< int > & parmIndices, idUniformBuffer & ubo );
+	void	AllocParmBlockBuffer( const idList< int > & parmIndices, idUniformBuffer & ubo, vkRecordContext_t * context = NULL );
+	void	CommitDescriptors( const renderProg_t & prog, VkPipeline pipeline, vertCacheHandle_t jointCacheHandle, vkRecordContext_t * context );
+
+	void	LoadPipelineManifest();
+	void	SavePipelineManifest();
+	void	WarmPipelines( int programIndex );
 #endif
 
 public:
@@ -333,6 +368,8 @@ private:
 	int					m_currentParmBufferOffset;
 	VkDescriptorPool	m_descriptorPools[ NUM_FRAME_DATA ];
 	VkDescriptorSet		m_descriptorSets[ NUM_FRAME_DATA ][ MAX_DESC_SETS ];
+	VkDescriptorPool	m_recordPools[ NUM_FRAME_DATA ][ MAX_RECORD_CONTEXTS ];
+	int					m_recordPoolSets[ MAX_RECORD_CONTEXTS ];
 
 	idUniformBuffer *	m_parmBuffers[ NUM_FRAME_DATA ];
 #endif
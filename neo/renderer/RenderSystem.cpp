@@ -550,7 +550,7 @@ void idRenderSystemLocal::Init() {
 		m_testImageTriangles = R_MakeTestImageTriangles();
 	}
 
-	m_frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 2048, 0, NULL );
+	m_frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, MAX_FRONTEND_JOBS, 0, NULL );
 
 	m_bInitialized = true;
 
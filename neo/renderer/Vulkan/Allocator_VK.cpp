@@ -33,6 +33,8 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar r_vkDeviceLocalMemoryMB( "r_vkDeviceLocalMemoryMB", "128", CVAR_INTEGER | CVAR_INIT, "" );
 idCVar r_vkHostVisibleMemoryMB( "r_vkHostVisibleMemoryMB", "64", CVAR_INTEGER | CVAR_INIT, "" );
+idCVar r_vkDefragment( "r_vkDefragment", "1", CVAR_BOOL, "Move image allocations out of sparse memory blocks so they can be released." );
+idCVar r_vkDefragmentThreshold( "r_vkDefragmentThreshold", "0.5", CVAR_FLOAT, "Blocks used less than this fraction are candidates for defragmentation.", 0.0f, 1.0f );
 
 /*
 =============
@@ -100,6 +102,52 @@ uint32 FindMemoryTypeIndex( const uint32 memoryTypeBits, const vulkanMemoryUsage
 /*
 ================================================================================================
 
+idVulkanDeviceMemoryLocal
+
+================================================================================================
+*/
+
+class idVulkanDeviceMemoryLocal : public idVulkanDeviceMemory {
+public:
+	virtual uint32 FindMemoryTypeIndex( const uint32 memoryTypeBits, const vulkanMemoryUsage_t usage ) {
+		return ::FindMemoryTypeIndex( memoryTypeBits, usage );
+	}
+
+	virtual bool AllocateMemory( const uint32 memoryTypeIndex, const VkDeviceSize size, const bool hostVisible, VkDeviceMemory & deviceMemory, byte * & data ) {
+		VkMemoryAllocateInfo memoryAllocateInfo = {};
+		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memoryAllocateInfo.allocationSize = size;
+		memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+		ID_VK_CHECK( vkAllocateMemory( vkcontext.device, &memoryAllocateInfo, NULL, &deviceMemory ) )
+
+		if ( deviceMemory == VK_NULL_HANDLE ) {
+			return false;
+		}
+
+		if ( hostVisible ) {
+			ID_VK_CHECK( vkMapMemory( vkcontext.device, deviceMemory, 0, size, 0, (void **)&data ) );
+		}
+
+		return true;
+	}
+
+	virtual void FreeMemory( VkDeviceMemory deviceMemory, const bool hostVisible ) {
+		// Unmap the memory
+		if ( hostVisible ) {
+			vkUnmapMemory( vkcontext.device, deviceMemory );
+		}
+
+		// Free the memory
+		vkFreeMemory( vkcontext.device, deviceMemory, NULL );
+	}
+};
+
+static idVulkanDeviceMemoryLocal deviceMemoryLocal;
+
+/*
+================================================================================================
+
 idVulkanAllocator
 
 ================================================================================================
@@ -110,13 +158,19 @@ idVulkanAllocator
 idVulkanBlock::idVulkanBlock
 =============
 */
-idVulkanBlock::idVulkanBlock( const uint32 memoryTypeIndex, const VkDeviceSize size, vulkanMemoryUsage_t usage ) : 
+idVulkanBlock::idVulkanBlock( idVulkanDeviceMemory * deviceMemory, const uint32 memoryTypeIndex, const VkDeviceSize size, vulkanMemoryUsage_t usage ) : 
+	m_head( NULL ),
+	m_memory( deviceMemory ),
 	m_nextBlockId( 0 ),
 	m_size( size ),
 	m_allocated( 0 ),
+	m_data( NULL ),
 	m_memoryTypeIndex( memoryTypeIndex ),
 	m_usage( usage ),
-	m_deviceMemory( VK_NULL_HANDLE ) {
+	m_deviceMemory( VK_NULL_HANDLE ),
+	m_numAllocations( 0 ),
+	m_numImageAllocations( 0 ),
+	m_defragmentFailed( false ) {
 	
 }
 
@@ -139,22 +193,12 @@ bool idVulkanBlock::Init() {
 		return false;
 	}
 
-	VkMemoryAllocateInfo memoryAllocateInfo = {};
-	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	memoryAllocateInfo.allocationSize = m_size;
-	memoryAllocateInfo.memoryTypeIndex = m_memoryTypeIndex;
-
-	ID_VK_CHECK( vkAllocateMemory( vkcontext.device, &memoryAllocateInfo, NULL, &m_deviceMemory ) )
-
-	if ( m_deviceMemory == VK_NULL_HANDLE ) {
+	if ( !m_memory->AllocateMemory( m_memoryTypeIndex, m_size, IsHostVisible(), m_deviceMemory, m_data ) ) {
 		return false;
 	}
 
-	if ( IsHostVisible() ) {
-		ID_VK_CHECK( vkMapMemory( vkcontext.device, m_deviceMemory, 0, m_size, 0, (void **)&m_data ) );
-	}
-
 	m_head = new chunk_t();
+	m_head->id = m_nextBlockId++;
 	m_head->size = m_size;
 	m_head->offset = 0;
 	m_head->prev = NULL;
@@ -170,14 +214,13 @@ idVulkanBlock::Shutdown
 =============
 */
 void idVulkanBlock::Shutdown() {
-	// Unmap the memory
-	if ( IsHostVisible() ) {
-		vkUnmapMemory( vkcontext.device, m_deviceMemory );
+	if ( m_head == NULL ) {
+		return;
 	}
 
-	// Free the memory
-	vkFreeMemory( vkcontext.device, m_deviceMemory, NULL );
+	m_memory->FreeMemory( m_deviceMemory, IsHostVisible() );
 	m_deviceMemory = VK_NULL_HANDLE;
+	m_data = NULL;
 
 	chunk_t * prev = NULL;
 	chunk_t * current = m_head;
@@ -275,7 +318,7 @@ bool idVulkanBlock::Allocate(
 	VkDeviceSize alignedSize = 0;
 
 	for ( current = m_head; current != NULL; previous = current, current = current->next ) {
-		if ( !current->type == VULKAN_ALLOCATION_TYPE_FREE ) {
+		if ( current->type != VULKAN_ALLOCATION_TYPE_FREE ) {
 			continue;
 		}
 
@@ -322,11 +365,15 @@ bool idVulkanBlock::Allocate(
 		return false;
 	}
 
-	if ( bestFit->size > size ) {
+	// The chunk keeps its alignment padding so freeing it returns exactly what was taken.
+	if ( bestFit->size > alignedSize ) {
 		chunk_t * chunk = new chunk_t();
 		chunk->id = m_nextBlockId++;
 		chunk->prev = bestFit;
 		chunk->next = bestFit->next;
+		if ( bestFit->next ) {
+			bestFit->next->prev = chunk;
+		}
 		bestFit->next = chunk;
 
 		chunk->size = bestFit->size - alignedSize;
@@ -335,11 +382,16 @@ bool idVulkanBlock::Allocate(
 	}
 
 	bestFit->type = allocType;
-	bestFit->size = size;
+	bestFit->size = alignedSize;
 
 	m_allocated += alignedSize;
 
-	allocation.size = bestFit->size;
+	m_numAllocations++;
+	if ( allocType == VULKAN_ALLOCATION_TYPE_IMAGE_OPTIMAL ) {
+		m_numImageAllocations++;
+	}
+
+	allocation.size = size;
 	allocation.id = bestFit->id;
 	allocation.deviceMemory = m_deviceMemory;
 	if ( IsHostVisible() ) {
@@ -369,6 +421,18 @@ void idVulkanBlock::Free( vulkanAllocation_t & allocation ) {
 		return;
 	}
 
+	m_allocated -= current->size;
+
+	m_numAllocations--;
+	if ( current->type == VULKAN_ALLOCATION_TYPE_IMAGE_OPTIMAL ) {
+		m_numImageAllocations--;
+	}
+
+	// whatever kept the block from being emptied may have been this
+	m_defragmentFailed = false;
+
+	current->type = VULKAN_ALLOCATION_TYPE_FREE;
+
 	if ( current->prev && current->prev->type == VULKAN_ALLOCATION_TYPE_FREE ) {
 		chunk_t * prev = current->prev;
 
@@ -396,8 +460,32 @@ void idVulkanBlock::Free( vulkanAllocation_t & allocation ) {
 
 		delete next;
 	}
+}
 
-	m_allocated -= allocation.size;
+/*
+=============
+idVulkanBlock::GetStats
+=============
+*/
+void idVulkanBlock::GetStats( vulkanBlockStats_t & stats ) const {
+	stats.size = m_size;
+	stats.allocated = m_allocated;
+	stats.largestFree = 0;
+	stats.numAllocations = 0;
+	stats.numImageAllocations = 0;
+	stats.numFreeChunks = 0;
+
+	for ( const chunk_t * current = m_head; current != NULL; current = current->next ) {
+		if ( current->type == VULKAN_ALLOCATION_TYPE_FREE ) {
+			stats.numFreeChunks++;
+			stats.largestFree = Max( stats.largestFree, current->size );
+		} else {
+			stats.numAllocations++;
+			if ( current->type == VULKAN_ALLOCATION_TYPE_IMAGE_OPTIMAL ) {
+				stats.numImageAllocations++;
+			}
+		}
+	}
 }
 
 /*
@@ -420,6 +508,7 @@ idVulkanAllocator::idVulkanAllocator
 =============
 */
 idVulkanAllocator::idVulkanAllocator() : 
+	m_deviceMemory( &deviceMemoryLocal ),
 	m_garbageIndex( 0 ),
 	m_deviceLocalMemoryMB( 0 ),
 	m_hostVisibleMemoryMB( 0 ),
@@ -433,9 +522,19 @@ idVulkanAllocator::Init
 =============
 */
 void idVulkanAllocator::Init() {
+	Init( &deviceMemoryLocal, vkcontext.gpu->props.limits.bufferImageGranularity );
+}
+
+/*
+=============
+idVulkanAllocator::Init
+=============
+*/
+void idVulkanAllocator::Init( idVulkanDeviceMemory * deviceMemory, const VkDeviceSize bufferImageGranularity ) {
+	m_deviceMemory = deviceMemory;
 	m_deviceLocalMemoryMB = r_vkDeviceLocalMemoryMB.GetInteger() * 1024 * 1024;
 	m_hostVisibleMemoryMB = r_vkHostVisibleMemoryMB.GetInteger() * 1024 * 1024;
-	m_bufferImageGranularity = vkcontext.gpu->props.limits.bufferImageGranularity;
+	m_bufferImageGranularity = bufferImageGranularity;
 }
 
 /*
@@ -470,7 +569,7 @@ vulkanAllocation_t idVulkanAllocator::Allocate(
 	
 	vulkanAllocation_t allocation;
 
-	uint32 memoryTypeIndex = FindMemoryTypeIndex( memoryTypeBits, usage );
+	uint32 memoryTypeIndex = m_deviceMemory->FindMemoryTypeIndex( memoryTypeBits, usage );
 	if ( memoryTypeIndex == UINT32_MAX ) {
 		idLib::FatalError( "idVulkanAllocator::Allocate: Unable to find a memoryTypeIndex for allocation request." );
 	}
@@ -491,7 +590,7 @@ vulkanAllocation_t idVulkanAllocator::Allocate(
 
 	VkDeviceSize blockSize = ( usage == VULKAN_MEMORY_USAGE_GPU_ONLY ) ? m_deviceLocalMemoryMB : m_hostVisibleMemoryMB;
 
-	idVulkanBlock * block = new idVulkanBlock( memoryTypeIndex, blockSize, usage );
+	idVulkanBlock * block = new idVulkanBlock( m_deviceMemory, memoryTypeIndex, blockSize, usage );
 	if ( block->Init() ) {
 		blocks.Append( block );
 	} else {
@@ -503,6 +602,186 @@ vulkanAllocation_t idVulkanAllocator::Allocate(
 	return allocation;
 }
 
+/*
+=============
+idVulkanAllocator::AllocateForMove
+=============
+*/
+bool idVulkanAllocator::AllocateForMove( 
+		const uint32 size, 
+		const uint32 align, 
+		const uint32 memoryTypeBits,
+		const vulkanMemoryUsage_t usage,
+		const vulkanAllocationType_t allocType,
+		const idVulkanBlock * source,
+		vulkanAllocation_t & allocation ) {
+
+	uint32 memoryTypeIndex = m_deviceMemory->FindMemoryTypeIndex( memoryTypeBits, usage );
+	if ( memoryTypeIndex == UINT32_MAX ) {
+		return false;
+	}
+
+	idList< idVulkanBlock * > & blocks = m_blocks[ memoryTypeIndex ];
+	const int numBlocks = blocks.Num();
+	for ( int i = 0; i < numBlocks; ++i ) {
+		idVulkanBlock * block = blocks[ i ];
+
+		if ( block == source ) {
+			continue;
+		}
+
+		if ( block->Allocate( size, align, m_bufferImageGranularity, allocType, allocation ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+=============
+idVulkanAllocator::FindDefragmentBlock
+=============
+*/
+idVulkanBlock * idVulkanAllocator::FindDefragmentBlock() {
+	idVulkanBlock * best = NULL;
+	float bestUsage = r_vkDefragmentThreshold.GetFloat();
+
+	for ( int i = 0; i < VK_MAX_MEMORY_TYPES; ++i ) {
+		idList< idVulkanBlock * > & blocks = m_blocks[ i ];
+		const int numBlocks = blocks.Num();
+		if ( numBlocks < 2 ) {
+			continue;
+		}
+
+		VkDeviceSize totalFree = 0;
+		for ( int j = 0; j < numBlocks; ++j ) {
+			totalFree += blocks[ j ]->m_size - blocks[ j ]->m_allocated;
+		}
+
+		for ( int j = 0; j < numBlocks; ++j ) {
+			idVulkanBlock * block = blocks[ j ];
+			if ( block->m_usage != VULKAN_MEMORY_USAGE_GPU_ONLY ) {
+				continue;
+			}
+
+			// buffers can't be moved, so a block holding any can never be emptied
+			if ( block->m_numImageAllocations == 0 || block->m_numImageAllocations != block->m_numAllocations ) {
+				continue;
+			}
+
+			if ( block->m_defragmentFailed ) {
+				continue;
+			}
+
+			const float usage = (float)block->m_allocated / (float)block->m_size;
+			if ( usage >= bestUsage ) {
+				continue;
+			}
+
+			const VkDeviceSize otherFree = totalFree - ( block->m_size - block->m_allocated );
+			if ( otherFree < block->m_allocated ) {
+				continue;
+			}
+
+			best = block;
+			bestUsage = usage;
+		}
+	}
+
+	return best;
+}
+
+/*
+=============
+idVulkanAllocator::DefragmentFailed
+=============
+*/
+void idVulkanAllocator::DefragmentFailed( idVulkanBlock * block ) {
+	block->m_defragmentFailed = true;
+}
+
+/*
+=============
+idVulkanAllocator::GetBlocks
+=============
+*/
+void idVulkanAllocator::GetBlocks( idList< const idVulkanBlock * > & blocks ) const {
+	blocks.Clear();
+	for ( int i = 0; i < VK_MAX_MEMORY_TYPES; ++i ) {
+		for ( int j = 0; j < m_blocks[ i ].Num(); ++j ) {
+			blocks.Append( m_blocks[ i ][ j ] );
+		}
+	}
+}
+
+/*
+=============
+idVulkanAllocator::Print
+=============
+*/
+void idVulkanAllocator::Print() {
+	VkDeviceSize totalSize = 0;
+	VkDeviceSize totalAllocated = 0;
+	int totalBlocks = 0;
+
+	idLib::Printf( "Blocks\n------------------------\n" );
+	for ( int i = 0; i < VK_MAX_MEMORY_TYPES; ++i ) {
+		idList< idVulkanBlock * > & blocks = m_blocks[ i ];
+		for ( int j = 0; j < blocks.Num(); ++j ) {
+			vulkanBlockStats_t stats;
+			blocks[ j ]->GetStats( stats );
+
+			const VkDeviceSize freeSize = stats.size - stats.allocated;
+			const float fragmentation = ( freeSize > 0 ) ? 100.0f * ( 1.0f - (float)stats.largestFree / (float)freeSize ) : 0.0f;
+
+			idLib::Printf( "memory_type=%d, block=%d, %s, used=%lluK/%lluK, allocations=%d, free chunks=%d, largest free=%lluK, fragmentation=%.1f%%\n",
+				i, j, blocks[ j ]->IsHostVisible() ? "HOST_VISIBLE" : "DEVICE_LOCAL",
+				stats.allocated >> 10, stats.size >> 10,
+				stats.numAllocations, stats.numFreeChunks, stats.largestFree >> 10, fragmentation );
+
+			totalSize += stats.size;
+			totalAllocated += stats.allocated;
+			totalBlocks++;
+		}
+	}
+	idLib::Printf( "%d blocks, %lluK used of %lluK\n", totalBlocks, totalAllocated >> 10, totalSize >> 10 );
+
+	int pending = 0;
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		pending += m_garbage[ i ].Num();
+	}
+	idLib::Printf( "%d allocations waiting to be freed\n\n", pending );
+
+#if defined( VK_EXT_memory_budget )
+	if ( !vkcontext.memoryBudgetAvailable ) {
+		idLib::Printf( "VK_EXT_memory_budget not available\n" );
+		return;
+	}
+
+	PFN_vkGetPhysicalDeviceMemoryProperties2KHR getMemoryProperties2 = 
+		(PFN_vkGetPhysicalDeviceMemoryProperties2KHR)vkGetInstanceProcAddr( vkcontext.instance, "vkGetPhysicalDeviceMemoryProperties2KHR" );
+	if ( getMemoryProperties2 == NULL ) {
+		return;
+	}
+
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {};
+	budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+	VkPhysicalDeviceMemoryProperties2KHR props = {};
+	props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR;
+	props.pNext = &budget;
+
+	getMemoryProperties2( vkcontext.physicalDevice, &props );
+
+	idLib::Printf( "Budget\n------------------------\n" );
+	for ( uint32 i = 0; i < props.memoryProperties.memoryHeapCount; ++i ) {
+		idLib::Printf( "heap=%u, usage=%lluK, budget=%lluK, size=%lluK\n", i, 
+			budget.heapUsage[ i ] >> 10, budget.heapBudget[ i ] >> 10, props.memoryProperties.memoryHeaps[ i ].size >> 10 );
+	}
+#endif
+}
+
 /*
 =============
 idVulkanAllocator::Free
@@ -583,4 +862,202 @@ CONSOLE_COMMAND( Vulkan_PrintHeapInfo, "Print out the heap information for this
 
 		idLib::Printf( "\n" );
 	}
-}
\ No newline at end of file
+}
+
+#if !defined( ID_USE_AMD_ALLOCATOR )
+CONSOLE_COMMAND( Vulkan_PrintAllocations, "Print block usage, fragmentation and the device memory budget.", 0 ) {
+	vulkanAllocator.Print();
+}
+
+/*
+================================================================================================
+
+idVulkanDeviceMemoryMock
+
+Hands out fake device memory handles so the allocator runs without a device. Host
+visible blocks get no backing, nothing in Vulkan_TestAllocator writes through them.
+
+================================================================================================
+*/
+
+class idVulkanDeviceMemoryMock : public idVulkanDeviceMemory {
+public:
+	idVulkanDeviceMemoryMock() : m_nextHandle( 1 ), m_numLive( 0 ) {}
+
+	virtual uint32 FindMemoryTypeIndex( const uint32 memoryTypeBits, const vulkanMemoryUsage_t usage ) {
+		return ( usage == VULKAN_MEMORY_USAGE_GPU_ONLY ) ? 0 : 1;
+	}
+
+	virtual bool AllocateMemory( const uint32 memoryTypeIndex, const VkDeviceSize size, const bool hostVisible, VkDeviceMemory & deviceMemory, byte * & data ) {
+		deviceMemory = (VkDeviceMemory)m_nextHandle++;
+		data = NULL;
+		m_numLive++;
+		return true;
+	}
+
+	virtual void FreeMemory( VkDeviceMemory deviceMemory, const bool hostVisible ) {
+		m_numLive--;
+	}
+
+	int NumLive() const { return m_numLive; }
+
+private:
+	uint64	m_nextHandle;
+	int		m_numLive;
+};
+
+/*
+=============
+Vulkan_TestAllocator
+
+Fills mock device memory with a mix of images and buffers, frees most of it and then
+runs the same defragmentation steps idImage::DefragmentImages does each frame until
+there is nothing left to move. Checks that blocks holding buffers are never picked,
+that blocks nothing could be moved out of aren't picked forever, and that the chunk
+bookkeeping still matches the live allocations afterwards.
+=============
+*/
+CONSOLE_COMMAND( Vulkan_TestAllocator, "Runs the block allocator and image defragmentation against mock device memory.", 0 ) {
+	struct testAllocation_t {
+		vulkanAllocation_t	allocation;
+		bool				image;
+		bool				pinned;		// stands in for render targets, which are never moved
+	};
+
+	const uint32 MB = 1024 * 1024;
+	const uint32 ALIGNMENT = 256;
+	const int MAX_MOVES_PER_FRAME = 4;
+	const int MAX_FRAMES = 1024;
+
+	idVulkanDeviceMemoryMock mockMemory;
+	idVulkanAllocator allocator;
+	allocator.Init( &mockMemory, 1024 );
+
+	idRandom random( args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 0 );
+	idList< testAllocation_t > live;
+	int failures = 0;
+
+	for ( int i = 0; i < 256; i++ ) {
+		testAllocation_t & test = live.Alloc();
+		test.image = ( random.RandomInt( 4 ) != 0 );
+		test.pinned = test.image && ( random.RandomInt( 8 ) == 0 );
+		test.allocation = allocator.Allocate( ( 1 + random.RandomInt( 8 ) ) * MB, ALIGNMENT, 1, VULKAN_MEMORY_USAGE_GPU_ONLY,
+			test.image ? VULKAN_ALLOCATION_TYPE_IMAGE_OPTIMAL : VULKAN_ALLOCATION_TYPE_BUFFER );
+	}
+	for ( int i = live.Num() - 1; i >= 0; i-- ) {
+		if ( random.RandomInt( 4 ) != 0 ) {
+			allocator.Free( live[ i ].allocation );
+			live.RemoveIndexFast( i );
+		}
+	}
+	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		allocator.EmptyGarbage();
+	}
+
+	idList< const idVulkanBlock * > blocks;
+	allocator.GetBlocks( blocks );
+	const int startBlocks = blocks.Num();
+
+	int numMoves = 0;
+	int frame = 0;
+	for ( ; frame < MAX_FRAMES; frame++ ) {
+		idVulkanBlock * block = allocator.FindDefragmentBlock();
+		if ( block == NULL ) {
+			break;
+		}
+
+		vulkanBlockStats_t stats;
+		block->GetStats( stats );
+		if ( stats.numImageAllocations == 0 || stats.numImageAllocations != stats.numAllocations ) {
+			idLib::Printf( "frame %d: picked a block holding %d allocations that can't be moved\n", frame, stats.numAllocations - stats.numImageAllocations );
+			failures++;
+			break;
+		}
+
+		int moved = 0;
+		for ( int i = 0; i < live.Num() && moved < MAX_MOVES_PER_FRAME; i++ ) {
+			testAllocation_t & test = live[ i ];
+			if ( test.allocation.block != block || test.pinned ) {
+				continue;
+			}
+
+			vulkanAllocation_t allocation;
+			if ( !allocator.AllocateForMove( test.allocation.size, ALIGNMENT, 1, VULKAN_MEMORY_USAGE_GPU_ONLY, VULKAN_ALLOCATION_TYPE_IMAGE_OPTIMAL, block, allocation ) ) {
+				break;
+			}
+			if ( allocation.block == block ) {
+				idLib::Printf( "frame %d: an allocation was moved into the block being emptied\n", frame );
+				failures++;
+			}
+
+			allocator.Free( test.allocation );
+			test.allocation = allocation;
+			moved++;
+		}
+
+		if ( moved == 0 ) {
+			allocator.DefragmentFailed( block );
+		}
+		numMoves += moved;
+
+		allocator.EmptyGarbage();
+	}
+
+	if ( frame == MAX_FRAMES ) {
+		idLib::Printf( "defragmentation was still picking blocks after %d frames\n", MAX_FRAMES );
+		failures++;
+	}
+
+	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		allocator.EmptyGarbage();
+	}
+
+	// every live allocation must sit in a block that still exists, without overlapping another
+	allocator.GetBlocks( blocks );
+	const int endBlocks = blocks.Num();
+
+	int numAllocations = 0;
+	for ( int i = 0; i < blocks.Num(); i++ ) {
+		vulkanBlockStats_t stats;
+		blocks[ i ]->GetStats( stats );
+		numAllocations += stats.numAllocations;
+	}
+	if ( numAllocations != live.Num() ) {
+		idLib::Printf( "blocks hold %d allocations, %d are live\n", numAllocations, live.Num() );
+		failures++;
+	}
+
+	for ( int i = 0; i < live.Num(); i++ ) {
+		const vulkanAllocation_t & a = live[ i ].allocation;
+		if ( blocks.FindIndex( a.block ) == -1 ) {
+			idLib::Printf( "allocation %d points at a released block\n", i );
+			failures++;
+			continue;
+		}
+		for ( int j = i + 1; j < live.Num(); j++ ) {
+			const vulkanAllocation_t & b = live[ j ].allocation;
+			if ( a.block == b.block && a.offset < b.offset + b.size && b.offset < a.offset + a.size ) {
+				idLib::Printf( "allocations %d and %d overlap\n", i, j );
+				failures++;
+			}
+		}
+	}
+
+	// and everything has to drain back to no blocks at all
+	for ( int i = 0; i < live.Num(); i++ ) {
+		allocator.Free( live[ i ].allocation );
+	}
+	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		allocator.EmptyGarbage();
+	}
+	allocator.GetBlocks( blocks );
+	if ( blocks.Num() != 0 || mockMemory.NumLive() != 0 ) {
+		idLib::Printf( "%d blocks and %d device allocations left after freeing everything\n", blocks.Num(), mockMemory.NumLive() );
+		failures++;
+	}
+
+	allocator.Shutdown();
+
+	idLib::Printf( "%d blocks before, %d after, %d images moved in %d frames, %d failures\n", startBlocks, endBlocks, numMoves, frame, failures );
+}
+#endif
@@ -66,6 +66,36 @@ struct vulkanAllocation_t {
 	byte *			data;
 };
 
+struct vulkanBlockStats_t {
+	VkDeviceSize	size;
+	VkDeviceSize	allocated;
+	VkDeviceSize	largestFree;
+	int				numAllocations;
+	int				numImageAllocations;	// optimal tiling images, the only allocations that can be moved
+	int				numFreeChunks;
+};
+
+/*
+================================================================================================
+
+idVulkanDeviceMemory
+
+Where blocks get their memory from. The allocator normally goes straight to the
+device, Vulkan_TestAllocator swaps in a mock so the block and defragmentation
+bookkeeping can be exercised without one.
+
+================================================================================================
+*/
+
+class idVulkanDeviceMemory {
+public:
+	virtual					~idVulkanDeviceMemory() {}
+
+	virtual uint32			FindMemoryTypeIndex( const uint32 memoryTypeBits, const vulkanMemoryUsage_t usage ) = 0;
+	virtual bool			AllocateMemory( const uint32 memoryTypeIndex, const VkDeviceSize size, const bool hostVisible, VkDeviceMemory & deviceMemory, byte * & data ) = 0;
+	virtual void			FreeMemory( VkDeviceMemory deviceMemory, const bool hostVisible ) = 0;
+};
+
 /*
 ================================================================================================
 
@@ -77,7 +107,7 @@ idVulkanBlock
 class idVulkanBlock {
 friend class idVulkanAllocator;
 public:
-	idVulkanBlock( const uint32 memoryTypeIndex, const VkDeviceSize size, vulkanMemoryUsage_t usage );
+	idVulkanBlock( idVulkanDeviceMemory * deviceMemory, const uint32 memoryTypeIndex, const VkDeviceSize size, vulkanMemoryUsage_t usage );
 	~idVulkanBlock();
 
 	bool				Init();
@@ -93,6 +123,8 @@ public:
 							vulkanAllocation_t & allocation );
 	void				Free( vulkanAllocation_t & allocation );
 
+	void				GetStats( vulkanBlockStats_t & stats ) const;
+
 private:
 	struct chunk_t {
 		uint32					id;
@@ -105,6 +137,7 @@ private:
 	};
 	chunk_t *			m_head;
 
+	idVulkanDeviceMemory *	m_memory;
 	uint32				m_nextBlockId;
 	uint32				m_memoryTypeIndex;
 	vulkanMemoryUsage_t	m_usage;
@@ -112,6 +145,10 @@ private:
 	VkDeviceSize		m_size;
 	VkDeviceSize		m_allocated;
 	byte *				m_data;
+
+	int					m_numAllocations;
+	int					m_numImageAllocations;
+	bool				m_defragmentFailed;	// nothing could be moved out, skipped until something in it is freed
 };
 
 /*
@@ -127,6 +164,7 @@ public:
 	idVulkanAllocator();
 
 	void					Init();
+	void					Init( idVulkanDeviceMemory * deviceMemory, const VkDeviceSize bufferImageGranularity );
 	void					Shutdown();
 
 	vulkanAllocation_t			Allocate( 
@@ -138,7 +176,31 @@ public:
 	void					Free( const vulkanAllocation_t allocation );
 	void					EmptyGarbage();
 
+	// Places an allocation in an existing block other than source without growing the
+	// heap. Used to move allocations out of sparse blocks so they can be released.
+	bool					AllocateForMove( 
+								const uint32 size, 
+								const uint32 align, 
+								const uint32 memoryTypeBits, 
+								const vulkanMemoryUsage_t usage,
+								const vulkanAllocationType_t allocType,
+								const idVulkanBlock * source,
+								vulkanAllocation_t & allocation );
+
+	// Returns the emptiest device local block that only holds movable images and whose
+	// contents fit in the free space of the other blocks of the same memory type, or
+	// NULL if nothing is worth moving.
+	idVulkanBlock *			FindDefragmentBlock();
+	// Called when nothing could be moved out of the block FindDefragmentBlock returned,
+	// so it isn't picked again every frame.
+	void					DefragmentFailed( idVulkanBlock * block );
+
+	void					GetBlocks( idList< const idVulkanBlock * > & blocks ) const;
+
+	void					Print();
+
 private:
+	idVulkanDeviceMemory *		m_deviceMemory;
 	int							m_garbageIndex;
 
 	int							m_deviceLocalMemoryMB;
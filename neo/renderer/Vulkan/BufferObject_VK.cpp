@@ -88,6 +88,7 @@ bool idVertexBuffer::AllocBufferObject( const void * data, int allocSize, buffer
 	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	if ( m_usage == BU_STATIC ) {
 		bufferCreateInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		stagingManager.SetSharingMode( bufferCreateInfo );
 	}
 
 #if defined( ID_USE_AMD_ALLOCATOR )
@@ -314,6 +315,7 @@ bool idIndexBuffer::AllocBufferObject( const void * data, int allocSize, bufferU
 	bufferCreateInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
 	if ( m_usage == BU_STATIC ) {
 		bufferCreateInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		stagingManager.SetSharingMode( bufferCreateInfo );
 	}
 
 #if defined( ID_USE_AMD_ALLOCATOR )
@@ -541,6 +543,7 @@ bool idUniformBuffer::AllocBufferObject( const void * data, int allocSize, buffe
 	bufferCreateInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 	if ( m_usage == BU_STATIC ) {
 		bufferCreateInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		stagingManager.SetSharingMode( bufferCreateInfo );
 	}
 
 #if defined( ID_USE_AMD_ALLOCATOR )
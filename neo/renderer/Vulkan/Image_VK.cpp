@@ -34,6 +34,9 @@ If you have questions concerning this license or the applicable additional terms
 #include "Allocator_VK.h"
 #include "Staging_VK.h"
 
+extern idCVar r_vkDefragment;
+idCVar r_vkDefragmentMovesPerFrame( "r_vkDefragmentMovesPerFrame", "4", CVAR_INTEGER, "Maximum number of images moved between memory blocks each frame." );
+
 int						idImage::m_garbageIndex = 0;
 #if defined( ID_USE_AMD_ALLOCATOR )
 idList< VmaAllocation > idImage::m_allocationGarbage[ NUM_FRAME_DATA ];
@@ -298,6 +301,60 @@ void idImage::EmptyGarbage() {
 	samplersToFree.Clear();
 }
 
+/*
+====================
+idImage::GetImageCreateInfo
+====================
+*/
+void idImage::GetImageCreateInfo( VkImageCreateInfo & createInfo ) const {
+	VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT;
+	if ( m_opts.format == FMT_DEPTH ) {
+		usageFlags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	} else {
+		// Transfer source lets the allocator relocate the image during defragmentation.
+		usageFlags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
+
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	createInfo.flags = ( m_opts.textureType == TT_CUBIC ) ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT: 0;
+	createInfo.imageType = VK_IMAGE_TYPE_2D;
+	createInfo.format = m_internalFormat;
+	createInfo.extent.width = m_opts.width;
+	createInfo.extent.height = m_opts.height;
+	createInfo.extent.depth = 1;
+	createInfo.mipLevels = m_opts.numLevels;
+	createInfo.arrayLayers = ( m_opts.textureType == TT_CUBIC ) ? 6 : 1;
+	createInfo.samples = static_cast< VkSampleCountFlagBits >( m_opts.samples );
+	createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	createInfo.usage = usageFlags;
+	createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if ( usageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT ) {
+		stagingManager.SetSharingMode( createInfo );
+	}
+}
+
+/*
+====================
+idImage::CreateImageView
+====================
+*/
+void idImage::CreateImageView( VkImage image, VkImageView & view ) const {
+	VkImageViewCreateInfo viewCreateInfo = {};
+	viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewCreateInfo.image = image;
+	viewCreateInfo.viewType = ( m_opts.textureType == TT_CUBIC ) ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D;
+	viewCreateInfo.format = m_internalFormat;
+	viewCreateInfo.components = VK_GetComponentMappingFromTextureFormat( m_opts.format, m_opts.colorFormat );
+	viewCreateInfo.subresourceRange.aspectMask = ( m_opts.format == FMT_DEPTH ) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+	viewCreateInfo.subresourceRange.levelCount = m_opts.numLevels;
+	viewCreateInfo.subresourceRange.layerCount = ( m_opts.textureType == TT_CUBIC ) ? 6 : 1;
+	viewCreateInfo.subresourceRange.baseMipLevel = 0;
+	
+	ID_VK_CHECK( vkCreateImageView( vkcontext.device, &viewCreateInfo, NULL, &view ) );
+}
+
 /*
 ====================
 idImage::AllocImage
@@ -311,29 +368,9 @@ void idImage::AllocImage() {
 	// Create Sampler
 	CreateSampler();
 
-	VkImageUsageFlags usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT;
-	if ( m_opts.format == FMT_DEPTH ) {
-		usageFlags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-	} else {
-		usageFlags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-	}
-
 	// Create Image
-	VkImageCreateInfo imageCreateInfo = {};
-	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-	imageCreateInfo.flags = ( m_opts.textureType == TT_CUBIC ) ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT: 0;
-	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-	imageCreateInfo.format = m_internalFormat;
-	imageCreateInfo.extent.width = m_opts.width;
-	imageCreateInfo.extent.height = m_opts.height;
-	imageCreateInfo.extent.depth = 1;
-	imageCreateInfo.mipLevels = m_opts.numLevels;
-	imageCreateInfo.arrayLayers = ( m_opts.textureType == TT_CUBIC ) ? 6 : 1;
-	imageCreateInfo.samples = static_cast< VkSampleCountFlagBits >( m_opts.samples );
-	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-	imageCreateInfo.usage = usageFlags;
-	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	VkImageCreateInfo imageCreateInfo;
+	GetImageCreateInfo( imageCreateInfo );
 
 #if defined( ID_USE_AMD_ALLOCATOR )
 	VmaMemoryRequirements vmaReq = {};
@@ -357,20 +394,148 @@ void idImage::AllocImage() {
 #endif
 
 	// Create Image View
-	VkImageViewCreateInfo viewCreateInfo = {};
-	viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-	viewCreateInfo.image = m_image;
-	viewCreateInfo.viewType = ( m_opts.textureType == TT_CUBIC ) ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D;
-	viewCreateInfo.format = m_internalFormat;
-	viewCreateInfo.components = VK_GetComponentMappingFromTextureFormat( m_opts.format, m_opts.colorFormat );
-	viewCreateInfo.subresourceRange.aspectMask = ( m_opts.format == FMT_DEPTH ) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-	viewCreateInfo.subresourceRange.levelCount = m_opts.numLevels;
-	viewCreateInfo.subresourceRange.layerCount = ( m_opts.textureType == TT_CUBIC ) ? 6 : 1;
-	viewCreateInfo.subresourceRange.baseMipLevel = 0;
-	
-	ID_VK_CHECK( vkCreateImageView( vkcontext.device, &viewCreateInfo, NULL, &m_view ) );
+	CreateImageView( m_image, m_view );
+}
+
+#if !defined( ID_USE_AMD_ALLOCATOR )
+/*
+====================
+idImage::MoveAllocation
+
+Copies the image into memory outside of its current block. The old image,
+view and allocation go through the garbage lists like a purge, so frames
+still in flight keep sampling the old copy.
+====================
+*/
+bool idImage::MoveAllocation( VkCommandBuffer commandBuffer ) {
+	VkImageCreateInfo imageCreateInfo;
+	GetImageCreateInfo( imageCreateInfo );
+
+	VkImage image = VK_NULL_HANDLE;
+	ID_VK_CHECK( vkCreateImage( vkcontext.device, &imageCreateInfo, NULL, &image ) );
+
+	VkMemoryRequirements memoryRequirements;
+	vkGetImageMemoryRequirements( vkcontext.device, image, &memoryRequirements );
+
+	vulkanAllocation_t allocation;
+	if ( !vulkanAllocator.AllocateForMove( 
+			memoryRequirements.size,
+			memoryRequirements.alignment,
+			memoryRequirements.memoryTypeBits, 
+			VULKAN_MEMORY_USAGE_GPU_ONLY,
+			VULKAN_ALLOCATION_TYPE_IMAGE_OPTIMAL,
+			m_allocation.block,
+			allocation ) ) {
+		vkDestroyImage( vkcontext.device, image, NULL );
+		return false;
+	}
+
+	ID_VK_CHECK( vkBindImageMemory( vkcontext.device, image, allocation.deviceMemory, allocation.offset ) );
+
+	VkImageView view = VK_NULL_HANDLE;
+	CreateImageView( image, view );
+
+	const uint32 numLayers = imageCreateInfo.arrayLayers;
+
+	VkImageMemoryBarrier barriers[ 2 ] = {};
+	for ( int i = 0; i < 2; ++i ) {
+		barriers[ i ].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barriers[ i ].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[ i ].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[ i ].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barriers[ i ].subresourceRange.levelCount = m_opts.numLevels;
+		barriers[ i ].subresourceRange.layerCount = numLayers;
+	}
+
+	barriers[ 0 ].image = m_image;
+	barriers[ 0 ].oldLayout = m_layout;
+	barriers[ 0 ].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[ 0 ].srcAccessMask = 0;
+	barriers[ 0 ].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+	barriers[ 1 ].image = image;
+	barriers[ 1 ].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[ 1 ].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[ 1 ].srcAccessMask = 0;
+	barriers[ 1 ].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 2, barriers );
+
+	idStaticList< VkImageCopy, 16 > regions;
+	for ( int mip = 0; mip < m_opts.numLevels && regions.Num() < regions.Max(); ++mip ) {
+		VkImageCopy & region = *regions.Alloc();
+		memset( &region, 0, sizeof( region ) );
+		region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.srcSubresource.mipLevel = mip;
+		region.srcSubresource.layerCount = numLayers;
+		region.dstSubresource = region.srcSubresource;
+		region.extent.width = Max( 1, m_opts.width >> mip );
+		region.extent.height = Max( 1, m_opts.height >> mip );
+		region.extent.depth = 1;
+	}
+
+	vkCmdCopyImage( commandBuffer, m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.Num(), regions.Ptr() );
+
+	barriers[ 1 ].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[ 1 ].newLayout = m_layout;
+	barriers[ 1 ].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[ 1 ].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, 0, 0, NULL, 0, NULL, 1, &barriers[ 1 ] );
+
+	m_allocationGarbage[ m_garbageIndex ].Append( m_allocation );
+	m_viewGarbage[ m_garbageIndex ].Append( m_view );
+	m_imageGarbage[ m_garbageIndex ].Append( m_image );
+
+	m_allocation = allocation;
+	m_image = image;
+	m_view = view;
+
+	return true;
 }
 
+/*
+====================
+idImage::DefragmentImages
+====================
+*/
+void idImage::DefragmentImages( VkCommandBuffer commandBuffer ) {
+	if ( !r_vkDefragment.GetBool() ) {
+		return;
+	}
+
+	idVulkanBlock * block = vulkanAllocator.FindDefragmentBlock();
+	if ( block == NULL ) {
+		return;
+	}
+
+	const int maxMoves = r_vkDefragmentMovesPerFrame.GetInteger();
+	int numMoves = 0;
+
+	for ( int i = 0; i < globalImages->m_images.Num() && numMoves < maxMoves; ++i ) {
+		idImage * image = globalImages->m_images[ i ];
+		if ( image->m_image == VK_NULL_HANDLE || image->m_allocation.block != block ) {
+			continue;
+		}
+
+		// Only uploaded textures; render targets and swap chain images stay put.
+		if ( image->m_bIsSwapChainImage || image->m_opts.format == FMT_DEPTH || image->m_layout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL ) {
+			continue;
+		}
+
+		if ( !image->MoveAllocation( commandBuffer ) ) {
+			break;
+		}
+		numMoves++;
+	}
+
+	// whatever is left in the block can't be moved right now, don't keep picking it
+	if ( numMoves == 0 ) {
+		vulkanAllocator.DefragmentFailed( block );
+	}
+}
+#endif
+
 /*
 ====================
 idImage::PurgeImage
@@ -482,8 +647,15 @@ void idImage::SubImageUpload( int mipLevel, int x, int y, int z, int width, int
 	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-	vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, 0, 0, NULL, 0, NULL, 1, &barrier );
+	if ( stagingManager.UsesTransferQueue() ) {
+		// The transfer queue can't name graphics stages; the semaphore the graphics
+		// queue waits on makes the copy visible to the shaders.
+		barrier.dstAccessMask = 0;
+		vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, 1, &barrier );
+	} else {
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, 0, 0, NULL, 0, NULL, 1, &barrier );
+	}
 
 	m_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 }
\ No newline at end of file
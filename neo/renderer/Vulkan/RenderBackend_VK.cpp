@@ -45,6 +45,8 @@ If you have questions concerning this license or the applicable additional terms
 vulkanContext_t vkcontext;
 
 idCVar r_vkEnableValidationLayers( "r_vkEnableValidationLayers", "0", CVAR_BOOL, "" );
+idCVar r_vkUseTransferQueue( "r_vkUseTransferQueue", "1", CVAR_BOOL | CVAR_INIT, "Upload buffers and images on a dedicated transfer queue when the device has one." );
+idCVar r_vkUsePipelineCache( "r_vkUsePipelineCache", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "Load and save the pipeline cache to disk between sessions." );
 
 extern idCVar r_multiSamples;
 extern idCVar r_skipRender;
@@ -402,6 +404,21 @@ static void CreateInstance() {
 		vkcontext.deviceExtensions.Append( g_deviceExtensions[ i ] );
 	}
 
+#if defined( VK_EXT_memory_budget )
+	// Needed to query VK_EXT_memory_budget on a 1.0 instance.
+	uint32 numInstanceExtensions = 0;
+	ID_VK_CHECK( vkEnumerateInstanceExtensionProperties( NULL, &numInstanceExtensions, NULL ) );
+	idList< VkExtensionProperties > instanceExtensionProps;
+	instanceExtensionProps.SetNum( numInstanceExtensions );
+	ID_VK_CHECK( vkEnumerateInstanceExtensionProperties( NULL, &numInstanceExtensions, instanceExtensionProps.Ptr() ) );
+	for ( int i = 0; i < instanceExtensionProps.Num(); ++i ) {
+		if ( idStr::Icmp( instanceExtensionProps[ i ].extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME ) == 0 ) {
+			vkcontext.instanceExtensions.Append( VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME );
+			break;
+		}
+	}
+#endif
+
 	if ( enableLayers ) {
 		for ( int i = 0; i < g_numDebugInstanceExtensions; ++i ) {
 			vkcontext.instanceExtensions.Append( g_debugInstanceExtensions[ i ] );
@@ -541,6 +558,7 @@ static void SelectPhysicalDevice() {
 
 		int graphicsIdx = -1;
 		int presentIdx = -1;
+		int transferIdx = -1;
 
 		if ( !CheckPhysicalDeviceExtensionSupport( gpu, vkcontext.deviceExtensions ) ) {
 			continue;
@@ -584,10 +602,29 @@ static void SelectPhysicalDevice() {
 			}
 		}
 
+		// Find a transfer only queue family, usually backed by a dedicated DMA engine.
+		// Prefer one without compute so uploads don't contend with async compute.
+		for ( int j = 0; j < gpu.queueFamilyProps.Num() && r_vkUseTransferQueue.GetBool(); ++j ) {
+			VkQueueFamilyProperties & props = gpu.queueFamilyProps[ j ];
+
+			if ( props.queueCount == 0 ) {
+				continue;
+			}
+
+			if ( ( props.queueFlags & VK_QUEUE_TRANSFER_BIT ) == 0 || ( props.queueFlags & VK_QUEUE_GRAPHICS_BIT ) != 0 ) {
+				continue;
+			}
+
+			if ( transferIdx < 0 || ( props.queueFlags & VK_QUEUE_COMPUTE_BIT ) == 0 ) {
+				transferIdx = j;
+			}
+		}
+
 		// Did we find a device supporting both graphics and present.
 		if ( graphicsIdx >= 0 && presentIdx >= 0 ) {
 			vkcontext.graphicsFamilyIdx = graphicsIdx;
 			vkcontext.presentFamilyIdx = presentIdx;
+			vkcontext.transferFamilyIdx = transferIdx;
 			vkcontext.physicalDevice = gpu.device;
 			vkcontext.gpu = &gpu;
 
@@ -610,6 +647,9 @@ static void CreateLogicalDeviceAndQueues() {
 	idList< int > uniqueIdx;
 	uniqueIdx.AddUnique( vkcontext.graphicsFamilyIdx );
 	uniqueIdx.AddUnique( vkcontext.presentFamilyIdx );
+	if ( vkcontext.transferFamilyIdx >= 0 ) {
+		uniqueIdx.AddUnique( vkcontext.transferFamilyIdx );
+	}
 	
 	idList< VkDeviceQueueCreateInfo > devqInfo;
 
@@ -624,6 +664,23 @@ static void CreateLogicalDeviceAndQueues() {
 		devqInfo.Append( qinfo );
 	}
 
+	vkcontext.memoryBudgetAvailable = false;
+#if defined( VK_EXT_memory_budget )
+	for ( int i = 0; i < vkcontext.instanceExtensions.Num(); ++i ) {
+		if ( idStr::Icmp( vkcontext.instanceExtensions[ i ], VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME ) != 0 ) {
+			continue;
+		}
+
+		idList< const char * > budgetExtension;
+		budgetExtension.Append( VK_EXT_MEMORY_BUDGET_EXTENSION_NAME );
+		if ( CheckPhysicalDeviceExtensionSupport( *vkcontext.gpu, budgetExtension ) ) {
+			vkcontext.deviceExtensions.Append( VK_EXT_MEMORY_BUDGET_EXTENSION_NAME );
+			vkcontext.memoryBudgetAvailable = true;
+		}
+		break;
+	}
+#endif
+
 	VkPhysicalDeviceFeatures deviceFeatures = {};
 	deviceFeatures.textureCompressionBC = VK_TRUE;
 	deviceFeatures.imageCubeArray = VK_TRUE;
@@ -651,6 +708,9 @@ static void CreateLogicalDeviceAndQueues() {
 
 	vkGetDeviceQueue( vkcontext.device, vkcontext.graphicsFamilyIdx, 0, &vkcontext.graphicsQueue );
 	vkGetDeviceQueue( vkcontext.device, vkcontext.presentFamilyIdx, 0, &vkcontext.presentQueue );
+	if ( vkcontext.transferFamilyIdx >= 0 ) {
+		vkGetDeviceQueue( vkcontext.device, vkcontext.transferFamilyIdx, 0, &vkcontext.transferQueue );
+	}
 }
 
 /*
@@ -1012,7 +1072,7 @@ static void CreateRenderPass() {
 	depthAttachment.format = vkcontext.depthFormat;
 	depthAttachment.samples = vkcontext.sampleCount;
 	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
@@ -1054,6 +1114,90 @@ static void CreateRenderPass() {
 	renderPassCreateInfo.dependencyCount = 0;
 
 	ID_VK_CHECK( vkCreateRenderPass( vkcontext.device, &renderPassCreateInfo, NULL, &vkcontext.renderPass ) );
+
+	// A compatible pass that keeps the attachment contents. The frame is split
+	// with this when the secondary command buffers recorded by jobs are executed.
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_GENERAL;
+	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	resolveAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+	resolveAttachment.initialLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+	ID_VK_CHECK( vkCreateRenderPass( vkcontext.device, &renderPassCreateInfo, NULL, &vkcontext.renderPassResume ) );
+}
+
+/*
+=============
+CreatePipelineCache
+=============
+*/
+static const char * PIPELINE_CACHE_FILE = "pipeline.cache";
+static const uint32 PIPELINE_CACHE_MAGIC = ( 'P' << 24 ) | ( 'C' << 16 ) | ( 'H' << 8 ) | 1;
+static const uint32 PIPELINE_CACHE_MAX_SIZE = 256 * 1024 * 1024;
+
+struct pipelineCacheHeader_t {
+	uint32	magic;
+	uint32	dataSize;
+	uint32	vendorID;
+	uint32	deviceID;
+	uint32	driverVersion;
+	uint8	pipelineCacheUUID[ VK_UUID_SIZE ];
+};
+
+/*
+=============
+FillPipelineCacheHeader
+=============
+*/
+static void FillPipelineCacheHeader( pipelineCacheHeader_t & header, uint32 dataSize ) {
+	memset( &header, 0, sizeof( header ) );
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.dataSize = dataSize;
+	header.vendorID = vkcontext.gpu->props.vendorID;
+	header.deviceID = vkcontext.gpu->props.deviceID;
+	header.driverVersion = vkcontext.gpu->props.driverVersion;
+	memcpy( header.pipelineCacheUUID, vkcontext.gpu->props.pipelineCacheUUID, VK_UUID_SIZE );
+}
+
+/*
+=============
+LoadPipelineCacheData
+
+The driver rejects or silently ignores data produced by a different
+device or driver, so anything that doesn't match the current gpu is
+discarded before it gets that far.
+=============
+*/
+static void * LoadPipelineCacheData( size_t & dataSize ) {
+	dataSize = 0;
+
+	idFileLocal file( fileSystem->OpenFileRead( PIPELINE_CACHE_FILE ) );
+	if ( file == NULL ) {
+		return NULL;
+	}
+
+	pipelineCacheHeader_t header;
+	if ( file->Read( &header, sizeof( header ) ) != sizeof( header ) ) {
+		return NULL;
+	}
+
+	pipelineCacheHeader_t expected;
+	FillPipelineCacheHeader( expected, header.dataSize );
+	if ( memcmp( &header, &expected, sizeof( header ) ) != 0 || header.dataSize == 0 || header.dataSize > PIPELINE_CACHE_MAX_SIZE ) {
+		idLib::Printf( "Discarding pipeline cache from a different device or driver.\n" );
+		return NULL;
+	}
+
+	void * data = Mem_Alloc( header.dataSize, TAG_RENDER );
+	if ( file->Read( data, header.dataSize ) != (int)header.dataSize ) {
+		Mem_Free( data );
+		return NULL;
+	}
+
+	dataSize = header.dataSize;
+	return data;
 }
 
 /*
@@ -1064,9 +1208,64 @@ CreatePipelineCache
 static void CreatePipelineCache() {
 	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
 	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+	size_t dataSize = 0;
+	void * data = NULL;
+	if ( r_vkUsePipelineCache.GetBool() ) {
+		data = LoadPipelineCacheData( dataSize );
+	}
+
+	if ( data != NULL ) {
+		pipelineCacheCreateInfo.initialDataSize = dataSize;
+		pipelineCacheCreateInfo.pInitialData = data;
+
+		VkResult result = vkCreatePipelineCache( vkcontext.device, &pipelineCacheCreateInfo, NULL, &vkcontext.pipelineCache );
+		Mem_Free( data );
+
+		if ( result == VK_SUCCESS ) {
+			idLib::Printf( "Loaded pipeline cache ( %d kB ).\n", (int)( dataSize >> 10 ) );
+			return;
+		}
+
+		// fall back to an empty cache
+		pipelineCacheCreateInfo.initialDataSize = 0;
+		pipelineCacheCreateInfo.pInitialData = NULL;
+	}
+
 	ID_VK_CHECK( vkCreatePipelineCache( vkcontext.device, &pipelineCacheCreateInfo, NULL, &vkcontext.pipelineCache ) );
 }
 
+/*
+=============
+SavePipelineCache
+=============
+*/
+static void SavePipelineCache() {
+	if ( !r_vkUsePipelineCache.GetBool() || vkcontext.pipelineCache == VK_NULL_HANDLE ) {
+		return;
+	}
+
+	size_t dataSize = 0;
+	if ( vkGetPipelineCacheData( vkcontext.device, vkcontext.pipelineCache, &dataSize, NULL ) != VK_SUCCESS ) {
+		return;
+	}
+	if ( dataSize == 0 || dataSize > PIPELINE_CACHE_MAX_SIZE ) {
+		return;
+	}
+
+	void * data = Mem_Alloc( (int)dataSize, TAG_RENDER );
+	if ( vkGetPipelineCacheData( vkcontext.device, vkcontext.pipelineCache, &dataSize, data ) == VK_SUCCESS ) {
+		idFileLocal file( fileSystem->OpenFileWrite( PIPELINE_CACHE_FILE, "fs_savepath" ) );
+		if ( file != NULL ) {
+			pipelineCacheHeader_t header;
+			FillPipelineCacheHeader( header, (uint32)dataSize );
+			file->Write( &header, sizeof( header ) );
+			file->Write( data, (int)dataSize );
+		}
+	}
+	Mem_Free( data );
+}
+
 /*
 =============
 CreateFrameBuffers
@@ -1130,8 +1329,11 @@ static void ClearContext() {
 	vkcontext.device = VK_NULL_HANDLE;
 	vkcontext.graphicsQueue = VK_NULL_HANDLE;
 	vkcontext.presentQueue = VK_NULL_HANDLE;
+	vkcontext.transferQueue = VK_NULL_HANDLE;
 	vkcontext.graphicsFamilyIdx = -1;
 	vkcontext.presentFamilyIdx = -1;
+	vkcontext.transferFamilyIdx = -1;
+	vkcontext.memoryBudgetAvailable = false;
 	vkcontext.callback = VK_NULL_HANDLE;
 	vkcontext.instanceExtensions.Clear();
 	vkcontext.deviceExtensions.Clear();
@@ -1146,6 +1348,7 @@ static void ClearContext() {
 	vkcontext.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
 	vkcontext.depthFormat = VK_FORMAT_UNDEFINED;
 	vkcontext.renderPass = VK_NULL_HANDLE;
+	vkcontext.renderPassResume = VK_NULL_HANDLE;
 	vkcontext.pipelineCache = VK_NULL_HANDLE;
 	vkcontext.sampleCount = VK_SAMPLE_COUNT_1_BIT;
 	vkcontext.supersampling = false;
@@ -1163,6 +1366,425 @@ static void ClearContext() {
 	vkcontext.imageParms.Zero();
 }
 
+/*
+=========================================================================================================
+
+PARALLEL RECORDING
+
+Passes that are cheap to set up can be split across jobs, each recording into its own
+secondary command buffer. The secondaries are executed in job order, so the result is
+identical to recording the draws inline on the render thread.
+
+The light passes set up too much state per draw to do that, so their draws are captured
+on the render thread instead, with the parms, images, pipeline and dynamic state each one
+needs, and only the descriptor writes and command recording are split across the jobs.
+
+=========================================================================================================
+*/
+
+idCVar r_vkParallelDepthPass( "r_vkParallelDepthPass", "1", CVAR_RENDERER | CVAR_BOOL, "Record the opaque depth pass into secondary command buffers on the job threads." );
+idCVar r_vkParallelDepthPassSurfaces( "r_vkParallelDepthPassSurfaces", "256", CVAR_RENDERER | CVAR_INTEGER, "Minimum number of opaque surfaces per depth pass recording job.", 16, 16384 );
+idCVar r_vkParallelLightPass( "r_vkParallelLightPass", "1", CVAR_RENDERER | CVAR_BOOL, "Record the stencil shadow and interaction draws of busy lights into secondary command buffers on the job threads." );
+idCVar r_vkParallelLightPassDraws( "r_vkParallelLightPassDraws", "128", CVAR_RENDERER | CVAR_INTEGER, "Minimum number of draws per light pass recording job.", 16, 16384 );
+
+struct vkDynamicState_t {
+	VkViewport		viewport;
+	VkRect2D		scissor;
+	float			depthBoundsMin;
+	float			depthBoundsMax;
+	float			depthBiasScale;
+	float			depthBiasBias;
+};
+
+struct depthRecordJob_t {
+	vkRecordContext_t *			context;
+	const drawSurf_t * const *	drawSurfs;
+	int							numDrawSurfs;
+	uint64						stateBits;
+	VkPipeline					pipelines[ 2 ];		// static, skinned
+	backEndCounters_t			pc;
+};
+
+enum drawCounter_t {
+	DRAW_COUNTER_NONE,			// second draw of a preloaded shadow volume
+	DRAW_COUNTER_ELEMENTS,
+	DRAW_COUNTER_SHADOW
+};
+
+// everything a draw issued between BeginParallelDraws and EndParallelDraws
+// needs, captured on the render thread so a job can record it later
+struct vkCapturedDraw_t {
+	int					progIndex;
+	VkPipeline			pipeline;
+	vertCacheHandle_t	jointCache;
+	idVertexBuffer *	vertexBuffer;
+	idIndexBuffer *		indexBuffer;
+	int					numIndexes;
+	int					firstIndex;
+	int					baseVertex;
+	int					firstParm;
+	int					firstImage;
+	int					numImages;
+	uint64				stateBits;
+	vkDynamicState_t	dynamicState;
+	drawCounter_t		counter;
+};
+
+struct drawRecordJob_t {
+	vkRecordContext_t *			context;
+	const vkCapturedDraw_t *	draws;
+	int							numDraws;
+	backEndCounters_t			pc;
+};
+
+// the dynamic state last set on the primary command buffer, secondary
+// command buffers don't inherit it so it has to be replayed
+static vkDynamicState_t dynamicState;
+
+static idParallelJobList *		recordJobList = NULL;
+static vkRecordContext_t		recordContexts[ MAX_RECORD_CONTEXTS ];
+static depthRecordJob_t			depthRecordJobs[ MAX_RECORD_CONTEXTS ];
+static drawRecordJob_t			drawRecordJobs[ MAX_RECORD_CONTEXTS ];
+
+static bool									capturingDraws = false;
+static int									capturedParmBytes = 0;	// largest parm block of any captured draw
+static idList< vkCapturedDraw_t, TAG_RENDER >	capturedDraws;
+static idList< idVec4, TAG_RENDER >			capturedParms;
+static idList< idImage *, TAG_RENDER >		capturedImages;
+static VkCommandPool			recordCommandPools[ NUM_FRAME_DATA ][ MAX_RECORD_CONTEXTS ];
+static idList< VkCommandBuffer >	recordCommandBuffers[ NUM_FRAME_DATA ][ MAX_RECORD_CONTEXTS ];
+static int						recordCommandBuffersUsed[ MAX_RECORD_CONTEXTS ];
+
+/*
+=============
+CreateRecordCommandPools
+
+Command pools are externally synchronized, so every recording job gets its own.
+=============
+*/
+static void CreateRecordCommandPools() {
+	VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = vkcontext.graphicsFamilyIdx;
+
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		for ( int j = 0; j < MAX_RECORD_CONTEXTS; ++j ) {
+			ID_VK_CHECK( vkCreateCommandPool( vkcontext.device, &commandPoolCreateInfo, NULL, &recordCommandPools[ i ][ j ] ) );
+		}
+	}
+	memset( recordCommandBuffersUsed, 0, sizeof( recordCommandBuffersUsed ) );
+
+	recordJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_BACKEND, JOBLIST_PRIORITY_HIGH, MAX_RECORD_CONTEXTS, 0, NULL );
+}
+
+/*
+=============
+DestroyRecordCommandPools
+=============
+*/
+static void DestroyRecordCommandPools() {
+	if ( recordJobList != NULL ) {
+		parallelJobManager->FreeJobList( recordJobList );
+		recordJobList = NULL;
+	}
+
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		for ( int j = 0; j < MAX_RECORD_CONTEXTS; ++j ) {
+			// destroying the pool frees its command buffers
+			vkDestroyCommandPool( vkcontext.device, recordCommandPools[ i ][ j ], NULL );
+			recordCommandPools[ i ][ j ] = VK_NULL_HANDLE;
+			recordCommandBuffers[ i ][ j ].Clear();
+		}
+	}
+}
+
+/*
+=============
+ResetRecordCommandPools
+
+The frame data being started has already been waited on in BlockingSwapBuffers.
+=============
+*/
+static void ResetRecordCommandPools() {
+	for ( int i = 0; i < MAX_RECORD_CONTEXTS; ++i ) {
+		ID_VK_CHECK( vkResetCommandPool( vkcontext.device, recordCommandPools[ vkcontext.currentFrameData ][ i ], 0 ) );
+	}
+	memset( recordCommandBuffersUsed, 0, sizeof( recordCommandBuffersUsed ) );
+}
+
+/*
+=============
+AllocRecordCommandBuffer
+=============
+*/
+static VkCommandBuffer AllocRecordCommandBuffer( int context ) {
+	idList< VkCommandBuffer > & commandBuffers = recordCommandBuffers[ vkcontext.currentFrameData ][ context ];
+	if ( recordCommandBuffersUsed[ context ] == commandBuffers.Num() ) {
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		commandBufferAllocateInfo.commandPool = recordCommandPools[ vkcontext.currentFrameData ][ context ];
+		commandBufferAllocateInfo.commandBufferCount = 1;
+
+		ID_VK_CHECK( vkAllocateCommandBuffers( vkcontext.device, &commandBufferAllocateInfo, &commandBuffers.Alloc() ) );
+	}
+	return commandBuffers[ recordCommandBuffersUsed[ context ]++ ];
+}
+
+/*
+=============
+SetDynamicState
+=============
+*/
+static void SetDynamicState( VkCommandBuffer commandBuffer, const vkDynamicState_t & state, uint64 stateBits ) {
+	vkCmdSetViewport( commandBuffer, 0, 1, &state.viewport );
+	vkCmdSetScissor( commandBuffer, 0, 1, &state.scissor );
+	vkCmdSetDepthBias( commandBuffer, state.depthBiasBias, 0.0f, state.depthBiasScale );
+	if ( stateBits & GLS_DEPTH_TEST_MASK ) {
+		vkCmdSetDepthBounds( commandBuffer, state.depthBoundsMin, state.depthBoundsMax );
+	}
+}
+
+/*
+=============
+UpdateDynamicState
+
+Only sets the parts of the dynamic state that differ from the previous draw.
+=============
+*/
+static void UpdateDynamicState( VkCommandBuffer commandBuffer, const vkDynamicState_t & oldState, const vkDynamicState_t & state, uint64 stateBits ) {
+	if ( memcmp( &oldState.viewport, &state.viewport, sizeof( state.viewport ) ) != 0 ) {
+		vkCmdSetViewport( commandBuffer, 0, 1, &state.viewport );
+	}
+	if ( memcmp( &oldState.scissor, &state.scissor, sizeof( state.scissor ) ) != 0 ) {
+		vkCmdSetScissor( commandBuffer, 0, 1, &state.scissor );
+	}
+	if ( oldState.depthBiasScale != state.depthBiasScale || oldState.depthBiasBias != state.depthBiasBias ) {
+		vkCmdSetDepthBias( commandBuffer, state.depthBiasBias, 0.0f, state.depthBiasScale );
+	}
+	if ( ( stateBits & GLS_DEPTH_TEST_MASK ) && ( oldState.depthBoundsMin != state.depthBoundsMin || oldState.depthBoundsMax != state.depthBoundsMax ) ) {
+		vkCmdSetDepthBounds( commandBuffer, state.depthBoundsMin, state.depthBoundsMax );
+	}
+}
+
+/*
+=============
+MergeRecordCounters
+=============
+*/
+static void MergeRecordCounters( backEndCounters_t & pc, const backEndCounters_t & jobCounters ) {
+	pc.c_drawElements += jobCounters.c_drawElements;
+	pc.c_drawIndexes += jobCounters.c_drawIndexes;
+	pc.c_shadowElements += jobCounters.c_shadowElements;
+	pc.c_shadowIndexes += jobCounters.c_shadowIndexes;
+}
+
+/*
+=============
+BeginRecordCommandBuffer
+=============
+*/
+static void BeginRecordCommandBuffer( VkCommandBuffer commandBuffer ) {
+	VkCommandBufferInheritanceInfo inheritanceInfo = {};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = vkcontext.renderPassResume;
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = vkcontext.frameBuffers[ vkcontext.currentSwapIndex ];
+
+	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+	ID_VK_CHECK( vkBeginCommandBuffer( commandBuffer, &commandBufferBeginInfo ) );
+}
+
+/*
+=============
+ExecuteRecordCommandBuffers
+
+Restarts the render pass so the secondary command buffers can be executed, then
+resumes inline recording. Executing secondaries leaves the bound state undefined,
+so the dynamic state is set again afterwards.
+=============
+*/
+static void ExecuteRecordCommandBuffers( const VkCommandBuffer * commandBuffers, int numCommandBuffers, uint64 stateBits ) {
+	VkCommandBuffer commandBuffer = vkcontext.commandBuffer[ vkcontext.currentFrameData ];
+
+	VkRenderPassBeginInfo renderPassBeginInfo = {};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.renderPass = vkcontext.renderPassResume;
+	renderPassBeginInfo.framebuffer = vkcontext.frameBuffers[ vkcontext.currentSwapIndex ];
+	renderPassBeginInfo.renderArea.extent = vkcontext.swapchainExtent;
+
+	vkCmdEndRenderPass( commandBuffer );
+	vkCmdBeginRenderPass( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS );
+	vkCmdExecuteCommands( commandBuffer, numCommandBuffers, commandBuffers );
+	vkCmdEndRenderPass( commandBuffer );
+	vkCmdBeginRenderPass( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+
+	SetDynamicState( commandBuffer, dynamicState, stateBits );
+}
+
+/*
+=============
+RB_RecordDepthSurfaces
+=============
+*/
+static void RB_RecordDepthSurfaces( depthRecordJob_t * job ) {
+	vkRecordContext_t & context = *job->context;
+
+	BeginRecordCommandBuffer( context.commandBuffer );
+
+	SetDynamicState( context.commandBuffer, dynamicState, job->stateBits );
+
+	const viewEntity_t * currentSpace = NULL;
+	for ( int i = 0; i < job->numDrawSurfs; i++ ) {
+		const drawSurf_t * surf = job->drawSurfs[ i ];
+
+		idVertexBuffer * vertexBuffer;
+		idIndexBuffer * indexBuffer;
+		int vertOffset;
+		int indexOffset;
+		if ( !GetDrawBuffers( surf, vertexBuffer, vertOffset, indexBuffer, indexOffset ) ) {
+			continue;
+		}
+
+		// set mvp matrix
+		if ( surf->space != currentSpace ) {
+			memcpy( &context.uniforms[ RENDERPARM_MVPMATRIX_X ], surf->space->mvp[ 0 ], 4 * sizeof( idVec4 ) );
+			currentSpace = surf->space;
+		}
+
+		const int skinned = ( surf->jointCache != 0 ) ? 1 : 0;
+		renderProgManager.CommitRecordContext( &context, skinned ? BUILTIN_DEPTH_SKINNED : BUILTIN_DEPTH, job->pipelines[ skinned ], surf->jointCache );
+
+		{
+			const VkBuffer buffer = indexBuffer->GetAPIObject();
+			const VkDeviceSize offset = indexBuffer->GetOffset();
+			vkCmdBindIndexBuffer( context.commandBuffer, buffer, offset, VK_INDEX_TYPE_UINT16 );
+		}
+		{
+			const VkBuffer buffer = vertexBuffer->GetAPIObject();
+			const VkDeviceSize offset = vertexBuffer->GetOffset();
+			vkCmdBindVertexBuffers( context.commandBuffer, 0, 1, &buffer, &offset );
+		}
+
+		vkCmdDrawIndexed( 
+			context.commandBuffer, 
+			surf->numIndexes, 1, ( indexOffset >> 1 ), vertOffset / sizeof( idDrawVert ), 0 );
+
+		job->pc.c_drawElements++;
+		job->pc.c_drawIndexes += surf->numIndexes;
+	}
+
+	ID_VK_CHECK( vkEndCommandBuffer( context.commandBuffer ) );
+}
+REGISTER_PARALLEL_JOB( RB_RecordDepthSurfaces, "RB_RecordDepthSurfaces" );
+
+/*
+=============
+RecordCapturedDraws
+
+Records draws captured between BeginParallelDraws and EndParallelDraws. With a record
+context this runs on a job, without one it commits through the render thread's state.
+=============
+*/
+static void RecordCapturedDraws( VkCommandBuffer commandBuffer, vkRecordContext_t * context, const vkCapturedDraw_t * draws, int numDraws, backEndCounters_t & pc ) {
+	for ( int i = 0; i < numDraws; i++ ) {
+		const vkCapturedDraw_t & draw = draws[ i ];
+
+		if ( i == 0 ) {
+			SetDynamicState( commandBuffer, draw.dynamicState, draw.stateBits );
+		} else {
+			UpdateDynamicState( commandBuffer, draws[ i - 1 ].dynamicState, draw.dynamicState, draw.stateBits );
+		}
+
+		idImage ** imageParms = ( context != NULL ) ? context->imageParms : vkcontext.imageParms.Ptr();
+		for ( int j = 0; j < draw.numImages; j++ ) {
+			imageParms[ j ] = capturedImages[ draw.firstImage + j ];
+		}
+
+		renderProgManager.CommitRecordContext( context, draw.progIndex, draw.pipeline, draw.jointCache, capturedParms.Ptr() + draw.firstParm );
+
+		{
+			const VkBuffer buffer = draw.indexBuffer->GetAPIObject();
+			const VkDeviceSize offset = draw.indexBuffer->GetOffset();
+			vkCmdBindIndexBuffer( commandBuffer, buffer, offset, VK_INDEX_TYPE_UINT16 );
+		}
+		{
+			const VkBuffer buffer = draw.vertexBuffer->GetAPIObject();
+			const VkDeviceSize offset = draw.vertexBuffer->GetOffset();
+			vkCmdBindVertexBuffers( commandBuffer, 0, 1, &buffer, &offset );
+		}
+
+		vkCmdDrawIndexed( commandBuffer, draw.numIndexes, 1, draw.firstIndex, draw.baseVertex, 0 );
+
+		if ( draw.counter == DRAW_COUNTER_ELEMENTS ) {
+			pc.c_drawElements++;
+			pc.c_drawIndexes += draw.numIndexes;
+		} else if ( draw.counter == DRAW_COUNTER_SHADOW ) {
+			pc.c_shadowElements++;
+			pc.c_shadowIndexes += draw.numIndexes;
+		}
+	}
+}
+
+/*
+=============
+RB_RecordCapturedDraws
+=============
+*/
+static void RB_RecordCapturedDraws( drawRecordJob_t * job ) {
+	vkRecordContext_t & context = *job->context;
+
+	BeginRecordCommandBuffer( context.commandBuffer );
+
+	RecordCapturedDraws( context.commandBuffer, &context, job->draws, job->numDraws, job->pc );
+
+	ID_VK_CHECK( vkEndCommandBuffer( context.commandBuffer ) );
+}
+REGISTER_PARALLEL_JOB( RB_RecordCapturedDraws, "RB_RecordCapturedDraws" );
+
+/*
+=============
+CaptureDraw
+
+Called on the render thread in place of committing and drawing. The pipeline is
+looked up now because it depends on the current stencil operations.
+=============
+*/
+static void CaptureDraw( uint64 stateBits, vertCacheHandle_t jointCache, idVertexBuffer * vertexBuffer, idIndexBuffer * indexBuffer, int numIndexes, int firstIndex, int baseVertex, drawCounter_t counter ) {
+	const int progIndex = renderProgManager.GetCurrentRenderProgIndex();
+
+	vkCapturedDraw_t & draw = capturedDraws.Alloc();
+	draw.progIndex = progIndex;
+	draw.pipeline = renderProgManager.PreparePipeline( progIndex, stateBits );
+	draw.jointCache = jointCache;
+	draw.vertexBuffer = vertexBuffer;
+	draw.indexBuffer = indexBuffer;
+	draw.numIndexes = numIndexes;
+	draw.firstIndex = firstIndex;
+	draw.baseVertex = baseVertex;
+	draw.stateBits = stateBits;
+	draw.dynamicState = dynamicState;
+	draw.counter = counter;
+
+	draw.firstParm = capturedParms.Num();
+	capturedParms.SetNum( draw.firstParm + renderProgManager.GetRecordParmCount( progIndex ) );
+	renderProgManager.CaptureRecordParms( progIndex, capturedParms.Ptr() + draw.firstParm );
+
+	draw.firstImage = capturedImages.Num();
+	draw.numImages = renderProgManager.GetRecordImageCount( progIndex );
+	assert( draw.numImages <= MAX_RECORD_CONTEXT_IMAGES );
+	for ( int i = 0; i < draw.numImages; i++ ) {
+		capturedImages.Append( vkcontext.imageParms[ i ] );
+	}
+
+	capturedParmBytes = Max( capturedParmBytes, renderProgManager.GetParmBlockBytes( progIndex ) );
+}
+
 /*
 =============
 idRenderBackend::idRenderBackend
@@ -1231,6 +1853,9 @@ void idRenderBackend::Init() {
 	// Create Command Buffer
 	CreateCommandBuffer();
 
+	// Create Secondary Command Pools
+	CreateRecordCommandPools();
+
 	// Setup the allocator
 #if defined( ID_USE_AMD_ALLOCATOR )
 	extern idCVar r_vkHostVisibleMemoryMB;
@@ -1290,11 +1915,13 @@ void idRenderBackend::Shutdown() {
 	// Detroy Frame Buffers
 	DestroyFrameBuffers();
 
-	// Destroy Pipeline Cache
+	// Save and Destroy Pipeline Cache
+	SavePipelineCache();
 	vkDestroyPipelineCache( vkcontext.device, vkcontext.pipelineCache, NULL );
 
 	// Destroy Render Pass
 	vkDestroyRenderPass( vkcontext.device, vkcontext.renderPass, NULL );
+	vkDestroyRenderPass( vkcontext.device, vkcontext.renderPassResume, NULL );
 
 	// Destroy Render Targets
 	DestroyRenderTargets();
@@ -1314,6 +1941,9 @@ void idRenderBackend::Shutdown() {
 	// Destroy Command Pool
 	vkDestroyCommandPool( vkcontext.device, vkcontext.commandPool, NULL );
 
+	// Destroy Secondary Command Pools
+	DestroyRecordCommandPools();
+
 	// Destroy Semaphores
 	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
 		vkDestroySemaphore( vkcontext.device, vkcontext.acquireSemaphores[ i ], NULL );
@@ -1457,39 +2087,54 @@ BACKEND COMMANDS
 
 /*
 =============
-idRenderBackend::DrawElementsWithCounters
+GetDrawBuffers
 =============
 */
-void idRenderBackend::DrawElementsWithCounters( const drawSurf_t * surf ) {
+static bool GetDrawBuffers( const drawSurf_t * surf, idVertexBuffer * & vertexBuffer, int & vertOffset, idIndexBuffer * & indexBuffer, int & indexOffset ) {
 	// get vertex buffer
 	const vertCacheHandle_t vbHandle = surf->ambientCache;
-	idVertexBuffer * vertexBuffer;
 	if ( vertexCache.CacheIsStatic( vbHandle ) ) {
 		vertexBuffer = &vertexCache.m_staticData.vertexBuffer;
 	} else {
 		const uint64 frameNum = (int)( vbHandle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 		if ( frameNum != ( ( vertexCache.m_currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) ) {
 			idLib::Warning( "idRenderBackend::DrawElementsWithCounters, vertexBuffer == NULL" );
-			return;
+			return false;
 		}
 		vertexBuffer = &vertexCache.m_frameData[ vertexCache.m_drawListNum ].vertexBuffer;
 	}
-	int vertOffset = (int)( vbHandle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
+	vertOffset = (int)( vbHandle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
 
 	// get index buffer
 	const vertCacheHandle_t ibHandle = surf->indexCache;
-	idIndexBuffer * indexBuffer;
 	if ( vertexCache.CacheIsStatic( ibHandle ) ) {
 		indexBuffer = &vertexCache.m_staticData.indexBuffer;
 	} else {
 		const uint64 frameNum = (int)( ibHandle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 		if ( frameNum != ( ( vertexCache.m_currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) ) {
 			idLib::Warning( "idRenderBackend::DrawElementsWithCounters, indexBuffer == NULL" );
-			return;
+			return false;
 		}
 		indexBuffer = &vertexCache.m_frameData[ vertexCache.m_drawListNum ].indexBuffer;
 	}
-	int indexOffset = (int)( ibHandle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
+	indexOffset = (int)( ibHandle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
+
+	return true;
+}
+
+/*
+=============
+idRenderBackend::DrawElementsWithCounters
+=============
+*/
+void idRenderBackend::DrawElementsWithCounters( const drawSurf_t * surf ) {
+	idVertexBuffer * vertexBuffer;
+	idIndexBuffer * indexBuffer;
+	int vertOffset;
+	int indexOffset;
+	if ( !GetDrawBuffers( surf, vertexBuffer, vertOffset, indexBuffer, indexOffset ) ) {
+		return;
+	}
 
 	RENDERLOG_PRINTF( "Binding Buffers(%d): %p:%i %p:%i\n", surf->numIndexes, vertexBuffer, vertOffset, indexBuffer, indexOffset );
 
@@ -1507,6 +2152,11 @@ void idRenderBackend::DrawElementsWithCounters( const drawSurf_t * surf ) {
 		}
 	}
 
+	if ( capturingDraws ) {
+		CaptureDraw( m_glStateBits, surf->jointCache, vertexBuffer, indexBuffer, surf->numIndexes, ( indexOffset >> 1 ), vertOffset / sizeof( idDrawVert ), DRAW_COUNTER_ELEMENTS );
+		return;
+	}
+
 	vkcontext.jointCacheHandle = surf->jointCache;
 
 	PrintState( m_glStateBits, vkcontext.stencilOperations );
@@ -1526,6 +2176,9 @@ void idRenderBackend::DrawElementsWithCounters( const drawSurf_t * surf ) {
 	vkCmdDrawIndexed( 
 		vkcontext.commandBuffer[ vkcontext.currentFrameData ], 
 		surf->numIndexes, 1, ( indexOffset >> 1 ), vertOffset / sizeof( idDrawVert ), 0 );
+
+	m_pc.c_drawElements++;
+	m_pc.c_drawIndexes += surf->numIndexes;
 }
 
 /*
@@ -1550,11 +2203,16 @@ void idRenderBackend::GL_StartFrame() {
 #endif
 	stagingManager.Flush();
 	renderProgManager.StartFrame();
+	ResetRecordCommandPools();
 
 	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
 	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	ID_VK_CHECK( vkBeginCommandBuffer( vkcontext.commandBuffer[ vkcontext.currentFrameData ], &commandBufferBeginInfo ) );
 
+#if !defined( ID_USE_AMD_ALLOCATOR )
+	idImage::DefragmentImages( vkcontext.commandBuffer[ vkcontext.currentFrameData ] );
+#endif
+
 	VkRenderPassBeginInfo renderPassBeginInfo = {};
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	renderPassBeginInfo.renderPass = vkcontext.renderPass;
@@ -1836,6 +2494,8 @@ void idRenderBackend::GL_DepthBoundsTest( const float zmin, const float zmax ) {
 	} else {
 		m_glStateBits |= GLS_DEPTH_TEST_MASK;
 		vkCmdSetDepthBounds( vkcontext.commandBuffer[ vkcontext.currentFrameData ], zmin, zmax );
+		dynamicState.depthBoundsMin = zmin;
+		dynamicState.depthBoundsMax = zmax;
 	}
 
 	RENDERLOG_PRINTF( "GL_DepthBoundsTest( zmin=%f, zmax=%f )\n", zmin, zmax );
@@ -1848,6 +2508,8 @@ idRenderBackend::GL_PolygonOffset
 */
 void idRenderBackend::GL_PolygonOffset( float scale, float bias ) {
 	vkCmdSetDepthBias( vkcontext.commandBuffer[ vkcontext.currentFrameData ], bias, 0.0f, scale );
+	dynamicState.depthBiasScale = scale;
+	dynamicState.depthBiasBias = bias;
 
 	RENDERLOG_PRINTF( "GL_PolygonOffset( scale=%f, bias=%f )\n", scale, bias );
 }
@@ -1864,6 +2526,7 @@ void idRenderBackend::GL_Scissor( int x /* left*/, int y /* bottom */, int w, in
 	scissor.extent.width = w;
 	scissor.extent.height = h;
 	vkCmdSetScissor( vkcontext.commandBuffer[ vkcontext.currentFrameData ], 0, 1, &scissor );
+	dynamicState.scissor = scissor;
 }
 
 /*
@@ -1880,6 +2543,7 @@ void idRenderBackend::GL_Viewport( int x /* left */, int y /* bottom */, int w,
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
 	vkCmdSetViewport( vkcontext.commandBuffer[ vkcontext.currentFrameData ], 0, 1, &viewport );
+	dynamicState.viewport = viewport;
 }
 
 /*
@@ -1940,6 +2604,21 @@ void idRenderBackend::DrawStencilShadowPass( const drawSurf_t * drawSurf, const
 
 	RENDERLOG_PRINTF( "Binding Buffers(%d): %p:%i %p:%i\n", drawSurf->numIndexes, vertexBuffer, vertOffset, indexBuffer, indexOffset );
 
+	const int baseVertex = vertOffset / ( drawSurf->jointCache ? sizeof( idShadowVertSkinned ) : sizeof( idShadowVert ) );
+
+	if ( capturingDraws ) {
+		CaptureDraw( m_glStateBits, drawSurf->jointCache, vertexBuffer, indexBuffer, drawSurf->numIndexes, ( indexOffset >> 1 ), baseVertex, DRAW_COUNTER_SHADOW );
+
+		if ( !renderZPass && r_useStencilShadowPreload.GetBool() ) {
+			// render again with Z-pass
+			GL_SeparateStencil( STENCIL_FACE_FRONT, GLS_STENCIL_OP_FAIL_KEEP | GLS_STENCIL_OP_ZFAIL_KEEP | GLS_STENCIL_OP_PASS_INCR );
+			GL_SeparateStencil( STENCIL_FACE_BACK, GLS_STENCIL_OP_FAIL_KEEP | GLS_STENCIL_OP_ZFAIL_KEEP | GLS_STENCIL_OP_PASS_DECR );
+
+			CaptureDraw( m_glStateBits, drawSurf->jointCache, vertexBuffer, indexBuffer, drawSurf->numIndexes, ( indexOffset >> 1 ), baseVertex, DRAW_COUNTER_NONE );
+		}
+		return;
+	}
+
 	vkcontext.jointCacheHandle = drawSurf->jointCache;
 
 	PrintState( m_glStateBits, vkcontext.stencilOperations );
@@ -1956,12 +2635,13 @@ void idRenderBackend::DrawStencilShadowPass( const drawSurf_t * drawSurf, const
 		vkCmdBindVertexBuffers( vkcontext.commandBuffer[ vkcontext.currentFrameData ], 0, 1, &buffer, &offset );
 	}
 
-	const int baseVertex = vertOffset / ( drawSurf->jointCache ? sizeof( idShadowVertSkinned ) : sizeof( idShadowVert ) );
-
 	vkCmdDrawIndexed( 
 		vkcontext.commandBuffer[ vkcontext.currentFrameData ],
 		drawSurf->numIndexes, 1, ( indexOffset >> 1 ), baseVertex, 0 );
 
+	m_pc.c_shadowElements++;
+	m_pc.c_shadowIndexes += drawSurf->numIndexes;
+
 	if ( !renderZPass && r_useStencilShadowPreload.GetBool() ) {
 		// render again with Z-pass
 		GL_SeparateStencil( STENCIL_FACE_FRONT, GLS_STENCIL_OP_FAIL_KEEP | GLS_STENCIL_OP_ZFAIL_KEEP | GLS_STENCIL_OP_PASS_INCR );
@@ -1975,3 +2655,161 @@ void idRenderBackend::DrawStencilShadowPass( const drawSurf_t * drawSurf, const
 		drawSurf->numIndexes, 1, ( indexOffset >> 1 ), baseVertex, 0 );
 	}
 }
+
+/*
+=============
+idRenderBackend::FillDepthBufferParallel
+
+Records the opaque depth surfaces on the job threads. Returns false when the
+pass is too small to be worth splitting or the frame is out of record space,
+and the caller draws the surfaces inline instead.
+=============
+*/
+bool idRenderBackend::FillDepthBufferParallel( const drawSurf_t * const * drawSurfs, int numDrawSurfs ) {
+	if ( !r_vkParallelDepthPass.GetBool() || recordJobList == NULL ) {
+		return false;
+	}
+
+	const int numJobs = Min( numDrawSurfs / r_vkParallelDepthPassSurfaces.GetInteger(), MAX_RECORD_CONTEXTS );
+	if ( numJobs < 2 ) {
+		return false;
+	}
+
+	const int surfsPerJob = ( numDrawSurfs + numJobs - 1 ) / numJobs;
+	const int parmBytesPerDraw = Max( renderProgManager.GetParmBlockBytes( BUILTIN_DEPTH ), renderProgManager.GetParmBlockBytes( BUILTIN_DEPTH_SKINNED ) );
+	if ( !renderProgManager.BeginRecordContexts( recordContexts, numJobs, surfsPerJob, parmBytesPerDraw ) ) {
+		return false;
+	}
+
+	// must render with less-equal for Z-Cull to work properly
+	assert( ( m_glStateBits & GLS_DEPTHFUNC_BITS ) == GLS_DEPTHFUNC_LESS );
+
+	renderLog.OpenBlock( "RB_FillDepthBufferParallel" );
+
+	// pipelines can't be created from the jobs
+	VkPipeline pipelines[ 2 ];
+	pipelines[ 0 ] = renderProgManager.PreparePipeline( BUILTIN_DEPTH, m_glStateBits );
+	pipelines[ 1 ] = renderProgManager.PreparePipeline( BUILTIN_DEPTH_SKINNED, m_glStateBits );
+
+	VkCommandBuffer commandBuffers[ MAX_RECORD_CONTEXTS ];
+	for ( int i = 0; i < numJobs; i++ ) {
+		const int firstSurf = i * surfsPerJob;
+
+		vkRecordContext_t & context = recordContexts[ i ];
+		context.commandBuffer = AllocRecordCommandBuffer( i );
+		commandBuffers[ i ] = context.commandBuffer;
+
+		depthRecordJob_t & job = depthRecordJobs[ i ];
+		job.context = &context;
+		job.drawSurfs = drawSurfs + firstSurf;
+		job.numDrawSurfs = Min( surfsPerJob, numDrawSurfs - firstSurf );
+		job.stateBits = m_glStateBits;
+		job.pipelines[ 0 ] = pipelines[ 0 ];
+		job.pipelines[ 1 ] = pipelines[ 1 ];
+		memset( &job.pc, 0, sizeof( job.pc ) );
+
+		recordJobList->AddJob( (jobRun_t)RB_RecordDepthSurfaces, &job );
+	}
+
+	recordJobList->Submit();
+	recordJobList->Wait();
+
+	for ( int i = 0; i < numJobs; i++ ) {
+		MergeRecordCounters( m_pc, depthRecordJobs[ i ].pc );
+	}
+
+	ExecuteRecordCommandBuffers( commandBuffers, numJobs, m_glStateBits );
+
+	// the jobs set their own mvp, but make sure the next inline draw sets it again
+	m_currentSpace = NULL;
+
+	renderLog.CloseBlock();
+
+	return true;
+}
+
+/*
+=============
+idRenderBackend::BeginParallelDraws
+
+Starts capturing the draws of a light pass instead of recording them, so
+EndParallelDraws can split them across the job threads. Returns false when
+the pass is expected to be too small to be worth splitting.
+=============
+*/
+bool idRenderBackend::BeginParallelDraws( int numExpectedDraws ) {
+	if ( !r_vkParallelLightPass.GetBool() || recordJobList == NULL ) {
+		return false;
+	}
+	if ( numExpectedDraws < r_vkParallelLightPassDraws.GetInteger() * 2 ) {
+		return false;
+	}
+
+	assert( !capturingDraws );
+
+	capturingDraws = true;
+	capturedParmBytes = 0;
+	capturedDraws.SetNum( 0 );
+	capturedParms.SetNum( 0 );
+	capturedImages.SetNum( 0 );
+
+	return true;
+}
+
+/*
+=============
+idRenderBackend::EndParallelDraws
+
+Records the captured draws on the job threads and executes them in order. If
+the frame is out of record space they are recorded inline instead.
+=============
+*/
+void idRenderBackend::EndParallelDraws() {
+	assert( capturingDraws );
+
+	capturingDraws = false;
+
+	const int numDraws = capturedDraws.Num();
+	if ( numDraws == 0 ) {
+		return;
+	}
+
+	const int numJobs = idMath::ClampInt( 1, MAX_RECORD_CONTEXTS, numDraws / r_vkParallelLightPassDraws.GetInteger() );
+	const int drawsPerJob = ( numDraws + numJobs - 1 ) / numJobs;
+
+	if ( !renderProgManager.BeginRecordContexts( recordContexts, numJobs, drawsPerJob, capturedParmBytes ) ) {
+		RecordCapturedDraws( vkcontext.commandBuffer[ vkcontext.currentFrameData ], NULL, capturedDraws.Ptr(), numDraws, m_pc );
+		SetDynamicState( vkcontext.commandBuffer[ vkcontext.currentFrameData ], dynamicState, m_glStateBits );
+		return;
+	}
+
+	renderLog.OpenBlock( "RB_EndParallelDraws" );
+
+	VkCommandBuffer commandBuffers[ MAX_RECORD_CONTEXTS ];
+	for ( int i = 0; i < numJobs; i++ ) {
+		const int firstDraw = i * drawsPerJob;
+
+		vkRecordContext_t & context = recordContexts[ i ];
+		context.commandBuffer = AllocRecordCommandBuffer( i );
+		commandBuffers[ i ] = context.commandBuffer;
+
+		drawRecordJob_t & job = drawRecordJobs[ i ];
+		job.context = &context;
+		job.draws = capturedDraws.Ptr() + firstDraw;
+		job.numDraws = Min( drawsPerJob, numDraws - firstDraw );
+		memset( &job.pc, 0, sizeof( job.pc ) );
+
+		recordJobList->AddJob( (jobRun_t)RB_RecordCapturedDraws, &job );
+	}
+
+	recordJobList->Submit();
+	recordJobList->Wait();
+
+	for ( int i = 0; i < numJobs; i++ ) {
+		MergeRecordCounters( m_pc, drawRecordJobs[ i ].pc );
+	}
+
+	ExecuteRecordCommandBuffers( commandBuffers, numJobs, m_glStateBits );
+
+	renderLog.CloseBlock();
+}
@@ -37,6 +37,9 @@ If you have questions concerning this license or the applicable additional terms
 
 void RpPrintState( uint64 stateBits, uint64 * stencilBits );
 
+idCVar r_vkCacheDescriptorSets( "r_vkCacheDescriptorSets", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_INIT, "Bind uniform buffers with dynamic offsets and reuse identical descriptor sets within a frame." );
+idCVar r_vkWarmPipelines( "r_vkWarmPipelines", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "Pre-build the pipelines used in the previous session at startup." );
+
 struct vertexLayout_t {
 	VkPipelineVertexInputStateCreateInfo inputState;
 	idList< VkVertexInputBindingDescription > bindingDesc;
@@ -53,6 +56,103 @@ static const char * renderProgBindingStrings[ BINDING_TYPE_MAX ] = {
 	"sampler"
 };
 
+/*
+================================================================================================
+
+Pipeline Manifest
+
+Records the shader pair and state of every pipeline built during a session so the next
+session can create them up front, while the pipeline cache is warm, instead of hitching
+the first time each material / state combination is drawn.
+
+================================================================================================
+*/
+
+static const char * PIPELINE_MANIFEST_FILE = "pipeline.manifest";
+static const unsigned int PIPELINE_MANIFEST_MAGIC = ( 'P' << 24 ) | ( 'M' << 16 ) | ( 'F' << 8 ) | 1;
+
+struct pipelineManifestEntry_t {
+	idStr	vertexShader;
+	idStr	fragmentShader;
+	uint64	stateBits;
+	uint64	stencilOperations[ STENCIL_FACE_NUM ];
+	bool	warmed;
+};
+
+static idList< pipelineManifestEntry_t > pipelineManifest;
+
+/*
+================================================================================================
+
+Descriptor Set Cache
+
+With r_vkCacheDescriptorSets the uniform buffers are bound as dynamic descriptors, so the
+per-draw parm block offset no longer lives in the descriptor set. Most draws then only differ
+in their images, and a set written earlier in the frame with the same buffers, images and
+samplers can be bound again with new dynamic offsets instead of being allocated and updated.
+
+================================================================================================
+*/
+
+struct descriptorSetKey_t {
+	VkDescriptorSetLayout	layout;
+	int						numBindings;
+	struct {
+		uint64				handle;		// VkBuffer or VkImageView
+		uint64				data;		// buffer range or VkSampler
+		uint64				layout;		// VkImageLayout
+	} bindings[ MAX_DESC_SET_WRITES ];
+};
+
+struct descriptorSetCacheEntry_t {
+	descriptorSetKey_t		key;
+	VkDescriptorSet			set;
+};
+
+static bool cacheDescriptorSets = false;
+static idList< descriptorSetCacheEntry_t, TAG_RENDER > descriptorSetCache[ NUM_FRAME_DATA ];
+static idHashIndex descriptorSetHash[ NUM_FRAME_DATA ];
+
+/*
+========================
+MakeDescriptorSetKey
+========================
+*/
+static int MakeDescriptorSetKey( VkDescriptorSetLayout layout, const VkWriteDescriptorSet * writes, int numWrites, descriptorSetKey_t & key ) {
+	key.layout = layout;
+	key.numBindings = numWrites;
+
+	uint64 hash = (uint64)layout;
+	for ( int i = 0; i < numWrites; ++i ) {
+		const VkWriteDescriptorSet & write = writes[ i ];
+		if ( write.pBufferInfo != NULL ) {
+			key.bindings[ i ].handle = (uint64)write.pBufferInfo->buffer;
+			key.bindings[ i ].data = (uint64)write.pBufferInfo->range;
+			key.bindings[ i ].layout = 0;
+		} else {
+			key.bindings[ i ].handle = (uint64)write.pImageInfo->imageView;
+			key.bindings[ i ].data = (uint64)write.pImageInfo->sampler;
+			key.bindings[ i ].layout = (uint64)write.pImageInfo->imageLayout;
+		}
+		hash = ( hash * 31 ) ^ key.bindings[ i ].handle;
+		hash = ( hash * 31 ) ^ key.bindings[ i ].data;
+	}
+
+	return (int)( hash ^ ( hash >> 32 ) );
+}
+
+/*
+========================
+CompareDescriptorSetKeys
+========================
+*/
+static bool CompareDescriptorSetKeys( const descriptorSetKey_t & a, const descriptorSetKey_t & b ) {
+	if ( a.layout != b.layout || a.numBindings != b.numBindings ) {
+		return false;
+	}
+	return memcmp( a.bindings, b.bindings, a.numBindings * sizeof( a.bindings[ 0 ] ) ) == 0;
+}
+
 /*
 =============
 CreateVertexDescriptions
@@ -170,26 +270,35 @@ static void CreateVertexDescriptions() {
 
 /*
 ========================
-CreateDescriptorPools
+CreateDescriptorPool
 ========================
 */
-static void CreateDescriptorPools( VkDescriptorPool (&pools)[ NUM_FRAME_DATA ] ) {
+static void CreateDescriptorPool( int maxSets, int numUniformBuffers, int numImageSamplers, VkDescriptorPool & pool ) {
 	const int numPools = 2;
 	VkDescriptorPoolSize poolSizes[ numPools ];
-	poolSizes[ 0 ].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[ 0 ].descriptorCount = MAX_DESC_UNIFORM_BUFFERS;
+	poolSizes[ 0 ].type = cacheDescriptorSets ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	poolSizes[ 0 ].descriptorCount = numUniformBuffers;
 	poolSizes[ 1 ].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[ 1 ].descriptorCount = MAX_DESC_IMAGE_SAMPLERS;
+	poolSizes[ 1 ].descriptorCount = numImageSamplers;
 
 	VkDescriptorPoolCreateInfo poolCreateInfo = {};
 	poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 	poolCreateInfo.pNext = NULL;
-	poolCreateInfo.maxSets = MAX_DESC_SETS;
+	poolCreateInfo.maxSets = maxSets;
 	poolCreateInfo.poolSizeCount = numPools;
 	poolCreateInfo.pPoolSizes = poolSizes;
 
+	ID_VK_CHECK( vkCreateDescriptorPool( vkcontext.device, &poolCreateInfo, NULL, &pool ) );
+}
+
+/*
+========================
+CreateDescriptorPools
+========================
+*/
+static void CreateDescriptorPools( VkDescriptorPool (&pools)[ NUM_FRAME_DATA ] ) {
 	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
-		ID_VK_CHECK( vkCreateDescriptorPool( vkcontext.device, &poolCreateInfo, NULL, &pools[ i ] ) );
+		CreateDescriptorPool( MAX_DESC_SETS, MAX_DESC_UNIFORM_BUFFERS, MAX_DESC_IMAGE_SAMPLERS, pools[ i ] );
 	}
 }
 
@@ -200,7 +309,7 @@ GetDescriptorType
 */
 static VkDescriptorType GetDescriptorType( rpBinding_t type ) {
 	switch ( type ) {
-	case BINDING_TYPE_UNIFORM_BUFFER: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	case BINDING_TYPE_UNIFORM_BUFFER: return cacheDescriptorSets ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 	case BINDING_TYPE_SAMPLER: return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 	default: 
 		idLib::Error( "Unknown rpBinding_t %d", static_cast< int >( type ) );
@@ -601,6 +710,8 @@ idRenderProgManager::idRenderProgManager() :
 	m_currentParmBufferOffset( 0 ) {
 	
 	memset( m_parmBuffers, 0, sizeof( m_parmBuffers ) );
+	memset( m_recordPools, 0, sizeof( m_recordPools ) );
+	memset( m_recordPoolSets, 0, sizeof( m_recordPoolSets ) );
 }
 
 /*
@@ -648,6 +759,8 @@ void idRenderProgManager::Init() {
 		{ BUILTIN_BINK, "bink", SHADER_STAGE_ALL, LAYOUT_DRAW_VERT },
 		{ BUILTIN_BINK_GUI, "bink_gui", SHADER_STAGE_ALL, LAYOUT_DRAW_VERT },
 	};
+	cacheDescriptorSets = r_vkCacheDescriptorSets.GetBool();
+
 	m_renderProgs.SetNum( MAX_BUILTINS );
 	
 	for ( int i = 0; i < MAX_BUILTINS; i++ ) {
@@ -692,6 +805,14 @@ void idRenderProgManager::Init() {
 	// Create Descriptor Pools
 	CreateDescriptorPools( m_descriptorPools );
 
+	// one pool per recording job so they never touch the same pool
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		for ( int j = 0; j < MAX_RECORD_CONTEXTS; ++j ) {
+			CreateDescriptorPool( MAX_RECORD_CONTEXT_SETS, MAX_RECORD_CONTEXT_SETS * 3, MAX_RECORD_CONTEXT_SETS * MAX_RECORD_CONTEXT_IMAGES, m_recordPools[ i ][ j ] );
+		}
+	}
+	memset( m_recordPoolSets, 0, sizeof( m_recordPoolSets ) );
+
 	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
 		m_parmBuffers[ i ] = new idUniformBuffer();
 		m_parmBuffers[ i ]->AllocBufferObject( NULL, MAX_DESC_SETS * MAX_DESC_SET_UNIFORMS * sizeof( idVec4 ), BU_DYNAMIC );
@@ -699,6 +820,11 @@ void idRenderProgManager::Init() {
 
 	// Placeholder: mainly for optionalSkinning
 	emptyUBO.AllocBufferObject( NULL, sizeof( idVec4 ), BU_DYNAMIC );
+
+	LoadPipelineManifest();
+	for ( int i = 0; i < MAX_BUILTINS; i++ ) {
+		WarmPipelines( i );
+	}
 }
 
 /*
@@ -707,6 +833,8 @@ idRenderProgManager::Shutdown
 ========================
 */
 void idRenderProgManager::Shutdown() {
+	SavePipelineManifest();
+
 	// destroy shaders
 	for ( int i = 0; i < m_shaders.Num(); ++i ) {
 		shader_t & shader = m_shaders[ i ];
@@ -745,6 +873,18 @@ void idRenderProgManager::Shutdown() {
 	memset( m_descriptorSets, 0, sizeof( m_descriptorSets ) );
 	memset( m_descriptorPools, 0, sizeof( m_descriptorPools ) );
 
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		for ( int j = 0; j < MAX_RECORD_CONTEXTS; ++j ) {
+			vkDestroyDescriptorPool( vkcontext.device, m_recordPools[ i ][ j ], NULL );
+		}
+	}
+	memset( m_recordPools, 0, sizeof( m_recordPools ) );
+
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		descriptorSetCache[ i ].Clear();
+		descriptorSetHash[ i ].Free();
+	}
+
 	m_counter = 0;
 	m_currentData = 0;
 	m_currentDescSet = 0;
@@ -762,6 +902,13 @@ void idRenderProgManager::StartFrame() {
 	m_currentParmBufferOffset = 0;
 
 	vkResetDescriptorPool( vkcontext.device, m_descriptorPools[ m_currentData ], 0 );
+	for ( int i = 0; i < MAX_RECORD_CONTEXTS; ++i ) {
+		vkResetDescriptorPool( vkcontext.device, m_recordPools[ m_currentData ][ i ], 0 );
+	}
+	memset( m_recordPoolSets, 0, sizeof( m_recordPoolSets ) );
+
+	descriptorSetCache[ m_currentData ].SetNum( 0 );
+	descriptorSetHash[ m_currentData ].Clear();
 }
 
 /*
@@ -792,21 +939,26 @@ void idRenderProgManager::Unbind() {
 idRenderProgManager::AllocParmBlockBuffer
 ========================
 */
-void idRenderProgManager::AllocParmBlockBuffer( const idList< int > & parmIndices, idUniformBuffer & ubo ) {
+void idRenderProgManager::AllocParmBlockBuffer( const idList< int > & parmIndices, idUniformBuffer & ubo, vkRecordContext_t * context ) {
 	const int numParms = parmIndices.Num();
 	const int bytes = ALIGN( numParms * sizeof( idVec4 ), vkcontext.gpu->props.limits.minUniformBufferOffsetAlignment );
 
-	ubo.Reference( *m_parmBuffers[ m_currentData ], m_currentParmBufferOffset, bytes );
+	// record contexts sub-allocate from the range reserved in BeginRecordContexts
+	int & parmBufferOffset = ( context != NULL ) ? context->parmBufferOffset : m_currentParmBufferOffset;
+	const idVec4 * source = ( context != NULL ) ? context->uniforms : m_uniforms.Ptr();
+	assert( context == NULL || parmBufferOffset + bytes <= context->parmBufferEnd );
+
+	ubo.Reference( *m_parmBuffers[ m_currentData ], parmBufferOffset, bytes );
 
 	idVec4 * uniforms = (idVec4 *)ubo.MapBuffer( BM_WRITE );
 	
 	for ( int i = 0; i < numParms; ++i ) {
-		uniforms[ i ] = renderProgManager.GetRenderParm( static_cast< renderParm_t >( parmIndices[ i ] ) );
+		uniforms[ i ] = source[ parmIndices[ i ] ];
 	}
 
 	ubo.UnmapBuffer();
 
-	m_currentParmBufferOffset += bytes;
+	parmBufferOffset += bytes;
 }
 
 /*
@@ -822,18 +974,19 @@ void idRenderProgManager::CommitCurrent( uint64 stateBits ) {
 		m_shaders[ prog.vertexShaderIndex ].module,
 		prog.fragmentShaderIndex != -1 ? m_shaders[ prog.fragmentShaderIndex ].module : VK_NULL_HANDLE );
 
-	VkDescriptorSetAllocateInfo setAllocInfo = {};
-	setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	setAllocInfo.pNext = NULL;
-	setAllocInfo.descriptorPool = m_descriptorPools[ m_currentData ];
-	setAllocInfo.descriptorSetCount = 1;
-	setAllocInfo.pSetLayouts = &prog.descriptorSetLayout;
-
-	ID_VK_CHECK( vkAllocateDescriptorSets( vkcontext.device, &setAllocInfo, &m_descriptorSets[ m_currentData ][ m_currentDescSet ] ) );
+	CommitDescriptors( prog, pipeline, vkcontext.jointCacheHandle, NULL );
+}
 
-	VkDescriptorSet descSet = m_descriptorSets[ m_currentData ][ m_currentDescSet ];
-	m_currentDescSet++;
+/*
+========================
+idRenderProgManager::CommitDescriptors
 
+Writes the parm blocks and descriptor set for a draw and binds them along with the
+pipeline. Without a record context this targets the frame's primary command buffer
+and descriptor pool, otherwise only the context's own resources are touched.
+========================
+*/
+void idRenderProgManager::CommitDescriptors( const renderProg_t & prog, VkPipeline pipeline, vertCacheHandle_t jointCacheHandle, vkRecordContext_t * context ) {
 	int writeIndex = 0;
 	int bufferIndex = 0;
 	int	imageIndex = 0;
@@ -843,20 +996,23 @@ void idRenderProgManager::CommitCurrent( uint64 stateBits ) {
 	VkDescriptorBufferInfo bufferInfos[ MAX_DESC_SET_WRITES ];
 	VkDescriptorImageInfo imageInfos[ MAX_DESC_SET_WRITES ];
 
+	uint32 dynamicOffsets[ MAX_DESC_SET_WRITES ];
+	int numDynamicOffsets = 0;
+
 	int uboIndex = 0;
 	idUniformBuffer * ubos[ 3 ] = { NULL, NULL, NULL };
 
 	idUniformBuffer vertParms;
 	if ( prog.vertexShaderIndex > -1 && m_shaders[ prog.vertexShaderIndex ].parmIndices.Num() > 0 ) {
-		AllocParmBlockBuffer( m_shaders[ prog.vertexShaderIndex ].parmIndices, vertParms );
+		AllocParmBlockBuffer( m_shaders[ prog.vertexShaderIndex ].parmIndices, vertParms, context );
 
 		ubos[ uboIndex++ ] = &vertParms;
 	}
 
 	idUniformBuffer jointBuffer;
-	if ( prog.usesJoints && vkcontext.jointCacheHandle > 0 ) {
-		if ( !vertexCache.GetJointBuffer( vkcontext.jointCacheHandle, &jointBuffer ) ) {
-			idLib::Error( "idRenderProgManager::CommitCurrent: jointBuffer == NULL" );
+	if ( prog.usesJoints && jointCacheHandle > 0 ) {
+		if ( !vertexCache.GetJointBuffer( jointCacheHandle, &jointBuffer ) ) {
+			idLib::Error( "idRenderProgManager::CommitDescriptors: jointBuffer == NULL" );
 			return;
 		}
 		assert( ( jointBuffer.GetOffset() & ( vkcontext.gpu->props.limits.minUniformBufferOffsetAlignment - 1 ) ) == 0 );
@@ -868,7 +1024,7 @@ void idRenderProgManager::CommitCurrent( uint64 stateBits ) {
 
 	idUniformBuffer fragParms;
 	if ( prog.fragmentShaderIndex > -1 && m_shaders[ prog.fragmentShaderIndex ].parmIndices.Num() > 0 ) {
-		AllocParmBlockBuffer( m_shaders[ prog.fragmentShaderIndex ].parmIndices, fragParms );
+		AllocParmBlockBuffer( m_shaders[ prog.fragmentShaderIndex ].parmIndices, fragParms, context );
 
 		ubos[ uboIndex++ ] = &fragParms;
 	}
@@ -883,22 +1039,25 @@ void idRenderProgManager::CommitCurrent( uint64 stateBits ) {
 				VkDescriptorBufferInfo & bufferInfo = bufferInfos[ bufferIndex++ ];
 				memset( &bufferInfo, 0, sizeof( VkDescriptorBufferInfo ) );
 				bufferInfo.buffer = ubo->GetAPIObject();
-				bufferInfo.offset = ubo->GetOffset();
 				bufferInfo.range = ubo->GetSize();
+				if ( cacheDescriptorSets ) {
+					dynamicOffsets[ numDynamicOffsets++ ] = ubo->GetOffset();
+				} else {
+					bufferInfo.offset = ubo->GetOffset();
+				}
 
 				VkWriteDescriptorSet & write = writes[ writeIndex++ ];
 				memset( &write, 0, sizeof( VkWriteDescriptorSet ) );
 				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				write.dstSet = descSet;
 				write.dstBinding = bindingIndex++;
 				write.descriptorCount = 1;
-				write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				write.descriptorType = GetDescriptorType( binding );
 				write.pBufferInfo = &bufferInfo;
 				
 				break;
 			}
 			case BINDING_TYPE_SAMPLER: {
-				idImage * image = vkcontext.imageParms[ imageIndex ];
+				idImage * image = ( context != NULL ) ? context->imageParms[ imageIndex ] : vkcontext.imageParms[ imageIndex ];
 
 				VkDescriptorImageInfo & imageInfo = imageInfos[ imageIndex++ ];
 				memset( &imageInfo, 0, sizeof( VkDescriptorImageInfo ) );
@@ -911,7 +1070,6 @@ void idRenderProgManager::CommitCurrent( uint64 stateBits ) {
 				VkWriteDescriptorSet & write = writes[ writeIndex++ ];
 				memset( &write, 0, sizeof( VkWriteDescriptorSet ) );
 				write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-				write.dstSet = descSet;
 				write.dstBinding = bindingIndex++;
 				write.descriptorCount = 1;
 				write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -922,19 +1080,250 @@ void idRenderProgManager::CommitCurrent( uint64 stateBits ) {
 		}
 	}
 
-	vkUpdateDescriptorSets( vkcontext.device, writeIndex, writes, 0, NULL );
+	VkDescriptorSet descSet = VK_NULL_HANDLE;
+
+	descriptorSetKey_t key;
+	int keyHash = 0;
+	if ( cacheDescriptorSets && context == NULL ) {
+		keyHash = MakeDescriptorSetKey( prog.descriptorSetLayout, writes, writeIndex, key );
+
+		const idList< descriptorSetCacheEntry_t, TAG_RENDER > & cache = descriptorSetCache[ m_currentData ];
+		const idHashIndex & hash = descriptorSetHash[ m_currentData ];
+		for ( int i = hash.First( keyHash ); i != -1; i = hash.Next( i ) ) {
+			if ( CompareDescriptorSetKeys( cache[ i ].key, key ) ) {
+				descSet = cache[ i ].set;
+				break;
+			}
+		}
+	}
+
+	if ( context != NULL ) {
+		VkDescriptorSetAllocateInfo setAllocInfo = {};
+		setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		setAllocInfo.pNext = NULL;
+		setAllocInfo.descriptorPool = context->descriptorPool;
+		setAllocInfo.descriptorSetCount = 1;
+		setAllocInfo.pSetLayouts = &prog.descriptorSetLayout;
+
+		ID_VK_CHECK( vkAllocateDescriptorSets( vkcontext.device, &setAllocInfo, &descSet ) );
+
+		for ( int i = 0; i < writeIndex; ++i ) {
+			writes[ i ].dstSet = descSet;
+		}
+
+		vkUpdateDescriptorSets( vkcontext.device, writeIndex, writes, 0, NULL );
+	} else if ( descSet == VK_NULL_HANDLE ) {
+		VkDescriptorSetAllocateInfo setAllocInfo = {};
+		setAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		setAllocInfo.pNext = NULL;
+		setAllocInfo.descriptorPool = m_descriptorPools[ m_currentData ];
+		setAllocInfo.descriptorSetCount = 1;
+		setAllocInfo.pSetLayouts = &prog.descriptorSetLayout;
+
+		ID_VK_CHECK( vkAllocateDescriptorSets( vkcontext.device, &setAllocInfo, &m_descriptorSets[ m_currentData ][ m_currentDescSet ] ) );
+
+		descSet = m_descriptorSets[ m_currentData ][ m_currentDescSet ];
+		m_currentDescSet++;
+
+		for ( int i = 0; i < writeIndex; ++i ) {
+			writes[ i ].dstSet = descSet;
+		}
+
+		vkUpdateDescriptorSets( vkcontext.device, writeIndex, writes, 0, NULL );
+
+		if ( cacheDescriptorSets ) {
+			descriptorSetCacheEntry_t & entry = descriptorSetCache[ m_currentData ].Alloc();
+			entry.key = key;
+			entry.set = descSet;
+			descriptorSetHash[ m_currentData ].Add( keyHash, descriptorSetCache[ m_currentData ].Num() - 1 );
+		}
+	}
+
+	VkCommandBuffer commandBuffer = ( context != NULL ) ? context->commandBuffer : vkcontext.commandBuffer[ vkcontext.currentFrameData ];
 
 	vkCmdBindDescriptorSets( 
-		vkcontext.commandBuffer[ vkcontext.currentFrameData ], 
+		commandBuffer, 
 		VK_PIPELINE_BIND_POINT_GRAPHICS, 
 		prog.pipelineLayout, 0, 1, &descSet, 
-		0, NULL );
+		numDynamicOffsets, dynamicOffsets );
 	vkCmdBindPipeline( 
-		vkcontext.commandBuffer[ vkcontext.currentFrameData ], 
+		commandBuffer, 
 		VK_PIPELINE_BIND_POINT_GRAPHICS, 
 		pipeline );
 }
 
+/*
+========================
+idRenderProgManager::PreparePipeline
+
+Pipelines are created lazily and the list isn't safe to grow from a job,
+so any pipeline a record context will use has to be fetched here first.
+========================
+*/
+VkPipeline idRenderProgManager::PreparePipeline( int index, uint64 stateBits ) {
+	renderProg_t & prog = m_renderProgs[ index ];
+	return prog.GetPipeline( 
+		stateBits,
+		m_shaders[ prog.vertexShaderIndex ].module,
+		prog.fragmentShaderIndex != -1 ? m_shaders[ prog.fragmentShaderIndex ].module : VK_NULL_HANDLE );
+}
+
+/*
+========================
+idRenderProgManager::GetParmBlockBytes
+
+Worst case parm buffer space a single draw with this program consumes.
+========================
+*/
+int idRenderProgManager::GetParmBlockBytes( int index ) const {
+	const renderProg_t & prog = m_renderProgs[ index ];
+	const int alignment = (int)vkcontext.gpu->props.limits.minUniformBufferOffsetAlignment;
+
+	int bytes = 0;
+	if ( prog.vertexShaderIndex > -1 ) {
+		bytes += ALIGN( m_shaders[ prog.vertexShaderIndex ].parmIndices.Num() * (int)sizeof( idVec4 ), alignment );
+	}
+	if ( prog.fragmentShaderIndex > -1 ) {
+		bytes += ALIGN( m_shaders[ prog.fragmentShaderIndex ].parmIndices.Num() * (int)sizeof( idVec4 ), alignment );
+	}
+	return bytes;
+}
+
+/*
+========================
+idRenderProgManager::GetRecordParmCount
+
+Number of render parms a draw with this program reads, which is how many
+CaptureRecordParms writes.
+========================
+*/
+int idRenderProgManager::GetRecordParmCount( int index ) const {
+	const renderProg_t & prog = m_renderProgs[ index ];
+
+	int count = 0;
+	if ( prog.vertexShaderIndex > -1 ) {
+		count += m_shaders[ prog.vertexShaderIndex ].parmIndices.Num();
+	}
+	if ( prog.fragmentShaderIndex > -1 ) {
+		count += m_shaders[ prog.fragmentShaderIndex ].parmIndices.Num();
+	}
+	return count;
+}
+
+/*
+========================
+idRenderProgManager::GetRecordImageCount
+========================
+*/
+int idRenderProgManager::GetRecordImageCount( int index ) const {
+	const renderProg_t & prog = m_renderProgs[ index ];
+
+	int count = 0;
+	for ( int i = 0; i < prog.bindings.Num(); ++i ) {
+		if ( prog.bindings[ i ] == BINDING_TYPE_SAMPLER ) {
+			count++;
+		}
+	}
+	return count;
+}
+
+/*
+========================
+idRenderProgManager::CaptureRecordParms
+
+Copies the current values of the render parms the program reads so a draw can
+be recorded later from a job, after the render thread has moved on.
+========================
+*/
+void idRenderProgManager::CaptureRecordParms( int index, idVec4 * parms ) const {
+	const renderProg_t & prog = m_renderProgs[ index ];
+
+	int count = 0;
+	if ( prog.vertexShaderIndex > -1 ) {
+		const idList< int > & parmIndices = m_shaders[ prog.vertexShaderIndex ].parmIndices;
+		for ( int i = 0; i < parmIndices.Num(); ++i ) {
+			parms[ count++ ] = m_uniforms[ parmIndices[ i ] ];
+		}
+	}
+	if ( prog.fragmentShaderIndex > -1 ) {
+		const idList< int > & parmIndices = m_shaders[ prog.fragmentShaderIndex ].parmIndices;
+		for ( int i = 0; i < parmIndices.Num(); ++i ) {
+			parms[ count++ ] = m_uniforms[ parmIndices[ i ] ];
+		}
+	}
+}
+
+/*
+========================
+idRenderProgManager::BeginRecordContexts
+
+Hands out a descriptor pool and a slice of the frame's parm buffer to each context
+and snapshots the current render parms. Returns false if the frame doesn't have
+room left, in which case the caller should record on the render thread instead.
+========================
+*/
+bool idRenderProgManager::BeginRecordContexts( vkRecordContext_t * contexts, int numContexts, int maxDrawsPerContext, int parmBytesPerDraw ) {
+	assert( numContexts <= MAX_RECORD_CONTEXTS );
+
+	const int parmBytesPerContext = maxDrawsPerContext * parmBytesPerDraw;
+	if ( m_currentParmBufferOffset + numContexts * parmBytesPerContext > m_parmBuffers[ m_currentData ]->GetSize() ) {
+		return false;
+	}
+	for ( int i = 0; i < numContexts; ++i ) {
+		if ( m_recordPoolSets[ i ] + maxDrawsPerContext > MAX_RECORD_CONTEXT_SETS ) {
+			return false;
+		}
+	}
+
+	for ( int i = 0; i < numContexts; ++i ) {
+		vkRecordContext_t & context = contexts[ i ];
+		context.descriptorPool = m_recordPools[ m_currentData ][ i ];
+		context.parmBufferOffset = m_currentParmBufferOffset;
+		context.parmBufferEnd = m_currentParmBufferOffset + parmBytesPerContext;
+		memcpy( context.uniforms, m_uniforms.Ptr(), sizeof( context.uniforms ) );
+		memcpy( context.imageParms, vkcontext.imageParms.Ptr(), sizeof( context.imageParms ) );
+
+		m_recordPoolSets[ i ] += maxDrawsPerContext;
+		m_currentParmBufferOffset += parmBytesPerContext;
+	}
+
+	return true;
+}
+
+/*
+========================
+idRenderProgManager::CommitRecordContext
+
+Safe to call from any thread as long as each context is only used by one. Parms
+written by CaptureRecordParms are copied back into the uniforms first. Without a
+context the draw is committed to the frame's command buffer like CommitCurrent,
+which must then be done on the render thread.
+========================
+*/
+void idRenderProgManager::CommitRecordContext( vkRecordContext_t * context, int index, VkPipeline pipeline, vertCacheHandle_t jointCacheHandle, const idVec4 * parms ) {
+	const renderProg_t & prog = m_renderProgs[ index ];
+
+	if ( parms != NULL ) {
+		idVec4 * uniforms = ( context != NULL ) ? context->uniforms : m_uniforms.Ptr();
+
+		int count = 0;
+		if ( prog.vertexShaderIndex > -1 ) {
+			const idList< int > & parmIndices = m_shaders[ prog.vertexShaderIndex ].parmIndices;
+			for ( int i = 0; i < parmIndices.Num(); ++i ) {
+				uniforms[ parmIndices[ i ] ] = parms[ count++ ];
+			}
+		}
+		if ( prog.fragmentShaderIndex > -1 ) {
+			const idList< int > & parmIndices = m_shaders[ prog.fragmentShaderIndex ].parmIndices;
+			for ( int i = 0; i < parmIndices.Num(); ++i ) {
+				uniforms[ parmIndices[ i ] ] = parms[ count++ ];
+			}
+		}
+	}
+
+	CommitDescriptors( prog, pipeline, jointCacheHandle, context );
+}
+
 /*
 ========================
 idRenderProgManager::FindProgram
@@ -975,9 +1364,137 @@ int idRenderProgManager::FindProgram( const char * name, int vIndex, int fIndex
 	}
 
 	int index = m_renderProgs.Append( program );
+	WarmPipelines( index );
 	return index;
 }
 
+/*
+========================
+idRenderProgManager::LoadPipelineManifest
+========================
+*/
+void idRenderProgManager::LoadPipelineManifest() {
+	pipelineManifest.Clear();
+
+	if ( !r_vkWarmPipelines.GetBool() ) {
+		return;
+	}
+
+	idFileLocal file( fileSystem->OpenFileRead( PIPELINE_MANIFEST_FILE ) );
+	if ( file == NULL ) {
+		return;
+	}
+
+	unsigned int magic = 0;
+	int numEntries = 0;
+	file->ReadUnsignedInt( magic );
+	file->ReadInt( numEntries );
+	if ( magic != PIPELINE_MANIFEST_MAGIC || numEntries < 0 ) {
+		return;
+	}
+
+	pipelineManifest.SetNum( numEntries );
+	for ( int i = 0; i < numEntries; ++i ) {
+		pipelineManifestEntry_t & entry = pipelineManifest[ i ];
+		file->ReadString( entry.vertexShader );
+		file->ReadString( entry.fragmentShader );
+		file->Read( &entry.stateBits, sizeof( entry.stateBits ) );
+		if ( file->Read( entry.stencilOperations, sizeof( entry.stencilOperations ) ) != sizeof( entry.stencilOperations ) ) {
+			pipelineManifest.Clear();
+			return;
+		}
+		entry.warmed = false;
+	}
+}
+
+/*
+========================
+idRenderProgManager::SavePipelineManifest
+
+Entries from the previous session whose programs were never created this time
+are carried over so that a short session doesn't forget about the rest of the game.
+========================
+*/
+void idRenderProgManager::SavePipelineManifest() {
+	if ( !r_vkWarmPipelines.GetBool() ) {
+		return;
+	}
+
+	idList< pipelineManifestEntry_t > entries;
+	for ( int i = 0; i < m_renderProgs.Num(); ++i ) {
+		const renderProg_t & prog = m_renderProgs[ i ];
+		for ( int j = 0; j < prog.pipelines.Num(); ++j ) {
+			const renderProg_t::pipelineState_t & pipelineState = prog.pipelines[ j ];
+
+			pipelineManifestEntry_t & entry = entries.Alloc();
+			entry.vertexShader = m_shaders[ prog.vertexShaderIndex ].name;
+			entry.fragmentShader = ( prog.fragmentShaderIndex != -1 ) ? m_shaders[ prog.fragmentShaderIndex ].name.c_str() : "";
+			entry.stateBits = pipelineState.stateBits;
+			memcpy( entry.stencilOperations, pipelineState.stencilOperations, sizeof( entry.stencilOperations ) );
+		}
+	}
+	for ( int i = 0; i < pipelineManifest.Num(); ++i ) {
+		if ( !pipelineManifest[ i ].warmed ) {
+			entries.Append( pipelineManifest[ i ] );
+		}
+	}
+	pipelineManifest.Clear();
+
+	idFileLocal file( fileSystem->OpenFileWrite( PIPELINE_MANIFEST_FILE, "fs_savepath" ) );
+	if ( file == NULL ) {
+		return;
+	}
+
+	file->WriteUnsignedInt( PIPELINE_MANIFEST_MAGIC );
+	file->WriteInt( entries.Num() );
+	for ( int i = 0; i < entries.Num(); ++i ) {
+		const pipelineManifestEntry_t & entry = entries[ i ];
+		file->WriteString( entry.vertexShader );
+		file->WriteString( entry.fragmentShader );
+		file->Write( &entry.stateBits, sizeof( entry.stateBits ) );
+		file->Write( entry.stencilOperations, sizeof( entry.stencilOperations ) );
+	}
+}
+
+/*
+========================
+idRenderProgManager::WarmPipelines
+
+Builds every pipeline the manifest recorded for this program's shader pair.
+========================
+*/
+void idRenderProgManager::WarmPipelines( int programIndex ) {
+	if ( pipelineManifest.Num() == 0 ) {
+		return;
+	}
+
+	renderProg_t & prog = m_renderProgs[ programIndex ];
+	const char * vertexShaderName = m_shaders[ prog.vertexShaderIndex ].name;
+	const char * fragmentShaderName = ( prog.fragmentShaderIndex != -1 ) ? m_shaders[ prog.fragmentShaderIndex ].name.c_str() : "";
+	VkShaderModule vertexShader = m_shaders[ prog.vertexShaderIndex ].module;
+	VkShaderModule fragmentShader = ( prog.fragmentShaderIndex != -1 ) ? m_shaders[ prog.fragmentShaderIndex ].module : VK_NULL_HANDLE;
+
+	// GetPipeline keys separate stencil pipelines off the current stencil state
+	uint64 stencilOperations[ STENCIL_FACE_NUM ];
+	memcpy( stencilOperations, vkcontext.stencilOperations, sizeof( stencilOperations ) );
+
+	for ( int i = 0; i < pipelineManifest.Num(); ++i ) {
+		pipelineManifestEntry_t & entry = pipelineManifest[ i ];
+		if ( entry.warmed ) {
+			continue;
+		}
+		if ( entry.vertexShader.Icmp( vertexShaderName ) != 0 || entry.fragmentShader.Icmp( fragmentShaderName ) != 0 ) {
+			continue;
+		}
+
+		memcpy( vkcontext.stencilOperations, entry.stencilOperations, sizeof( vkcontext.stencilOperations ) );
+		prog.GetPipeline( entry.stateBits, vertexShader, fragmentShader );
+		entry.warmed = true;
+	}
+
+	memcpy( vkcontext.stencilOperations, stencilOperations, sizeof( stencilOperations ) );
+}
+
 /*
 ========================
 idRenderProgManager::LoadShader
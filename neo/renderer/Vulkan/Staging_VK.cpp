@@ -32,6 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "Staging_VK.h"
 
 idCVar r_vkUploadBufferSizeMB( "r_vkUploadBufferSizeMB", "64", CVAR_INTEGER | CVAR_INIT, "Size of gpu upload buffer." );
+idCVar r_vkUploadBufferMaxSizeMB( "r_vkUploadBufferMaxSizeMB", "256", CVAR_INTEGER | CVAR_INIT, "Largest size the gpu upload buffer may grow to." );
 
 /*
 ===========================================================================
@@ -53,8 +54,11 @@ idVulkanStagingManager::idVulkanStagingManager() :
 	m_currentBuffer( 0 ),
 	m_mappedData( NULL ),
 	m_memory( VK_NULL_HANDLE ),
-	m_commandPool( VK_NULL_HANDLE ) {
+	m_commandPool( VK_NULL_HANDLE ),
+	m_useTransferQueue( false ) {
 	
+	m_queueFamilyIndices[ 0 ] = 0;
+	m_queueFamilyIndices[ 1 ] = 0;
 }
 
 /*
@@ -72,7 +76,77 @@ idVulkanStagingManager::Init
 =============
 */
 void idVulkanStagingManager::Init() {
-	m_maxBufferSize = (size_t)( r_vkUploadBufferSizeMB.GetInteger() * 1024 * 1024 );
+	m_useTransferQueue = ( vkcontext.transferFamilyIdx >= 0 && vkcontext.transferQueue != VK_NULL_HANDLE );
+	m_queueFamilyIndices[ 0 ] = (uint32)vkcontext.graphicsFamilyIdx;
+	m_queueFamilyIndices[ 1 ] = (uint32)( m_useTransferQueue ? vkcontext.transferFamilyIdx : vkcontext.graphicsFamilyIdx );
+
+	AllocBuffers( r_vkUploadBufferSizeMB.GetInteger() * 1024 * 1024 );
+
+	VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = m_queueFamilyIndices[ 1 ];
+	ID_VK_CHECK( vkCreateCommandPool( vkcontext.device, &commandPoolCreateInfo, NULL, &m_commandPool ) );
+
+	VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	commandBufferAllocateInfo.commandPool = m_commandPool;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+
+	VkFenceCreateInfo fenceCreateInfo = {};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		ID_VK_CHECK( vkAllocateCommandBuffers( vkcontext.device, &commandBufferAllocateInfo, &m_buffers[ i ].commandBuffer ) );
+		ID_VK_CHECK( vkCreateFence( vkcontext.device, &fenceCreateInfo, NULL, &m_buffers[ i ].fence ) );
+		if ( m_useTransferQueue ) {
+			ID_VK_CHECK( vkCreateSemaphore( vkcontext.device, &semaphoreCreateInfo, NULL, &m_buffers[ i ].semaphore ) );
+		}
+		ID_VK_CHECK( vkBeginCommandBuffer( m_buffers[ i ].commandBuffer, &commandBufferBeginInfo ) );
+	}
+
+	idLib::Printf( "Staging uploads on the %s queue\n", m_useTransferQueue ? "transfer" : "graphics" );
+}
+
+/*
+=============
+idVulkanStagingManager::Shutdown
+=============
+*/
+void idVulkanStagingManager::Shutdown() {
+	FreeBuffers();
+
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		vkDestroyFence( vkcontext.device, m_buffers[ i ].fence, NULL );
+		if ( m_buffers[ i ].semaphore != VK_NULL_HANDLE ) {
+			vkDestroySemaphore( vkcontext.device, m_buffers[ i ].semaphore, NULL );
+		}
+		vkFreeCommandBuffers( vkcontext.device, m_commandPool, 1, &m_buffers[ i ].commandBuffer );
+	}
+	memset( m_buffers, 0, sizeof( m_buffers ) );
+
+	vkDestroyCommandPool( vkcontext.device, m_commandPool, NULL );
+	m_commandPool = VK_NULL_HANDLE;
+
+	m_currentBuffer = 0;
+	m_useTransferQueue = false;
+}
+
+/*
+=============
+idVulkanStagingManager::AllocBuffers
+
+All staging buffers share a single persistently mapped allocation.
+=============
+*/
+void idVulkanStagingManager::AllocBuffers( const int bufferSize ) {
+	m_maxBufferSize = bufferSize;
 
 	VkBufferCreateInfo bufferCreateInfo = {};
 	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -104,51 +178,93 @@ void idVulkanStagingManager::Init() {
 
 	ID_VK_CHECK( vkMapMemory( vkcontext.device, m_memory, 0, alignedSize * NUM_FRAME_DATA, 0, reinterpret_cast< void ** >( &m_mappedData ) ) );
 
-	VkCommandPoolCreateInfo commandPoolCreateInfo = {};
-	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-	commandPoolCreateInfo.queueFamilyIndex = vkcontext.graphicsFamilyIdx;
-	ID_VK_CHECK( vkCreateCommandPool( vkcontext.device, &commandPoolCreateInfo, NULL, &m_commandPool ) );
-
-	VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
-	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	commandBufferAllocateInfo.commandPool = m_commandPool;
-	commandBufferAllocateInfo.commandBufferCount = 1;
-
-	VkFenceCreateInfo fenceCreateInfo = {};
-	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-
-	VkCommandBufferBeginInfo commandBufferBeginInfo = {};
-	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-
 	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
-		ID_VK_CHECK( vkAllocateCommandBuffers( vkcontext.device, &commandBufferAllocateInfo, &m_buffers[ i ].commandBuffer ) );
-		ID_VK_CHECK( vkCreateFence( vkcontext.device, &fenceCreateInfo, NULL, &m_buffers[ i ].fence ) );
-		ID_VK_CHECK( vkBeginCommandBuffer( m_buffers[ i ].commandBuffer, &commandBufferBeginInfo ) );
-
 		m_buffers[ i ].data = (byte *)m_mappedData + (i * alignedSize);
 	}
 }
 
 /*
 =============
-idVulkanStagingManager::Shutdown
+idVulkanStagingManager::FreeBuffers
 =============
 */
-void idVulkanStagingManager::Shutdown() {
+void idVulkanStagingManager::FreeBuffers() {
 	vkUnmapMemory( vkcontext.device, m_memory );
-	m_memory = VK_NULL_HANDLE;
-	m_mappedData = NULL;
 
 	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
-		vkDestroyFence( vkcontext.device, m_buffers[ i ].fence, NULL );
 		vkDestroyBuffer( vkcontext.device, m_buffers[ i ].buffer, NULL );
-		vkFreeCommandBuffers( vkcontext.device, m_commandPool, 1, &m_buffers[ i ].commandBuffer );
+		m_buffers[ i ].buffer = VK_NULL_HANDLE;
+		m_buffers[ i ].data = NULL;
+		m_buffers[ i ].offset = 0;
 	}
-	memset( m_buffers, 0, sizeof( m_buffers ) );
 
+	vkFreeMemory( vkcontext.device, m_memory, NULL );
+	m_memory = VK_NULL_HANDLE;
+	m_mappedData = NULL;
 	m_maxBufferSize = 0;
-	m_currentBuffer = 0;
+}
+
+/*
+=============
+idVulkanStagingManager::Grow
+
+Submits and drains every pending upload, then reallocates the staging
+buffers large enough to hold a single upload of the requested size.
+=============
+*/
+void idVulkanStagingManager::Grow( const int size ) {
+	int newSize = m_maxBufferSize;
+	while ( newSize <= size ) {
+		newSize *= 2;
+	}
+
+	const int maxSize = Max( r_vkUploadBufferMaxSizeMB.GetInteger(), r_vkUploadBufferSizeMB.GetInteger() ) * 1024 * 1024;
+	if ( newSize > maxSize ) {
+		if ( size >= maxSize ) {
+			idLib::FatalError( "Can't allocate %d MB in gpu transfer buffer", (int)( size / 1024 / 1024 ) );
+		}
+		newSize = maxSize;
+	}
+
+	Flush();
+	for ( int i = 0; i < NUM_FRAME_DATA; ++i ) {
+		Wait( m_buffers[ i ] );
+	}
+
+	FreeBuffers();
+	AllocBuffers( newSize );
+
+	idLib::Printf( "Staging buffers grown to %d MB\n", newSize / 1024 / 1024 );
+}
+
+/*
+=============
+idVulkanStagingManager::SetSharingMode
+=============
+*/
+void idVulkanStagingManager::SetSharingMode( VkBufferCreateInfo & createInfo ) const {
+	if ( !m_useTransferQueue ) {
+		createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		return;
+	}
+	createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+	createInfo.queueFamilyIndexCount = 2;
+	createInfo.pQueueFamilyIndices = m_queueFamilyIndices;
+}
+
+/*
+=============
+idVulkanStagingManager::SetSharingMode
+=============
+*/
+void idVulkanStagingManager::SetSharingMode( VkImageCreateInfo & createInfo ) const {
+	if ( !m_useTransferQueue ) {
+		createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		return;
+	}
+	createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+	createInfo.queueFamilyIndexCount = 2;
+	createInfo.pQueueFamilyIndices = m_queueFamilyIndices;
 }
 
 /*
@@ -157,8 +273,8 @@ idVulkanStagingManager::Stage
 =============
 */
 byte * idVulkanStagingManager::Stage( const int size, const int alignment, VkCommandBuffer & commandBuffer, VkBuffer & buffer, int & bufferOffset ) {
-	if ( size > m_maxBufferSize ) {
-		idLib::FatalError( "Can't allocate %d MB in gpu transfer buffer", (int)( size / 1024 / 1024 ) );
+	if ( size >= m_maxBufferSize ) {
+		Grow( size );
 	}
 
 	stagingBuffer_t * stage = &m_buffers[ m_currentBuffer ];
@@ -187,6 +303,10 @@ byte * idVulkanStagingManager::Stage( const int size, const int alignment, VkCom
 /*
 =============
 idVulkanStagingManager::Flush
+
+On the transfer queue the copies run alongside the graphics work already in
+flight. The graphics queue is handed a wait on the stage's semaphore so that
+anything it executes after this point sees the uploaded data.
 =============
 */
 void idVulkanStagingManager::Flush() {
@@ -195,15 +315,17 @@ void idVulkanStagingManager::Flush() {
 		return;
 	}
 
-	VkMemoryBarrier barrier = {};
-	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-	barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
-	vkCmdPipelineBarrier( 
-		stage.commandBuffer, 
-		VK_PIPELINE_STAGE_TRANSFER_BIT, 
-		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 
-		0, 1, &barrier, 0, NULL, 0, NULL );
+	if ( !m_useTransferQueue ) {
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+		vkCmdPipelineBarrier( 
+			stage.commandBuffer, 
+			VK_PIPELINE_STAGE_TRANSFER_BIT, 
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 
+			0, 1, &barrier, 0, NULL, 0, NULL );
+	}
 
 	vkEndCommandBuffer( stage.commandBuffer );
 
@@ -218,7 +340,27 @@ void idVulkanStagingManager::Flush() {
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &stage.commandBuffer;
 
-	vkQueueSubmit( vkcontext.graphicsQueue, 1, &submitInfo, stage.fence );
+	if ( m_useTransferQueue ) {
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &stage.semaphore;
+
+		ID_VK_CHECK( vkQueueSubmit( vkcontext.transferQueue, 1, &submitInfo, stage.fence ) );
+
+		// A semaphore wait also orders every later submission on the graphics queue,
+		// so an empty batch is enough and the semaphore is unsignaled again before
+		// this stage can be reused.
+		const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+		VkSubmitInfo waitInfo = {};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		waitInfo.waitSemaphoreCount = 1;
+		waitInfo.pWaitSemaphores = &stage.semaphore;
+		waitInfo.pWaitDstStageMask = &waitStage;
+
+		ID_VK_CHECK( vkQueueSubmit( vkcontext.graphicsQueue, 1, &waitInfo, VK_NULL_HANDLE ) );
+	} else {
+		vkQueueSubmit( vkcontext.graphicsQueue, 1, &submitInfo, stage.fence );
+	}
 
 	stage.submitted = true;
 
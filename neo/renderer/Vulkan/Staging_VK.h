@@ -43,6 +43,7 @@ struct stagingBuffer_t {
 		commandBuffer( VK_NULL_HANDLE ),
 		buffer( VK_NULL_HANDLE ),
 		fence( VK_NULL_HANDLE ),
+		semaphore( VK_NULL_HANDLE ),
 		offset( 0 ),
 		data( NULL ) {}
 
@@ -50,6 +51,7 @@ struct stagingBuffer_t {
 	VkCommandBuffer		commandBuffer;
 	VkBuffer			buffer;
 	VkFence				fence;
+	VkSemaphore			semaphore;		// signaled by the transfer queue, waited on by the graphics queue
 	VkDeviceSize		offset;
 	byte *				data;
 };
@@ -65,7 +67,18 @@ public:
 	byte *			Stage( const int size, const int alignment, VkCommandBuffer & commandBuffer, VkBuffer & buffer, int & bufferOffset );
 	void			Flush();
 
+	// True when uploads are recorded and submitted on a dedicated transfer queue.
+	bool			UsesTransferQueue() const { return m_useTransferQueue; }
+
+	// Resources written by the transfer queue and read by the graphics queue are shared
+	// concurrently between both families so no ownership transfers are needed.
+	void			SetSharingMode( VkBufferCreateInfo & createInfo ) const;
+	void			SetSharingMode( VkImageCreateInfo & createInfo ) const;
+
 private:
+	void			AllocBuffers( const int bufferSize );
+	void			FreeBuffers();
+	void			Grow( const int size );
 	void			Wait( stagingBuffer_t & stage );
 
 private:
@@ -75,6 +88,9 @@ private:
 	VkDeviceMemory	m_memory;
 	VkCommandPool	m_commandPool;
 
+	bool			m_useTransferQueue;
+	uint32			m_queueFamilyIndices[ 2 ];
+
 	stagingBuffer_t m_buffers[ NUM_FRAME_DATA ];
 };
 
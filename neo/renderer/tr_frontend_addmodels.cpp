@@ -41,6 +41,7 @@ idCVar r_skipStaticShadows( "r_skipStaticShadows", "0", CVAR_RENDERER | CVAR_BOO
 idCVar r_skipDynamicShadows( "r_skipDynamicShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip dynamic shadows" );
 idCVar r_useParallelAddModels( "r_useParallelAddModels", "1", CVAR_RENDERER | CVAR_BOOL, "add all models in parallel with jobs" );
 idCVar r_useParallelAddShadows( "r_useParallelAddShadows", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = off, 1 = threaded", 0, 1 );
+idCVar r_useEntityFrustumCulling( "r_useEntityFrustumCulling", "1", CVAR_RENDERER | CVAR_BOOL, "cull the view entities to the view frustum in batches before adding them" );
 idCVar r_useShadowPreciseInsideTest( "r_useShadowPreciseInsideTest", "1", CVAR_RENDERER | CVAR_BOOL, "use a precise and more expensive test to determine whether the view is inside a shadow volume" );
 idCVar r_cullDynamicShadowTriangles( "r_cullDynamicShadowTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull occluder triangles that are outside the light frustum so they do not contribute to the dynamic shadow volume" );
 idCVar r_cullDynamicLightTriangles( "r_cullDynamicLightTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull surface triangles that are outside the light frustum so they do not get rendered for interactions" );
@@ -979,6 +980,26 @@ void R_AddSingleModel( viewEntity_t * vEntity ) {
 
 REGISTER_PARALLEL_JOB( R_AddSingleModel, "R_AddSingleModel" );
 
+/*
+===================
+R_AddSingleModelShadows
+
+Sets up the shadow volumes R_AddSingleModel queued on the view entity.
+===================
+*/
+static void R_AddSingleModelShadows( viewEntity_t * vEntity ) {
+	for ( staticShadowVolumeParms_t * shadowParms = vEntity->staticShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next ) {
+		StaticShadowVolumeJob( shadowParms );
+	}
+	for ( dynamicShadowVolumeParms_t * shadowParms = vEntity->dynamicShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next ) {
+		DynamicShadowVolumeJob( shadowParms );
+	}
+	vEntity->staticShadowVolumes = NULL;
+	vEntity->dynamicShadowVolumes = NULL;
+}
+
+REGISTER_PARALLEL_JOB( R_AddSingleModelShadows, "R_AddSingleModelShadows" );
+
 /*
 =================
 R_LinkDrawSurfToView
@@ -1007,6 +1028,161 @@ void R_LinkDrawSurfToView( drawSurf_t * drawSurf, viewDef_t * viewDef ) {
 	viewDef->numDrawSurfs++;
 }
 
+/*
+===================
+R_CullViewEntityBounds
+
+Tests the global reference bounds of a batch of entities, stored as structure-of-arrays,
+against the view frustum planes. Sets cullBits[i] when the bounds of entity i are
+completely outside the view frustum. The arrays are padded to a multiple of four.
+===================
+*/
+static void R_CullViewEntityBounds( byte * cullBits, const idPlane * planes, const int numPlanes,
+									const float * minX, const float * minY, const float * minZ,
+									const float * maxX, const float * maxY, const float * maxZ, const int numEntities ) {
+	assert_16_byte_aligned( cullBits );
+	assert_16_byte_aligned( minX );
+	assert_16_byte_aligned( maxX );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vector_float_zero = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	for ( int i = 0; i < numEntities; i += 4 ) {
+		const __m128 bMinX = _mm_load_ps( minX + i );
+		const __m128 bMinY = _mm_load_ps( minY + i );
+		const __m128 bMinZ = _mm_load_ps( minZ + i );
+		const __m128 bMaxX = _mm_load_ps( maxX + i );
+		const __m128 bMaxY = _mm_load_ps( maxY + i );
+		const __m128 bMaxZ = _mm_load_ps( maxZ + i );
+
+		__m128 culled = vector_float_zero;
+
+		for ( int j = 0; j < numPlanes; j++ ) {
+			const idPlane & plane = planes[j];
+
+			// the frustum planes face outward so test the corner closest to the inside of the frustum
+			const __m128 vX = ( plane[0] >= 0.0f ) ? bMinX : bMaxX;
+			const __m128 vY = ( plane[1] >= 0.0f ) ? bMinY : bMaxY;
+			const __m128 vZ = ( plane[2] >= 0.0f ) ? bMinZ : bMaxZ;
+
+			const __m128 pX = _mm_set1_ps( plane[0] );
+			const __m128 pY = _mm_set1_ps( plane[1] );
+			const __m128 pZ = _mm_set1_ps( plane[2] );
+			const __m128 pW = _mm_set1_ps( plane[3] );
+
+			const __m128 d = _mm_madd_ps( vX, pX, _mm_madd_ps( vY, pY, _mm_madd_ps( vZ, pZ, pW ) ) );
+
+			culled = _mm_or_ps( culled, _mm_cmpgt_ps( d, vector_float_zero ) );
+		}
+
+		const int mask = _mm_movemask_ps( culled );
+		cullBits[i + 0] = (byte)( ( mask >> 0 ) & 1 );
+		cullBits[i + 1] = (byte)( ( mask >> 1 ) & 1 );
+		cullBits[i + 2] = (byte)( ( mask >> 2 ) & 1 );
+		cullBits[i + 3] = (byte)( ( mask >> 3 ) & 1 );
+	}
+
+#else
+
+	for ( int i = 0; i < numEntities; i++ ) {
+		byte culled = 0;
+		for ( int j = 0; j < numPlanes; j++ ) {
+			const idPlane & plane = planes[j];
+			const float vX = ( plane[0] >= 0.0f ) ? minX[i] : maxX[i];
+			const float vY = ( plane[1] >= 0.0f ) ? minY[i] : maxY[i];
+			const float vZ = ( plane[2] >= 0.0f ) ? minZ[i] : maxZ[i];
+			if ( vX * plane[0] + vY * plane[1] + vZ * plane[2] + plane[3] > 0.0f ) {
+				culled = 1;
+			}
+		}
+		cullBits[i] = culled;
+	}
+
+#endif
+}
+
+/*
+===================
+R_CullViewEntities
+
+Culls all view entities to the view frustum before any per-entity work is started.
+The bounds are gathered into contiguous arrays so four entities are tested per
+iteration. Entities that were seen through a portal but are completely outside the
+view frustum can't be directly visible, so they get an empty scissor rect. Entities
+that are then neither visible nor interact with a light are flagged to be skipped.
+===================
+*/
+static byte * R_CullViewEntities( const viewDef_t * viewDef, int & numViewEntities ) {
+	SCOPED_PROFILE_EVENT( "R_CullViewEntities" );
+
+	numViewEntities = 0;
+	for ( viewEntity_t * vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
+		numViewEntities++;
+	}
+	if ( numViewEntities == 0 ) {
+		return NULL;
+	}
+
+	const int numPadded = ( numViewEntities + 3 ) & ~3;
+	float * bounds = (float *)renderSystem->FrameAlloc( numPadded * 6 * sizeof( float ), FRAME_ALLOC_UNKNOWN );
+	float * minX = bounds + numPadded * 0;
+	float * minY = bounds + numPadded * 1;
+	float * minZ = bounds + numPadded * 2;
+	float * maxX = bounds + numPadded * 3;
+	float * maxY = bounds + numPadded * 4;
+	float * maxZ = bounds + numPadded * 5;
+	byte * cullBits = (byte *)renderSystem->FrameAlloc( numPadded * sizeof( byte ), FRAME_ALLOC_UNKNOWN );
+
+	int index = 0;
+	for ( viewEntity_t * vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next, index++ ) {
+		const idBounds & b = vEntity->entityDef->globalReferenceBounds;
+		minX[index] = b[0][0];
+		minY[index] = b[0][1];
+		minZ[index] = b[0][2];
+		maxX[index] = b[1][0];
+		maxY[index] = b[1][1];
+		maxZ[index] = b[1][2];
+	}
+	for ( ; index < numPadded; index++ ) {
+		minX[index] = minY[index] = minZ[index] = 0.0f;
+		maxX[index] = maxY[index] = maxZ[index] = 0.0f;
+	}
+
+	// skip the far plane, the same as the portal flow
+	R_CullViewEntityBounds( cullBits, viewDef->frustum, 5, minX, minY, minZ, maxX, maxY, maxZ, numPadded );
+
+	index = 0;
+	for ( viewEntity_t * vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next, index++ ) {
+		if ( !cullBits[index] ) {
+			continue;
+		}
+		// depth hacked models are drawn in front of everything, so leave them alone
+		// the viewEntity copies of the depth hack values are only set later by R_AddSingleModel,
+		// and modelDepthHack is only set once the dynamic model is created, so test the model as well
+		const renderEntity_t & parms = vEntity->entityDef->parms;
+		if ( parms.weaponDepthHack || parms.modelDepthHack != 0.0f || ( parms.hModel != NULL && parms.hModel->DepthHack() != 0.0f ) ) {
+			cullBits[index] = 0;
+			continue;
+		}
+		vEntity->scissorRect.Clear();
+
+		// the entity may still be needed to cast shadows into the view
+		const int entityIndex = vEntity->entityDef->index;
+		for ( const viewLight_t * vLight = viewDef->viewLights; vLight != NULL; vLight = vLight->next ) {
+			if ( vLight->scissorRect.IsEmpty() ) {
+				continue;
+			}
+			if ( vLight->entityInteractionState == NULL || vLight->entityInteractionState[entityIndex] == viewLight_t::INTERACTION_YES ) {
+				cullBits[index] = 0;
+				break;
+			}
+		}
+	}
+
+	return cullBits;
+}
+
 /*
 ===================
 idRenderSystemLocal::AddModels
@@ -1021,19 +1197,55 @@ void idRenderSystemLocal::AddModels() {
 
 	m_viewDef->viewEntitys = R_SortViewEntities( m_viewDef->viewEntitys );
 
+	//-------------------------------------------------
+	// Cull the view entities to the view frustum in batches so entities
+	// that can't contribute anything don't spawn any per-entity work.
+	//-------------------------------------------------
+
+	int numViewEntities = 0;
+	byte * entityCulled = NULL;
+	if ( r_useEntityFrustumCulling.GetBool() ) {
+		entityCulled = R_CullViewEntities( m_viewDef, numViewEntities );
+	}
+
+	if ( entityCulled != NULL ) {
+		int index = 0;
+		for ( viewEntity_t * vEntity = m_viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next, index++ ) {
+			if ( entityCulled[index] ) {
+				// same state R_AddSingleModel leaves behind when it doesn't add anything
+				vEntity->drawSurfs = NULL;
+				vEntity->staticShadowVolumes = NULL;
+				vEntity->dynamicShadowVolumes = NULL;
+			}
+		}
+	}
+
 	//-------------------------------------------------
 	// Go through each view entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows).
 	//-------------------------------------------------
 
 	if ( r_useParallelAddModels.GetBool() ) {
-		for ( viewEntity_t * vEntity = m_viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
-			m_frontEndJobList->AddJob( (jobRun_t)R_AddSingleModel, vEntity );
+		// the shadow volumes of an entity can be set up as soon as its own model job is done
+		const bool chainShadows = ( r_useParallelAddShadows.GetInteger() == 1 );
+		int index = 0;
+		for ( viewEntity_t * vEntity = m_viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next, index++ ) {
+			if ( entityCulled != NULL && entityCulled[index] ) {
+				continue;
+			}
+			jobHandle_t modelJob = m_frontEndJobList->AddJob( (jobRun_t)R_AddSingleModel, vEntity );
+			if ( chainShadows ) {
+				m_frontEndJobList->AddJob( (jobRun_t)R_AddSingleModelShadows, vEntity, modelJob );
+			}
 		}
 		m_frontEndJobList->Submit();
 		m_frontEndJobList->Wait();
 	} else {
-		for ( viewEntity_t * vEntity = m_viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
+		int index = 0;
+		for ( viewEntity_t * vEntity = m_viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next, index++ ) {
+			if ( entityCulled != NULL && entityCulled[index] ) {
+				continue;
+			}
 			R_AddSingleModel( vEntity );
 		}
 	}
@@ -1043,6 +1255,7 @@ void idRenderSystemLocal::AddModels() {
 	//-------------------------------------------------
 
 	if ( r_useParallelAddShadows.GetInteger() == 1 ) {
+		// nothing is left to do here for entities whose shadows were chained to their model job
 		for ( viewEntity_t * vEntity = m_viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
 			for ( staticShadowVolumeParms_t * shadowParms = vEntity->staticShadowVolumes; shadowParms != NULL; shadowParms = shadowParms->next ) {
 				m_frontEndJobList->AddJob( (jobRun_t)StaticShadowVolumeJob, shadowParms );
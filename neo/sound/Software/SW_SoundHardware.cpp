@@ -0,0 +1,659 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+Copyright (C) 2016-2017 Dustin Land
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+#pragma hdrstop
+#include "../../idlib/precompiled.h"
+#include "../snd_local.h"
+
+#if defined( ID_SOUND_SOFTWARE )
+
+idCVar s_swOutput( "s_swOutput", "0", CVAR_INTEGER, "Software mixer output: 0 = discard the mix, 1 = write it to s_swOutputFile", 0, 1 );
+idCVar s_swOutputFile( "s_swOutputFile", "soundmix.wav", 0, "Wave file the software mixer writes to when s_swOutput is 1" );
+idCVar s_swOutputChannels( "s_swOutputChannels", "2", CVAR_INTEGER|CVAR_ARCHIVE, "Number of channels the software mixer produces, 2 or 6" );
+idCVar s_swRealTime( "s_swRealTime", "1", CVAR_BOOL, "Pace the software mixer to wall clock time instead of mixing as fast as possible" );
+idCVar s_showPerfData( "s_showPerfData", "0", CVAR_BOOL, "Show software mixer performance data" );
+extern idCVar s_volume_dB;
+
+// The whole system runs at this sample rate
+static const int SW_OUTPUT_SAMPLE_RATE = 44100;
+
+/*
+================================================
+idSoundCommandQueue_Software
+================================================
+*/
+
+/*
+========================
+idSoundCommandQueue_Software::Push
+========================
+*/
+bool idSoundCommandQueue_Software::Push( const swCommand_t & cmd ) {
+	const int write = writeIndex;
+	if ( write - readIndex >= QUEUE_SIZE ) {
+		return false;
+	}
+	commands[ write & ( QUEUE_SIZE - 1 ) ] = cmd;
+	// the command has to be visible before the mixer sees the new index
+	SYS_MEMORYBARRIER;
+	writeIndex = write + 1;
+	return true;
+}
+
+/*
+========================
+idSoundCommandQueue_Software::Pop
+========================
+*/
+bool idSoundCommandQueue_Software::Pop( swCommand_t & cmd ) {
+	const int read = readIndex;
+	if ( read == writeIndex ) {
+		return false;
+	}
+	SYS_MEMORYBARRIER;
+	cmd = commands[ read & ( QUEUE_SIZE - 1 ) ];
+	// don't hand the slot back before the command has been copied out
+	SYS_MEMORYBARRIER;
+	readIndex = read + 1;
+	return true;
+}
+
+/*
+================================================
+idSoundMixerThread_Software
+================================================
+*/
+
+/*
+========================
+idSoundMixerThread_Software::Run
+========================
+*/
+int idSoundMixerThread_Software::Run() {
+	// stay this far ahead of the wall clock
+	const int64 leadMicroseconds = 2 * SW_MIX_BLOCK_FRAMES * 1000000LL / hardware->GetOutputSampleRate();
+
+	uint64 startTime = Sys_Microseconds();
+	int64 mixedFrames = 0;
+
+	while ( !IsTerminating() ) {
+		hardware->MixBlock();
+
+		if ( !s_swRealTime.GetBool() ) {
+			startTime = Sys_Microseconds();
+			mixedFrames = 0;
+			continue;
+		}
+
+		mixedFrames += SW_MIX_BLOCK_FRAMES;
+		const int64 mixedMicroseconds = mixedFrames * 1000000LL / hardware->GetOutputSampleRate();
+		const int64 elapsed = (int64)( Sys_Microseconds() - startTime );
+
+		if ( elapsed > mixedMicroseconds + 1000000LL ) {
+			// fell more than a second behind, probably a hitch or a breakpoint, so don't try to catch up
+			startTime = Sys_Microseconds();
+			mixedFrames = 0;
+			continue;
+		}
+
+		while ( !IsTerminating() && (int64)( Sys_Microseconds() - startTime ) + leadMicroseconds < mixedMicroseconds ) {
+			Sys_Sleep( 1 );
+		}
+	}
+	return 0;
+}
+
+/*
+================================================
+idSoundHardware_Software
+================================================
+*/
+
+/*
+========================
+WriteWaveHeader
+========================
+*/
+static void WriteWaveHeader( idFile * f, int numChannels, int sampleRate, int dataBytes ) {
+	f->Write( "RIFF", 4 );
+	f->WriteInt( 36 + dataBytes );
+	f->Write( "WAVE", 4 );
+	f->Write( "fmt ", 4 );
+	f->WriteInt( 16 );
+	f->WriteUnsignedShort( idWaveFile::FORMAT_PCM );
+	f->WriteUnsignedShort( numChannels );
+	f->WriteInt( sampleRate );
+	f->WriteInt( sampleRate * numChannels * sizeof( short ) );
+	f->WriteUnsignedShort( numChannels * sizeof( short ) );
+	f->WriteUnsignedShort( 16 );
+	f->Write( "data", 4 );
+	f->WriteInt( dataBytes );
+}
+
+/*
+========================
+BenchmarkSoundMixer_f
+========================
+*/
+static void BenchmarkSoundMixer_f( const idCmdArgs & args ) {
+	if ( args.Argc() > 4 ) {
+		idLib::Printf( "usage: benchmarkSoundMixer [numVoices] [numBlocks] [sampleName]\n" );
+		return;
+	}
+	const int numVoices = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 256;
+	const int numBlocks = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 1000;
+	const char * sampleName = ( args.Argc() > 3 ) ? args.Argv( 3 ) : NULL;
+
+	soundSystemLocal.hardware.Benchmark( numVoices, numBlocks, sampleName );
+}
+
+/*
+========================
+idSoundHardware_Software::idSoundHardware_Software
+========================
+*/
+idSoundHardware_Software::idSoundHardware_Software() {
+	outputChannels = 0;
+	channelMask = 0;
+	outputSampleRate = SW_OUTPUT_SAMPLE_RATE;
+
+	masterVolume = 1.0f;
+
+	memset( mixBuffers, 0, sizeof( mixBuffers ) );
+	memset( resampleBuffers, 0, sizeof( resampleBuffers ) );
+	outputBuffer = NULL;
+
+	outputFile = NULL;
+	outputBytes = 0;
+
+	statBlocks = 0;
+	statVoices = 0;
+	statMicroseconds = 0;
+	lastStatBlocks = 0;
+	lastStatMicroseconds = 0;
+
+	voices.SetNum( 0 );
+	zombieVoices.SetNum( 0 );
+	freeVoices.SetNum( 0 );
+}
+
+/*
+========================
+idSoundHardware_Software::Init
+========================
+*/
+void idSoundHardware_Software::Init() {
+
+	cmdSystem->AddCommand( "benchmarkSoundMixer", BenchmarkSoundMixer_f, 0, "Mixes a number of looping voices without output and prints the mixer cost", NULL );
+
+	outputSampleRate = SW_OUTPUT_SAMPLE_RATE;
+	if ( s_swOutputChannels.GetInteger() >= 6 ) {
+		outputChannels = 6;
+		channelMask = idWaveFile::CHANNEL_MASK_FRONT_LEFT | idWaveFile::CHANNEL_MASK_FRONT_RIGHT | idWaveFile::CHANNEL_MASK_FRONT_CENTER
+					| idWaveFile::CHANNEL_MASK_LOW_FREQUENCY | idWaveFile::CHANNEL_MASK_BACK_LEFT | idWaveFile::CHANNEL_MASK_BACK_RIGHT;
+	} else {
+		outputChannels = 2;
+		channelMask = idWaveFile::CHANNEL_MASK_FRONT_LEFT | idWaveFile::CHANNEL_MASK_FRONT_RIGHT;
+	}
+
+	idSoundVoice::InitSurround( outputChannels, channelMask );
+
+	masterVolume = DBtoLinear( s_volume_dB.GetFloat() );
+
+	AllocMixBuffers();
+	OpenOutput();
+
+	voices.SetNum( voices.Max() );
+	freeVoices.SetNum( voices.Max() );
+	zombieVoices.SetNum( 0 );
+	for ( int i = 0; i < voices.Num(); i++ ) {
+		voices[i].Reset( this );
+		freeVoices[i] = &voices[i];
+	}
+
+	mixerThread.hardware = this;
+	mixerThread.StartThread( "SoundMixer", CORE_ANY, THREAD_ABOVE_NORMAL );
+
+	idLib::Printf( "Software mixer: %d channels at %d Hz, %s\n", outputChannels, outputSampleRate, ( outputFile != NULL ) ? outputFile->GetFullPath() : "no output" );
+}
+
+/*
+========================
+idSoundHardware_Software::InitOffline
+========================
+*/
+void idSoundHardware_Software::InitOffline( int numOutputChannels, int sampleRate ) {
+	outputChannels = numOutputChannels;
+	outputSampleRate = sampleRate;
+	masterVolume = 1.0f;
+	AllocMixBuffers();
+}
+
+/*
+========================
+idSoundHardware_Software::Shutdown
+========================
+*/
+void idSoundHardware_Software::Shutdown() {
+	mixerThread.StopThread();
+
+	// nothing will mix again, so drop whatever is still queued
+	swCommand_t cmd;
+	while ( commandQueue.Pop( cmd ) ) {
+	}
+	mixVoices.Clear();
+
+	voices.Clear();
+	freeVoices.Clear();
+	zombieVoices.Clear();
+
+	CloseOutput();
+	FreeMixBuffers();
+
+	outputChannels = 0;
+}
+
+/*
+========================
+idSoundHardware_Software::AllocMixBuffers
+========================
+*/
+void idSoundHardware_Software::AllocMixBuffers() {
+	FreeMixBuffers();
+	for ( int i = 0; i < MAX_CHANNELS_PER_VOICE; i++ ) {
+		mixBuffers[i] = (float *)Mem_Alloc16( SW_MIX_BLOCK_FRAMES * sizeof( float ), TAG_AUDIO );
+		resampleBuffers[i] = (float *)Mem_Alloc16( SW_MIX_BLOCK_FRAMES * sizeof( float ), TAG_AUDIO );
+	}
+	outputBuffer = (short *)Mem_Alloc16( SW_MIX_BLOCK_FRAMES * MAX_CHANNELS_PER_VOICE * sizeof( short ), TAG_AUDIO );
+	mixVoices.Resize( MAX_HARDWARE_VOICES * 2 );
+}
+
+/*
+========================
+idSoundHardware_Software::FreeMixBuffers
+========================
+*/
+void idSoundHardware_Software::FreeMixBuffers() {
+	for ( int i = 0; i < MAX_CHANNELS_PER_VOICE; i++ ) {
+		if ( mixBuffers[i] != NULL ) {
+			Mem_Free16( mixBuffers[i] );
+			mixBuffers[i] = NULL;
+		}
+		if ( resampleBuffers[i] != NULL ) {
+			Mem_Free16( resampleBuffers[i] );
+			resampleBuffers[i] = NULL;
+		}
+	}
+	if ( outputBuffer != NULL ) {
+		Mem_Free16( outputBuffer );
+		outputBuffer = NULL;
+	}
+}
+
+/*
+========================
+idSoundHardware_Software::OpenOutput
+========================
+*/
+void idSoundHardware_Software::OpenOutput() {
+	outputFile = NULL;
+	outputBytes = 0;
+
+	if ( s_swOutput.GetInteger() != 1 ) {
+		return;
+	}
+	outputFile = fileSystem->OpenFileWrite( s_swOutputFile.GetString() );
+	if ( outputFile == NULL ) {
+		idLib::Warning( "Couldn't open %s for the software mixer output", s_swOutputFile.GetString() );
+		return;
+	}
+	// the sizes are patched in CloseOutput
+	WriteWaveHeader( outputFile, outputChannels, outputSampleRate, 0 );
+}
+
+/*
+========================
+idSoundHardware_Software::WriteOutput
+========================
+*/
+void idSoundHardware_Software::WriteOutput( const short * samples, int numFrames ) {
+	if ( outputFile == NULL ) {
+		return;
+	}
+	outputBytes += outputFile->Write( samples, numFrames * outputChannels * sizeof( short ) );
+}
+
+/*
+========================
+idSoundHardware_Software::CloseOutput
+========================
+*/
+void idSoundHardware_Software::CloseOutput() {
+	if ( outputFile == NULL ) {
+		return;
+	}
+	outputFile->Seek( 0, FS_SEEK_SET );
+	WriteWaveHeader( outputFile, outputChannels, outputSampleRate, outputBytes );
+	fileSystem->CloseFile( outputFile );
+	outputFile = NULL;
+	outputBytes = 0;
+}
+
+/*
+========================
+idSoundHardware_Software::SubmitCommand
+========================
+*/
+int idSoundHardware_Software::SubmitCommand( const swCommand_t & cmd ) {
+	while ( !commandQueue.Push( cmd ) ) {
+		if ( mixerThread.IsRunning() ) {
+			Sys_Yield();
+		} else {
+			// nothing else is draining the queue, so apply the commands right here
+			ProcessCommands();
+		}
+	}
+	return commandQueue.GetLastSequence();
+}
+
+/*
+========================
+idSoundHardware_Software::WaitForMixer
+========================
+*/
+void idSoundHardware_Software::WaitForMixer() {
+	if ( !mixerThread.IsRunning() ) {
+		ProcessCommands();
+		return;
+	}
+	const int sequence = commandQueue.GetLastSequence();
+	while ( !commandQueue.IsComplete( sequence ) ) {
+		Sys_Yield();
+	}
+}
+
+/*
+========================
+idSoundHardware_Software::ProcessCommands
+========================
+*/
+void idSoundHardware_Software::ProcessCommands() {
+	swCommand_t cmd;
+	while ( commandQueue.Pop( cmd ) ) {
+		cmd.voice->ExecuteCommand( cmd );
+		if ( cmd.command == SWCMD_START ) {
+			mixVoices.AddUnique( cmd.voice );
+		} else if ( cmd.command == SWCMD_STOP ) {
+			mixVoices.Remove( cmd.voice );
+		}
+	}
+}
+
+/*
+========================
+idSoundHardware_Software::MixBlock
+========================
+*/
+void idSoundHardware_Software::MixBlock() {
+	const uint64 startTime = Sys_Microseconds();
+
+	ProcessCommands();
+
+	for ( int c = 0; c < outputChannels; c++ ) {
+		memset( mixBuffers[c], 0, SW_MIX_BLOCK_FRAMES * sizeof( float ) );
+	}
+
+	for ( int i = 0; i < mixVoices.Num(); i++ ) {
+		if ( !mixVoices[i]->Mix( mixBuffers, outputChannels, resampleBuffers ) ) {
+			mixVoices.RemoveIndexFast( i );
+			i--;
+		}
+	}
+
+	// apply the master volume and interleave into 16 bit frames
+	const float volume = masterVolume * 32767.0f;
+	int i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vvolume = _mm_set1_ps( volume );
+	const __m128 vmin = _mm_set1_ps( -32768.0f );
+	const __m128 vmax = _mm_set1_ps( 32767.0f );
+
+	if ( outputChannels == 2 ) {
+		for ( ; i + 4 <= SW_MIX_BLOCK_FRAMES; i += 4 ) {
+			const __m128 left = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_load_ps( mixBuffers[0] + i ), vvolume ), vmin ), vmax );
+			const __m128 right = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_load_ps( mixBuffers[1] + i ), vvolume ), vmin ), vmax );
+			// l0 l1 l2 l3 r0 r1 r2 r3 -> l0 r0 l1 r1 l2 r2 l3 r3
+			const __m128i packed = _mm_packs_epi32( _mm_cvtps_epi32( left ), _mm_cvtps_epi32( right ) );
+			const __m128i interleaved = _mm_unpacklo_epi16( packed, _mm_srli_si128( packed, 8 ) );
+			_mm_store_si128( (__m128i *)( outputBuffer + i * 2 ), interleaved );
+		}
+	} else {
+		ALIGN16( int converted[4] );
+		for ( ; i + 4 <= SW_MIX_BLOCK_FRAMES; i += 4 ) {
+			for ( int c = 0; c < outputChannels; c++ ) {
+				const __m128 v = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_load_ps( mixBuffers[c] + i ), vvolume ), vmin ), vmax );
+				_mm_store_si128( (__m128i *)converted, _mm_cvtps_epi32( v ) );
+				for ( int j = 0; j < 4; j++ ) {
+					outputBuffer[ ( i + j ) * outputChannels + c ] = (short)converted[j];
+				}
+			}
+		}
+	}
+
+#endif
+
+	for ( ; i < SW_MIX_BLOCK_FRAMES; i++ ) {
+		for ( int c = 0; c < outputChannels; c++ ) {
+			outputBuffer[ i * outputChannels + c ] = (short)idMath::ClampInt( SHRT_MIN, SHRT_MAX, idMath::Ftoi( mixBuffers[c][i] * volume ) );
+		}
+	}
+
+	WriteOutput( outputBuffer, SW_MIX_BLOCK_FRAMES );
+
+	statVoices = mixVoices.Num();
+	statMicroseconds += (int)( Sys_Microseconds() - startTime );
+	statBlocks++;
+}
+
+/*
+========================
+idSoundHardware_Software::AllocateVoice
+========================
+*/
+idSoundVoice * idSoundHardware_Software::AllocateVoice( const idSoundSample * leadinSample, const idSoundSample * loopingSample ) {
+	if ( leadinSample == NULL ) {
+		return NULL;
+	}
+	if ( loopingSample != NULL ) {
+		if ( ( leadinSample->format.basic.formatTag != loopingSample->format.basic.formatTag ) || ( leadinSample->format.basic.numChannels != loopingSample->format.basic.numChannels ) ) {
+			idLib::Warning( "Leadin/looping format mismatch: %s & %s", leadinSample->GetName(), loopingSample->GetName() );
+			loopingSample = NULL;
+		}
+	}
+
+	idSoundVoice * voice = NULL;
+	for ( int i = 0; i < freeVoices.Num(); i++ ) {
+		if ( freeVoices[i]->IsPlaying() ) {
+			continue;
+		}
+		voice = (idSoundVoice *)freeVoices[i];
+		break;
+	}
+	if ( voice != NULL ) {
+		voice->Create( leadinSample, loopingSample );
+		freeVoices.Remove( voice );
+		return voice;
+	}
+	
+	return NULL;
+}
+
+/*
+========================
+idSoundHardware_Software::FreeVoice
+========================
+*/
+void idSoundHardware_Software::FreeVoice( idSoundVoice * voice ) {
+	voice->Stop();
+
+	// The mixer picks up the stop on its next block, so the voice
+	// stays on the zombie list until it reports !IsPlaying()
+	zombieVoices.Append( voice );
+}
+
+/*
+========================
+idSoundHardware_Software::Update
+========================
+*/
+void idSoundHardware_Software::Update() {
+	if ( outputChannels == 0 ) {
+		return;
+	}
+	if ( soundSystem->IsMuted() ) {
+		masterVolume = 0.0f;
+	} else {
+		masterVolume = DBtoLinear( s_volume_dB.GetFloat() );
+	}
+
+	for ( int i = 0; i < zombieVoices.Num(); i++ ) {
+		if ( !zombieVoices[i]->IsPlaying() ) {
+			freeVoices.Append( zombieVoices[i] );
+			zombieVoices.RemoveIndexFast( i );
+			i--;
+		}
+	}
+
+	if ( s_showPerfData.GetBool() ) {
+		const int blocks = statBlocks - lastStatBlocks;
+		const int microseconds = statMicroseconds - lastStatMicroseconds;
+		lastStatBlocks += blocks;
+		lastStatMicroseconds += microseconds;
+		if ( blocks > 0 ) {
+			const float realTimeMicroseconds = blocks * SW_MIX_BLOCK_FRAMES * 1000000.0f / outputSampleRate;
+			idLib::Printf( "Voices: %d/%d CPU: %.2f%% Blocks: %d\n", statVoices, voices.Num(), 100.0f * microseconds / realTimeMicroseconds, blocks );
+		}
+	}
+}
+
+/*
+========================
+idSoundHardware_Software::Benchmark
+
+Every voice loops the same sample with its own position, pitch and
+occlusion so both resampling paths and the filter get exercised.
+Without a sample name a second of noise at 22kHz is used.
+========================
+*/
+void idSoundHardware_Software::Benchmark( int numVoices, int numBlocks, const char * sampleName ) {
+	if ( outputChannels == 0 ) {
+		idLib::Warning( "Sound hardware is not initialized" );
+		return;
+	}
+
+	idSoundSample * sample = NULL;
+	idSoundSample * ownedSample = NULL;
+	if ( sampleName != NULL ) {
+		sample = soundSystemLocal.LoadSample( sampleName );
+		if ( sample == NULL || sample->IsDefault() ) {
+			idLib::Warning( "Couldn't load %s", sampleName );
+			return;
+		}
+	} else {
+		static const int NOISE_SAMPLE_RATE = 22050;
+
+		ownedSample = new (TAG_AUDIO) idSoundSample;
+		ownedSample->SetName( "_benchmarkNoise" );
+		ownedSample->format.basic.formatTag = idWaveFile::FORMAT_PCM;
+		ownedSample->format.basic.numChannels = 1;
+		ownedSample->format.basic.bitsPerSample = 16;
+		ownedSample->format.basic.samplesPerSec = NOISE_SAMPLE_RATE;
+		ownedSample->format.basic.blockSize = sizeof( short );
+		ownedSample->format.basic.avgBytesPerSec = NOISE_SAMPLE_RATE * sizeof( short );
+
+		idRandom noise( 0 );
+		short * pcm = (short *)Mem_Alloc( NOISE_SAMPLE_RATE * sizeof( short ), TAG_AUDIO );
+		for ( int i = 0; i < NOISE_SAMPLE_RATE; i++ ) {
+			pcm[i] = (short)noise.RandomInt( 0x10000 );
+		}
+		ownedSample->buffers.SetNum( 1 );
+		ownedSample->buffers[0].buffer = pcm;
+		ownedSample->buffers[0].bufferSize = NOISE_SAMPLE_RATE * sizeof( short );
+		ownedSample->buffers[0].numSamples = NOISE_SAMPLE_RATE;
+		ownedSample->totalBufferSize = NOISE_SAMPLE_RATE * sizeof( short );
+		ownedSample->playBegin = 0;
+		ownedSample->playLength = NOISE_SAMPLE_RATE;
+		ownedSample->timestamp = 0;
+		ownedSample->loaded = true;
+		sample = ownedSample;
+	}
+
+	idSoundHardware_Software * mixer = new (TAG_AUDIO) idSoundHardware_Software;
+	mixer->InitOffline( outputChannels, outputSampleRate );
+
+	idSoundVoice * benchmarkVoices = new (TAG_AUDIO) idSoundVoice[ numVoices ];
+	idRandom random( numVoices );
+	for ( int i = 0; i < numVoices; i++ ) {
+		idSoundVoice & voice = benchmarkVoices[i];
+		voice.Reset( mixer );
+		voice.Create( sample, sample );
+		voice.SetPosition( idVec3( random.CRandomFloat() * 20.0f, random.CRandomFloat() * 20.0f, random.CRandomFloat() * 2.0f ) );
+		voice.SetGain( 1.0f / numVoices );
+		voice.SetCenterChannel( 0.0f );
+		voice.SetInnerRadius( 1.0f );
+		// every fourth voice plays at the exact output rate and goes through the straight conversion
+		voice.SetPitch( ( i & 3 ) ? 0.8f + random.RandomFloat() * 0.4f : (float)outputSampleRate / sample->SampleRate() );
+		voice.SetOcclusion( ( i & 7 ) ? 0.0f : 0.5f );
+		voice.Start( random.RandomInt( sample->LengthInMsec() ), ( i & 15 ) ? SSF_NO_FLICKER : 0 );
+	}
+	// run the start commands through before timing
+	mixer->MixBlock();
+
+	const uint64 startTime = Sys_Microseconds();
+	for ( int b = 0; b < numBlocks; b++ ) {
+		// the sound world sends a new position and volume for every voice once per frame
+		for ( int i = 0; i < numVoices; i++ ) {
+			benchmarkVoices[i].Update();
+		}
+		mixer->MixBlock();
+	}
+	const uint64 elapsed = Sys_Microseconds() - startTime;
+
+	const float blockMsec = elapsed / 1000.0f / numBlocks;
+	const float realTimeMsec = SW_MIX_BLOCK_FRAMES * 1000.0f / outputSampleRate;
+	idLib::Printf( "%d voices (%d mixing), %d channels, %d blocks of %d frames\n", numVoices, mixer->mixVoices.Num(), outputChannels, numBlocks, SW_MIX_BLOCK_FRAMES );
+	idLib::Printf( "%.3f ms per block, %.2f%% of real time, %.2f us per voice\n", blockMsec, 100.0f * blockMsec / realTimeMsec, blockMsec * 1000.0f / numVoices );
+
+	mixer->Shutdown();
+	delete mixer;
+	delete[] benchmarkVoices;
+	delete ownedSample;
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __SW_SOUNDHARDWARE_H__
+#define __SW_SOUNDHARDWARE_H__
+
+class idSoundSample_Software;
+class idSoundVoice_Software;
+
+enum swCommandType_t {
+	SWCMD_START,
+	SWCMD_UPDATE,
+	SWCMD_PAUSE,
+	SWCMD_UNPAUSE,
+	SWCMD_STOP
+};
+
+/*
+================================================
+swCommand_t
+
+A voice state change sent from the sound world update to the mixer thread.
+================================================
+*/
+struct swCommand_t {
+	swCommandType_t					command;
+	idSoundVoice_Software *			voice;
+	const idSoundSample_Software *	leadinSample;	// SWCMD_START
+	const idSoundSample_Software *	loopingSample;	// SWCMD_START
+	int								offsetSamples;	// SWCMD_START
+	bool							vuMeter;		// SWCMD_START
+	float							pitch;			// SWCMD_UPDATE
+	float							lowPass;		// SWCMD_UPDATE
+	float							levels[ MAX_CHANNELS_PER_VOICE * MAX_CHANNELS_PER_VOICE ];	// SWCMD_UPDATE, gain included
+};
+
+/*
+================================================
+idSoundCommandQueue_Software
+
+Single producer, single consumer ring buffer. The game thread only
+writes 'writeIndex' and the mixer thread only writes 'readIndex', so
+no locks are needed as long as the command is stored before the index
+is published. The indices double as command sequence numbers.
+================================================
+*/
+class idSoundCommandQueue_Software {
+public:
+	static const int QUEUE_SIZE = 1024;		// must be a power of two
+
+					idSoundCommandQueue_Software() : writeIndex( 0 ), readIndex( 0 ) {}
+
+	// Returns false if the queue is full
+	bool			Push( const swCommand_t & cmd );
+	// Returns false if the queue is empty
+	bool			Pop( swCommand_t & cmd );
+
+	// Sequence number of the most recently pushed command
+	int				GetLastSequence() const { return writeIndex; }
+	// True once the command with this sequence number has been popped
+	bool			IsComplete( int sequence ) const { return ( readIndex - sequence ) >= 0; }
+
+private:
+	swCommand_t		commands[ QUEUE_SIZE ];
+	volatile int	writeIndex;
+	volatile int	readIndex;
+};
+
+/*
+================================================
+idSoundMixerThread_Software
+================================================
+*/
+class idSoundMixerThread_Software : public idSysThread {
+public:
+					idSoundMixerThread_Software() : hardware( NULL ) {}
+
+	idSoundHardware_Software * hardware;
+
+protected:
+	virtual int		Run();
+};
+
+/*
+================================================
+idSoundHardware_Software
+
+Mixes all voices on the CPU into a planar float buffer and hands the
+result to an output sink. There is no device output, the mix is either
+discarded or written to a wave file, which keeps the whole pipeline
+running on machines without any audio hardware.
+================================================
+*/
+class idSoundHardware_Software {
+public:
+					idSoundHardware_Software();
+
+	void			Init();
+	void			Shutdown();
+
+	void 			Update();
+
+	idSoundVoice *	AllocateVoice( const idSoundSample * leadinSample, const idSoundSample * loopingSample );
+	void			FreeVoice( idSoundVoice * voice );
+
+	// there is no XAudio2 engine behind the software mixer
+	void *			GetIXAudio2() const { return NULL; };
+
+	int				GetNumZombieVoices() const { return zombieVoices.Num(); }
+	int				GetNumFreeVoices() const { return freeVoices.Num(); }
+
+	int				GetOutputChannels() const { return outputChannels; }
+	int				GetOutputSampleRate() const { return outputSampleRate; }
+
+	// Blocks until the mixer has consumed every queued command
+	void			WaitForMixer();
+
+	// Mixes one block of SW_MIX_BLOCK_FRAMES frames and sends it to the output
+	void			MixBlock();
+
+	// Mixes numVoices looping voices through a private mixer without output and prints the cost
+	void			Benchmark( int numVoices, int numBlocks, const char * sampleName );
+
+protected:
+	friend class idSoundSample_Software;
+	friend class idSoundVoice_Software;
+
+	// Queues a command for the mixer and returns its sequence number
+	int				SubmitCommand( const swCommand_t & cmd );
+	bool			IsCommandComplete( int sequence ) const { return commandQueue.IsComplete( sequence ); }
+
+private:
+	// Sets up the mix buffers without starting the mixer thread or opening an output,
+	// the caller drives MixBlock() directly
+	void			InitOffline( int numOutputChannels, int sampleRate );
+
+	void			AllocMixBuffers();
+	void			FreeMixBuffers();
+	void			ProcessCommands();
+
+	void			OpenOutput();
+	void			WriteOutput( const short * samples, int numFrames );
+	void			CloseOutput();
+
+	idSoundMixerThread_Software	mixerThread;
+	idSoundCommandQueue_Software	commandQueue;
+
+	int					outputChannels;
+	int					channelMask;
+	int					outputSampleRate;
+
+	// set by the game thread, read by the mixer
+	volatile float		masterVolume;
+
+	// voices the mixer is currently processing, only touched by the mixer thread
+	idList< idSoundVoice_Software *, TAG_AUDIO > mixVoices;
+
+	float *				mixBuffers[ MAX_CHANNELS_PER_VOICE ];
+	float *				resampleBuffers[ MAX_CHANNELS_PER_VOICE ];
+	short *				outputBuffer;
+
+	idFile *			outputFile;
+	int					outputBytes;
+
+	// mixer statistics for s_showPerfData, written by the mixer thread
+	volatile int		statBlocks;
+	volatile int		statVoices;
+	volatile int		statMicroseconds;
+	int					lastStatBlocks;
+	int					lastStatMicroseconds;
+
+	// Can't stop and start a voice on the same frame, so we have to double this to handle the worst case scenario of stopping all voices and starting a full new set
+	idStaticList<idSoundVoice_Software, MAX_HARDWARE_VOICES * 2 > voices;
+	idStaticList<idSoundVoice_Software *, MAX_HARDWARE_VOICES * 2 > zombieVoices;
+	idStaticList<idSoundVoice_Software *, MAX_HARDWARE_VOICES * 2 > freeVoices;
+};
+
+/*
+================================================
+idSoundHardware
+================================================
+*/
+class idSoundHardware : public idSoundHardware_Software {
+};
+
+#endif
@@ -0,0 +1,534 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+Copyright (C) 2016-2017 Dustin Land
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "../../idlib/precompiled.h"
+#include "../snd_local.h"
+
+extern idCVar s_useCompression;
+extern idCVar s_noSound;
+
+const uint32 SOUND_MAGIC_IDMSA = 0x6D7A7274;
+
+extern idCVar sys_lang;
+
+/*
+========================
+AllocBuffer
+========================
+*/
+static void * AllocBuffer( int size, const char * name ) {
+	return Mem_Alloc( size, TAG_AUDIO );
+}
+
+/*
+========================
+FreeBuffer
+========================
+*/
+static void FreeBuffer( void * p ) {
+	return Mem_Free( p );
+}
+
+/*
+========================
+idSoundSample_Software::idSoundSample_Software
+========================
+*/
+idSoundSample_Software::idSoundSample_Software() {
+	timestamp = FILE_NOT_FOUND_TIMESTAMP;
+	loaded = false;
+	neverPurge = false;
+	levelLoadReferenced = false;
+
+	memset( &format, 0, sizeof( format ) );
+
+	totalBufferSize = 0;
+
+	playBegin = 0;
+	playLength = 0;
+
+	lastPlayedTime = 0;
+}
+
+/*
+========================
+idSoundSample_Software::~idSoundSample_Software
+========================
+*/
+idSoundSample_Software::~idSoundSample_Software() {
+	FreeData();
+}
+
+/*
+========================
+idSoundSample_Software::WriteGeneratedSample
+========================
+*/
+void idSoundSample_Software::WriteGeneratedSample( idFile *fileOut ) {
+	fileOut->WriteBig( SOUND_MAGIC_IDMSA );
+	fileOut->WriteBig( timestamp );
+	fileOut->WriteBig( loaded );
+	fileOut->WriteBig( playBegin );
+	fileOut->WriteBig( playLength );
+	idWaveFile::WriteWaveFormatDirect( format, fileOut );
+	fileOut->WriteBig( ( int )amplitude.Num() );
+	fileOut->Write( amplitude.Ptr(), amplitude.Num() );
+	fileOut->WriteBig( totalBufferSize );
+	fileOut->WriteBig( ( int )buffers.Num() );
+	for ( int i = 0; i < buffers.Num(); i++ ) {
+		fileOut->WriteBig( buffers[ i ].numSamples );
+		fileOut->WriteBig( buffers[ i ].bufferSize );
+		fileOut->Write( buffers[ i ].buffer, buffers[ i ].bufferSize );
+	};
+}
+/*
+========================
+idSoundSample_Software::WriteAllSamples
+========================
+*/
+void idSoundSample_Software::WriteAllSamples( const idStr &sampleName ) {
+	idSoundSample_Software * samplePC = new idSoundSample_Software();
+	{
+		idStrStatic< MAX_OSPATH > inName = sampleName;
+		inName.Append( ".msadpcm" );
+		idStrStatic< MAX_OSPATH > inName2 = sampleName;
+		inName2.Append( ".wav" );
+
+		idStrStatic< MAX_OSPATH > outName = "generated/";
+		outName.Append( sampleName );
+		outName.Append( ".idwav" );
+
+		if ( samplePC->LoadWav( inName ) || samplePC->LoadWav( inName2 ) ) {
+			idFile *fileOut = fileSystem->OpenFileWrite( outName, "fs_basepath" );
+			samplePC->WriteGeneratedSample( fileOut );
+			delete fileOut;
+		} 
+	}
+	delete samplePC;
+}
+
+/*
+========================
+idSoundSample_Software::LoadGeneratedSound
+========================
+*/
+bool idSoundSample_Software::LoadGeneratedSample( const idStr &filename ) {
+	idFileLocal fileIn( fileSystem->OpenFileReadMemory( filename ) );
+	if ( fileIn != NULL ) {
+		uint32 magic;
+		fileIn->ReadBig( magic );
+		fileIn->ReadBig( timestamp );
+		fileIn->ReadBig( loaded );
+		fileIn->ReadBig( playBegin );
+		fileIn->ReadBig( playLength );
+		idWaveFile::ReadWaveFormatDirect( format, fileIn );
+		int num;
+		fileIn->ReadBig( num );
+		amplitude.Clear();
+		amplitude.SetNum( num );
+		fileIn->Read( amplitude.Ptr(), amplitude.Num() );
+		fileIn->ReadBig( totalBufferSize );
+		fileIn->ReadBig( num );
+		buffers.SetNum( num );
+		for ( int i = 0; i < num; i++ ) {
+			fileIn->ReadBig( buffers[ i ].numSamples );
+			fileIn->ReadBig( buffers[ i ].bufferSize );
+			buffers[ i ].buffer = AllocBuffer( buffers[ i ].bufferSize, GetName() );
+			fileIn->Read( buffers[ i ].buffer, buffers[ i ].bufferSize );
+		}
+		if ( format.basic.formatTag != idWaveFile::FORMAT_PCM && format.basic.formatTag != idWaveFile::FORMAT_ADPCM ) {
+			idLib::Warning( "LoadGeneratedSample( %s ) : Unsupported wave format %d", filename.c_str(), format.basic.formatTag );
+			FreeData();
+			return false;
+		}
+		return DecodeADPCM();
+	}
+	return false;
+}
+/*
+========================
+idSoundSample_Software::Load
+========================
+*/
+void idSoundSample_Software::LoadResource() {
+	FreeData();
+
+	if ( idStr::Icmpn( GetName(), "_default", 8 ) == 0 ) {
+		MakeDefault();
+		return;
+	}
+
+	if ( s_noSound.GetBool() ) {
+		MakeDefault();
+		return;
+	}
+
+	loaded = false;
+
+	for ( int i = 0; i < 2; i++ ) {
+		idStrStatic< MAX_OSPATH > sampleName = GetName();
+		if ( ( i == 0 ) && !sampleName.Replace( "/vo/", va( "/vo/%s/", sys_lang.GetString() ) ) ) {
+			i++;
+		}
+		idStrStatic< MAX_OSPATH > generatedName = "generated/";
+		generatedName.Append( sampleName );
+
+		{
+			if ( s_useCompression.GetBool() ) {
+				sampleName.Append( ".msadpcm" );
+			} else {
+				sampleName.Append( ".wav" );
+			}
+			generatedName.Append( ".idwav" );
+		}
+		loaded = LoadGeneratedSample( generatedName ) || LoadWav( sampleName );
+
+		if ( !loaded && s_useCompression.GetBool() ) {
+			sampleName.SetFileExtension( "wav" );
+			loaded = LoadWav( sampleName );
+		}
+
+		if ( loaded ) {
+			if ( cvarSystem->GetCVarBool( "fs_buildresources" ) ) {
+				fileSystem->AddSamplePreload( GetName() );
+				WriteAllSamples( GetName() );
+
+				if ( sampleName.Find( "/vo/" ) >= 0 ) {
+					for ( int j = 0; j < Sys_NumLangs(); j++ ) {
+						const char * lang = Sys_Lang( j );
+						if ( idStr::Icmp( lang, ID_LANG_ENGLISH ) == 0 ) {
+							continue;
+						}
+						idStrStatic< MAX_OSPATH > locName = GetName();
+						locName.Replace( "/vo/", va( "/vo/%s/", Sys_Lang( j ) ) );
+						WriteAllSamples( locName );
+					}
+				}
+			}
+			return;
+		}
+	}
+
+	if ( !loaded ) {
+		// make it default if everything else fails
+		MakeDefault();
+	}
+	return;
+}
+
+/*
+========================
+idSoundSample_Software::LoadWav
+========================
+*/
+bool idSoundSample_Software::LoadWav( const idStr & filename ) {
+
+	// load the wave
+	idWaveFile wave;
+	if ( !wave.Open( filename ) ) {
+		return false;
+	}
+
+	idStrStatic< MAX_OSPATH > sampleName = filename;
+	sampleName.SetFileExtension( "amp" );
+	LoadAmplitude( sampleName );
+
+	const char * formatError = wave.ReadWaveFormat( format );
+	if ( formatError != NULL ) {
+		idLib::Warning( "LoadWav( %s ) : %s", filename.c_str(), formatError );
+		MakeDefault();
+		return false;
+	}
+	timestamp = wave.Timestamp();
+
+	totalBufferSize = wave.SeekToChunk( 'data' );
+
+	if ( format.basic.formatTag == idWaveFile::FORMAT_PCM || format.basic.formatTag == idWaveFile::FORMAT_EXTENSIBLE ) {
+
+		if ( format.basic.bitsPerSample != 16 ) {
+			idLib::Warning( "LoadWav( %s ) : %s", filename.c_str(), "Not a 16 bit PCM wav file" );
+			MakeDefault();
+			return false;
+		}
+
+		playBegin = 0;
+		playLength = ( totalBufferSize ) / format.basic.blockSize;
+
+		buffers.SetNum( 1 );
+		buffers[0].bufferSize = totalBufferSize;
+		buffers[0].numSamples = playLength;
+		buffers[0].buffer = AllocBuffer( totalBufferSize, GetName() );
+		
+
+		wave.Read( buffers[0].buffer, totalBufferSize );
+
+		if ( format.basic.bitsPerSample == 16 ) {
+			idSwap::LittleArray( (short *)buffers[0].buffer, totalBufferSize / sizeof( short ) );
+		}
+
+	} else if ( format.basic.formatTag == idWaveFile::FORMAT_ADPCM ) {
+
+		playBegin = 0;
+		playLength = ( ( totalBufferSize / format.basic.blockSize ) * format.extra.adpcm.samplesPerBlock );
+
+		buffers.SetNum( 1 );
+		buffers[0].bufferSize = totalBufferSize;
+		buffers[0].numSamples = playLength;
+		buffers[0].buffer  = AllocBuffer( totalBufferSize, GetName() );
+		
+		wave.Read( buffers[0].buffer, totalBufferSize );
+
+		if ( !DecodeADPCM() ) {
+			idLib::Warning( "LoadWav( %s ) : %s", filename.c_str(), "Malformed ADPCM data" );
+			MakeDefault();
+			return false;
+		}
+
+	} else {
+		idLib::Warning( "LoadWav( %s ) : Unsupported wave format %d", filename.c_str(), format.basic.formatTag );
+		MakeDefault();
+		return false;
+	}
+
+	wave.Close();
+
+	if ( format.basic.formatTag == idWaveFile::FORMAT_EXTENSIBLE ) {
+		// the mixer only deals with basic formats, so convert it after extracting the channel mask
+		format.basic.formatTag = format.extra.extensible.subFormat.data1;
+	}
+
+	// sanity check...
+	assert( buffers[buffers.Num()-1].numSamples == playBegin + playLength );
+
+	return true;
+}
+
+
+/*
+========================
+idSoundSample_Software::MakeDefault
+========================
+*/
+void idSoundSample_Software::MakeDefault() {
+	FreeData();
+
+	static const int DEFAULT_NUM_SAMPLES = 256;
+	static const int DEFAULT_SAMPLE_RATE = 1000;
+
+	timestamp = FILE_NOT_FOUND_TIMESTAMP;
+	loaded = true;
+
+	memset( &format, 0, sizeof( format ) );
+	format.basic.formatTag = idWaveFile::FORMAT_PCM;
+	format.basic.numChannels = 1;
+	format.basic.bitsPerSample = 16;
+	format.basic.samplesPerSec = DEFAULT_SAMPLE_RATE;
+	format.basic.blockSize = format.basic.numChannels * format.basic.bitsPerSample / 8;
+	format.basic.avgBytesPerSec = format.basic.samplesPerSec * format.basic.blockSize;
+
+	assert( format.basic.blockSize == 2 );
+
+	totalBufferSize = DEFAULT_NUM_SAMPLES * 2;
+
+	short * defaultBuffer = (short *)AllocBuffer( totalBufferSize, GetName() );
+	for ( int i = 0; i < DEFAULT_NUM_SAMPLES; i += 2 ) {
+		defaultBuffer[i + 0] = SHRT_MIN;
+		defaultBuffer[i + 1] = SHRT_MAX;
+	}
+
+	buffers.SetNum( 1 );
+	buffers[0].buffer = defaultBuffer;
+	buffers[0].bufferSize = totalBufferSize;
+	buffers[0].numSamples = DEFAULT_NUM_SAMPLES;
+
+	playBegin = 0;
+	playLength = DEFAULT_NUM_SAMPLES;
+}
+
+/*
+========================
+idSoundSample_Software::FreeData
+
+Called before deleting the object and at the start of LoadResource()
+========================
+*/
+void idSoundSample_Software::FreeData() {
+	if ( buffers.Num() > 0 ) {
+		soundSystemLocal.StopVoicesWithSample( (idSoundSample *)this );
+		// the mixer thread may still be reading from the buffers until it has seen the stop commands
+		soundSystemLocal.hardware.WaitForMixer();
+		for ( int i = 0; i < buffers.Num(); i++ ) {
+			FreeBuffer( buffers[i].buffer );
+		}
+		buffers.Clear();
+	}
+	amplitude.Clear();
+
+	timestamp = FILE_NOT_FOUND_TIMESTAMP;
+	memset( &format, 0, sizeof( format ) );
+	loaded = false;
+	totalBufferSize = 0;
+	playBegin = 0;
+	playLength = 0;
+}
+
+/*
+========================
+idSoundSample_Software::DecodeADPCM
+
+Expands MS-ADPCM blocks to 16 bit PCM in place of the compressed buffer.
+Any partial block at the end of the data is dropped, which matches the
+playLength calculated from the format.
+========================
+*/
+bool idSoundSample_Software::DecodeADPCM() {
+	static const int adaptationTable[16] = { 230, 230, 230, 230, 307, 409, 512, 614, 768, 614, 512, 409, 307, 230, 230, 230 };
+
+	if ( format.basic.formatTag != idWaveFile::FORMAT_ADPCM ) {
+		return true;
+	}
+	if ( buffers.Num() != 1 ) {
+		return false;
+	}
+
+	const int numChannels = format.basic.numChannels;
+	const int blockSize = format.basic.blockSize;
+	const int samplesPerBlock = format.extra.adpcm.samplesPerBlock;
+	const int numCoef = format.extra.adpcm.numCoef;
+	if ( numChannels < 1 || numChannels > MAX_CHANNELS_PER_VOICE || samplesPerBlock < 2 || numCoef < 1 || numCoef > 7 ) {
+		return false;
+	}
+	// header is predictor, delta and two history samples per channel, followed by a nibble per sample
+	if ( blockSize < numChannels * 7 + ( ( samplesPerBlock - 2 ) * numChannels + 1 ) / 2 ) {
+		return false;
+	}
+
+	const int numBlocks = buffers[0].bufferSize / blockSize;
+	const int numSamples = numBlocks * samplesPerBlock;
+	const int pcmSize = numSamples * numChannels * sizeof( short );
+	short * pcm = (short *)AllocBuffer( pcmSize, GetName() );
+
+	for ( int b = 0; b < numBlocks; b++ ) {
+		const byte * in = (const byte *)buffers[0].buffer + b * blockSize;
+		short * out = pcm + b * samplesPerBlock * numChannels;
+
+		int coef1[MAX_CHANNELS_PER_VOICE];
+		int coef2[MAX_CHANNELS_PER_VOICE];
+		int delta[MAX_CHANNELS_PER_VOICE];
+		int sample1[MAX_CHANNELS_PER_VOICE];
+		int sample2[MAX_CHANNELS_PER_VOICE];
+
+		for ( int c = 0; c < numChannels; c++ ) {
+			const int predictor = Min( (int)*in++, numCoef - 1 );
+			coef1[c] = format.extra.adpcm.aCoef[predictor].coef1;
+			coef2[c] = format.extra.adpcm.aCoef[predictor].coef2;
+		}
+		for ( int c = 0; c < numChannels; c++, in += 2 ) {
+			delta[c] = (short)( in[0] | ( in[1] << 8 ) );
+		}
+		for ( int c = 0; c < numChannels; c++, in += 2 ) {
+			sample1[c] = (short)( in[0] | ( in[1] << 8 ) );
+		}
+		for ( int c = 0; c < numChannels; c++, in += 2 ) {
+			sample2[c] = (short)( in[0] | ( in[1] << 8 ) );
+		}
+
+		// the older history sample is the first one played
+		for ( int c = 0; c < numChannels; c++ ) {
+			out[c] = (short)sample2[c];
+			out[numChannels + c] = (short)sample1[c];
+		}
+		out += numChannels * 2;
+
+		const int numNibbles = ( samplesPerBlock - 2 ) * numChannels;
+		for ( int n = 0; n < numNibbles; n++ ) {
+			const int c = n % numChannels;
+			const int nibble = ( n & 1 ) ? ( in[n >> 1] & 0x0F ) : ( in[n >> 1] >> 4 );
+			const int signedNibble = ( nibble & 8 ) ? nibble - 16 : nibble;
+
+			int predicted = ( sample1[c] * coef1[c] + sample2[c] * coef2[c] ) >> 8;
+			predicted += signedNibble * delta[c];
+			predicted = idMath::ClampInt( SHRT_MIN, SHRT_MAX, predicted );
+
+			sample2[c] = sample1[c];
+			sample1[c] = predicted;
+			delta[c] = Max( 16, ( adaptationTable[nibble] * delta[c] ) >> 8 );
+
+			out[n] = (short)predicted;
+		}
+	}
+
+	FreeBuffer( buffers[0].buffer );
+	buffers[0].buffer = pcm;
+	buffers[0].bufferSize = pcmSize;
+	buffers[0].numSamples = playBegin + numSamples;
+	totalBufferSize = pcmSize;
+	playLength = numSamples;
+
+	format.basic.formatTag = idWaveFile::FORMAT_PCM;
+	format.basic.bitsPerSample = 16;
+	format.basic.blockSize = numChannels * sizeof( short );
+	format.basic.avgBytesPerSec = format.basic.samplesPerSec * format.basic.blockSize;
+	return true;
+}
+
+/*
+========================
+idSoundSample_Software::LoadAmplitude
+========================
+*/
+bool idSoundSample_Software::LoadAmplitude( const idStr & name ) {
+	amplitude.Clear();
+	idFileLocal f( fileSystem->OpenFileRead( name ) );
+	if ( f == NULL ) {
+		return false;
+	}
+	amplitude.SetNum( f->Length() );
+	f->Read( amplitude.Ptr(), amplitude.Num() );
+	return true;
+}
+
+/*
+========================
+idSoundSample_Software::GetAmplitude
+========================
+*/
+float idSoundSample_Software::GetAmplitude( int timeMS ) const {
+	if ( timeMS < 0 || timeMS > LengthInMsec() ) {
+		return 0.0f;
+	}
+	if ( IsDefault() ) {
+		return 1.0f;
+	}
+	int index = timeMS * 60 / 1000;
+	if ( index < 0 || index >= amplitude.Num() ) {
+		return 0.0f;
+	}
+	return (float)amplitude[index] / 255.0f;
+}
@@ -0,0 +1,635 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "../../idlib/precompiled.h"
+#include "../snd_local.h"
+
+#if defined( ID_SOUND_SOFTWARE )
+
+idCVar s_skipHardwareSets( "s_skipHardwareSets", "0", CVAR_BOOL, "Do all calculation, but skip sending updates to the mixer" );
+idCVar s_debugHardware( "s_debugHardware", "0", CVAR_BOOL, "Print a message any time a hardware voice changes" );
+
+// Highest resampling step, this keeps the fixed point positions of a whole block within 31 bits
+static const int SW_MAX_STEP = 8 << SW_FRACTION_BITS;
+
+/*
+========================
+ResampleFrames
+
+Converts numFrames frames starting at the 16.16 position 'fraction' into
+planar floats, linearly interpolating between neighbouring frames. The
+caller guarantees that every frame read, including the one after the last
+position, is inside the sample.
+========================
+*/
+static void ResampleFrames( float * dst[ MAX_CHANNELS_PER_VOICE ], int dstOffset, const short * src, int srcChannels, int numFrames, int fraction, int step ) {
+	const float scale = 1.0f / 32768.0f;
+	const float fractionScale = 1.0f / SW_FRACTION_ONE;
+	int i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vscale = _mm_set1_ps( scale );
+
+	if ( step == SW_FRACTION_ONE && fraction == 0 && srcChannels <= 2 ) {
+		// playing at the output rate, so this is a straight conversion
+		if ( srcChannels == 1 ) {
+			for ( ; i + 4 <= numFrames; i += 4 ) {
+				const __m128i s = _mm_loadl_epi64( (const __m128i *)( src + i ) );
+				const __m128i s32 = _mm_srai_epi32( _mm_unpacklo_epi16( s, s ), 16 );
+				_mm_storeu_ps( dst[0] + dstOffset + i, _mm_mul_ps( _mm_cvtepi32_ps( s32 ), vscale ) );
+			}
+		} else {
+			for ( ; i + 4 <= numFrames; i += 4 ) {
+				const __m128i s = _mm_loadu_si128( (const __m128i *)( src + i * 2 ) );
+				const __m128i left = _mm_srai_epi32( _mm_slli_epi32( s, 16 ), 16 );
+				const __m128i right = _mm_srai_epi32( s, 16 );
+				_mm_storeu_ps( dst[0] + dstOffset + i, _mm_mul_ps( _mm_cvtepi32_ps( left ), vscale ) );
+				_mm_storeu_ps( dst[1] + dstOffset + i, _mm_mul_ps( _mm_cvtepi32_ps( right ), vscale ) );
+			}
+		}
+	} else {
+		const __m128 vfractionScale = _mm_set1_ps( fractionScale );
+		const int fractionMask = SW_FRACTION_ONE - 1;
+
+		for ( ; i + 4 <= numFrames; i += 4 ) {
+			const int p0 = fraction + i * step;
+			const int p1 = p0 + step;
+			const int p2 = p1 + step;
+			const int p3 = p2 + step;
+
+			const short * f0 = src + ( p0 >> SW_FRACTION_BITS ) * srcChannels;
+			const short * f1 = src + ( p1 >> SW_FRACTION_BITS ) * srcChannels;
+			const short * f2 = src + ( p2 >> SW_FRACTION_BITS ) * srcChannels;
+			const short * f3 = src + ( p3 >> SW_FRACTION_BITS ) * srcChannels;
+
+			const __m128 weight = _mm_mul_ps( _mm_cvtepi32_ps( _mm_setr_epi32( p0 & fractionMask, p1 & fractionMask, p2 & fractionMask, p3 & fractionMask ) ), vfractionScale );
+
+			for ( int c = 0; c < srcChannels; c++ ) {
+				const int n = c + srcChannels;
+				const __m128 a = _mm_cvtepi32_ps( _mm_setr_epi32( f0[c], f1[c], f2[c], f3[c] ) );
+				const __m128 b = _mm_cvtepi32_ps( _mm_setr_epi32( f0[n], f1[n], f2[n], f3[n] ) );
+				const __m128 r = _mm_add_ps( a, _mm_mul_ps( _mm_sub_ps( b, a ), weight ) );
+				_mm_storeu_ps( dst[c] + dstOffset + i, _mm_mul_ps( r, vscale ) );
+			}
+		}
+	}
+
+#endif
+
+	for ( ; i < numFrames; i++ ) {
+		const int p = fraction + i * step;
+		const short * f = src + ( p >> SW_FRACTION_BITS ) * srcChannels;
+		const float w = ( p & ( SW_FRACTION_ONE - 1 ) ) * fractionScale;
+		for ( int c = 0; c < srcChannels; c++ ) {
+			const float a = f[c];
+			const float b = f[c + srcChannels];
+			dst[c][dstOffset + i] = ( a + ( b - a ) * w ) * scale;
+		}
+	}
+}
+
+/*
+========================
+MixChannel
+
+Adds src into dst while ramping the level linearly over the block, which
+hides the steps of the once per frame volume and pan updates.
+Both buffers are 16 byte aligned.
+========================
+*/
+static void MixChannel( float * dst, const float * src, int numFrames, float startLevel, float endLevel ) {
+	if ( startLevel == 0.0f && endLevel == 0.0f ) {
+		return;
+	}
+	const float delta = ( endLevel - startLevel ) / numFrames;
+	int i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	__m128 level = _mm_add_ps( _mm_set1_ps( startLevel ), _mm_mul_ps( _mm_set1_ps( delta ), _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f ) ) );
+	const __m128 levelStep = _mm_set1_ps( delta * 4.0f );
+
+	for ( ; i + 4 <= numFrames; i += 4 ) {
+		_mm_store_ps( dst + i, _mm_add_ps( _mm_load_ps( dst + i ), _mm_mul_ps( _mm_load_ps( src + i ), level ) ) );
+		level = _mm_add_ps( level, levelStep );
+	}
+
+#endif
+
+	for ( ; i < numFrames; i++ ) {
+		dst[i] += src[i] * ( startLevel + delta * i );
+	}
+}
+
+/*
+========================
+ChannelRMS
+========================
+*/
+static float ChannelRMS( const float * src, int numFrames ) {
+	float sum = 0.0f;
+	int i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	__m128 vsum = _mm_setzero_ps();
+	for ( ; i + 4 <= numFrames; i += 4 ) {
+		const __m128 s = _mm_load_ps( src + i );
+		vsum = _mm_add_ps( vsum, _mm_mul_ps( s, s ) );
+	}
+	vsum = _mm_add_ps( vsum, _mm_movehl_ps( vsum, vsum ) );
+	vsum = _mm_add_ss( vsum, _mm_shuffle_ps( vsum, vsum, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	_mm_store_ss( &sum, vsum );
+
+#endif
+
+	for ( ; i < numFrames; i++ ) {
+		sum += src[i] * src[i];
+	}
+	return idMath::Sqrt( sum / numFrames );
+}
+
+/*
+========================
+idSoundVoice_Software::idSoundVoice_Software
+========================
+*/
+idSoundVoice_Software::idSoundVoice_Software()
+:	hardware( NULL ),
+	leadinSample( NULL ),
+	loopingSample( NULL ),
+	formatTag( 0 ),
+	numChannels( 0 ),
+	sampleRate( 0 ),
+	hasVUMeter( false ),
+	paused( true ),
+	lastCommand( 0 ),
+	mixPlaying( false ),
+	mixAmplitude( 0.0f ),
+	mixSample( NULL ),
+	mixLeadin( NULL ),
+	mixLooping( NULL ),
+	mixPosition( 0 ),
+	mixFraction( 0 ),
+	mixStep( SW_FRACTION_ONE ),
+	mixPitch( 1.0f ),
+	mixLowPass( 1.0f ),
+	mixPaused( true ),
+	mixVUMeter( false ) {
+
+	memset( mixFilterState, 0, sizeof( mixFilterState ) );
+	memset( mixLevels, 0, sizeof( mixLevels ) );
+	memset( mixTargetLevels, 0, sizeof( mixTargetLevels ) );
+}
+
+/*
+========================
+idSoundVoice_Software::~idSoundVoice_Software
+========================
+*/
+idSoundVoice_Software::~idSoundVoice_Software() {
+}
+
+/*
+========================
+idSoundVoice_Software::Reset
+========================
+*/
+void idSoundVoice_Software::Reset( idSoundHardware_Software * hardware_ ) {
+	hardware = hardware_;
+	leadinSample = NULL;
+	loopingSample = NULL;
+	paused = true;
+	lastCommand = hardware->commandQueue.GetLastSequence();
+	mixPlaying = false;
+	mixSample = NULL;
+	mixLeadin = NULL;
+	mixLooping = NULL;
+}
+
+/*
+========================
+idSoundVoice_Software::CompatibleFormat
+========================
+*/
+bool idSoundVoice_Software::CompatibleFormat( idSoundSample_Software * s ) {
+	// There is no hardware resource tied to the format, so any voice can play anything
+	return true;
+}
+
+/*
+========================
+idSoundVoice_Software::Create
+========================
+*/
+void idSoundVoice_Software::Create( const idSoundSample * leadinSample_, const idSoundSample * loopingSample_ ) {
+	if ( IsPlaying() ) {
+		// This should never hit
+		Stop();
+		return;
+	}
+	leadinSample = (idSoundSample_Software *)leadinSample_;
+	loopingSample = (idSoundSample_Software *)loopingSample_;
+
+	formatTag = leadinSample->format.basic.formatTag;
+	numChannels = leadinSample->format.basic.numChannels;
+	sampleRate = leadinSample->format.basic.samplesPerSec;
+
+	if ( s_debugHardware.GetBool() ) {
+		if ( loopingSample == NULL || loopingSample == leadinSample ) {
+			idLib::Printf( "%dms: %p created for %s\n", Sys_Milliseconds(), this, leadinSample ? leadinSample->GetName() : "<null>" );
+		} else {
+			idLib::Printf( "%dms: %p created for %s and %s\n", Sys_Milliseconds(), this, leadinSample ? leadinSample->GetName() : "<null>", loopingSample ? loopingSample->GetName() : "<null>" );
+		}
+	}
+}
+
+/*
+========================
+idSoundVoice_Software::SubmitCommand
+========================
+*/
+void idSoundVoice_Software::SubmitCommand( swCommand_t & cmd ) {
+	cmd.voice = this;
+	lastCommand = hardware->SubmitCommand( cmd );
+}
+
+/*
+========================
+idSoundVoice_Software::Start
+========================
+*/
+void idSoundVoice_Software::Start( int offsetMS, int ssFlags ) {
+
+	if ( s_debugHardware.GetBool() ) {
+		idLib::Printf( "%dms: %p starting %s @ %dms\n", Sys_Milliseconds(), this, leadinSample ? leadinSample->GetName() : "<null>", offsetMS );
+	}
+
+	if ( !leadinSample ) {
+		return;
+	}
+
+	if ( leadinSample->IsDefault() ) {
+		idLib::Warning( "Starting defaulted sound sample %s", leadinSample->GetName() );
+	}
+
+	hasVUMeter = ( ssFlags & SSF_NO_FLICKER ) == 0;
+
+	assert( offsetMS >= 0 );
+	int offsetSamples = MsecToSamples( offsetMS, leadinSample->SampleRate() );
+	if ( loopingSample == NULL && offsetSamples >= leadinSample->playLength ) {
+		return;
+	}
+
+	swCommand_t cmd;
+	cmd.command = SWCMD_START;
+	cmd.leadinSample = leadinSample;
+	cmd.loopingSample = loopingSample;
+	cmd.offsetSamples = offsetSamples;
+	cmd.vuMeter = hasVUMeter;
+	SubmitCommand( cmd );
+
+	Update();
+	UnPause();
+}
+
+/*
+========================
+idSoundVoice_Software::Update
+========================
+*/
+bool idSoundVoice_Software::Update() {
+	if ( hardware == NULL || leadinSample == NULL ) {
+		return false;
+	}
+
+	const int srcChannels = leadinSample->NumChannels();
+
+	swCommand_t cmd;
+	cmd.command = SWCMD_UPDATE;
+	memset( cmd.levels, 0, sizeof( cmd.levels ) );
+	CalculateSurround( srcChannels, cmd.levels, 1.0f );
+
+	if ( s_skipHardwareSets.GetBool() ) {
+		return true;
+	}
+
+	// the matrix is applied per sample, so fold the voice volume into it
+	assert( idMath::Fabs( gain ) <= 1024.0f );
+	for ( int i = 0; i < srcChannels * dstChannels; i++ ) {
+		cmd.levels[i] *= gain;
+	}
+
+	cmd.pitch = pitch;
+
+	// same cutoff frequency the XAudio2 voices use for occlusion, applied with a one pole filter at the output rate
+	const float outputRate = (float)hardware->GetOutputSampleRate();
+	const float cutoffFrequency = 1000.0f / Max( 0.01f, occlusion );
+	if ( cutoffFrequency * 6.0f >= outputRate ) {
+		cmd.lowPass = 1.0f;
+	} else {
+		cmd.lowPass = 1.0f - idMath::Exp( -idMath::TWO_PI * cutoffFrequency / outputRate );
+	}
+
+	SubmitCommand( cmd );
+	return true;
+}
+
+/*
+========================
+idSoundVoice_Software::IsPlaying
+========================
+*/
+bool idSoundVoice_Software::IsPlaying() {
+	if ( hardware == NULL ) {
+		return false;
+	}
+	return !hardware->IsCommandComplete( lastCommand ) || mixPlaying;
+}
+
+/*
+========================
+idSoundVoice_Software::Pause
+========================
+*/
+void idSoundVoice_Software::Pause() {
+	if ( hardware == NULL || paused ) {
+		return;
+	}
+	if ( s_debugHardware.GetBool() ) {
+		idLib::Printf( "%dms: %p pausing %s\n", Sys_Milliseconds(), this, leadinSample ? leadinSample->GetName() : "<null>" );
+	}
+	swCommand_t cmd;
+	cmd.command = SWCMD_PAUSE;
+	SubmitCommand( cmd );
+	paused = true;
+}
+
+/*
+========================
+idSoundVoice_Software::UnPause
+========================
+*/
+void idSoundVoice_Software::UnPause() {
+	if ( hardware == NULL || !paused ) {
+		return;
+	}
+	if ( s_debugHardware.GetBool() ) {
+		idLib::Printf( "%dms: %p unpausing %s\n", Sys_Milliseconds(), this, leadinSample ? leadinSample->GetName() : "<null>" );
+	}
+	swCommand_t cmd;
+	cmd.command = SWCMD_UNPAUSE;
+	SubmitCommand( cmd );
+	paused = false;
+}
+
+/*
+========================
+idSoundVoice_Software::Stop
+
+A paused voice is still attached to the mixer, so the stop is always sent.
+========================
+*/
+void idSoundVoice_Software::Stop() {
+	if ( hardware == NULL ) {
+		return;
+	}
+	if ( s_debugHardware.GetBool() && !paused ) {
+		idLib::Printf( "%dms: %p stopping %s\n", Sys_Milliseconds(), this, leadinSample ? leadinSample->GetName() : "<null>" );
+	}
+	swCommand_t cmd;
+	cmd.command = SWCMD_STOP;
+	SubmitCommand( cmd );
+	paused = true;
+}
+
+/*
+========================
+idSoundVoice_Software::GetAmplitude
+========================
+*/
+float idSoundVoice_Software::GetAmplitude() {
+	if ( !hasVUMeter ) {
+		return 1.0f;
+	}
+	return mixAmplitude;
+}
+
+/*
+========================
+idSoundVoice_Software::ExecuteCommand
+========================
+*/
+void idSoundVoice_Software::ExecuteCommand( const swCommand_t & cmd ) {
+	switch ( cmd.command ) {
+		case SWCMD_START: {
+			mixLeadin = cmd.leadinSample;
+			mixLooping = cmd.loopingSample;
+			mixSample = mixLeadin;
+			mixPosition = cmd.offsetSamples;
+			mixFraction = 0;
+			if ( mixPosition >= mixLeadin->playLength ) {
+				// Start() only lets this through for looping sounds
+				mixPosition = ( mixPosition - mixLeadin->playLength ) % Max( 1, mixLooping->playLength );
+				mixSample = mixLooping;
+			}
+			mixPitch = 1.0f;
+			mixLowPass = 1.0f;
+			mixPaused = true;
+			mixVUMeter = cmd.vuMeter;
+			mixAmplitude = 0.0f;
+			memset( mixFilterState, 0, sizeof( mixFilterState ) );
+			memset( mixLevels, 0, sizeof( mixLevels ) );
+			memset( mixTargetLevels, 0, sizeof( mixTargetLevels ) );
+			UpdateStep();
+			mixPlaying = true;
+			break;
+		}
+		case SWCMD_UPDATE: {
+			memcpy( mixTargetLevels, cmd.levels, sizeof( mixTargetLevels ) );
+			mixPitch = cmd.pitch;
+			mixLowPass = cmd.lowPass;
+			UpdateStep();
+			break;
+		}
+		case SWCMD_PAUSE: {
+			mixPaused = true;
+			break;
+		}
+		case SWCMD_UNPAUSE: {
+			mixPaused = false;
+			break;
+		}
+		case SWCMD_STOP: {
+			mixSample = NULL;
+			mixPlaying = false;
+			break;
+		}
+	}
+}
+
+/*
+========================
+idSoundVoice_Software::UpdateStep
+========================
+*/
+void idSoundVoice_Software::UpdateStep() {
+	if ( mixSample == NULL ) {
+		return;
+	}
+	const float freqRatio = mixPitch * (float)mixSample->SampleRate() / (float)hardware->GetOutputSampleRate();
+	mixStep = idMath::ClampInt( 1, SW_MAX_STEP, idMath::Ftoi( freqRatio * SW_FRACTION_ONE ) );
+}
+
+/*
+========================
+idSoundVoice_Software::Resample
+========================
+*/
+int idSoundVoice_Software::Resample( float * resampleBuffers[ MAX_CHANNELS_PER_VOICE ], int numFrames ) {
+	const float scale = 1.0f / 32768.0f;
+
+	int frame = 0;
+	while ( frame < numFrames && mixSample != NULL ) {
+		const int srcChannels = mixSample->NumChannels();
+		const int length = mixSample->playLength;
+		const short * pcm = mixSample->GetPCM();
+
+		if ( length <= 0 ) {
+			mixSample = NULL;
+			break;
+		}
+
+		// frames that can be interpolated without reading past the end of the sample
+		const int64 distance = ( (int64)( length - 1 - mixPosition ) << SW_FRACTION_BITS ) - mixFraction;
+		if ( distance > 0 ) {
+			const int count = (int)Min( (int64)( numFrames - frame ), ( distance + mixStep - 1 ) / mixStep );
+			ResampleFrames( resampleBuffers, frame, pcm + mixPosition * srcChannels, srcChannels, count, mixFraction, mixStep );
+
+			const int64 advance = (int64)mixFraction + (int64)count * mixStep;
+			mixPosition += (int)( advance >> SW_FRACTION_BITS );
+			mixFraction = (int)( advance & ( SW_FRACTION_ONE - 1 ) );
+			frame += count;
+			continue;
+		}
+
+		if ( mixPosition < length ) {
+			// the last frame interpolates towards whatever plays next
+			const short * next = ( mixLooping != NULL ) ? mixLooping->GetPCM() : NULL;
+			const float w = mixFraction * ( 1.0f / SW_FRACTION_ONE );
+			for ( int c = 0; c < srcChannels; c++ ) {
+				const float a = pcm[mixPosition * srcChannels + c];
+				const float b = ( next != NULL ) ? next[c] : 0.0f;
+				resampleBuffers[c][frame] = ( a + ( b - a ) * w ) * scale;
+			}
+			mixFraction += mixStep;
+			mixPosition += mixFraction >> SW_FRACTION_BITS;
+			mixFraction &= SW_FRACTION_ONE - 1;
+			frame++;
+			continue;
+		}
+
+		// ran off the end of the sample
+		mixPosition -= length;
+		if ( mixLooping == NULL ) {
+			mixSample = NULL;
+			break;
+		}
+		if ( mixSample != mixLooping ) {
+			mixSample = mixLooping;
+			UpdateStep();
+		}
+		if ( mixPosition >= mixLooping->playLength ) {
+			mixPosition %= Max( 1, mixLooping->playLength );
+		}
+	}
+	return frame;
+}
+
+/*
+========================
+idSoundVoice_Software::Mix
+========================
+*/
+bool idSoundVoice_Software::Mix( float * mixBuffers[ MAX_CHANNELS_PER_VOICE ], int numOutputChannels, float * resampleBuffers[ MAX_CHANNELS_PER_VOICE ] ) {
+	if ( mixSample == NULL ) {
+		mixPlaying = false;
+		return false;
+	}
+	if ( mixPaused ) {
+		return true;
+	}
+
+	const int srcChannels = mixSample->NumChannels();
+
+	const int numFrames = Resample( resampleBuffers, SW_MIX_BLOCK_FRAMES );
+	if ( numFrames < SW_MIX_BLOCK_FRAMES ) {
+		for ( int c = 0; c < srcChannels; c++ ) {
+			memset( resampleBuffers[c] + numFrames, 0, ( SW_MIX_BLOCK_FRAMES - numFrames ) * sizeof( float ) );
+		}
+	}
+
+	if ( mixLowPass < 1.0f ) {
+		for ( int c = 0; c < srcChannels; c++ ) {
+			float * buffer = resampleBuffers[c];
+			float state = mixFilterState[c];
+			for ( int i = 0; i < numFrames; i++ ) {
+				state += mixLowPass * ( buffer[i] - state );
+				buffer[i] = state;
+			}
+			mixFilterState[c] = state;
+		}
+	}
+
+	if ( mixVUMeter ) {
+		float rms = 0.0f;
+		for ( int c = 0; c < srcChannels; c++ ) {
+			rms += ChannelRMS( resampleBuffers[c], SW_MIX_BLOCK_FRAMES );
+		}
+		mixAmplitude = rms / (float)srcChannels;
+	}
+
+	if ( numFrames > 0 ) {
+		for ( int d = 0; d < numOutputChannels; d++ ) {
+			for ( int s = 0; s < srcChannels; s++ ) {
+				const int index = srcChannels * d + s;
+				MixChannel( mixBuffers[d], resampleBuffers[s], SW_MIX_BLOCK_FRAMES, mixLevels[index], mixTargetLevels[index] );
+			}
+		}
+	}
+	memcpy( mixLevels, mixTargetLevels, sizeof( mixLevels ) );
+
+	if ( mixSample == NULL ) {
+		mixPlaying = false;
+		return false;
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __SW_SOUNDVOICE_H__
+#define __SW_SOUNDVOICE_H__
+
+class idSoundHardware_Software;
+struct swCommand_t;
+
+// Number of output frames mixed in one pass, must be a multiple of 4
+static const int SW_MIX_BLOCK_FRAMES = 512;
+
+// Resampling positions are 16.16 fixed point
+static const int SW_FRACTION_BITS = 16;
+static const int SW_FRACTION_ONE = 1 << SW_FRACTION_BITS;
+
+/*
+================================================
+idSoundVoice_Software
+
+The public interface is called from the sound world update, which never
+touches the mixing state directly. Every change is sent to the mixer
+thread through the hardware command queue, and the only data flowing back
+are the playing flag and the VU meter level.
+================================================
+*/
+class idSoundVoice_Software : public idSoundVoice_Base {
+public:
+							idSoundVoice_Software();
+							~idSoundVoice_Software();
+
+	void					Create( const idSoundSample * leadinSample, const idSoundSample * loopingSample );
+
+	// Start playing at a particular point in the buffer.  Does an Update() too
+	void					Start( int offsetMS, int ssFlags );
+
+	// Stop playing.
+	void					Stop();
+
+	// Stop consuming buffers
+	void					Pause();
+	// Start consuming buffers again
+	void					UnPause();
+
+	// Sends new position/volume/pitch information to the mixer
+	bool					Update();
+
+	// returns the RMS levels of the most recently processed block of audio, SSF_FLICKER must have been passed to Start
+	float					GetAmplitude();
+
+	// returns true if we can re-use this voice
+	bool					CompatibleFormat( idSoundSample_Software * s );
+
+	uint32					GetSampleRate() const { return sampleRate; }
+
+private:
+	friend class idSoundHardware_Software;
+
+	// Returns true until the mixer has seen the last command and finished the samples
+	bool					IsPlaying();
+
+	// Called after the voice has been stopped
+	void					FlushSourceBuffers() {}
+
+	// Detaches the voice from any previous mixer state
+	void					Reset( idSoundHardware_Software * hardware_ );
+
+	// Queues a command for this voice on the mixer
+	void					SubmitCommand( swCommand_t & cmd );
+
+	//------------------------
+	// Called from the mixer thread only
+	//------------------------
+
+	// Applies a command taken from the hardware queue
+	void					ExecuteCommand( const swCommand_t & cmd );
+
+	// Adds one block of this voice to the planar mix buffers, returns false once the voice is done
+	bool					Mix( float * mixBuffers[ MAX_CHANNELS_PER_VOICE ], int numOutputChannels, float * resampleBuffers[ MAX_CHANNELS_PER_VOICE ] );
+
+	// Converts numFrames frames of the current sample into float, returns the number of frames written
+	int						Resample( float * resampleBuffers[ MAX_CHANNELS_PER_VOICE ], int numFrames );
+
+	// Recalculates the resampling step for the current sample rate and pitch
+	void					UpdateStep();
+
+	idSoundHardware_Software *	hardware;
+	idSoundSample_Software *	leadinSample;
+	idSoundSample_Software *	loopingSample;
+
+	// These are the fields from the sample format that matter to us for voice reuse
+	uint16					formatTag;
+	uint16					numChannels;
+
+	uint32					sampleRate;
+
+	bool					hasVUMeter;
+	bool					paused;
+
+	// sequence number of the last command queued for this voice
+	int						lastCommand;
+
+	// written by the mixer thread
+	volatile bool			mixPlaying;
+	volatile float			mixAmplitude;
+
+	// mixer thread state
+	const idSoundSample_Software *	mixSample;
+	const idSoundSample_Software *	mixLeadin;
+	const idSoundSample_Software *	mixLooping;
+	int						mixPosition;		// sample frame in mixSample
+	int						mixFraction;		// 16 bit fraction of the position
+	int						mixStep;			// 16.16 source frames per output frame
+	float					mixPitch;
+	float					mixLowPass;			// one pole filter coefficient, 1.0 disables filtering
+	bool					mixPaused;
+	bool					mixVUMeter;
+	float					mixFilterState[ MAX_CHANNELS_PER_VOICE ];
+	float					mixLevels[ MAX_CHANNELS_PER_VOICE * MAX_CHANNELS_PER_VOICE ];
+	float					mixTargetLevels[ MAX_CHANNELS_PER_VOICE * MAX_CHANNELS_PER_VOICE ];
+};
+
+/*
+================================================
+idSoundVoice
+================================================
+*/
+class idSoundVoice : public idSoundVoice_Software {
+};
+
+#endif
@@ -30,6 +30,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../../idlib/precompiled.h"
 #include "../snd_local.h"
 
+#if !defined( ID_SOUND_SOFTWARE )
+
 extern idCVar s_useCompression;
 extern idCVar s_noSound;
 
@@ -486,3 +488,5 @@ float idSoundSample_XAudio2::GetAmplitude( int timeMS ) const {
 	}
 	return (float)amplitude[index] / 255.0f;
 }
+
+#endif
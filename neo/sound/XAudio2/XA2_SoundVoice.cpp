@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../../idlib/precompiled.h"
 #include "../snd_local.h"
 
+#if !defined( ID_SOUND_SOFTWARE )
+
 idCVar s_skipHardwareSets( "s_skipHardwareSets", "0", CVAR_BOOL, "Do all calculation, but skip XA2 calls" );
 idCVar s_debugHardware( "s_debugHardware", "0", CVAR_BOOL, "Print a message any time a hardware voice changes" );
 
@@ -490,3 +492,5 @@ void idSoundVoice_XAudio2::OnBufferStart( idSoundSample_XAudio2 * sample, int bu
 
 	SubmitBuffer( nextSample, nextBuffer, 0 );
 }
+
+#endif
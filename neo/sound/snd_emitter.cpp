@@ -368,6 +368,8 @@ idSoundEmitterLocal::idSoundEmitterLocal
 ========================
 */
 idSoundEmitterLocal::idSoundEmitterLocal() {
+	bucketArea = EMITTER_UNBUCKETED;
+	bucketIndex = -1;
 	Init( 0, NULL );
 }
 
@@ -401,6 +403,13 @@ void idSoundEmitterLocal::Init( int i, idSoundWorldLocal * sw ) {
 	spatializedDistance = 0.0f;
 	spatializedOrigin.Zero();
 
+	areaOrigin.Zero();
+	areaValid = false;
+
+	pathGeneration = -1;
+	pathArea = -1;
+	numPathPortals = -1;
+
 	memset( &parms, 0, sizeof( parms ) );
 }
 
@@ -532,15 +541,15 @@ void idSoundEmitterLocal::Update( int currentTime ) {
 		// work out virtual origin and distance, which may be from a portal instead of the actual origin
 		if ( soundWorld->renderWorld != NULL ) {
 			// we have a valid renderWorld
-			int soundInArea = soundWorld->renderWorld->PointInArea( origin );
-			if ( soundInArea == -1 ) {
-				soundInArea = lastValidPortalArea;
-			} else {
-				lastValidPortalArea = soundInArea;
-			}
+			FindPortalArea();
+			int soundInArea = lastValidPortalArea;
 			if ( soundInArea != -1 && soundInArea != soundWorld->listener.area ) {
 				spatializedDistance = maxDistance * METERS_TO_DOOM;
-				soundWorld->ResolveOrigin( 0, NULL, soundInArea, 0.0f, origin, this );
+				if ( soundWorld->emitterIndexActive ) {
+					soundWorld->ResolveCachedOrigin( soundInArea, this );
+				} else {
+					soundWorld->ResolveOrigin( 0, NULL, soundInArea, 0.0f, origin, this );
+				}
 				spatializedDistance *= DOOM_TO_METERS;
 			}
 		}
@@ -553,6 +562,77 @@ void idSoundEmitterLocal::Update( int currentTime ) {
 	return;
 }
 
+/*
+========================
+idSoundEmitterLocal::FindPortalArea
+
+Only looks up the area again when the emitter has moved
+========================
+*/
+void idSoundEmitterLocal::FindPortalArea() {
+	if ( areaValid && origin == areaOrigin ) {
+		return;
+	}
+	areaOrigin = origin;
+	areaValid = true;
+
+	int area = soundWorld->renderWorld->PointInArea( origin );
+	if ( area != -1 ) {
+		lastValidPortalArea = area;
+	}
+}
+
+/*
+========================
+idSoundEmitterLocal::BucketArea
+
+Returns the area this emitter should be bucketed in by the soundWorld, -1 if it has
+to be updated no matter where the listener is, or EMITTER_UNBUCKETED if it isn't playing anything.
+========================
+*/
+int idSoundEmitterLocal::BucketArea() {
+	if ( channels.Num() == 0 ) {
+		return EMITTER_UNBUCKETED;
+	}
+	if ( soundWorld->renderWorld == NULL || emitterId == soundWorld->listener.id ) {
+		return -1;
+	}
+	float maxDistance = 0.0f;
+	for ( int i = 0; i < channels.Num(); i++ ) {
+		idSoundChannel * chan = channels[i];
+		if ( ( chan->parms.soundShaderFlags & ( SSF_GLOBAL | SSF_NO_OCCLUSION ) ) != 0 ) {
+			return -1;
+		}
+		if ( maxDistance < chan->parms.maxDistance ) {
+			maxDistance = chan->parms.maxDistance;
+		}
+	}
+	if ( !areaValid || origin != areaOrigin ) {
+		// a moving emitter that is too far away to be heard keeps its old area,
+		// Update will find it silent before it looks at portals anyway
+		if ( ( soundWorld->listener.pos - origin ).LengthFast() * DOOM_TO_METERS >= maxDistance ) {
+			return lastValidPortalArea;
+		}
+		FindPortalArea();
+	}
+	return lastValidPortalArea;
+}
+
+/*
+========================
+idSoundEmitterLocal::Silence
+
+Frees the voices of an emitter that is in an area the listener can't hear
+========================
+*/
+void idSoundEmitterLocal::Silence() {
+	for ( int i = 0; i < channels.Num(); i++ ) {
+		channels[i]->volumeDB = DB_SILENCE;
+		channels[i]->currentAmplitude = 0.0f;
+		channels[i]->Mute();
+	}
+}
+
 /*
 ========================
 idSoundEmitterLocal::Index
@@ -80,6 +80,14 @@ typedef enum {
 
 #include "SoundVoice.h"
 
+// Define ID_SOUND_SOFTWARE to replace the XAudio2 backend with the portable software mixer
+#if defined( ID_SOUND_SOFTWARE )
+
+#include "Software/SW_SoundSample.h"
+#include "Software/SW_SoundVoice.h"
+#include "Software/SW_SoundHardware.h"
+
+#else
 
 #define OPERATION_SET 1
 
@@ -93,6 +101,8 @@ typedef enum {
 #include "XAudio2/XA2_SoundVoice.h"
 #include "XAudio2/XA2_SoundHardware.h"
 
+#endif
+
 
 
 //------------------------
@@ -170,6 +180,12 @@ public:
 // This is probably excessive...
 const int MAX_CHANNELS_PER_EMITTER = 16;
 
+// sounds are only traced through this many portals to reach the listener
+const int MAX_PORTAL_TRACE_DEPTH = 10;
+
+// emitters without any channels aren't kept in an area bucket
+const int EMITTER_UNBUCKETED = -2;
+
 /*
 ===================================================================================
 
@@ -266,13 +282,39 @@ public:
 	float					slowmoSpeed;
 	bool					enviroSuitActive;
 
+	//------------------------
+	// Emitter index
+	//
+	// Emitters that can only be heard through portals are bucketed by the area they are in,
+	// so areas that can't reach the listener are skipped without touching their emitters.
+	// The area table and the portal path cached on each emitter are only rebuilt when a
+	// portal changes state or the listener moves into a different area.
+	//------------------------
+	idList< idList< idSoundEmitterLocal *, TAG_AUDIO >, TAG_AUDIO >	areaEmitters;
+	idList< idSoundEmitterLocal *, TAG_AUDIO >	unculledEmitters;	// global, unoccluded, or not in any area
+	idList< idSoundEmitterLocal *, TAG_AUDIO >	updateEmitters;		// gathered each Update
+	idList< int, TAG_AUDIO >					areaClosedPortals;	// fewest closed portals between an area and the listener
+
+	bool					emitterIndexActive;
+	int						portalCacheGeneration;				// cached portal paths are only valid for this generation
+	int						portalCacheListenerArea;
+	int						portalCacheConnectedAreaNum;		// idRenderWorld::m_connectedAreaNum changes with every portal state
+
+	void			UpdatePortalCache();
+	void			InvalidatePortalCache();
+	bool			AreaIsAudible( int area ) const;
+	void			BucketEmitter( idSoundEmitterLocal * emitter, int area );
+	void			UnbucketEmitter( idSoundEmitterLocal * emitter );
+
 public: 
 	struct soundPortalTrace_t {
 		int		portalArea;
+		int		portal;			// portal taken out of portalArea
 		const soundPortalTrace_t * prevStack;
 	};
 
 	void			ResolveOrigin( const int stackDepth, const soundPortalTrace_t * prevStack, const int soundArea, const float dist, const idVec3 & soundOrigin, idSoundEmitterLocal * def );
+	void			ResolveCachedOrigin( const int soundArea, idSoundEmitterLocal * def );
 };
 
 
@@ -314,6 +356,10 @@ public:
 	void			Update( int currentTime );
 	void			OnReloadSound( const idDecl *decl );
 
+	void			FindPortalArea();
+	int				BucketArea();
+	void			Silence();
+
 	//----------------------------------------------
 
 	idSoundWorldLocal *		soundWorld;						// the world that holds this emitter
@@ -335,6 +381,20 @@ public:
 	float		spatializedDistance;
 	idVec3		spatializedOrigin;
 
+	//----- set by FindPortalArea -----
+	idVec3		areaOrigin;						// origin lastValidPortalArea was found for
+	bool		areaValid;
+
+	//----- emitter index, owned by the soundWorld -----
+	int			bucketArea;						// -1 for soundWorld->unculledEmitters
+	int			bucketIndex;					// in the bucket list
+
+	//----- portal path to the listener, valid while pathGeneration == soundWorld->portalCacheGeneration -----
+	int			pathGeneration;
+	int			pathArea;
+	int			numPathPortals;					// -1 if no path has been found
+	int			pathPortals[MAX_PORTAL_TRACE_DEPTH];
+
 	// sound emitters are only allocated by the soundWorld block allocator
 					idSoundEmitterLocal();
 	virtual			~idSoundEmitterLocal();
@@ -425,8 +485,13 @@ public:
 			sample( NULL ),
 			bufferNumber( 0 )
 		{ }
+#if defined( ID_SOUND_SOFTWARE )
+		idSoundVoice_Software *	voice;
+		idSoundSample_Software * sample;
+#else
 		idSoundVoice_XAudio2 *	voice;
 		idSoundSample_XAudio2 * sample;
+#endif
 		int bufferNumber;
 	};
 
@@ -40,10 +40,12 @@ idCVar s_cushionFadeLimit( "s_cushionFadeLimit", "-30", CVAR_FLOAT, "Never cushi
 idCVar s_cushionFadeOver( "s_cushionFadeOver", "10", CVAR_FLOAT, "DB above s_cushionFadeLimit to start ramp to silence" );
 idCVar s_unpauseFadeInTime( "s_unpauseFadeInTime", "250", CVAR_INTEGER, "When unpausing a sound world, milliseconds to fade sounds in over" );
 idCVar s_doorDistanceAdd( "s_doorDistanceAdd", "150", CVAR_FLOAT, "reduce sound volume with this distance when going through a door" );
+idCVar s_useEmitterIndex( "s_useEmitterIndex", "1", CVAR_BOOL, "skip emitters in areas that can't reach the listener and reuse portal paths until a portal or the listener area changes" );
 idCVar s_drawSounds( "s_drawSounds", "0", CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar s_showVoices( "s_showVoices", "0", CVAR_BOOL, "show active voices" );
 idCVar s_volume_dB( "s_volume_dB", "0", CVAR_ARCHIVE | CVAR_FLOAT, "volume in dB" );
 extern idCVar s_noSound;
+extern idCVar s_useOcclusion;
 
 /*
 ========================
@@ -74,6 +76,11 @@ idSoundWorldLocal::idSoundWorldLocal() {
 
 	slowmoSpeed = 1.0f;
 	enviroSuitActive = false;
+
+	emitterIndexActive = false;
+	portalCacheGeneration = 0;
+	portalCacheListenerArea = -1;
+	portalCacheConnectedAreaNum = 0;
 }
 
 /*
@@ -91,6 +98,8 @@ idSoundWorldLocal::~idSoundWorldLocal() {
 		emitters[i]->Reset();
 		emitterAllocator.Free( emitters[i] );
 	}
+	areaEmitters.Clear();
+	unculledEmitters.Clear();
 
 	// Make sure we aren't leaking emitters or channels
 	assert( emitterAllocator.GetAllocCount() == 0 );
@@ -295,10 +304,14 @@ void idSoundWorldLocal::Update() {
 	int	totalHardwareChannels = 0;
 	int	totalEmitterChannels = 0;
 
+	UpdatePortalCache();
+
 	int currentTime = GetSoundTime();
+	updateEmitters.SetNum( 0 );
 	for ( int e = emitters.Num() - 1; e >= 0; e-- ) {
 		// check for freeing a one-shot emitter that is finished playing
 		if ( emitters[e]->CheckForCompletion( currentTime ) ) {
+			UnbucketEmitter( emitters[e] );
 			// do a fast list collapse by swapping the last element into
 			// the slot we are deleting
 			emitters[e]->Reset();
@@ -312,13 +325,39 @@ void idSoundWorldLocal::Update() {
 			continue;
 		}
 
-		emitters[e]->Update( currentTime );
+		// keep the emitter in the bucket for the area it is in now
+		const int bucketArea = emitters[e]->BucketArea();
+		if ( bucketArea != emitters[e]->bucketArea ) {
+			UnbucketEmitter( emitters[e] );
+			BucketEmitter( emitters[e], bucketArea );
+		}
+
+		if ( !emitterIndexActive ) {
+			updateEmitters.Append( emitters[e] );
+		}
+	}
+
+	// only gather the emitters in areas that can reach the listener,
+	// the others were silenced when their area or the listener moved
+	if ( emitterIndexActive ) {
+		updateEmitters.Append( unculledEmitters );
+		for ( int a = 0; a < areaEmitters.Num(); a++ ) {
+			if ( AreaIsAudible( a ) ) {
+				updateEmitters.Append( areaEmitters[a] );
+			}
+		}
+	}
+
+	for ( int e = 0; e < updateEmitters.Num(); e++ ) {
+		idSoundEmitterLocal * emitter = updateEmitters[e];
+
+		emitter->Update( currentTime );
 
-		totalEmitterChannels += emitters[e]->channels.Num();
+		totalEmitterChannels += emitter->channels.Num();
 
 		// sort the active channels into the hardware list
-		for ( int i = 0; i < emitters[e]->channels.Num(); i++ ) {
-			idSoundChannel * channel = emitters[e]->channels[i];
+		for ( int i = 0; i < emitter->channels.Num(); i++ ) {
+			idSoundChannel * channel = emitter->channels[i];
 
 			// check if this channel contributes at all
 			const bool canMute = channel->CanMute();
@@ -397,6 +436,13 @@ void idSoundWorldLocal::Update() {
 		showVoiceTable.Format( "currentCushionDB: %5.1f  freeVoices: %i zombieVoices: %i buffers:%i/%i\n", currentCushionDB, 
 			soundSystemLocal.hardware.GetNumFreeVoices(), soundSystemLocal.hardware.GetNumZombieVoices(),
 			soundSystemLocal.activeStreamBufferContexts.Num(), soundSystemLocal.freeStreamBufferContexts.Num() );
+		if ( emitterIndexActive ) {
+			int audibleAreas = 0;
+			for ( int a = 0; a < areaClosedPortals.Num(); a++ ) {
+				audibleAreas += AreaIsAudible( a ) ? 1 : 0;
+			}
+			showVoiceTable.Append( va( "updatedEmitters: %i/%i audibleAreas: %i/%i\n", updateEmitters.Num(), emitters.Num(), audibleAreas, areaClosedPortals.Num() ) );
+		}
 	}
 	for ( int i = 0; i < activeEmitterChannels.Num(); i++ ) {
 		idSoundChannel * chan = activeEmitterChannels[i].channel;
@@ -517,6 +563,9 @@ void idSoundWorldLocal::ClearAllSoundEmitters() {
 		emitterAllocator.Free( emitters[i] );
 	}
 	emitters.Clear();
+	areaEmitters.Clear();
+	unculledEmitters.Clear();
+	InvalidatePortalCache();
 	localSound = AllocSoundEmitter();
 }
 
@@ -621,6 +670,50 @@ int idSoundWorldLocal::GetSoundTime() {
 	}
 }
 
+/*
+===================
+PortalSoundOrigin
+
+Picks the point on a portal where the sound appears to come from, as close as possible
+to the ray from the sound to the listener.
+===================
+*/
+static idVec3 PortalSoundOrigin( const exitPortal_t & re, const idVec3 & soundOrigin, const idVec3 & listenerPos ) {
+	idVec3	source;
+
+	idPlane	pl;
+	re.w->GetPlane( pl );
+
+	float	scale;
+	idVec3	dir = listenerPos - soundOrigin;
+	if ( !pl.RayIntersection( soundOrigin, dir, scale ) ) {
+		source = re.w->GetCenter();
+	} else {
+		source = soundOrigin + scale * dir;
+
+		// if this point isn't inside the portal edges, slide it in
+		for ( int i = 0 ; i < re.w->GetNumPoints() ; i++ ) {
+			int j = ( i + 1 ) % re.w->GetNumPoints();
+			idVec3	edgeDir = (*(re.w))[j].ToVec3() - (*(re.w))[i].ToVec3();
+			idVec3	edgeNormal;
+
+			edgeNormal.Cross( pl.Normal(), edgeDir );
+
+			idVec3	fromVert = source - (*(re.w))[j].ToVec3();
+
+			float d = edgeNormal * fromVert;
+			if ( d > 0 ) {
+				// move it in
+				float div = edgeNormal.Normalize();
+				d /= div;
+
+				source -= d * edgeNormal;
+			}
+		}
+	}
+	return source;
+}
+
 /*
 ===================
 idSoundWorldLocal::ResolveOrigin
@@ -636,8 +729,6 @@ If there is no path through open portals from the sound to the listener, def->sp
 set at maxDistance
 ===================
 */
-static const int MAX_PORTAL_TRACE_DEPTH = 10;
-
 void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTrace_t *prevStack, const int soundArea, const float dist, const idVec3& soundOrigin, idSoundEmitterLocal *def ) {
 
 	if ( dist >= def->spatializedDistance ) {
@@ -650,6 +741,13 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 		if ( fullDist < def->spatializedDistance ) {
 			def->spatializedDistance = fullDist;
 			def->spatializedOrigin = soundOrigin;
+
+			// remember the chain of portals so ResolveCachedOrigin can follow it without searching
+			def->numPathPortals = stackDepth;
+			int depth = stackDepth;
+			for ( const soundPortalTrace_t * prev = prevStack; prev != NULL; prev = prev->prevStack ) {
+				def->pathPortals[--depth] = prev->portal;
+			}
 		}
 		return;
 	}
@@ -694,44 +792,210 @@ void idSoundWorldLocal::ResolveOrigin( const int stackDepth, const soundPortalTr
 		}
 
 		// pick a point on the portal to serve as our virtual sound origin
-		idVec3	source;
+		idVec3 source = PortalSoundOrigin( re, soundOrigin, listener.pos );
+
+		idVec3 tlen = source - soundOrigin;
+		float tlenLength = tlen.LengthFast();
+
+		newStack.portal = p;
+		ResolveOrigin( stackDepth+1, &newStack, otherArea, dist+tlenLength+occlusionDistance, source, def );
+	}
+}
+
+/*
+===================
+idSoundWorldLocal::ResolveCachedOrigin
+
+Same result as ResolveOrigin, but follows the portal path found the last time instead of searching
+for it, until the portal cache generation changes or the emitter moves to a different area.
+The path isn't searched for again when the emitter or listener move within their areas.
+===================
+*/
+void idSoundWorldLocal::ResolveCachedOrigin( const int soundArea, idSoundEmitterLocal * def ) {
+	if ( !AreaIsAudible( soundArea ) ) {
+		// no chain of portals short enough to trace reaches the listener
+		return;
+	}
+
+	// any path through the portals is at least as long as the direct path plus its closed portals
+	const float minDistance = def->directDistance * METERS_TO_DOOM + areaClosedPortals[soundArea] * s_doorDistanceAdd.GetFloat();
+	if ( minDistance >= def->spatializedDistance ) {
+		return;
+	}
+
+	if ( def->pathGeneration != portalCacheGeneration || def->pathArea != soundArea ) {
+		def->numPathPortals = -1;
+		ResolveOrigin( 0, NULL, soundArea, 0.0f, def->origin, def );
+		if ( def->numPathPortals >= 0 ) {
+			def->pathGeneration = portalCacheGeneration;
+			def->pathArea = soundArea;
+		}
+		// if nothing was close enough, search again next time
+		return;
+	}
+
+	float dist = 0.0f;
+	idVec3 soundOrigin = def->origin;
+	int area = soundArea;
+	for ( int i = 0; i < def->numPathPortals; i++ ) {
+		exitPortal_t re = renderWorld->GetPortal( area, def->pathPortals[i] );
+
+		if ( (re.blockingBits & ( PS_BLOCK_VIEW | PS_BLOCK_AIR ) ) ) {
+			dist += s_doorDistanceAdd.GetFloat();
+		}
 
-		idPlane	pl;
-		re.w->GetPlane( pl );
+		idVec3 source = PortalSoundOrigin( re, soundOrigin, listener.pos );
+		dist += ( source - soundOrigin ).LengthFast();
+		soundOrigin = source;
 
-		float	scale;
-		idVec3	dir = listener.pos - soundOrigin;
-		if ( !pl.RayIntersection( soundOrigin, dir, scale ) ) {
-			source = re.w->GetCenter();
-		} else {
-			source = soundOrigin + scale * dir;
+		area = ( re.areas[0] == area ) ? re.areas[1] : re.areas[0];
+	}
+	assert( area == listener.area );
 
-			// if this point isn't inside the portal edges, slide it in
-			for ( int i = 0 ; i < re.w->GetNumPoints() ; i++ ) {
-				int j = ( i + 1 ) % re.w->GetNumPoints();
-				idVec3	edgeDir = (*(re.w))[j].ToVec3() - (*(re.w))[i].ToVec3();
-				idVec3	edgeNormal;
+	float fullDist = dist + ( soundOrigin - listener.pos ).LengthFast();
+	if ( fullDist < def->spatializedDistance ) {
+		def->spatializedDistance = fullDist;
+		def->spatializedOrigin = soundOrigin;
+	}
+}
 
-				edgeNormal.Cross( pl.Normal(), edgeDir );
+/*
+===================
+idSoundWorldLocal::AreaIsAudible
+===================
+*/
+bool idSoundWorldLocal::AreaIsAudible( int area ) const {
+	return ( area >= 0 && area < areaClosedPortals.Num() && areaClosedPortals[area] <= MAX_PORTAL_TRACE_DEPTH );
+}
 
-				idVec3	fromVert = source - (*(re.w))[j].ToVec3();
+/*
+===================
+idSoundWorldLocal::InvalidatePortalCache
+===================
+*/
+void idSoundWorldLocal::InvalidatePortalCache() {
+	emitterIndexActive = false;
+	portalCacheGeneration++;
+}
 
-				float d = edgeNormal * fromVert;
-				if ( d > 0 ) {
-					// move it in
-					float div = edgeNormal.Normalize();
-					d /= div;
+/*
+===================
+idSoundWorldLocal::UpdatePortalCache
 
-					source -= d * edgeNormal;
+Rebuilds the fewest closed portals between each area and the listener area when a portal
+changes state or the listener moves to another area.  Areas more than MAX_PORTAL_TRACE_DEPTH
+portals away can't be heard, so emitters bucketed in them are silenced and skipped.
+===================
+*/
+void idSoundWorldLocal::UpdatePortalCache() {
+	if ( !s_useEmitterIndex.GetBool() || !s_useOcclusion.GetBool() || renderWorld == NULL ) {
+		if ( emitterIndexActive ) {
+			InvalidatePortalCache();
+		}
+		return;
+	}
+
+	const int numAreas = renderWorld->NumAreas();
+	if ( emitterIndexActive && listener.area == portalCacheListenerArea && renderWorld->m_connectedAreaNum == portalCacheConnectedAreaNum
+		&& areaClosedPortals.Num() == numAreas ) {
+		return;
+	}
+
+	emitterIndexActive = true;
+	portalCacheGeneration++;
+	portalCacheListenerArea = listener.area;
+	portalCacheConnectedAreaNum = renderWorld->m_connectedAreaNum;
+
+	// more than MAX_PORTAL_TRACE_DEPTH means the listener can't be reached
+	areaClosedPortals.SetNum( numAreas );
+	for ( int a = 0; a < numAreas; a++ ) {
+		areaClosedPortals[a] = MAX_PORTAL_TRACE_DEPTH + 1;
+	}
+
+	if ( listener.area >= 0 && listener.area < numAreas ) {
+		areaClosedPortals[listener.area] = 0;
+
+		// each pass extends the paths by one portal, like ResolveOrigin's stack depth
+		idList< int, TAG_AUDIO > prevClosedPortals;
+		for ( int depth = 0; depth < MAX_PORTAL_TRACE_DEPTH; depth++ ) {
+			prevClosedPortals = areaClosedPortals;
+			bool changed = false;
+			for ( int a = 0; a < numAreas; a++ ) {
+				if ( prevClosedPortals[a] > MAX_PORTAL_TRACE_DEPTH ) {
+					continue;
+				}
+				int numPortals = renderWorld->NumPortalsInArea( a );
+				for ( int p = 0; p < numPortals; p++ ) {
+					exitPortal_t re = renderWorld->GetPortal( a, p );
+					int otherArea = ( re.areas[0] == a ) ? re.areas[1] : re.areas[0];
+					int closedPortals = prevClosedPortals[a] + ( ( re.blockingBits & ( PS_BLOCK_VIEW | PS_BLOCK_AIR ) ) ? 1 : 0 );
+					if ( closedPortals < areaClosedPortals[otherArea] ) {
+						areaClosedPortals[otherArea] = closedPortals;
+						changed = true;
+					}
 				}
 			}
+			if ( !changed ) {
+				break;
+			}
 		}
+	}
 
-		idVec3 tlen = source - soundOrigin;
-		float tlenLength = tlen.LengthFast();
+	// emitters that can't be heard anymore won't be updated, so free their voices now
+	for ( int a = 0; a < areaEmitters.Num(); a++ ) {
+		if ( AreaIsAudible( a ) ) {
+			continue;
+		}
+		for ( int e = 0; e < areaEmitters[a].Num(); e++ ) {
+			areaEmitters[a][e]->Silence();
+		}
+	}
+}
 
-		ResolveOrigin( stackDepth+1, &newStack, otherArea, dist+tlenLength+occlusionDistance, source, def );
+/*
+===================
+idSoundWorldLocal::BucketEmitter
+===================
+*/
+void idSoundWorldLocal::BucketEmitter( idSoundEmitterLocal * emitter, int area ) {
+	assert( emitter->bucketArea == EMITTER_UNBUCKETED );
+	if ( area == EMITTER_UNBUCKETED ) {
+		return;
+	}
+
+	idList< idSoundEmitterLocal *, TAG_AUDIO > * bucket = &unculledEmitters;
+	if ( area >= 0 ) {
+		if ( area >= areaEmitters.Num() ) {
+			areaEmitters.SetNum( area + 1 );
+		}
+		bucket = &areaEmitters[area];
+
+		if ( emitterIndexActive && !AreaIsAudible( area ) ) {
+			emitter->Silence();
+		}
+	}
+	emitter->bucketArea = area;
+	emitter->bucketIndex = bucket->Append( emitter );
+}
+
+/*
+===================
+idSoundWorldLocal::UnbucketEmitter
+===================
+*/
+void idSoundWorldLocal::UnbucketEmitter( idSoundEmitterLocal * emitter ) {
+	if ( emitter->bucketArea == EMITTER_UNBUCKETED ) {
+		return;
+	}
+
+	idList< idSoundEmitterLocal *, TAG_AUDIO > & bucket = ( emitter->bucketArea >= 0 ) ? areaEmitters[emitter->bucketArea] : unculledEmitters;
+	assert( bucket[emitter->bucketIndex] == emitter );
+	bucket.RemoveIndexFast( emitter->bucketIndex );
+	if ( emitter->bucketIndex < bucket.Num() ) {
+		bucket[emitter->bucketIndex]->bucketIndex = emitter->bucketIndex;
 	}
+	emitter->bucketArea = EMITTER_UNBUCKETED;
+	emitter->bucketIndex = -1;
 }
 
 /*
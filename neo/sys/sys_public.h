@@ -536,6 +536,19 @@ typedef HANDLE idFileHandle;
 
 
 ID_TIME_T		Sys_FileTimeStamp( idFileHandle fp );
+
+// Read only view of an entire file. The view stays valid until unmapped,
+// independently of any handles used to create it.
+struct mappedFile_t {
+	mappedFile_t() : data( NULL ), length( 0 ) {}
+	const byte *	data;
+	size_t			length;
+};
+
+bool			Sys_MapFile( const char * osPath, mappedFile_t & mapping );
+void			Sys_UnmapFile( mappedFile_t & mapping );
+// hint that a range of the mapping will be read soon so the OS can page it in ahead of time
+void			Sys_PrefetchMappedFile( const mappedFile_t & mapping, size_t offset, size_t length );
 // NOTE: do we need to guarantee the same output on all platforms?
 const char *	Sys_TimeStampToStr( ID_TIME_T timeStamp );
 const char *	Sys_SecToStr( int sec );
@@ -431,6 +431,82 @@ ID_TIME_T Sys_FileTimeStamp( idFileHandle fp ) {
 	return itime.QuadPart;
 }
 
+/*
+========================
+Sys_MapFile
+========================
+*/
+bool Sys_MapFile( const char * osPath, mappedFile_t & mapping ) {
+	mapping.data = NULL;
+	mapping.length = 0;
+
+	HANDLE file = CreateFile( osPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( file, &size ) || size.QuadPart == 0 ) {
+		CloseHandle( file );
+		return false;
+	}
+
+	HANDLE fileMapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( file );
+	if ( fileMapping == NULL ) {
+		return false;
+	}
+
+	// the view keeps the mapping object alive
+	void * view = MapViewOfFile( fileMapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( fileMapping );
+	if ( view == NULL ) {
+		return false;
+	}
+
+	mapping.data = (const byte *)view;
+	mapping.length = (size_t)size.QuadPart;
+	return true;
+}
+
+/*
+========================
+Sys_UnmapFile
+========================
+*/
+void Sys_UnmapFile( mappedFile_t & mapping ) {
+	if ( mapping.data != NULL ) {
+		UnmapViewOfFile( mapping.data );
+	}
+	mapping.data = NULL;
+	mapping.length = 0;
+}
+
+/*
+========================
+Sys_PrefetchMappedFile
+
+PrefetchVirtualMemory is only available from Windows 8 on, so it is looked up at runtime.
+========================
+*/
+void Sys_PrefetchMappedFile( const mappedFile_t & mapping, size_t offset, size_t length ) {
+	struct prefetchRange_t {
+		void *	virtualAddress;
+		size_t	numberOfBytes;
+	};
+	typedef BOOL ( WINAPI * PrefetchVirtualMemory_t )( HANDLE, ULONG_PTR, prefetchRange_t *, ULONG );
+	static PrefetchVirtualMemory_t PrefetchVirtualMemory = (PrefetchVirtualMemory_t)GetProcAddress( GetModuleHandle( TEXT( "kernel32" ) ), "PrefetchVirtualMemory" );
+
+	if ( PrefetchVirtualMemory == NULL || mapping.data == NULL || offset >= mapping.length ) {
+		return;
+	}
+
+	prefetchRange_t range;
+	range.virtualAddress = (void *)( mapping.data + offset );
+	range.numberOfBytes = Min( length, mapping.length - offset );
+	PrefetchVirtualMemory( GetCurrentProcess(), 1, &range, 0 );
+}
+
 /*
 ========================
 Sys_Rmdir